@@ -0,0 +1,72 @@
+#include "ai_params.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <stddef.h>
+
+typedef struct {
+    const char* key;
+    size_t offset;
+    bool isInt;
+} AIParamField;
+
+static const AIParamField fields[] = {
+    { "base_difficulty",       offsetof(PongAIParams, baseDifficulty),       false },
+    { "scaling_factor",        offsetof(PongAIParams, scalingFactor),        false },
+    { "difficulty_cap",        offsetof(PongAIParams, difficultyCap),        false },
+    { "score_threshold",       offsetof(PongAIParams, scoreThreshold),       false },
+    { "facilitate_difficulty", offsetof(PongAIParams, facilitateDifficulty), false },
+    { "reaction_delay",        offsetof(PongAIParams, reactionDelay),        false },
+    { "max_error_scale",       offsetof(PongAIParams, maxErrorScale),        false },
+    { "guaranteed_hits",       offsetof(PongAIParams, guaranteedHits),       true  },
+};
+#define FIELD_COUNT (int)(sizeof(fields) / sizeof(fields[0]))
+
+static char* Trim(char* s) {
+    while (isspace((unsigned char)*s)) s++;
+    char* end = s + strlen(s);
+    while (end > s && isspace((unsigned char)end[-1])) *--end = 0;
+    return s;
+}
+
+bool Pong_LoadAIParams(const char* path, PongAIParams* params) {
+    FILE* f = fopen(path, "r");
+    if (!f) return false;
+
+    char line[256];
+    while (fgets(line, sizeof(line), f)) {
+        char* hash = strchr(line, '#');
+        if (hash) *hash = 0;
+        char* eq = strchr(line, '=');
+        if (!eq) continue;
+        *eq = 0;
+        char* key = Trim(line);
+        char* value = Trim(eq + 1);
+
+        for (int i = 0; i < FIELD_COUNT; i++) {
+            if (strcmp(key, fields[i].key) != 0) continue;
+            char* field = (char*)params + fields[i].offset;
+            if (fields[i].isInt) *(int*)field = atoi(value);
+            else *(float*)field = strtof(value, NULL);
+            break;
+        }
+    }
+    fclose(f);
+    return true;
+}
+
+bool Pong_SaveAIParams(const char* path, const PongAIParams* params, const char* comment) {
+    FILE* f = fopen(path, "w");
+    if (!f) return false;
+
+    if (comment) fprintf(f, "# %s\n", comment);
+    for (int i = 0; i < FIELD_COUNT; i++) {
+        const char* field = (const char*)params + fields[i].offset;
+        // %.9g round-trips a float exactly
+        if (fields[i].isInt) fprintf(f, "%s = %d\n", fields[i].key, *(const int*)field);
+        else fprintf(f, "%s = %.9g\n", fields[i].key, (double)*(const float*)field);
+    }
+    fclose(f);
+    return true;
+}
@@ -0,0 +1,11 @@
+#ifndef AI_PARAMS_H
+#define AI_PARAMS_H
+#include <stdbool.h>
+#include "pong_core.h"
+
+// Text file with one "key = value" per line ('#' starts a comment). Missing
+// keys keep the value already in params, unknown keys are ignored.
+bool Pong_LoadAIParams(const char* path, PongAIParams* params);
+bool Pong_SaveAIParams(const char* path, const PongAIParams* params, const char* comment);
+
+#endif
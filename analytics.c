@@ -0,0 +1,309 @@
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200112L
+#endif
+#include "analytics.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#ifdef _WIN32
+#include <windows.h>
+typedef CRITICAL_SECTION Lock;
+static void LockInit(Lock* l) { InitializeCriticalSection(l); }
+static void LockAcquire(Lock* l) { EnterCriticalSection(l); }
+static void LockRelease(Lock* l) { LeaveCriticalSection(l); }
+static void LockFree(Lock* l) { DeleteCriticalSection(l); }
+#else
+#include <pthread.h>
+typedef pthread_mutex_t Lock;
+static void LockInit(Lock* l) { pthread_mutex_init(l, NULL); }
+static void LockAcquire(Lock* l) { pthread_mutex_lock(l); }
+static void LockRelease(Lock* l) { pthread_mutex_unlock(l); }
+static void LockFree(Lock* l) { pthread_mutex_destroy(l); }
+#endif
+
+#ifdef _MSC_VER
+#define THREAD_LOCAL __declspec(thread)
+#else
+#define THREAD_LOCAL __thread
+#endif
+
+static const char ANALYTICS_MAGIC[8] = { 'P', 'O', 'N', 'G', 'S', 'T', 'A', 'T' };
+
+#define COLUMN_COUNT 6
+#define EVENT_BYTES 16      // Sum of the column widths
+#define BLOCK_MAX_BYTES (4 + EVENT_BYTES * ANALYTICS_BUFFER_EVENTS)
+
+struct AnalyticsLog {
+    FILE* file;
+    Lock lock;
+    bool failed;
+};
+
+// One thread's events, already split into columns
+typedef struct {
+    AnalyticsLog* log;
+    int count;
+    unsigned char type[ANALYTICS_BUFFER_EVENTS];
+    unsigned char side[ANALYTICS_BUFFER_EVENTS];
+    unsigned short rally[ANALYTICS_BUFFER_EVENTS];
+    unsigned int frame[ANALYTICS_BUFFER_EVENTS];
+    float a[ANALYTICS_BUFFER_EVENTS];
+    float b[ANALYTICS_BUFFER_EVENTS];
+    unsigned char packed[BLOCK_MAX_BYTES];
+} Buffer;
+
+static THREAD_LOCAL Buffer* threadBuffer;
+
+// ---------------------------------------------------------------------------
+// Little-endian helpers
+// ---------------------------------------------------------------------------
+
+static unsigned char* PutU16(unsigned char* p, unsigned int v) {
+    p[0] = (unsigned char)v; p[1] = (unsigned char)(v >> 8);
+    return p + 2;
+}
+
+static unsigned char* PutU32(unsigned char* p, unsigned int v) {
+    p[0] = (unsigned char)v; p[1] = (unsigned char)(v >> 8);
+    p[2] = (unsigned char)(v >> 16); p[3] = (unsigned char)(v >> 24);
+    return p + 4;
+}
+
+static unsigned char* PutF32(unsigned char* p, float v) {
+    unsigned int bits;
+    memcpy(&bits, &v, sizeof(bits));
+    return PutU32(p, bits);
+}
+
+static unsigned int GetU16(const unsigned char* p) {
+    return (unsigned int)p[0] | ((unsigned int)p[1] << 8);
+}
+
+static unsigned int GetU32(const unsigned char* p) {
+    return (unsigned int)p[0] | ((unsigned int)p[1] << 8) | ((unsigned int)p[2] << 16) | ((unsigned int)p[3] << 24);
+}
+
+static float GetF32(const unsigned char* p) {
+    unsigned int bits = GetU32(p);
+    float v;
+    memcpy(&v, &bits, sizeof(v));
+    return v;
+}
+
+// ---------------------------------------------------------------------------
+// Writer
+// ---------------------------------------------------------------------------
+
+AnalyticsLog* Analytics_Open(const char* path) {
+    AnalyticsLog* log = (AnalyticsLog*)calloc(1, sizeof(AnalyticsLog));
+    if (!log) return NULL;
+    log->file = fopen(path, "wb");
+    if (!log->file) { free(log); return NULL; }
+
+    unsigned char header[sizeof(ANALYTICS_MAGIC) + 4];
+    memcpy(header, ANALYTICS_MAGIC, sizeof(ANALYTICS_MAGIC));
+    PutU16(PutU16(header + sizeof(ANALYTICS_MAGIC), ANALYTICS_VERSION), COLUMN_COUNT);
+    log->failed = fwrite(header, 1, sizeof(header), log->file) != sizeof(header);
+    LockInit(&log->lock);
+    return log;
+}
+
+bool Analytics_Close(AnalyticsLog* log) {
+    bool ok = !log->failed;
+    if (fclose(log->file) != 0) ok = false;
+    LockFree(&log->lock);
+    free(log);
+    return ok;
+}
+
+// Packs the columns outside the lock; only the write is serialised
+static void Flush(Buffer* buf) {
+    int n = buf->count;
+    if (n == 0) return;
+    unsigned char* p = PutU32(buf->packed, (unsigned int)n);
+    memcpy(p, buf->type, (size_t)n); p += n;
+    memcpy(p, buf->side, (size_t)n); p += n;
+    for (int i = 0; i < n; i++) p = PutU16(p, buf->rally[i]);
+    for (int i = 0; i < n; i++) p = PutU32(p, buf->frame[i]);
+    for (int i = 0; i < n; i++) p = PutF32(p, buf->a[i]);
+    for (int i = 0; i < n; i++) p = PutF32(p, buf->b[i]);
+    size_t size = (size_t)(p - buf->packed);
+
+    AnalyticsLog* log = buf->log;
+    LockAcquire(&log->lock);
+    if (fwrite(buf->packed, 1, size, log->file) != size) log->failed = true;
+    LockRelease(&log->lock);
+    buf->count = 0;
+}
+
+bool Analytics_AttachThread(AnalyticsLog* log) {
+    Analytics_DetachThread();
+    Buffer* buf = (Buffer*)malloc(sizeof(Buffer));
+    if (!buf) return false;
+    buf->log = log;
+    buf->count = 0;
+    threadBuffer = buf;
+    return true;
+}
+
+void Analytics_DetachThread(void) {
+    Buffer* buf = threadBuffer;
+    if (!buf) return;
+    Flush(buf);
+    free(buf);
+    threadBuffer = NULL;
+}
+
+void Analytics_Emit(AnalyticsEvent type, int side, int rally, unsigned long long frame, float a, float b) {
+    Buffer* buf = threadBuffer;
+    if (!buf) return;
+    int i = buf->count;
+    buf->type[i] = (unsigned char)type;
+    buf->side[i] = (unsigned char)side;
+    buf->rally[i] = (unsigned short)(rally > 0xFFFF ? 0xFFFF : rally);
+    buf->frame[i] = (unsigned int)frame;
+    buf->a[i] = a;
+    buf->b[i] = b;
+    if (++buf->count == ANALYTICS_BUFFER_EVENTS) Flush(buf);
+}
+
+// ---------------------------------------------------------------------------
+// Aggregator
+// ---------------------------------------------------------------------------
+
+#define HISTOGRAM_BINS 10
+#define HISTOGRAM_WIDTH 40
+
+typedef struct {
+    float* v;
+    size_t count, capacity;
+} Values;
+
+static bool Push(Values* values, float v) {
+    if (values->count == values->capacity) {
+        size_t capacity = values->capacity ? values->capacity * 2 : 1024;
+        float* grown = (float*)realloc(values->v, capacity * sizeof(float));
+        if (!grown) return false;
+        values->v = grown;
+        values->capacity = capacity;
+    }
+    values->v[values->count++] = v;
+    return true;
+}
+
+static int CompareFloat(const void* a, const void* b) {
+    float x = *(const float*)a, y = *(const float*)b;
+    return (x > y) - (x < y);
+}
+
+// Nearest rank, on sorted values
+static float Percentile(const Values* values, double p) {
+    size_t rank = (size_t)ceil(p / 100.0 * (double)values->count);
+    return values->v[rank > 0 ? rank - 1 : 0];
+}
+
+// Percentiles and a histogram over [lo, hi] (the values' range if lo == hi).
+// Whole-number values get whole-number bins.
+static void PrintDistribution(FILE* out, const char* title, Values* values, float lo, float hi, bool whole) {
+    fprintf(out, "%s: ", title);
+    if (values->count == 0) { fprintf(out, "none\n"); return; }
+    qsort(values->v, values->count, sizeof(float), CompareFloat);
+    double sum = 0.0;
+    for (size_t i = 0; i < values->count; i++) sum += values->v[i];
+    fprintf(out, "n %zu, mean %.3f, p50 %.4g, p90 %.4g, p99 %.4g, min %.4g, max %.4g\n", values->count,
+            sum / (double)values->count, Percentile(values, 50), Percentile(values, 90), Percentile(values, 99),
+            values->v[0], values->v[values->count - 1]);
+
+    if (lo == hi) { lo = values->v[0]; hi = values->v[values->count - 1]; }
+    float width = (hi - lo) / HISTOGRAM_BINS;
+    if (whole) { hi += 1.0f; width = ceilf((hi - lo) / HISTOGRAM_BINS); }
+    if (width <= 0.0f) width = 1.0f;
+    int binCount = (int)ceilf((hi - lo) / width);
+    if (binCount < 1) binCount = 1;
+    if (binCount > HISTOGRAM_BINS) binCount = HISTOGRAM_BINS;
+
+    size_t bins[HISTOGRAM_BINS] = { 0 }, most = 0;
+    for (size_t i = 0; i < values->count; i++) {
+        int bin = (int)((values->v[i] - lo) / width);
+        if (bin < 0) bin = 0;
+        if (bin >= binCount) bin = binCount - 1;
+        if (++bins[bin] > most) most = bins[bin];
+    }
+    for (int i = 0; i < binCount; i++) {
+        float from = lo + width * (float)i;
+        int bar = (int)((bins[i] * HISTOGRAM_WIDTH + most - 1) / most);
+        if (whole && width == 1.0f) fprintf(out, "  %9.0f           ", from);
+        else if (whole) fprintf(out, "  %9.0f .. %6.0f ", from, from + width - 1.0f);
+        else fprintf(out, "  %9.3f .. %6.3f ", from, from + width);
+        fprintf(out, "%8zu %.*s\n", bins[i], bar, "########################################");
+    }
+}
+
+bool Analytics_Report(const char* path, FILE* out) {
+    FILE* f = fopen(path, "rb");
+    if (!f) return false;
+    unsigned char header[sizeof(ANALYTICS_MAGIC) + 4];
+    if (fread(header, 1, sizeof(header), f) != sizeof(header) ||
+        memcmp(header, ANALYTICS_MAGIC, sizeof(ANALYTICS_MAGIC)) != 0 ||
+        GetU16(header + sizeof(ANALYTICS_MAGIC)) != ANALYTICS_VERSION ||
+        GetU16(header + sizeof(ANALYTICS_MAGIC) + 2) != COLUMN_COUNT) {
+        fclose(f);
+        return false;
+    }
+
+    // Only the columns each statistic needs are kept
+    Values rallies = { 0 }, difficulty = { 0 }, aimError = { 0 }, contact[2] = { { 0 } }, maxSpeedAfter = { 0 };
+    unsigned long long counts[ANALYTICS_EVENT_COUNT] = { 0 }, events = 0, blocks = 0;
+    unsigned char* block = (unsigned char*)malloc(BLOCK_MAX_BYTES);
+    bool ok = block != NULL;
+
+    unsigned char countBytes[4];
+    while (ok && fread(countBytes, 1, 4, f) == 4) {
+        unsigned int n = GetU32(countBytes);
+        if (n == 0 || n > ANALYTICS_BUFFER_EVENTS || fread(block, EVENT_BYTES, n, f) != n) { ok = false; break; }
+        const unsigned char* type = block;
+        const unsigned char* side = type + n;
+        const unsigned char* rally = side + n;
+        const unsigned char* a = rally + 2 * n + 4 * n;     // frame isn't aggregated
+        const unsigned char* b = a + 4 * n;
+        for (unsigned int i = 0; i < n && ok; i++) {
+            if (type[i] >= ANALYTICS_EVENT_COUNT || side[i] < 1 || side[i] > 2) { ok = false; break; }
+            counts[type[i]]++;
+            if (type[i] == ANALYTICS_HIT) {
+                if (side[i] == 2) ok = Push(&difficulty, GetF32(a + 4 * i));
+                ok = ok && Push(&contact[side[i] - 1], GetF32(b + 4 * i));
+            } else if (type[i] == ANALYTICS_MAX_SPEED) {
+                ok = Push(&maxSpeedAfter, (float)GetU16(rally + 2 * i));
+            } else if (type[i] == ANALYTICS_AIM) {
+                ok = Push(&aimError, GetF32(b + 4 * i));
+            } else {
+                ok = Push(&rallies, (float)GetU16(rally + 2 * i));
+            }
+        }
+        events += n;
+        blocks++;
+    }
+    fclose(f);
+    free(block);
+
+    if (ok) {
+        fprintf(out, "analytics %s: %llu events in %llu blocks (%llu hits, %llu aims, %llu points)\n", path, events, blocks,
+                counts[ANALYTICS_HIT], counts[ANALYTICS_AIM], counts[ANALYTICS_POINT]);
+        PrintDistribution(out, "rally length (hits)", &rallies, 0.0f, 0.0f, true);
+        PrintDistribution(out, "AI difficulty at AI hits", &difficulty, 0.0f, 1.0f, false);
+        PrintDistribution(out, "AI aim error (px)", &aimError, 0.0f, 0.0f, true);
+        PrintDistribution(out, "contact on paddle, player 1 (-1 top, 1 bottom)", &contact[0], -1.0f, 1.0f, false);
+        PrintDistribution(out, "contact on paddle, player 2 (-1 top, 1 bottom)", &contact[1], -1.0f, 1.0f, false);
+        // Reached at most once per rally: the speed only drops at the serve
+        unsigned long long reached = counts[ANALYTICS_MAX_SPEED], points = counts[ANALYTICS_POINT];
+        fprintf(out, "MAX_BALL_SPEED reached in %llu rallies", reached);
+        if (points) fprintf(out, " (%.1f%% of %llu points)", 100.0 * (double)reached / (double)points, points);
+        fprintf(out, "\n");
+        PrintDistribution(out, "hit that reached MAX_BALL_SPEED", &maxSpeedAfter, 0.0f, 0.0f, true);
+    }
+
+    free(rallies.v); free(difficulty.v); free(aimError.v);
+    free(contact[0].v); free(contact[1].v); free(maxSpeedAfter.v);
+    return ok;
+}
@@ -0,0 +1,53 @@
+#ifndef ANALYTICS_H
+#define ANALYTICS_H
+#include <stdio.h>
+#include <stdbool.h>
+
+// Gameplay analytics: Pong_Step (float and fixed point) emits a typed event
+// at every paddle hit, AI aim sample and point. Events go into a buffer
+// owned by the calling thread, so emitting takes no lock; a thread with no
+// buffer attached drops them after one check. Full buffers are appended to
+// a shared log file as one block, under a lock.
+//
+// Log file ('PONGSTAT'): u16 version, u16 column count, then blocks of
+// u32 event count followed by each column for those events, all
+// little-endian:
+//
+//   type   u8    AnalyticsEvent
+//   side   u8    player (1 or 2) the event belongs to
+//   rally  u16   paddle hits since the serve, this one included
+//   frame  u32   PongState.frame (low 32 bits)
+//   a, b   f32   values, per type below
+//
+// Analytics_Report reads a log block by block and prints histograms and
+// percentiles (pong_headless --analytics-report).
+
+#define ANALYTICS_VERSION 1
+#define ANALYTICS_BUFFER_EVENTS 4096    // Events per block
+
+typedef enum {
+    ANALYTICS_HIT,          // a: AI difficulty, b: contact on the paddle (-1 top .. 1 bottom)
+    ANALYTICS_MAX_SPEED,    // The hit took the ball to MAX_BALL_SPEED. a: the speed
+    ANALYTICS_AIM,          // AI sampled its aim error. a: difficulty, b: errorOffset (px)
+    ANALYTICS_POINT,        // side scored; rally is the rally length. a: |ball speed x|
+    ANALYTICS_EVENT_COUNT
+} AnalyticsEvent;
+
+typedef struct AnalyticsLog AnalyticsLog;
+
+// Returns NULL if the file can't be created
+AnalyticsLog* Analytics_Open(const char* path);
+// Call after every thread has detached. Returns false if a write failed.
+bool Analytics_Close(AnalyticsLog* log);
+
+// Gives the calling thread a buffer that flushes to log
+bool Analytics_AttachThread(AnalyticsLog* log);
+// Flushes and frees the calling thread's buffer
+void Analytics_DetachThread(void);
+
+void Analytics_Emit(AnalyticsEvent type, int side, int rally, unsigned long long frame, float a, float b);
+
+// Aggregates a log into out. Returns false if it can't be read.
+bool Analytics_Report(const char* path, FILE* out);
+
+#endif
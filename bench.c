@@ -0,0 +1,490 @@
+#include "pong_core.h"
+#include "pong_clock.h"
+#include "snapshot.h"
+#include "pong_env.h"
+#include "analytics.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+// Microbenchmarks for the per-frame hot paths of pong_core.c, the state
+// snapshot encoder (snapshot.c), the training environments (pong_env.c) and
+// the gameplay analytics (analytics.c).
+//
+//   pong_bench [--reps N] [--min-time-ms N] [--warmup-ms N] [--filter TEXT]
+//              [--json FILE] [--baseline FILE] [--threshold PERCENT]
+//
+// Each benchmark is calibrated so one repetition runs for at least
+// --min-time-ms, warmed up for --warmup-ms, then timed --reps times. The
+// median ns/op is what gets compared: with --baseline, any benchmark whose
+// median is more than --threshold percent slower than the baseline's fails
+// the run (exit code 1), and so does step_analytics costing more than
+// ANALYTICS_BUDGET percent over step (timed in alternation). Results are always written as JSON (--json, default
+// bench_results.json), in the same format the baseline is read from, so a
+// results file can be committed as the next baseline.
+
+#define MONITOR_W 1920
+#define MONITOR_H 1080
+#define FIXTURE_SIZE 1024
+#define FIXTURE_STATES 256
+#define MAX_BENCHMARKS 16
+#define BENCH_ENVS 256
+#define ANALYTICS_BUDGET 2.0    // Most step_analytics may cost over step, percent
+
+typedef unsigned long long (*BenchFn)(long long ops);
+
+typedef struct {
+    const char* name;
+    const char* description;
+    BenchFn fn;
+} Benchmark;
+
+typedef struct {
+    const char* name;
+    long long ops;
+    int reps;
+    double medianNs, minNs, meanNs, stddevNs;
+} BenchResult;
+
+// ---------------------------------------------------------------------------
+// Fixtures: inputs recorded from a real AI-vs-AI match, so branches see
+// realistic data instead of one repeated value
+// ---------------------------------------------------------------------------
+
+static float easeT[FIXTURE_SIZE];
+static PongVec2 ballPositions[FIXTURE_SIZE];
+static float paddleYs[FIXTURE_SIZE];
+static PongState states[FIXTURE_STATES];
+static PongState stepGame;
+static PongState stepFixedGame;     // Same match in fixed point
+static PongState stepAnalyticsGame; // Same match, logging analytics events
+static AnalyticsLog* analyticsLog;
+static PongInput stepInput;
+// Consecutive states of one match, and their snapshots and deltas
+static PongTweens tweens;
+static float tweenValues[PONG_TWEEN_CAPACITY];
+static size_t tweenOffsets[PONG_TWEEN_CAPACITY];
+static PongState frames[FIXTURE_STATES];
+static unsigned char snapshots[FIXTURE_STATES][SNAPSHOT_MAX_SIZE];
+static int snapshotSizes[FIXTURE_STATES];
+static unsigned char deltas[FIXTURE_STATES][SNAPSHOT_MAX_DELTA];
+static int deltaSizes[FIXTURE_STATES];
+// The same matches as environments (one physics step each) and stepped
+// directly, for the cost of the env API
+static PongEnv* benchEnv;
+static PongState envGames[BENCH_ENVS];
+static PongPlayerModel envModels[BENCH_ENVS];
+
+static void BuildFixtures(void) {
+    float windowX = MONITOR_W/2.0f - INITIAL_WIDTH/2.0f;
+    float windowY = MONITOR_H/2.0f - INITIAL_HEIGHT/2.0f;
+    PongState game;
+    Pong_Init(&game, windowX, windowY, MONITOR_W, MONITOR_H, 1);
+
+    int captured = 0, positions = 0;
+    for (long long f = 0; captured < FIXTURE_STATES || positions < FIXTURE_SIZE; f++) {
+        PongInput input = { Pong_AutoPlayerKeys(&game), windowX, windowY };
+        Pong_Step(&game, &input, PONG_FIXED_DT);
+        if (!game.gameStarted) continue;
+        if (positions < FIXTURE_SIZE && f % 7 == 0) {
+            ballPositions[positions] = game.ballPos;
+            paddleYs[positions] = game.p1.y + (float)((positions * 37) % 200) - 100.0f;  // Some out of range
+            positions++;
+        }
+        if (captured < FIXTURE_STATES && f % 97 == 0) states[captured++] = game;
+    }
+    for (int i = 0; i < FIXTURE_SIZE; i++) easeT[i] = (float)i / (float)(FIXTURE_SIZE - 1);
+
+    // A full tween set over every curve, half of them from lookup tables.
+    // Long enough that none finishes during a run.
+    for (int i = 0; i < PONG_TWEEN_CAPACITY; i++) {
+        tweenOffsets[i] = (size_t)i * sizeof(float);
+        PongTween_Add(&tweens, i, 0.0f, 100.0f, 1e9f, 0.0f,
+                      (PongEase)(i % PONG_EASE_COUNT), (i & 1) ? PONG_TWEEN_LUT : 0, i % PONG_TWEEN_GROUPS);
+    }
+
+    stepGame = states[0];
+    stepFixedGame = states[0];
+    stepAnalyticsGame = states[0];
+    Pong_UseFixedPoint(&stepFixedGame);
+    stepInput = (PongInput){ 0, windowX, windowY };
+
+    for (int i = 0; i < FIXTURE_STATES; i++) {
+        PongInput input = { Pong_AutoPlayerKeys(&game), windowX, windowY };
+        Pong_Step(&game, &input, PONG_FIXED_DT);
+        frames[i] = game;
+        snapshotSizes[i] = Snapshot_Encode(&frames[i], snapshots[i], SNAPSHOT_MAX_SIZE);
+        const PongState* prev = &frames[i > 0 ? i - 1 : FIXTURE_STATES - 1];
+        deltaSizes[i] = Snapshot_EncodeDelta(prev, &frames[i], deltas[i], SNAPSHOT_MAX_DELTA);
+    }
+
+    PongEnvConfig cfg;
+    PongEnv_DefaultConfig(&cfg);
+    cfg.frameSkip = 1;
+    benchEnv = PongEnv_Create(BENCH_ENVS, &cfg, NULL);
+    PongEnvBuffers buffers = PongEnv_Buffers(benchEnv);
+    for (int i = 0; i < BENCH_ENVS; i++) {
+        buffers.actions[i] = (signed char)(i % 3 - 1);
+        envGames[i] = *PongEnv_Game(benchEnv, i);
+        PlayerModel_Init(&envModels[i], Pong_PlayerSkill(cfg.opponent), cfg.seed + (unsigned long long)i);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Benchmarks. Each returns something derived from every result so the
+// compiler can't drop the work.
+// ---------------------------------------------------------------------------
+
+static unsigned long long BenchEase(long long ops) {
+    float sum = 0.0f;
+    for (long long i = 0; i < ops; i++) sum += EaseInOutCubic(easeT[i & (FIXTURE_SIZE - 1)]);
+    return (unsigned long long)sum;
+}
+
+static unsigned long long BenchTweenUpdate(long long ops) {
+    for (long long i = 0; i < ops; i++) PongTween_Update(&tweens, tweenValues, tweenOffsets, 1.0f);
+    return (unsigned long long)tweenValues[PONG_TWEEN_CAPACITY - 1];
+}
+
+static unsigned long long BenchPaddleHit(long long ops) {
+    unsigned long long hits = 0;
+    PongRect paddle = states[0].p1;
+    for (long long i = 0; i < ops; i++) {
+        paddle.y = paddleYs[(i * 13) & (FIXTURE_SIZE - 1)];
+        hits += Pong_CheckPaddleHit(ballPositions[i & (FIXTURE_SIZE - 1)], paddle);
+    }
+    return hits;
+}
+
+static unsigned long long BenchUpdateAI(long long ops) {
+    float sum = 0.0f;
+    for (long long i = 0; i < ops; i++) {
+        PongState* s = &states[i & (FIXTURE_STATES - 1)];
+        Pong_UpdateAI(s, PONG_FIXED_DT);
+        sum += s->p2.y;
+    }
+    return (unsigned long long)sum;
+}
+
+static unsigned long long BenchClamp(long long ops) {
+    float sum = 0.0f;
+    for (long long i = 0; i < ops; i++) {
+        PongState* s = &states[i & (FIXTURE_STATES - 1)];
+        s->p1.y = paddleYs[i & (FIXTURE_SIZE - 1)];
+        s->p2.y = paddleYs[(i + 511) & (FIXTURE_SIZE - 1)];
+        Pong_ClampPaddles(s);
+        sum += s->p1.y + s->p2.y;
+    }
+    return (unsigned long long)sum;
+}
+
+static unsigned long long BenchStep(long long ops) {
+    for (long long i = 0; i < ops; i++) {
+        stepInput.keys = Pong_AutoPlayerKeys(&stepGame);
+        Pong_Step(&stepGame, &stepInput, PONG_FIXED_DT);
+    }
+    return stepGame.frame;
+}
+
+static unsigned long long BenchStepFixed(long long ops) {
+    PongInput input = stepInput;
+    for (long long i = 0; i < ops; i++) {
+        input.keys = Pong_AutoPlayerKeys(&stepFixedGame);
+        Pong_Step(&stepFixedGame, &input, PONG_FIXED_DT);
+    }
+    return stepFixedGame.frame;
+}
+
+// Same as step, with the events going into this thread's analytics buffer
+static unsigned long long BenchStepAnalytics(long long ops) {
+    Analytics_AttachThread(analyticsLog);
+    for (long long i = 0; i < ops; i++) {
+        stepInput.keys = Pong_AutoPlayerKeys(&stepAnalyticsGame);
+        Pong_Step(&stepAnalyticsGame, &stepInput, PONG_FIXED_DT);
+    }
+    Analytics_DetachThread();
+    return stepAnalyticsGame.frame;
+}
+
+static unsigned long long BenchSnapshotEncode(long long ops) {
+    unsigned char buffer[SNAPSHOT_MAX_SIZE];
+    unsigned long long bytes = 0;
+    for (long long i = 0; i < ops; i++) {
+        bytes += (unsigned long long)Snapshot_Encode(&frames[i & (FIXTURE_STATES - 1)], buffer, sizeof(buffer));
+    }
+    return bytes + buffer[20];
+}
+
+static unsigned long long BenchSnapshotDecode(long long ops) {
+    PongState s;
+    float sum = 0.0f;
+    for (long long i = 0; i < ops; i++) {
+        int f = (int)(i & (FIXTURE_STATES - 1));
+        Snapshot_Decode(snapshots[f], snapshotSizes[f], &s);
+        sum += s.ballPos.x;
+    }
+    return (unsigned long long)sum;
+}
+
+static unsigned long long BenchDeltaEncode(long long ops) {
+    unsigned char buffer[SNAPSHOT_MAX_DELTA];
+    unsigned long long bytes = 0;
+    for (long long i = 0; i < ops; i++) {
+        int f = (int)(i & (FIXTURE_STATES - 1));
+        const PongState* prev = &frames[(f + FIXTURE_STATES - 1) & (FIXTURE_STATES - 1)];
+        bytes += (unsigned long long)Snapshot_EncodeDelta(prev, &frames[f], buffer, sizeof(buffer));
+    }
+    return bytes;
+}
+
+static unsigned long long BenchDeltaApply(long long ops) {
+    // Walks the match forward frame by frame, as a spectator does
+    PongState s = frames[FIXTURE_STATES - 1];
+    int words = Snapshot_WordCount();
+    for (long long i = 0; i < ops; i++) {
+        int f = (int)(i & (FIXTURE_STATES - 1));
+        Snapshot_ApplyDelta(deltas[f], deltaSizes[f], words, &s);
+    }
+    return s.frame;
+}
+
+static unsigned long long BenchEnvDirect(long long ops) {
+    PongInput input = stepInput;
+    for (long long i = 0; i < ops; i++) {
+        int e = (int)(i & (BENCH_ENVS - 1));
+        input.keys = PlayerModel_Keys(&envModels[e], &envGames[e], PONG_FIXED_DT);
+        input.keys2 = (e % 3 == 0) ? PONG_KEY_W : (e % 3 == 2) ? PONG_KEY_S : 0;
+        Pong_Step(&envGames[e], &input, PONG_FIXED_DT);
+    }
+    return envGames[0].frame;
+}
+
+static unsigned long long BenchEnvStep(long long ops) {
+    for (long long done = 0; done < ops; done += BENCH_ENVS) {
+        PongEnv_StepRange(benchEnv, 0, ops - done < BENCH_ENVS ? (int)(ops - done) : BENCH_ENVS);
+    }
+    return (unsigned long long)PongEnv_Buffers(benchEnv).obs[PONG_ENV_OBS_BALL_X];
+}
+
+static const Benchmark benchmarks[] = {
+    { "ease_in_out_cubic", "EaseInOutCubic over [0, 1]",                    BenchEase },
+    { "paddle_hit",        "Pong_CheckPaddleHit (ball vs paddle AABB)",      BenchPaddleHit },
+    { "update_ai",         "Pong_UpdateAI (adaptive difficulty + movement)", BenchUpdateAI },
+    { "clamp_paddles",     "Pong_ClampPaddles",                              BenchClamp },
+    { "step",              "Pong_Step, one full headless physics step",     BenchStep },
+    { "step_fixed",        "Pong_Step in fixed-point mode, same match",      BenchStepFixed },
+    { "step_analytics",    "Pong_Step logging analytics events, same match", BenchStepAnalytics },
+    { "snapshot_encode",   "Snapshot_Encode, whole state",                   BenchSnapshotEncode },
+    { "snapshot_decode",   "Snapshot_Decode, whole state",                   BenchSnapshotDecode },
+    { "delta_encode",      "Snapshot_EncodeDelta, one physics step",         BenchDeltaEncode },
+    { "delta_apply",       "Snapshot_ApplyDelta, one physics step",          BenchDeltaApply },
+    { "tween_update",      "PongTween_Update, full set of tweens",           BenchTweenUpdate },
+    { "env_direct",        "Player model + Pong_Step over 256 versus matches", BenchEnvDirect },
+    { "env_step",          "PongEnv_StepRange, same matches, per environment", BenchEnvStep },
+};
+#define BENCHMARK_COUNT (int)(sizeof(benchmarks) / sizeof(benchmarks[0]))
+
+// ---------------------------------------------------------------------------
+// Harness
+// ---------------------------------------------------------------------------
+
+static volatile unsigned long long sink;
+
+static double TimeOps(BenchFn fn, long long ops) {
+    unsigned long long start = Pong_ClockNs();
+    sink += fn(ops);
+    return (double)(Pong_ClockNs() - start);
+}
+
+static int CompareDouble(const void* a, const void* b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+static void RunBenchmark(const Benchmark* b, int reps, double minTimeNs, double warmupNs, BenchResult* r) {
+    // Calibrate: grow the op count until one repetition takes long enough
+    long long ops = 1000;
+    while (TimeOps(b->fn, ops) < minTimeNs && ops < (1LL << 40)) ops *= 2;
+
+    // Warm up caches, branch predictors and CPU clocks
+    double warmed = 0.0;
+    while (warmed < warmupNs) warmed += TimeOps(b->fn, ops);
+
+    double* samples = (double*)malloc(sizeof(double) * (size_t)reps);
+    double sum = 0.0;
+    for (int i = 0; i < reps; i++) {
+        samples[i] = TimeOps(b->fn, ops) / (double)ops;
+        sum += samples[i];
+    }
+    qsort(samples, (size_t)reps, sizeof(double), CompareDouble);
+
+    r->name = b->name;
+    r->ops = ops;
+    r->reps = reps;
+    r->minNs = samples[0];
+    r->medianNs = (reps & 1) ? samples[reps / 2] : 0.5 * (samples[reps / 2 - 1] + samples[reps / 2]);
+    r->meanNs = sum / reps;
+    double var = 0.0;
+    for (int i = 0; i < reps; i++) var += (samples[i] - r->meanNs) * (samples[i] - r->meanNs);
+    r->stddevNs = reps > 1 ? sqrt(var / (reps - 1)) : 0.0;
+    free(samples);
+}
+
+// Times step and step_analytics alternately, so drift in clocks and load
+// hits both alike, and returns the median extra cost of analytics in percent
+static double AnalyticsOverhead(long long ops, int pairs) {
+    double* ratios = (double*)malloc(sizeof(double) * (size_t)pairs);
+    for (int i = 0; i < pairs; i++) {
+        double plain = TimeOps(BenchStep, ops);
+        double logged = TimeOps(BenchStepAnalytics, ops);
+        ratios[i] = logged / plain;
+    }
+    qsort(ratios, (size_t)pairs, sizeof(double), CompareDouble);
+    double median = ratios[pairs / 2];
+    free(ratios);
+    return 100.0 * (median - 1.0);
+}
+
+static bool WriteJson(const char* path, const BenchResult* results, int count) {
+    FILE* f = fopen(path, "w");
+    if (!f) return false;
+    fprintf(f, "{\n  \"version\": 1,\n  \"benchmarks\": [\n");
+    for (int i = 0; i < count; i++) {
+        const BenchResult* r = &results[i];
+        fprintf(f, "    {\"name\": \"%s\", \"ops\": %lld, \"reps\": %d, \"median_ns\": %.4f, "
+                   "\"min_ns\": %.4f, \"mean_ns\": %.4f, \"stddev_ns\": %.4f}%s\n",
+                r->name, r->ops, r->reps, r->medianNs, r->minNs, r->meanNs, r->stddevNs,
+                i + 1 < count ? "," : "");
+    }
+    fprintf(f, "  ]\n}\n");
+    fclose(f);
+    return true;
+}
+
+// Reads the median of one benchmark from a results file written by WriteJson
+static bool FindBaseline(const char* json, const char* name, double* medianNs) {
+    char key[96];
+    snprintf(key, sizeof(key), "\"name\": \"%s\"", name);
+    const char* entry = strstr(json, key);
+    if (!entry) return false;
+    const char* end = strchr(entry, '}');
+    const char* median = strstr(entry, "\"median_ns\":");
+    if (!median || (end && median > end)) return false;
+    *medianNs = strtod(median + strlen("\"median_ns\":"), NULL);
+    return *medianNs > 0.0;
+}
+
+static char* ReadFile(const char* path) {
+    FILE* f = fopen(path, "rb");
+    if (!f) return NULL;
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    char* text = (size >= 0) ? (char*)malloc((size_t)size + 1) : NULL;
+    if (text) {
+        size_t read = fread(text, 1, (size_t)size, f);
+        text[read] = 0;
+    }
+    fclose(f);
+    return text;
+}
+
+static void Usage(void) {
+    fprintf(stderr,
+            "usage: pong_bench [--reps N] [--min-time-ms N] [--warmup-ms N] [--filter TEXT]\n"
+            "                  [--json FILE] [--baseline FILE] [--threshold PERCENT]\n");
+}
+
+int main(int argc, char** argv) {
+    int reps = 15;
+    double minTimeMs = 20.0;
+    double warmupMs = 100.0;
+    const char* filter = NULL;
+    const char* jsonPath = "bench_results.json";
+    const char* baselinePath = NULL;
+    double threshold = 10.0;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        bool hasValue = (i + 1 < argc);
+        if (strcmp(arg, "--reps") == 0 && hasValue) reps = atoi(argv[++i]);
+        else if (strcmp(arg, "--min-time-ms") == 0 && hasValue) minTimeMs = atof(argv[++i]);
+        else if (strcmp(arg, "--warmup-ms") == 0 && hasValue) warmupMs = atof(argv[++i]);
+        else if (strcmp(arg, "--filter") == 0 && hasValue) filter = argv[++i];
+        else if (strcmp(arg, "--json") == 0 && hasValue) jsonPath = argv[++i];
+        else if (strcmp(arg, "--baseline") == 0 && hasValue) baselinePath = argv[++i];
+        else if (strcmp(arg, "--threshold") == 0 && hasValue) threshold = atof(argv[++i]);
+        else { Usage(); return 1; }
+    }
+    if (reps <= 0 || minTimeMs <= 0.0) { Usage(); return 1; }
+
+    char* baseline = NULL;
+    if (baselinePath) {
+        baseline = ReadFile(baselinePath);
+        if (!baseline) {
+            fprintf(stderr, "Could not read baseline %s\n", baselinePath);
+            return 1;
+        }
+    }
+
+    BuildFixtures();
+    analyticsLog = Analytics_Open("/dev/null");
+    if (!analyticsLog) {
+        fprintf(stderr, "Could not open the analytics log\n");
+        return 1;
+    }
+
+    BenchResult results[MAX_BENCHMARKS];
+    int count = 0, regressions = 0;
+    printf("%-18s %12s %10s %10s %8s", "benchmark", "median ns/op", "min", "stddev", "reps");
+    if (baseline) printf(" %12s %8s", "baseline", "change");
+    printf("\n");
+
+    for (int i = 0; i < BENCHMARK_COUNT; i++) {
+        const Benchmark* b = &benchmarks[i];
+        if (filter && !strstr(b->name, filter)) continue;
+
+        BenchResult* r = &results[count++];
+        RunBenchmark(b, reps, minTimeMs * 1e6, warmupMs * 1e6, r);
+        printf("%-18s %12.3f %10.3f %10.3f %8d", r->name, r->medianNs, r->minNs, r->stddevNs, r->reps);
+
+        double baseNs;
+        if (baseline && FindBaseline(baseline, r->name, &baseNs)) {
+            double change = 100.0 * (r->medianNs - baseNs) / baseNs;
+            bool regressed = change > threshold;
+            if (regressed) regressions++;
+            printf(" %12.3f %+7.1f%%%s", baseNs, change, regressed ? "  REGRESSION" : "");
+        } else if (baseline) {
+            printf(" %12s", "(new)");
+        }
+        printf("\n");
+    }
+
+    // The medians above are too far apart in time for a 2% comparison
+    const BenchResult *step = NULL, *stepAnalytics = NULL;
+    for (int i = 0; i < count; i++) {
+        if (strcmp(results[i].name, "step") == 0) step = &results[i];
+        if (strcmp(results[i].name, "step_analytics") == 0) stepAnalytics = &results[i];
+    }
+    if (step && stepAnalytics) {
+        double overhead = AnalyticsOverhead(step->ops, 2 * reps + 1);
+        bool over = overhead > ANALYTICS_BUDGET;
+        if (over) regressions++;
+        printf("analytics overhead on step: %+.1f%% (budget %.1f%%)%s\n", overhead, ANALYTICS_BUDGET, over ? "  OVER BUDGET" : "");
+    }
+    Analytics_Close(analyticsLog);
+
+    if (!WriteJson(jsonPath, results, count)) {
+        fprintf(stderr, "Could not write %s\n", jsonPath);
+        free(baseline);
+        return 1;
+    }
+    printf("results written to %s\n", jsonPath);
+    if (baseline) {
+        printf("%d regression%s beyond %.1f%% against %s\n", regressions, regressions == 1 ? "" : "s",
+               threshold, baselinePath);
+    }
+    free(baseline);
+    return regressions > 0 ? 1 : 0;
+}
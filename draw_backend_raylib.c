@@ -0,0 +1,106 @@
+#include "raylib.h"
+#include "pong_render.h"
+#include <math.h>
+
+// Raylib backend: layers are RenderTexture2Ds, the screen is the window's
+// back buffer. Layer commands come first in a list, so texture mode is always
+// entered outside BeginDrawing/EndDrawing.
+
+static RenderTexture2D layers[PONG_LAYER_COUNT];
+static bool layerLoaded[PONG_LAYER_COUNT];
+
+// Sprite batches draw one cached circle texture per instance: all quads share
+// the texture, so rlgl merges them into a few large vertex batches instead of
+// one triangle fan (and draw call) per circle.
+static Texture2D sprite;
+static int spriteRadius;
+
+static Color ToColor(PongColor c) {
+    return (Color){ c.r, c.g, c.b, c.a };
+}
+
+static bool Raylib_CreateLayer(int layer, int width, int height) {
+    if (layer < 0 || layer >= PONG_LAYER_COUNT) return false;
+    layers[layer] = LoadRenderTexture(width, height);
+    layerLoaded[layer] = layers[layer].id != 0;
+    return layerLoaded[layer];
+}
+
+static void Raylib_DestroyLayer(int layer) {
+    if (sprite.id != 0) {
+        UnloadTexture(sprite);
+        sprite.id = 0;
+    }
+    if (layer < 0 || layer >= PONG_LAYER_COUNT || !layerLoaded[layer]) return;
+    UnloadRenderTexture(layers[layer]);
+    layerLoaded[layer] = false;
+}
+
+static void Raylib_Copy(const PongDrawCommand* c) {
+    const RenderTexture2D* src = &layers[c->source];
+    // Render textures are stored bottom-up: flip the source region
+    Rectangle region = { c->x, (float)src->texture.height - c->y - c->h, c->w, -c->h };
+    DrawTextureRec(src->texture, region, (Vector2){ c->x, c->y }, WHITE);
+}
+
+static void Raylib_Sprites(const PongDrawCommand* c) {
+    int radius = (int)ceilf(c->w);
+    if (sprite.id == 0 || radius != spriteRadius) {
+        if (sprite.id != 0) UnloadTexture(sprite);
+        Image image = GenImageColor(2 * radius, 2 * radius, BLANK);
+        ImageDrawCircle(&image, radius, radius, radius, WHITE);
+        sprite = LoadTextureFromImage(image);
+        UnloadImage(image);
+        spriteRadius = radius;
+    }
+    Color tint = ToColor(c->color);
+    for (int i = 0; i < c->count; i++) {
+        DrawTextureV(sprite, (Vector2){ c->xs[i] - radius, c->ys[i] - radius }, tint);
+    }
+}
+
+static void Raylib_Execute(const PongDrawCommand* c) {
+    switch (c->op) {
+        case PONG_DRAW_CLEAR:  ClearBackground(ToColor(c->color)); break;
+        case PONG_DRAW_RECT:   DrawRectangleRec((Rectangle){ c->x, c->y, c->w, c->h }, ToColor(c->color)); break;
+        case PONG_DRAW_CIRCLE: DrawCircle((int)c->x, (int)c->y, c->w, ToColor(c->color)); break;
+        case PONG_DRAW_LINE:   DrawLine((int)c->x, (int)c->y, (int)c->x2, (int)c->y2, ToColor(c->color)); break;
+        case PONG_DRAW_TEXT:   DrawText(c->text, (int)c->x, (int)c->y, c->size, ToColor(c->color)); break;
+        case PONG_DRAW_COPY:   Raylib_Copy(c); break;
+        case PONG_DRAW_SPRITES: Raylib_Sprites(c); break;
+        default: break;
+    }
+}
+
+static void Raylib_Submit(const PongDrawList* list) {
+    int target = PONG_DRAW_SCREEN;
+    int i = 0;
+
+    // Off-screen layers
+    for (; i < list->count && list->commands[i].target != PONG_DRAW_SCREEN; i++) {
+        const PongDrawCommand* c = &list->commands[i];
+        if (c->target != target) {
+            if (target != PONG_DRAW_SCREEN) EndTextureMode();
+            BeginTextureMode(layers[c->target]);
+            target = c->target;
+        }
+        Raylib_Execute(c);
+    }
+    if (target != PONG_DRAW_SCREEN) EndTextureMode();
+
+    // Screen (always begun and ended: EndDrawing swaps the buffers, even for an
+    // empty frame; PongPacer does the pacing)
+    BeginDrawing();
+    for (; i < list->count; i++) Raylib_Execute(&list->commands[i]);
+    EndDrawing();
+}
+
+const PongDrawBackend* DrawBackend_Raylib(void) {
+    static const PongDrawBackend backend = {
+        "raylib",
+        Raylib_CreateLayer,
+        Raylib_DestroyLayer,
+        Raylib_Submit
+    };
+    return &backend;
+}
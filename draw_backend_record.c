@@ -0,0 +1,45 @@
+#include "pong_render.h"
+
+// Headless backend: draws nothing, only counts the commands of each frame so
+// draw-call budgets can be checked on a machine with no GPU.
+
+static PongDrawRecordCounts counts;
+
+static bool Record_CreateLayer(int layer, int width, int height) {
+    (void)width; (void)height;
+    counts.layerCreates++;
+    return layer >= 0 && layer < PONG_LAYER_COUNT;
+}
+
+static void Record_DestroyLayer(int layer) {
+    (void)layer;
+}
+
+static void Record_Submit(const PongDrawList* list) {
+    for (int i = 0; i < list->count; i++) {
+        counts.ops[list->commands[i].op]++;
+        if (list->commands[i].op == PONG_DRAW_SPRITES) counts.sprites += list->commands[i].count;
+    }
+    counts.frames++;
+    counts.commands += list->count;
+    counts.lastFrameCommands = list->count;
+    if (list->count > counts.maxFrameCommands) counts.maxFrameCommands = list->count;
+}
+
+void DrawRecord_GetCounts(PongDrawRecordCounts* out) {
+    *out = counts;
+}
+
+void DrawRecord_Reset(void) {
+    counts = (PongDrawRecordCounts){ 0 };
+}
+
+const PongDrawBackend* DrawBackend_Recording(void) {
+    static const PongDrawBackend backend = {
+        "recording",
+        Record_CreateLayer,
+        Record_DestroyLayer,
+        Record_Submit
+    };
+    return &backend;
+}
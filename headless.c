@@ -0,0 +1,1540 @@
+#if !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200112L
+#endif
+#include "pong_core.h"
+#include "pong_batch.h"
+#include "win_wrapper.h"
+#include "pong_clock.h"
+#include "profiler.h"
+#include "replay.h"
+#include "ai_params.h"
+#include "pong_render.h"
+#include "netplay.h"
+#include "net_udp.h"
+#include "net_shim.h"
+#include "pong_multiball.h"
+#include "pong_pacer.h"
+#include "snapshot.h"
+#include "overlay_presenter.h"
+#include "input_queue.h"
+#include "pong_env.h"
+#include "pong_video.h"
+#include "analytics.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+// Headless runner: steps the simulation with no window and no frame cap.
+// A frame here is one physics step (PONG_FIXED_DT unless --dt is given).
+//
+//   pong_headless [--frames N] [--matches N] [--seed N] [--dt SECONDS]
+//                 [--script PATTERN] [--ai-params FILE] [--fixed] [--quiet]
+//                 [--record FILE] [--stream FILE] [--save FILE] [--resume FILE]
+//                 [--analytics FILE]
+//   pong_headless --batch N [--frames N] [--seed N] [--dt SECONDS]
+//   pong_headless --window-stats [--frames N] [--seed N]
+//   pong_headless --draw-stats [--frames N] [--seed N] [--ai-params FILE]
+//   pong_headless --replay FILE
+//   pong_headless --analytics-report FILE
+//   pong_headless --video OUT --replay FILE [--frames N] [--size WxH] [--fps N] [--threads N]
+//   pong_headless --netplay [--frames N] [--seed N] [--delay MS] [--jitter MS] [--loss RATE]
+//   pong_headless --multiball N [--frames N] [--seed N]
+//   pong_headless --pacing HZ [--frames N] [--seed N] [--dt SECONDS]
+//   pong_headless --spectate FILE
+//   pong_headless --overlay-thread [--frames N] [--seed N] [--latency MS] [--jitter MS]
+//   pong_headless --input-latency [--frames N] [--seed N] [--record FILE]
+//   pong_headless --env N [--frames N] [--seed N] [--workers N]
+//
+// Without --script, player 1 is driven by Pong_AutoPlayerKeys (AI vs AI).
+// A script is a looping list of <keys><frames> tokens separated by commas,
+// where keys is any of W, S, U (up), D (down) or N (none). Example:
+//   --script W30,S30,N10
+//
+// --batch runs N matches in a PongBatch with every available kernel and
+// reports the throughput of each in matches-frames per second, then the same
+// in a PongFixedBatch.
+//
+// --ai-params FILE plays with AI parameters written by pong_tune.
+//
+// --fixed plays the matches with the fixed-point simulation. Its state
+// hashes don't depend on the compiler or flags: make fixed-check builds with
+// several sets of flags and checks that each re-simulates fixed_golden.replay
+// and ends the fixed batch on FIXED_BATCH_HASH.
+//
+// --record FILE writes the first match as a replay. --replay FILE re-simulates
+// a replay (from here or from the game) and verifies its checkpoints, final
+// score and state hash; the exit code is non-zero on a mismatch.
+//
+// --video OUT renders the replay to a Y4M file (bare I420 if OUT ends in
+// .yuv or .raw, stdout if OUT is -) at --size (default 1280x720) and --fps
+// (default 60), over --threads render threads (default one per CPU), and
+// reports the frames rendered per second. --frames limits the physics steps
+// played (default VIDEO_DEFAULT_SECONDS of play).
+//
+// --analytics FILE logs the gameplay events of every match (analytics.h);
+// --analytics-report FILE prints the histograms and percentiles of a log.
+//
+// --save FILE writes the final state of the first match as a snapshot, and
+// --resume FILE starts every match from one instead of from the seed.
+// --stream FILE writes the first match as a snapshot delta stream, flushed
+// every rendered frame. --spectate FILE follows such a stream (from here or
+// from the game) while it is being written, until it ends or nothing new
+// arrives for SPECTATE_IDLE_MS, and checks the decoded state against the
+// keyframe hashes; the exit code is non-zero on a mismatch.
+//
+// --overlay-thread plays at most OVERLAY_FRAMES paced 60 Hz frames twice
+// against a recording window backend whose every round trip takes --latency
+// (default 20) plus up to --jitter (default 10) ms: once syncing the overlay windows on
+// the game thread, once through the overlay presenter thread. It reports the
+// game thread's time per frame for both, and the presenter's drops and
+// latency; the exit code is non-zero if the presenter didn't end on the
+// newest frame or the game thread's p99 frame is over the 60 Hz budget.
+//
+// --input-latency plays at most INPUT_LATENCY_FRAMES frames at 60 Hz on a
+// virtual clock (INPUT_FRAME_WORK_NS from wake-up to present) while
+// synthetic key holds of random length are injected, twice: once with the
+// keys polled per frame like raylib does, once through the timestamped input
+// queue fed by a simulated 1 kHz sampler. It prints the press-to-present
+// latency histogram and how far paddle travel is from hold length for each;
+// the exit code is non-zero unless the queue does better on both. With
+// --record FILE an idle run through the queue is recorded first, which must
+// hold no 'T' chunks, then the queue run is recorded and the replay verified.
+//
+// --env N runs N training environments (pong_env.c) for --frames steps (at
+// most ENV_STEPS; more are capped, with a note) of a ball-following policy:
+// first as the same matches stepped by calling Pong_Step directly, then
+// through PongEnv on this thread, on a thread pool of --workers threads
+// (default one per CPU), and as --workers processes serving a shared-memory
+// batch. It reports throughput and the cost per physics step against the
+// direct loop; the exit code is non-zero if the environment runs don't all
+// end on the same observations, rewards and episode count, or a worker
+// process dies.
+//
+// Built with make PROFILE=1, per-phase timings are written to
+// headless_profile.json (Chrome trace) and headless_profile.csv on exit.
+//
+// --window-stats plays an AI-vs-AI match at 60 rendered frames per second,
+// syncing the overlay windows through the recording backend, and reports how
+// many window moves reached the backend versus how many the game requested.
+//
+// --netplay runs a versus match between two rollback sessions in this
+// process, talking over real UDP sockets on 127.0.0.1 through a shim that
+// adds --delay (one way), --jitter and --loss. Both sides are driven by
+// ball-tracking bots, on a virtual 60 Hz clock. It reports rollback depth and
+// re-simulation cost per rendered frame, then checks both peers against an
+// offline re-simulation of the inputs actually played; the exit code is
+// non-zero on a desync.
+//
+// --draw-stats renders a match against the AI at 60 frames per second through
+// the retained renderer and the recording draw backend; player 1 stops
+// defending every other DRAW_STATS_PLAY_FRAMES frames so points are scored.
+// It reports draw calls per frame, and fails if the static layer is rebuilt
+// on a frame where no score changed or popped, a score change doesn't
+// rebuild it exactly once, a frame (score pops included) needs more commands
+// than IMMEDIATE_DRAW_CALLS, or the run had no score change or pop to check.
+//
+// --multiball N runs the multi-ball stress mode in a monitor-sized arena at
+// doubling ball counts up to N, for at most MULTIBALL_FRAMES rendered frames
+// each. A frame is the physics steps of one 60 Hz frame plus building and
+// submitting its draw list to the recording backend. It reports frame time
+// (mean, p99, max) against ball count; the exit code is non-zero if the p99
+// frame at N balls misses the 60 FPS budget.
+//
+// --pacing HZ presents at most PACING_FRAMES frames at HZ (0: uncapped)
+// through the frame pacer, first sleeping only and then with the hybrid
+// sleep/spin wait, and prints a histogram of frame interval error for each.
+// Every frame steps an AI-vs-AI match at the simulation rate given by --dt
+// through a fixed-step accumulator and renders it to the recording backend.
+
+#define MONITOR_W 1920
+#define MONITOR_H 1080
+#define MAX_SCRIPT_STEPS 256
+#define RENDER_HZ 60
+// Commands the old immediate-mode frame issued: clear, 2 scores, net, 3 movers
+#define IMMEDIATE_DRAW_CALLS 7
+#define DRAW_STATS_PLAY_FRAMES 1200   // --draw-stats: 20 s of play, then 20 s parked
+#define MULTIBALL_FRAMES 600
+#define PACING_FRAMES 600
+#define SPECTATE_IDLE_MS 2000
+#define OVERLAY_FRAMES 300
+#define INPUT_LATENCY_FRAMES 3600
+#define INPUT_FRAME_WORK_NS 2000000ULL
+#define ENV_STEPS 1000
+
+typedef struct {
+    unsigned char keys[MAX_SCRIPT_STEPS];
+    int frames[MAX_SCRIPT_STEPS];
+    int count;
+} Script;
+
+static bool ParseScript(const char* text, Script* script) {
+    script->count = 0;
+    const char* p = text;
+    while (*p) {
+        if (script->count >= MAX_SCRIPT_STEPS) return false;
+        unsigned char keys = 0;
+        while (*p && *p != ',' && (*p < '0' || *p > '9')) {
+            switch (*p) {
+                case 'W': case 'w': keys |= PONG_KEY_W; break;
+                case 'S': case 's': keys |= PONG_KEY_S; break;
+                case 'U': case 'u': keys |= PONG_KEY_UP; break;
+                case 'D': case 'd': keys |= PONG_KEY_DOWN; break;
+                case 'N': case 'n': break;
+                default: return false;
+            }
+            p++;
+        }
+        int frames = (int)strtol(p, (char**)&p, 10);
+        if (frames <= 0) return false;
+        script->keys[script->count] = keys;
+        script->frames[script->count] = frames;
+        script->count++;
+        if (*p == ',') p++;
+    }
+    return script->count > 0;
+}
+
+static void Usage(void) {
+    fprintf(stderr, "Usage: pong_headless [--frames N] [--matches N] [--seed N] [--dt SECONDS] [--script PATTERN] [--ai-params FILE]\n");
+    fprintf(stderr, "                     [--record FILE] [--stream FILE] [--save FILE] [--resume FILE] [--analytics FILE] [--fixed] [--quiet]\n");
+    fprintf(stderr, "       pong_headless --batch N [--frames N] [--seed N] [--dt SECONDS]\n");
+    fprintf(stderr, "       pong_headless --window-stats [--frames N] [--seed N]\n");
+    fprintf(stderr, "       pong_headless --draw-stats [--frames N] [--seed N] [--ai-params FILE]\n");
+    fprintf(stderr, "       pong_headless --replay FILE\n");
+    fprintf(stderr, "       pong_headless --analytics-report FILE\n");
+    fprintf(stderr, "       pong_headless --video OUT --replay FILE [--frames N] [--size WxH] [--fps N] [--threads N]\n");
+    fprintf(stderr, "       pong_headless --netplay [--frames N] [--seed N] [--delay MS] [--jitter MS] [--loss RATE]\n");
+    fprintf(stderr, "       pong_headless --multiball N [--frames N] [--seed N]\n");
+    fprintf(stderr, "       pong_headless --pacing HZ [--frames N] [--seed N] [--dt SECONDS]\n");
+    fprintf(stderr, "       pong_headless --spectate FILE\n");
+    fprintf(stderr, "       pong_headless --overlay-thread [--frames N] [--seed N] [--latency MS] [--jitter MS]\n");
+    fprintf(stderr, "       pong_headless --input-latency [--frames N] [--seed N] [--record FILE]\n");
+    fprintf(stderr, "       pong_headless --env N [--frames N (at most %d)] [--seed N] [--workers N]\n", ENV_STEPS);
+}
+
+static int RunReplay(const char* path) {
+    ReplayResult result;
+    double start = Pong_ClockSeconds();
+    if (!Replay_Play(path, &result, NULL)) {
+        fprintf(stderr, "Could not read replay %s\n", path);
+        return 1;
+    }
+    double elapsed = Pong_ClockSeconds() - start;
+    double gameSeconds = (double)result.frames * PONG_FIXED_DT;
+
+    printf("replay %s: %llu frames (%.1f s of play) in %.3f s, %.0fx real time\n", path, result.frames,
+           gameSeconds, elapsed, elapsed > 0 ? gameSeconds / elapsed : 0.0);
+    printf("  score %d - %d, hash %016llx, %d checkpoints\n", result.score1, result.score2, result.hash, result.checkpoints);
+    if (result.divergedAtFrame) printf("  DIVERGED at checkpoint frame %llu\n", result.divergedAtFrame);
+    if (result.hasEnd) {
+        printf("  recorded: %llu frames, score %d - %d, hash %016llx\n", result.expectedFrames,
+               result.expectedScore1, result.expectedScore2, result.expectedHash);
+    } else {
+        printf("  no end record (recording was interrupted), final state not verified\n");
+    }
+    printf("  %s\n", result.ok ? "OK" : "MISMATCH");
+    return result.ok ? 0 : 1;
+}
+
+#define VIDEO_DEFAULT_SECONDS 60
+
+typedef struct {
+    PongVideo* video;
+    long long stepsPerFrame;
+    long long steps, limit;
+} VideoRun;
+
+static bool SubmitVideoFrame(void* ctx, const PongState* s) {
+    VideoRun* run = (VideoRun*)ctx;
+    run->steps++;
+    if (run->steps % run->stepsPerFrame == 0 && !PongVideo_Submit(run->video, s)) return false;
+    return run->steps < run->limit;
+}
+
+static bool HasSuffix(const char* s, const char* suffix) {
+    size_t n = strlen(s), k = strlen(suffix);
+    return n >= k && strcmp(s + n - k, suffix) == 0;
+}
+
+static int RunVideo(const char* outPath, const char* replayPath, long long frames, PongVideoConfig* cfg) {
+    ReplayHeader header;
+    if (!Replay_ReadHeader(replayPath, &header)) {
+        fprintf(stderr, "Could not read replay %s\n", replayPath);
+        return 1;
+    }
+    cfg->raw = HasSuffix(outPath, ".yuv") || HasSuffix(outPath, ".raw");
+    PongVideo* video = PongVideo_Open(outPath, cfg);
+    if (!video) {
+        fprintf(stderr, "Could not create video %s\n", outPath);
+        return 1;
+    }
+
+    // One frame every physicsHz / fps steps
+    long long limit = frames > 0 ? frames : (long long)VIDEO_DEFAULT_SECONDS * header.physicsHz;
+    VideoRun run = { video, (header.physicsHz + cfg->fps / 2) / cfg->fps, 0, limit };
+    if (run.stepsPerFrame < 1) run.stepsPerFrame = 1;
+    ReplayResult result;
+    bool read = Replay_Run(replayPath, &result, NULL, SubmitVideoFrame, &run);
+    PongVideoStats stats;
+    bool written = PongVideo_Close(video, &stats);
+
+    // Progress goes to stderr, stdout may be the video
+    FILE* out = strcmp(outPath, "-") == 0 ? stderr : stdout;
+    fprintf(out, "video %s: %llu frames %dx%d at %d fps (%.1f s of play, one frame every %lld steps)\n", outPath,
+            stats.frames, cfg->width + (cfg->width & 1), cfg->height + (cfg->height & 1), cfg->fps,
+            (double)result.frames / (double)header.physicsHz, run.stepsPerFrame);
+    fprintf(out, "  rendered in %.3f s: %.1f frames/s on %d threads, %.3f ms per frame per thread\n",
+            stats.seconds, stats.framesPerSecond, stats.threads, stats.renderMs);
+    fprintf(out, "  reorder buffer %d frames, at most %d waiting, %llu stalls, %.1f MB written\n",
+            stats.queueFrames, stats.maxWaiting, stats.stalls, (double)stats.bytes / (1024.0 * 1024.0));
+    if (!read || !written) {
+        fprintf(stderr, "%s\n", !read ? "Replay could not be played" : "Video write failed");
+        return 1;
+    }
+    if (!result.ok) fprintf(out, "  replay DIVERGED at checkpoint frame %llu\n", result.divergedAtFrame);
+    return result.ok ? 0 : 1;
+}
+
+static int RunWindowStats(long long frames, unsigned long long seed) {
+    Win32_SetBackend(WinBackend_Recording());
+    WinRecord_Reset();
+
+    float windowX = MONITOR_W/2.0f - INITIAL_WIDTH/2.0f;
+    float windowY = MONITOR_H/2.0f - INITIAL_HEIGHT/2.0f;
+    PongState game;
+    Pong_Init(&game, windowX, windowY, MONITOR_W, MONITOR_H, seed);
+
+    WinHandle overlays[PONG_OVERLAY_COUNT];
+    overlays[PONG_OVERLAY_PADDLE1] = Win32_CreateWindow(0, 0, PADDLE_WIDTH, PADDLE_HEIGHT, NULL);
+    overlays[PONG_OVERLAY_PADDLE2] = Win32_CreateWindow(0, 0, PADDLE_WIDTH, PADDLE_HEIGHT, NULL);
+    overlays[PONG_OVERLAY_BALL] = Win32_CreateWindow(0, 0, BALL_SIZE, BALL_SIZE, NULL);
+    Win32_MakeRound(overlays[PONG_OVERLAY_BALL], BALL_SIZE, BALL_SIZE);
+
+    int stepsPerFrame = PONG_PHYSICS_HZ / RENDER_HZ;
+    for (long long f = 0; f < frames; f++) {
+        PROFILE_BEGIN(PROF_FRAME);
+        unsigned int frameEvents = 0;
+        for (int i = 0; i < stepsPerFrame; i++) {
+            PongInput input = { Pong_AutoPlayerKeys(&game), game.windowPos.x, game.windowPos.y };
+            Pong_Step(&game, &input, PONG_FIXED_DT);
+            frameEvents |= game.events;
+        }
+        if (frameEvents & PONG_EVENT_EXPAND_START) {
+            for (int i = 0; i < PONG_OVERLAY_COUNT; i++) {
+                Win32_SetVisibleMode(overlays[i], true);
+                Win32_SetTopMost(overlays[i], true);
+            }
+        }
+
+        PROFILE_BEGIN(PROF_WINDOWS);
+        PongWinRect rects[PONG_OVERLAY_COUNT];
+        Pong_GetOverlayRects(&game, rects);
+        Win32_BeginWindowMoves(PONG_OVERLAY_COUNT);
+        for (int i = 0; i < PONG_OVERLAY_COUNT; i++) {
+            Win32_SetWindowPos(overlays[i], rects[i].x, rects[i].y, rects[i].width, rects[i].height);
+        }
+        Win32_EndWindowMoves();
+        Win32_ProcessMessages();
+        PROFILE_END(PROF_WINDOWS);
+        PROFILE_END(PROF_FRAME);
+    }
+
+    WinSyncStats stats;
+    WinRecordCounts counts;
+    Win32_GetSyncStats(&stats);
+    WinRecord_GetCounts(&counts);
+
+    printf("window sync over %lld frames (%s backend)\n", frames, Win32_GetBackend()->name);
+    printf("  move requests:      %ld\n", stats.moveRequests);
+    printf("  skipped (unchanged): %ld (%.1f%%)\n", stats.movesSkipped,
+           stats.moveRequests ? 100.0 * (double)stats.movesSkipped / (double)stats.moveRequests : 0.0);
+    printf("  backend moves:      %ld\n", counts.setWindowPos);
+    printf("  deferred batches:   %ld\n", counts.endMoves);
+    printf("  round trips/frame:  %.2f -> %.2f\n", (double)stats.moveRequests / (double)frames,
+           (double)counts.endMoves / (double)frames);
+
+    for (int i = 0; i < PONG_OVERLAY_COUNT; i++) Win32_DestroyWindow(overlays[i]);
+    PROFILE_DUMP("headless_profile.json", "headless_profile.csv");
+    return 0;
+}
+
+static bool ScorePopping(const PongState* s) {
+    return PongTween_GroupActive(&s->tweens, PONG_TWEEN_GROUP_POP1) || PongTween_GroupActive(&s->tweens, PONG_TWEEN_GROUP_POP2);
+}
+
+static int RunDrawStats(long long frames, unsigned long long seed, const PongAIParams* aiParams) {
+    DrawRecord_Reset();
+    PongRenderer renderer;
+    PongRenderer_Init(&renderer, DrawBackend_Recording());
+
+    float windowX = MONITOR_W/2.0f - INITIAL_WIDTH/2.0f;
+    float windowY = MONITOR_H/2.0f - INITIAL_HEIGHT/2.0f;
+    PongState game;
+    Pong_Init(&game, windowX, windowY, MONITOR_W, MONITOR_H, seed);
+    game.ai = *aiParams;
+
+    int stepsPerFrame = PONG_PHYSICS_HZ / RENDER_HZ;
+    long scoreChanges = 0, popFrames = 0, overBudget = 0, popOverBudget = 0, badRebuilds = 0, missedRebuilds = 0;
+    long histogram[IMMEDIATE_DRAW_CALLS + 1] = { 0 };
+    for (long long f = 0; f < frames; f++) {
+        int score1 = game.score1, score2 = game.score2;
+        bool popping = ScorePopping(&game);
+        // Player 1 plays for DRAW_STATS_PLAY_FRAMES, then parks at the top
+        // for as long, so the AI scores and the score layer has to change
+        bool parked = (f / DRAW_STATS_PLAY_FRAMES) % 2 == 1 && game.gameStarted;
+        for (int i = 0; i < stepsPerFrame; i++) {
+            PongInput input = { parked ? PONG_KEY_W : Pong_AutoPlayerKeys(&game), game.windowPos.x, game.windowPos.y };
+            Pong_Step(&game, &input, PONG_FIXED_DT);
+        }
+        bool scored = (game.score1 != score1 || game.score2 != score2);
+        if (scored) scoreChanges++;
+        // Includes the frame a pop settles back to the rest size
+        popping = popping || ScorePopping(&game);
+        if (popping) popFrames++;
+
+        long rebuilds = renderer.stats.staticRebuilds;
+        PongRenderer_Frame(&renderer, &game);
+        long rebuilt = renderer.stats.staticRebuilds - rebuilds;
+        if (rebuilt && !scored && !popping && f > 0) badRebuilds++;
+        if (scored && rebuilt != 1) missedRebuilds++;
+
+        PongDrawRecordCounts counts;
+        DrawRecord_GetCounts(&counts);
+        // Rebuild frames also re-rasterise the scores, like every immediate frame did
+        long budget = IMMEDIATE_DRAW_CALLS + (rebuilt ? 2 : 0);
+        if (counts.lastFrameCommands > budget) {
+            overBudget++;
+            if (popping) popOverBudget++;
+        }
+        histogram[counts.lastFrameCommands < IMMEDIATE_DRAW_CALLS ? counts.lastFrameCommands : IMMEDIATE_DRAW_CALLS]++;
+    }
+
+    PongDrawRecordCounts counts;
+    DrawRecord_GetCounts(&counts);
+    printf("draw stats over %lld frames (%s backend), %ld score changes, %ld frames of score pops\n", frames,
+           DrawBackend_Recording()->name, scoreChanges, popFrames);
+    printf("  draw calls/frame:   %.2f (max %ld), immediate mode: %d\n",
+           (double)counts.commands / (double)frames, counts.maxFrameCommands, IMMEDIATE_DRAW_CALLS);
+    printf("  text rasterised:    %ld, immediate mode: %lld\n", counts.ops[PONG_DRAW_TEXT], 2 * frames);
+    printf("  clears:             %ld, immediate mode: %lld\n", counts.ops[PONG_DRAW_CLEAR], frames);
+    printf("  static rebuilds:    %ld, full redraws: %ld, dirty rects: %ld\n",
+           renderer.stats.staticRebuilds, renderer.stats.fullRedraws, renderer.stats.dirtyRects);
+    printf("  frames by calls:   ");
+    for (int i = 0; i <= IMMEDIATE_DRAW_CALLS; i++) printf(" %d%s:%ld", i, i == IMMEDIATE_DRAW_CALLS ? "+" : "", histogram[i]);
+    printf("\n");
+
+    PongRenderer_Shutdown(&renderer);
+    bool ok = (badRebuilds == 0 && missedRebuilds == 0 && overBudget == 0 && scoreChanges > 0 && popFrames > 0);
+    if (badRebuilds) printf("  FAIL: static layer rebuilt on %ld frames without a score change or pop\n", badRebuilds);
+    if (missedRebuilds) printf("  FAIL: %ld score changes without exactly one static rebuild\n", missedRebuilds);
+    if (overBudget) printf("  FAIL: %ld frames over the draw-call budget (%ld of them during score pops)\n", overBudget, popOverBudget);
+    if (scoreChanges == 0 || popFrames == 0) printf("  FAIL: no score changes or pops to check, run more --frames\n");
+    return ok ? 0 : 1;
+}
+
+// Right-paddle counterpart of Pong_AutoPlayerKeys for versus matches
+static unsigned char AutoPlayer2Keys(const PongState* s) {
+    if (!s->gameStarted) return PONG_KEY_S;
+    float centerP2 = s->p2.y + PADDLE_HEIGHT / 2.0f;
+    float ballCenter = s->ballPos.y + BALL_RADIUS;
+    if (ballCenter < centerP2 - 10.0f) return PONG_KEY_W;
+    if (ballCenter > centerP2 + 10.0f) return PONG_KEY_S;
+    return 0;
+}
+
+static int CompareU64(const void* a, const void* b) {
+    unsigned long long x = *(const unsigned long long*)a, y = *(const unsigned long long*)b;
+    return (x > y) - (x < y);
+}
+
+typedef struct {
+    NetUdp udp;
+    NetShim shim;
+    NetSession session;
+    unsigned char* played;      // Local keys of every step, for the offline check
+} NetPeer;
+
+static bool OpenPeer(NetPeer* p, float delayMs, float jitterMs, float loss, unsigned long long seed) {
+    if (!NetUdp_Open(&p->udp, 0)) return false;
+    NetShim_Init(&p->shim, NetUdp_Transport(&p->udp), delayMs, jitterMs, loss, seed);
+    return true;
+}
+
+static void PrintNetStats(const char* label, const NetPeer* p) {
+    const NetStats* st = &p->session.stats;
+    printf("  %s: %lld steps, %lld rollbacks (avg depth %.1f, max %d), %lld re-simulated steps, %lld stalls\n",
+           label, st->steps, st->rollbacks, st->rollbacks ? (double)st->resimSteps / (double)st->rollbacks : 0.0,
+           st->maxRollback, st->resimSteps, st->stalls);
+    printf("  %*s  packets %lld sent (%lld dropped by the shim), %lld received, checkpoints %lld matched, %lld desynced\n",
+           (int)strlen(label), "", st->packetsSent, p->shim.dropped, st->packetsReceived, st->checksMatched, st->desyncs);
+}
+
+static int RunNetplay(long long frames, unsigned long long seed, float delayMs, float jitterMs, float loss) {
+    const unsigned long long frameNs = 1000000000ULL / RENDER_HZ;
+    const int stepsPerFrame = PONG_PHYSICS_HZ / RENDER_HZ;
+    long long maxSteps = frames * stepsPerFrame;
+
+    NetPeer peers[2];
+    memset(peers, 0, sizeof(peers));
+    if (!OpenPeer(&peers[0], delayMs, jitterMs, loss, seed * 2 + 1) ||
+        !OpenPeer(&peers[1], delayMs, jitterMs, loss, seed * 2 + 2)) {
+        fprintf(stderr, "Could not open UDP sockets\n");
+        return 1;
+    }
+    NetUdp_SetPeer(&peers[0].udp, "127.0.0.1", NetUdp_LocalPort(&peers[1].udp));
+    NetUdp_SetPeer(&peers[1].udp, "127.0.0.1", NetUdp_LocalPort(&peers[0].udp));
+    NetTransport links[2] = { NetShim_Transport(&peers[0].shim), NetShim_Transport(&peers[1].shim) };
+
+    // Lobby: the guest asks to join until the host's start packet gets through
+    NetStart start = { seed, MONITOR_W/2.0f - INITIAL_WIDTH/2.0f, MONITOR_H/2.0f - INITIAL_HEIGHT/2.0f, MONITOR_W, MONITOR_H };
+    NetStart joined;
+    bool hosted = false, guestReady = false;
+    unsigned long long now = 0;
+    for (int tries = 0; tries < 10 * RENDER_HZ && !guestReady; tries++, now += frameNs) {
+        for (int i = 0; i < 2; i++) NetShim_Pump(&peers[i].shim, now);
+        if (!hosted) hosted = NetPlay_HostPoll(&links[0], &start);
+        guestReady = NetPlay_JoinPoll(&links[1], &joined);
+    }
+    if (!guestReady) {
+        fprintf(stderr, "Lobby timed out\n");
+        return 1;
+    }
+    NetSession_Init(&peers[0].session, links[0], 0, &start);
+    NetSession_Init(&peers[1].session, links[1], 1, &joined);
+
+    unsigned long long* resimPerFrame = (unsigned long long*)calloc((size_t)frames, sizeof(unsigned long long));
+    peers[0].played = (unsigned char*)calloc((size_t)maxSteps, 1);
+    peers[1].played = (unsigned char*)calloc((size_t)maxSteps, 1);
+    if (!resimPerFrame || !peers[0].played || !peers[1].played) {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
+
+    printf("netplay over UDP loopback: %lld frames, delay %.0f ms, jitter %.0f ms, loss %.1f%%\n",
+           frames, delayMs, jitterMs, loss * 100.0f);
+
+    double wallStart = Pong_ClockSeconds();
+    for (long long f = 0; f < frames; f++, now += frameNs) {
+        for (int i = 0; i < 2; i++) {
+            NetSession* n = &peers[i].session;
+            unsigned long long resimBefore = n->stats.resimNs;
+            NetShim_Pump(&peers[i].shim, now);
+            NetSession_Poll(n);
+            resimPerFrame[f] += n->stats.resimNs - resimBefore;
+
+            for (int s = 0; s < stepsPerFrame; s++) {
+                unsigned char keys = (i == 0) ? Pong_AutoPlayerKeys(&n->game) : AutoPlayer2Keys(&n->game);
+                unsigned long long step = n->frame;
+                if (!NetSession_Step(n, keys)) break;
+                peers[i].played[step] = keys;
+            }
+            NetSession_Send(n);
+        }
+    }
+    double wall = Pong_ClockSeconds() - wallStart;
+
+    // Let the last inputs arrive (resent every frame, so loss only delays it)
+    for (int f = 0; f < 10 * RENDER_HZ; f++, now += frameNs) {
+        for (int i = 0; i < 2; i++) {
+            NetShim_Pump(&peers[i].shim, now);
+            NetSession_Poll(&peers[i].session);
+            NetSession_Send(&peers[i].session);
+        }
+    }
+
+    // Re-simulate offline with the inputs both sides actually played
+    NetSession* host = &peers[0].session;
+    NetSession* guest = &peers[1].session;
+    unsigned long long common = host->frame < guest->frame ? host->frame : guest->frame;
+    bool confirmed = host->remoteKnownUpTo >= common && guest->remoteKnownUpTo >= common;
+
+    PongState reference;
+    Pong_Init(&reference, start.windowX, start.windowY, start.monitorW, start.monitorH, start.seed);
+    reference.versus = true;
+    for (unsigned long long f = 0; f < common; f++) {
+        PongInput input = { peers[0].played[f], start.windowX, start.windowY, peers[1].played[f] };
+        Pong_Step(&reference, &input, PONG_FIXED_DT);
+    }
+    unsigned long long refHash = Pong_HashState(&reference);
+    const PongState* hostState = NetSession_StateAt(host, common);
+    const PongState* guestState = NetSession_StateAt(guest, common);
+    unsigned long long hostHash = hostState ? Pong_HashState(hostState) : 0;
+    unsigned long long guestHash = guestState ? Pong_HashState(guestState) : 0;
+
+    qsort(resimPerFrame, (size_t)frames, sizeof(resimPerFrame[0]), CompareU64);
+    unsigned long long totalResim = 0;
+    long long framesWithResim = 0;
+    for (long long f = 0; f < frames; f++) {
+        totalResim += resimPerFrame[f];
+        if (resimPerFrame[f]) framesWithResim++;
+    }
+
+    PrintNetStats("host ", &peers[0]);
+    PrintNetStats("guest", &peers[1]);
+    printf("  local input latency: 0 steps (predicted remote input, rollback on mismatch)\n");
+    printf("  rollback depth (steps):");
+    for (int i = 0; i < 2; i++) {
+        const NetStats* st = &peers[i].session.stats;
+        printf("%s", i ? " | guest" : " host");
+        for (int d = 1; d <= NET_MAX_PREDICTION; d++) {
+            if (st->depthHistogram[d]) printf(" %d%s:%lld", d, d == NET_MAX_PREDICTION ? "+" : "", st->depthHistogram[d]);
+        }
+    }
+    printf("\n");
+    printf("  re-simulation per frame: avg %.2f us, p99 %.2f us, max %.2f us (%lld of %lld frames rolled back)\n",
+           (double)totalResim / (double)frames / 1000.0,
+           (double)resimPerFrame[(frames - 1) * 99 / 100] / 1000.0,
+           (double)resimPerFrame[frames - 1] / 1000.0, framesWithResim, frames);
+    printf("  %lld frames in %.3f s wall time, score %d - %d\n", frames, wall, reference.score1, reference.score2);
+    printf("  step %llu: reference %016llx, host %016llx, guest %016llx%s\n", common, refHash, hostHash, guestHash,
+           confirmed ? "" : " (inputs not fully confirmed)");
+
+    bool ok = confirmed && hostHash == refHash && guestHash == refHash &&
+              host->stats.desyncs == 0 && guest->stats.desyncs == 0;
+    printf("  %s\n", ok ? "OK" : "DESYNC");
+
+    for (int i = 0; i < 2; i++) {
+        NetUdp_Close(&peers[i].udp);
+        free(peers[i].played);
+    }
+    free(resimPerFrame);
+    return ok ? 0 : 1;
+}
+
+static int RunMultiBall(int maxBalls, long long frames, unsigned long long seed) {
+    if (frames > MULTIBALL_FRAMES) frames = MULTIBALL_FRAMES;
+    unsigned long long* frameNs = malloc((size_t)frames * sizeof(*frameNs));
+    if (!frameNs) return 1;
+
+    PongRenderer renderer;
+    PongRenderer_Init(&renderer, DrawBackend_Recording());
+    int stepsPerFrame = PONG_PHYSICS_HZ / RENDER_HZ;
+    double budgetMs = 1000.0 / RENDER_HZ;
+    bool ok = true;
+
+    printf("multi-ball stress, %dx%d arena, %lld frames per count, %d steps per frame\n",
+           MONITOR_W, MONITOR_H, frames, stepsPerFrame);
+    printf("  %6s %9s %9s %9s %12s %10s %s\n", "balls", "mean ms", "p99 ms", "max ms", "pairs/step", "hits/step", "60 fps");
+    for (int count = 64; ; count *= 2) {
+        if (count > maxBalls) count = maxBalls;
+        PongMultiBall m;
+        if (!PongMultiBall_Init(&m, count, MONITOR_W, MONITOR_H, seed)) {
+            fprintf(stderr, "Could not allocate %d balls\n", count);
+            free(frameNs);
+            return 1;
+        }
+
+        DrawRecord_Reset();
+        double totalNs = 0.0;
+        for (long long f = 0; f < frames; f++) {
+            unsigned long long start = Pong_ClockNs();
+            for (int i = 0; i < stepsPerFrame; i++) PongMultiBall_Step(&m, PONG_FIXED_DT);
+            PongRenderer_MultiBallFrame(&renderer, &m);
+            frameNs[f] = Pong_ClockNs() - start;
+            totalNs += (double)frameNs[f];
+        }
+        qsort(frameNs, (size_t)frames, sizeof(*frameNs), CompareU64);
+        double p99 = frameNs[(frames * 99) / 100] / 1e6;
+        bool fits = p99 < budgetMs;
+        double steps = (double)frames * stepsPerFrame;
+        printf("  %6d %9.3f %9.3f %9.3f %12.0f %10.1f %s\n", count, totalNs / frames / 1e6, p99,
+               frameNs[frames - 1] / 1e6, m.pairTests / steps, (m.ballHits + m.paddleHits) / steps, fits ? "yes" : "no");
+
+        PongDrawRecordCounts counts;
+        DrawRecord_GetCounts(&counts);
+        if (counts.sprites != (long)count * frames) {
+            printf("  FAIL: %ld sprites drawn, expected %lld\n", counts.sprites, (long long)count * frames);
+            ok = false;
+        }
+        if (count == maxBalls && !fits) {
+            printf("  FAIL: p99 frame %.3f ms at %d balls, budget %.3f ms\n", p99, count, budgetMs);
+            ok = false;
+        }
+        PongMultiBall_Free(&m);
+        if (count == maxBalls) break;
+    }
+
+    PongRenderer_Shutdown(&renderer);
+    free(frameNs);
+    return ok ? 0 : 1;
+}
+
+static void PrintPaceStats(const char* label, const PongPacer* p, long long steps, double elapsed) {
+    const PongPaceStats* st = &p->stats;
+    double frames = st->frames > 0 ? (double)st->frames : 1.0;
+    printf("  %s: %.1f frames/s, %.2f sim steps/frame, sleeping %.1f%%, spinning %.1f%%\n", label,
+           st->frames / elapsed, steps / frames, 100.0 * st->sleepNs / (elapsed * 1e9), 100.0 * st->spinNs / (elapsed * 1e9));
+    if (p->periodNs == 0) return;
+    printf("    interval error: mean %.1f us, max %.1f us, missed %lld, resyncs %lld\n",
+           st->errorNs / frames / 1e3, st->maxErrorNs / 1e3, st->missed, st->resyncs);
+    printf("    histogram:");
+    for (int i = 0; i < PONG_PACE_BUCKETS; i++) {
+        if (i < PONG_PACE_BUCKETS - 1) printf(" <%dus:%lld", PONG_PACE_BUCKET_US[i], st->histogram[i]);
+        else printf(" more:%lld", st->histogram[i]);
+    }
+    printf("\n");
+}
+
+static int RunPacing(double hz, long long frames, unsigned long long seed, float dt) {
+    if (frames > PACING_FRAMES) frames = PACING_FRAMES;
+    PongRenderer renderer;
+    PongRenderer_Init(&renderer, DrawBackend_Recording());
+    float windowX = MONITOR_W/2.0f - INITIAL_WIDTH/2.0f;
+    float windowY = MONITOR_H/2.0f - INITIAL_HEIGHT/2.0f;
+
+    if (hz > 0.0) printf("frame pacing at %.0f Hz, simulation at %.0f Hz, %lld frames\n", hz, 1.0 / dt, frames);
+    else printf("frame pacing uncapped, simulation at %.0f Hz, %lld frames\n", 1.0 / dt, frames);
+    for (int spin = 0; spin <= 1; spin++) {
+        PongState game;
+        Pong_Init(&game, windowX, windowY, MONITOR_W, MONITOR_H, seed);
+        PongPacer pacer;
+        PongPacer_Init(&pacer, hz);
+        pacer.spin = spin;
+
+        PongPacer_Wait(&pacer);
+        double start = Pong_ClockSeconds(), accumulator = 0.0;
+        long long steps = 0;
+        for (long long f = 0; f < frames; f++) {
+            accumulator += PongPacer_Wait(&pacer);
+            if (accumulator > 0.25) accumulator = 0.25;
+            while (accumulator >= dt) {
+                PongInput input = { Pong_AutoPlayerKeys(&game), game.windowPos.x, game.windowPos.y };
+                Pong_Step(&game, &input, dt);
+                accumulator -= dt;
+                steps++;
+            }
+            PongRenderer_Frame(&renderer, &game);
+        }
+        PrintPaceStats(hz <= 0.0 ? "uncapped" : spin ? "sleep+spin" : "sleep only", &pacer, steps, Pong_ClockSeconds() - start);
+        if (hz <= 0.0) break;   // Nothing to wait for: one run is enough
+    }
+
+    PongRenderer_Shutdown(&renderer);
+    return 0;
+}
+
+static int RunSpectate(const char* path) {
+    SnapshotReader reader;
+    if (!SnapshotReader_Open(&reader, path)) {
+        fprintf(stderr, "Could not open stream %s\n", path);
+        return 1;
+    }
+    double lastData = Pong_ClockSeconds(), start = lastData;
+    int lastScore1 = -1, lastScore2 = -1;
+    while (!reader.ended && Pong_ClockSeconds() - lastData < SPECTATE_IDLE_MS / 1000.0) {
+        int decoded = SnapshotReader_Poll(&reader);
+        if (decoded < 0) {
+            printf("FAIL: corrupt stream at byte %zu\n", reader.offset);
+            SnapshotReader_Close(&reader);
+            return 1;
+        }
+        if (decoded > 0) lastData = Pong_ClockSeconds();
+        if (reader.synced && (reader.state.score1 != lastScore1 || reader.state.score2 != lastScore2)) {
+            lastScore1 = reader.state.score1;
+            lastScore2 = reader.state.score2;
+            printf("frame %llu: score %d - %d\n", reader.state.frame, lastScore1, lastScore2);
+        }
+        if (decoded == 0) Pong_SleepNs(1000000000ULL / RENDER_HZ);
+    }
+
+    printf("spectated %lld states (%lld keyframes) in %.2f s, %zu bytes, %s\n", reader.states, reader.keyframes,
+           Pong_ClockSeconds() - start, reader.offset, reader.ended ? "stream ended" : "stream went idle");
+    printf("final state hash %016llx, keyframe hash mismatches: %lld\n", Pong_HashState(&reader.state), reader.hashMismatches);
+    bool ok = reader.synced && reader.hashMismatches == 0;
+    SnapshotReader_Close(&reader);
+    return ok ? 0 : 1;
+}
+
+// Prints the game thread's work per frame and returns its p99 in ms
+static double PrintFrameTimes(const char* label, unsigned long long* ns, long long frames, const PongPacer* pacer) {
+    double total = 0.0;
+    for (long long i = 0; i < frames; i++) total += (double)ns[i];
+    qsort(ns, (size_t)frames, sizeof(*ns), CompareU64);
+    double p99 = ns[(frames * 99) / 100] / 1e6;
+    printf("  %-20s %7.3f ms/frame on the game thread (p99 %.3f, max %.3f), late frames %lld\n", label,
+           total / frames / 1e6, p99, ns[frames - 1] / 1e6, pacer->stats.missed);
+    return p99;
+}
+
+static int RunOverlayThread(long long frames, unsigned long long seed, float latencyMs, float jitterMs) {
+    if (frames > OVERLAY_FRAMES) frames = OVERLAY_FRAMES;
+    unsigned long long* frameNs = malloc((size_t)frames * sizeof(*frameNs));
+    if (!frameNs) return 1;
+    Win32_SetBackend(WinBackend_Latency(WinBackend_Recording(), (unsigned long long)(latencyMs * 1e6f),
+                                        (unsigned long long)(jitterMs * 1e6f)));
+    float windowX = MONITOR_W/2.0f - INITIAL_WIDTH/2.0f;
+    float windowY = MONITOR_H/2.0f - INITIAL_HEIGHT/2.0f;
+    int stepsPerFrame = PONG_PHYSICS_HZ / RENDER_HZ;
+    printf("overlay sync over %lld frames at %d Hz, window round trips %.1f ms + up to %.1f ms\n",
+           frames, RENDER_HZ, latencyMs, jitterMs);
+
+    OverlayPresenterStats stats = { 0 };
+    double p99Threaded = 0.0;
+    for (int threaded = 0; threaded <= 1; threaded++) {
+        PongState game;
+        Pong_Init(&game, windowX, windowY, MONITOR_W, MONITOR_H, seed);
+        WinHandle overlays[PONG_OVERLAY_COUNT] = { 0 };
+        OverlayPresenter* presenter = NULL;
+        if (threaded) {
+            presenter = OverlayPresenter_Create(NULL);
+            if (!presenter) {
+                fprintf(stderr, "Could not start the overlay presenter\n");
+                free(frameNs);
+                return 1;
+            }
+        } else {
+            overlays[PONG_OVERLAY_PADDLE1] = Win32_CreateWindow(0, 0, PADDLE_WIDTH, PADDLE_HEIGHT, NULL);
+            overlays[PONG_OVERLAY_PADDLE2] = Win32_CreateWindow(0, 0, PADDLE_WIDTH, PADDLE_HEIGHT, NULL);
+            overlays[PONG_OVERLAY_BALL] = Win32_CreateWindow(0, 0, BALL_SIZE, BALL_SIZE, NULL);
+        }
+
+        PongPacer pacer;
+        PongPacer_Init(&pacer, RENDER_HZ);
+        PongPacer_Wait(&pacer);
+        for (long long f = 0; f < frames; f++) {
+            PongPacer_Wait(&pacer);
+            unsigned long long start = Pong_ClockNs();
+            for (int i = 0; i < stepsPerFrame; i++) {
+                PongInput input = { Pong_AutoPlayerKeys(&game), game.windowPos.x, game.windowPos.y };
+                Pong_Step(&game, &input, PONG_FIXED_DT);
+            }
+            OverlayFrame frame;
+            Pong_GetOverlayRects(&game, frame.rects);
+            frame.visible = game.isExpanded || game.isAnimating;
+            if (threaded) {
+                OverlayPresenter_Publish(presenter, &frame);
+            } else {
+                Win32_BeginWindowMoves(PONG_OVERLAY_COUNT);
+                for (int i = 0; i < PONG_OVERLAY_COUNT; i++) {
+                    Win32_SetWindowPos(overlays[i], frame.rects[i].x, frame.rects[i].y, frame.rects[i].width, frame.rects[i].height);
+                }
+                Win32_EndWindowMoves();
+                Win32_ProcessMessages();
+            }
+            frameNs[f] = Pong_ClockNs() - start;
+        }
+
+        double p99 = PrintFrameTimes(threaded ? "presenter thread:" : "synced in the loop:", frameNs, frames, &pacer);
+        if (threaded) {
+            OverlayPresenter_Destroy(presenter, &stats);
+            p99Threaded = p99;
+        } else {
+            for (int i = 0; i < PONG_OVERLAY_COUNT; i++) Win32_DestroyWindow(overlays[i]);
+        }
+    }
+
+    printf("  presenter: %lld published, %lld presented, %lld dropped as stale, latency %.2f ms (max %.2f), %s\n",
+           stats.published, stats.presented, stats.dropped,
+           stats.presented ? stats.latencyNs / (double)stats.presented / 1e6 : 0.0, stats.maxLatencyNs / 1e6,
+           stats.presentedNewest ? "ended on the newest frame" : "did NOT end on the newest frame");
+    free(frameNs);
+    double budgetMs = 1000.0 / RENDER_HZ;
+    bool ok = stats.presentedNewest && p99Threaded < budgetMs;
+    if (p99Threaded >= budgetMs) printf("  FAIL: p99 game thread frame %.3f ms with the presenter, budget %.3f ms\n", p99Threaded, budgetMs);
+    return ok ? 0 : 1;
+}
+
+// Synthetic key holds for --input-latency: one key at a time, at least 50 ms
+// apart (more than two frames), so every hold is a separate movement of the
+// paddle with a still frame between
+typedef struct {
+    unsigned long long pressNs, releaseNs;
+    unsigned char key;
+} SyntheticHold;
+
+static unsigned long long SyntheticRandom(unsigned long long* state) {
+    unsigned long long x = *state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    *state = x;
+    return x * 2685821657736338717ULL;
+}
+
+static int MakeSyntheticHolds(unsigned long long endNs, unsigned long long seed, SyntheticHold* holds, int capacity) {
+    static const unsigned char keys[4] = { PONG_KEY_W, PONG_KEY_S, PONG_KEY_UP, PONG_KEY_DOWN };
+    unsigned long long rng = seed ? seed * 0x9E3779B97F4A7C15ULL : 1;
+    unsigned long long t = 100000000ULL;
+    int count = 0;
+    while (count < capacity) {
+        unsigned long long hold = 20000000ULL + SyntheticRandom(&rng) % 180000000ULL;
+        if (t + hold >= endNs) break;
+        // Alternate directions so the paddle stays near where it started
+        int key = (count & 1) + 2 * (int)(SyntheticRandom(&rng) >> 63);
+        holds[count++] = (SyntheticHold){ t, t + hold, keys[key] };
+        t += hold + 50000000ULL + SyntheticRandom(&rng) % 200000000ULL;
+    }
+    return count;
+}
+
+// When the sampler thread sees a transition at t: the next 1 kHz sample
+static unsigned long long SampledAt(unsigned long long t) {
+    unsigned long long period = 1000000000ULL / INPUT_SAMPLER_HZ;
+    return (t / period + 1) * period;
+}
+
+static void PrintInputLatency(const char* label, const InputLatencyStats* st, double holdErrorPx, double maxHoldErrorPx) {
+    printf("  %-18s latency mean %6.2f ms, max %6.2f ms; hold length error mean %.2f px, max %.2f px\n", label,
+           st->presses ? st->latencyNs / (double)st->presses / 1e6 : 0.0, st->maxLatencyNs / 1e6, holdErrorPx, maxHoldErrorPx);
+    printf("    histogram:");
+    for (int i = 0; i < INPUT_LATENCY_BUCKETS; i++) {
+        if (i < INPUT_LATENCY_BUCKETS - 1) printf(" <%dms:%lld", INPUT_LATENCY_BUCKET_US[i] / 1000, st->histogram[i]);
+        else printf(" more:%lld", st->histogram[i]);
+    }
+    printf("\n");
+}
+
+// Records steps with nothing pressed through the queue to path: they carry no
+// sub-step timing, so no 'T' chunk may be written
+static bool CheckIdleRecording(const char* path, long long steps, unsigned long long seed, float windowX, float windowY) {
+    InputQueue queue;
+    InputQueue_Init(&queue);
+    PongState game;
+    Pong_Init(&game, windowX, windowY, MONITOR_W, MONITOR_H, seed);
+    ReplayWriter writer;
+    ReplayHeader header = { seed, PONG_PHYSICS_HZ, MONITOR_W, MONITOR_H, windowX, windowY, game.ai };
+    if (!ReplayWriter_Open(&writer, path, &header)) {
+        fprintf(stderr, "Could not create replay %s\n", path);
+        return false;
+    }
+
+    unsigned long long stepNs = 1000000000ULL / PONG_PHYSICS_HZ;
+    for (long long i = 0; i < steps; i++) {
+        PongInput input = { 0, windowX, windowY };
+        InputQueue_StepInput(&queue, (unsigned long long)i * stepNs, (unsigned long long)(i + 1) * stepNs, &input);
+        Pong_Step(&game, &input, PONG_FIXED_DT);
+        ReplayWriter_Frame(&writer, &input, &game);
+    }
+    unsigned long long timingChunks = writer.timingChunks;
+    ReplayWriter_Close(&writer, &game);
+
+    ReplayResult result;
+    bool ok = Replay_Play(path, &result, NULL) && result.ok && timingChunks == 0;
+    printf("  idle run: %llu 'T' chunks in %lld steps, replay %s\n", timingChunks, steps, ok ? "OK" : "FAIL");
+    return ok;
+}
+
+static int RunInputLatency(long long frames, unsigned long long seed, const char* recordPath) {
+    if (frames > INPUT_LATENCY_FRAMES) frames = INPUT_LATENCY_FRAMES;
+    unsigned long long periodNs = 1000000000ULL / RENDER_HZ;
+    unsigned long long stepNs = 1000000000ULL / PONG_PHYSICS_HZ;
+    unsigned long long endNs = (unsigned long long)frames * periodNs;
+    int capacity = (int)(endNs / 50000000ULL) + 1;
+    SyntheticHold* holds = malloc((size_t)capacity * sizeof(*holds));
+    if (!holds) return 1;
+    int holdCount = MakeSyntheticHolds(endNs, seed, holds, capacity);
+
+    float windowX = MONITOR_W/2.0f - INITIAL_WIDTH/2.0f;
+    float windowY = MONITOR_H/2.0f - INITIAL_HEIGHT/2.0f;
+    printf("input latency over %lld frames at %d Hz (%.1f ms from wake-up to present), %d synthetic key holds\n",
+           frames, RENDER_HZ, INPUT_FRAME_WORK_NS / 1e6, holdCount);
+
+    double meanLatency[2] = { 0 }, meanError[2] = { 0 };
+    bool replayOk = true;
+    bool idleOk = !recordPath || CheckIdleRecording(recordPath, frames * PONG_PHYSICS_HZ / RENDER_HZ, seed, windowX, windowY);
+    for (int timed = 0; timed <= 1; timed++) {
+        InputQueue queue;
+        InputQueue_Init(&queue);
+        PongState game, shadow;
+        Pong_Init(&game, windowX, windowY, MONITOR_W, MONITOR_H, seed);
+        // Only ever moved by Pong_ApplyInput: never clamped, so its travel per
+        // hold can be compared with the hold's length
+        shadow = game;
+
+        ReplayWriter writer = { 0 };
+        if (timed && recordPath) {
+            ReplayHeader header = { seed, PONG_PHYSICS_HZ, MONITOR_W, MONITOR_H, windowX, windowY, game.ai };
+            ReplayWriter_Open(&writer, recordPath, &header);
+        }
+
+        int nextEvent = 0;      // Index into the holds' press and release events, in order
+        unsigned long long simNs = 0;
+        unsigned char polledKeys = 0;
+        float idleY = shadow.p1.y, lastY = shadow.p1.y;
+        int hold = 0;
+        double errorSum = 0.0, errorMax = 0.0;
+        for (long long f = 0; f < frames; f++) {
+            unsigned long long wakeNs = (unsigned long long)f * periodNs;
+            unsigned long long presentNs = wakeNs + INPUT_FRAME_WORK_NS;
+            // The sampler thread has queued every transition it has seen
+            while (timed && nextEvent < 2 * holdCount) {
+                const SyntheticHold* h = &holds[nextEvent / 2];
+                unsigned long long t = (nextEvent & 1) ? h->releaseNs : h->pressNs;
+                if (SampledAt(t) > wakeNs) break;
+                InputQueue_Push(&queue, h->key, !(nextEvent & 1), SampledAt(t) - 500000000ULL / INPUT_SAMPLER_HZ);
+                nextEvent++;
+            }
+
+            while (simNs + stepNs <= wakeNs) {
+                PongInput input = { 0, windowX, windowY };
+                if (timed) InputQueue_StepInput(&queue, simNs, simNs + stepNs, &input);
+                else input.keys = polledKeys;
+                Pong_Step(&game, &input, PONG_FIXED_DT);
+                Pong_ApplyInput(&shadow, &input, PONG_FIXED_DT);
+                if (writer.file) ReplayWriter_Frame(&writer, &input, &game);
+                simNs += stepNs;
+            }
+            InputQueue_FramePresented(&queue, presentNs);
+
+            // Polled input: the key state is read once per frame, after the
+            // frame is presented, and used for every step of the next one
+            if (!timed) {
+                while (nextEvent < 2 * holdCount) {
+                    const SyntheticHold* h = &holds[nextEvent / 2];
+                    unsigned long long t = (nextEvent & 1) ? h->releaseNs : h->pressNs;
+                    if (t > presentNs) break;
+                    InputQueue_Push(&queue, h->key, !(nextEvent & 1), t);
+                    nextEvent++;
+                }
+                PongInput polled;
+                InputQueue_StepInput(&queue, presentNs, presentNs, &polled);
+                polledKeys = queue.keys;
+            }
+
+            // A hold is over once the paddle stops
+            float y = shadow.p1.y;
+            if (y == lastY && y != idleY && hold < holdCount) {
+                double ideal = (holds[hold].releaseNs - holds[hold].pressNs) / 1e9 * 9.0 * PONG_REFERENCE_HZ;
+                double error = fabs(fabs((double)y - (double)idleY) - ideal);
+                errorSum += error;
+                if (error > errorMax) errorMax = error;
+                hold++;
+                idleY = y;
+            }
+            lastY = y;
+        }
+
+        InputLatencyStats stats;
+        InputQueue_GetStats(&queue, &stats);
+        meanError[timed] = hold ? errorSum / hold : 0.0;
+        meanLatency[timed] = stats.presses ? stats.latencyNs / (double)stats.presses / 1e6 : 0.0;
+        PrintInputLatency(timed ? "timestamped queue:" : "polled per frame:", &stats, meanError[timed], errorMax);
+
+        if (writer.file) {
+            ReplayWriter_Close(&writer, &game);
+            ReplayResult result;
+            replayOk = Replay_Play(recordPath, &result, NULL) && result.ok;
+            printf("  replay %s: sub-step input re-simulates %s\n", recordPath, replayOk ? "OK" : "with a MISMATCH");
+        }
+    }
+    free(holds);
+
+    bool ok = idleOk && replayOk && meanLatency[1] < meanLatency[0] && meanError[1] < meanError[0];
+    if (meanLatency[1] >= meanLatency[0]) printf("  FAIL: the queue did not lower input latency\n");
+    if (meanError[1] >= meanError[0]) printf("  FAIL: the queue did not make paddle travel match hold length better\n");
+    return ok ? 0 : 1;
+}
+
+// Trainer policy for --env: follows the ball on its way in, recenters
+// otherwise. Reads the observations where the environments wrote them.
+static void EnvPolicy(const float* obs, signed char* actions, int count) {
+    for (int i = 0; i < count; i++) {
+        const float* o = obs + (size_t)i * PONG_ENV_OBS;
+        float target = o[PONG_ENV_OBS_BALL_VX] > 0.0f ? o[PONG_ENV_OBS_BALL_Y] + BALL_RADIUS : o[PONG_ENV_OBS_ARENA_H] / 2.0f;
+        float center = o[PONG_ENV_OBS_PADDLE_Y] + PADDLE_HEIGHT / 2.0f;
+        actions[i] = center < target - 20.0f ? PONG_ENV_ACTION_DOWN
+                   : center > target + 20.0f ? PONG_ENV_ACTION_UP : PONG_ENV_ACTION_NONE;
+    }
+}
+
+typedef struct {
+    unsigned long long hash;    // Of the last observations
+    double reward;              // Summed over every step
+    long long episodes;
+} EnvTotals;
+
+static void EnvAccumulate(EnvTotals* t, const PongEnvBuffers* b, int count) {
+    for (int i = 0; i < count; i++) {
+        t->reward += b->rewards[i];
+        t->episodes += b->dones[i];
+    }
+}
+
+static void EnvFinish(EnvTotals* t, const PongEnvBuffers* b, int count) {
+    unsigned long long h = 1469598103934665603ULL;
+    const unsigned char* p = (const unsigned char*)b->obs;
+    for (size_t i = 0; i < (size_t)count * PONG_ENV_OBS * sizeof(float); i++) {
+        h ^= p[i];
+        h *= 1099511628211ULL;
+    }
+    t->hash = h;
+}
+
+static void PrintEnvRun(const char* label, double elapsed, long long envSteps, int frameSkip, double directNs, const EnvTotals* t, const EnvTotals* ref) {
+    double nsPerStep = envSteps > 0 ? elapsed * 1e9 / ((double)envSteps * frameSkip) : 0.0;
+    bool match = !ref || (t->hash == ref->hash && t->reward == ref->reward && t->episodes == ref->episodes);
+    printf("  %-14s %8.3f s  %12.0f env steps/s  %7.1f ns/physics step  %+6.1f%%  episodes %lld, reward %+.0f, obs %016llx%s\n",
+           label, elapsed, elapsed > 0 ? (double)envSteps / elapsed : 0.0, nsPerStep,
+           directNs > 0 ? (nsPerStep / directNs - 1.0) * 100.0 : 0.0, t->episodes, t->reward, t->hash, match ? "" : "  MISMATCH");
+}
+
+typedef struct {
+    pid_t* pids;    // 0 once reaped
+    int count;
+} EnvWorkers;
+
+// PongEnvAliveFn for the worker processes: none exits before Quit, so one
+// that has is dead
+static bool EnvWorkersAlive(void* ctx) {
+    EnvWorkers* w = (EnvWorkers*)ctx;
+    for (int i = 0; i < w->count; i++) {
+        if (w->pids[i] > 0 && waitpid(w->pids[i], NULL, WNOHANG) == w->pids[i]) {
+            w->pids[i] = 0;
+            return false;
+        }
+    }
+    return true;
+}
+
+static int RunEnv(int count, long long frames, unsigned int seed, int workers) {
+    long long steps = frames < ENV_STEPS ? frames : ENV_STEPS;
+    if (steps < frames) printf("env: --frames capped at %d steps\n", ENV_STEPS);
+    if (workers <= 0) workers = ThreadPool_CpuCount();
+    if (workers > count) workers = count;
+    PongEnvConfig cfg;
+    PongEnv_DefaultConfig(&cfg);
+    cfg.seed = seed;
+    cfg.maxSteps = ENV_STEPS / 4;   // Episodes end and reset during the run
+    long long envSteps = (long long)count * steps;
+    int result = 0;
+
+    printf("env: %d environments x %lld steps, frame skip %d, opponent %s, %d workers\n",
+           count, steps, cfg.frameSkip, Pong_PlayerSkill(cfg.opponent)->name, workers);
+
+    // Direct: the same matches and policy calling Pong_Step, no env API.
+    // Matches restart every maxSteps steps like the episodes do (none gets
+    // to pointsPerEpisode that fast).
+    PongState* games = (PongState*)malloc((size_t)count * sizeof(PongState));
+    PongPlayerModel* models = (PongPlayerModel*)malloc((size_t)count * sizeof(PongPlayerModel));
+    float* obs = (float*)malloc((size_t)count * PONG_ENV_OBS * sizeof(float));
+    signed char* actions = (signed char*)malloc((size_t)count);
+    if (!games || !models || !obs || !actions) {
+        fprintf(stderr, "Failed to allocate %d environments\n", count);
+        return 1;
+    }
+    float windowX = cfg.monitorW/2.0f - INITIAL_WIDTH/2.0f;
+    float windowY = cfg.monitorH/2.0f - INITIAL_HEIGHT/2.0f;
+    unsigned long long* seeds = (unsigned long long*)malloc((size_t)count * sizeof(unsigned long long));
+    if (!seeds) return 1;
+    for (int i = 0; i < count; i++) seeds[i] = cfg.seed + (unsigned long long)i;
+    double start = Pong_ClockSeconds();
+    for (long long step = 0; step < steps; step++) {
+        if (step % cfg.maxSteps == 0) {
+            for (int i = 0; i < count; i++) {
+                Pong_Init(&games[i], windowX, windowY, cfg.monitorW, cfg.monitorH, seeds[i]);
+                games[i].versus = true;
+                PlayerModel_Init(&models[i], Pong_PlayerSkill(cfg.opponent), seeds[i] * 0x9E3779B97F4A7C15ULL + 1);
+                seeds[i] = seeds[i] * 6364136223846793005ULL + 1442695040888963407ULL;
+            }
+        }
+        for (int i = 0; i < count; i++) {
+            const PongState* s = &games[i];
+            float* o = obs + (size_t)i * PONG_ENV_OBS;
+            o[PONG_ENV_OBS_BALL_Y] = s->ballPos.y;
+            o[PONG_ENV_OBS_BALL_VX] = s->ballSpeed.x;
+            o[PONG_ENV_OBS_PADDLE_Y] = s->p2.y;
+            o[PONG_ENV_OBS_ARENA_H] = s->currentArena.height;
+        }
+        EnvPolicy(obs, actions, count);
+        for (int i = 0; i < count; i++) {
+            PongInput in = { 0, windowX, windowY };
+            in.keys2 = actions[i] < 0 ? PONG_KEY_W : actions[i] > 0 ? PONG_KEY_S : 0;
+            for (int k = 0; k < cfg.frameSkip; k++) {
+                in.keys = PlayerModel_Keys(&models[i], &games[i], PONG_FIXED_DT);
+                Pong_Step(&games[i], &in, PONG_FIXED_DT);
+            }
+        }
+    }
+    double elapsed = Pong_ClockSeconds() - start;
+    double directNs = elapsed * 1e9 / ((double)envSteps * cfg.frameSkip);
+    printf("  %-14s %8.3f s  %12.0f env steps/s  %7.1f ns/physics step\n", "direct", elapsed, (double)envSteps / elapsed, directNs);
+    free(games);
+    free(models);
+    free(seeds);
+
+    // Caller-provided buffers, stepped on this thread and on a thread pool
+    EnvTotals reference = { 0 };
+    for (int threaded = 0; threaded <= 1; threaded++) {
+        PongEnvBuffers buffers = { obs, NULL, NULL, actions };
+        cfg.threads = threaded ? workers : 0;
+        PongEnv* env = PongEnv_Create(count, &cfg, &buffers);
+        if (!env) {
+            fprintf(stderr, "Failed to create %d environments\n", count);
+            return 1;
+        }
+        buffers = PongEnv_Buffers(env);
+        EnvTotals totals = { 0 };
+        start = Pong_ClockSeconds();
+        for (long long step = 0; step < steps; step++) {
+            EnvPolicy(buffers.obs, buffers.actions, count);
+            PongEnv_Step(env);
+            EnvAccumulate(&totals, &buffers, count);
+        }
+        elapsed = Pong_ClockSeconds() - start;
+        EnvFinish(&totals, &buffers, count);
+        if (!threaded) reference = totals;
+        char label[32];
+        snprintf(label, sizeof(label), threaded ? "threads %d" : "env", workers);
+        PrintEnvRun(label, elapsed, envSteps, cfg.frameSkip, directNs, &totals, threaded ? &reference : NULL);
+        if (memcmp(&totals, &reference, sizeof(totals)) != 0) result = 1;
+        PongEnv_Destroy(env);
+    }
+    free(obs);
+    free(actions);
+
+    // Worker processes over shared memory, each stepping its slice. The
+    // trainer (this process) only touches the shared buffers.
+    char name[64];
+    snprintf(name, sizeof(name), "pong_env_%d", (int)getpid());
+    PongEnvShared* shared = PongEnvShared_Create(name, count);
+    if (!shared) {
+        fprintf(stderr, "Could not create shared memory %s\n", name);
+        return 1;
+    }
+    EnvWorkers procs = { (pid_t*)calloc((size_t)workers, sizeof(pid_t)), workers };
+    bool ok = procs.pids != NULL;
+    for (int w = 0; ok && w < workers; w++) {
+        int first = (int)((long long)count * w / workers);
+        int slice = (int)((long long)count * (w + 1) / workers) - first;
+        pid_t pid = fork();
+        if (pid < 0) {
+            fprintf(stderr, "fork failed\n");
+            ok = false;
+            break;
+        }
+        if (pid == 0) {
+            // A worker that can't start exits, and the trainer's liveness
+            // check sees it instead of waiting for it forever
+            PongEnvShared* mine = PongEnvShared_Open(name);
+            if (!mine) _exit(1);
+            PongEnvBuffers buffers = PongEnvShared_Buffers(mine, first);
+            PongEnvConfig workerCfg = cfg;
+            workerCfg.threads = 0;
+            workerCfg.seed = cfg.seed + (unsigned long long)first;
+            PongEnv* env = PongEnv_Create(slice, &workerCfg, &buffers);
+            if (!env) {
+                PongEnvShared_Close(mine, false);
+                _exit(1);
+            }
+            PongEnvShared_Serve(mine, env);
+            PongEnv_Destroy(env);
+            PongEnvShared_Close(mine, false);
+            _exit(0);
+        }
+        procs.pids[w] = pid;
+    }
+    ok = ok && PongEnvShared_WaitWorkers(shared, workers, EnvWorkersAlive, &procs);
+
+    PongEnvBuffers buffers = PongEnvShared_Buffers(shared, 0);
+    EnvTotals totals = { 0 };
+    start = Pong_ClockSeconds();
+    for (long long step = 0; ok && step < steps; step++) {
+        EnvPolicy(buffers.obs, buffers.actions, count);
+        ok = PongEnvShared_Step(shared, workers, EnvWorkersAlive, &procs);
+        EnvAccumulate(&totals, &buffers, count);
+    }
+    elapsed = Pong_ClockSeconds() - start;
+    EnvFinish(&totals, &buffers, count);
+    PongEnvShared_Quit(shared);
+    if (procs.pids) {
+        for (int w = 0; w < workers; w++) {
+            if (procs.pids[w] > 0) waitpid(procs.pids[w], NULL, 0);
+        }
+    }
+    free(procs.pids);
+    PongEnvShared_Close(shared, true);
+    if (!ok) {
+        fprintf(stderr, "env worker processes failed\n");
+        return 1;
+    }
+
+    char label[32];
+    snprintf(label, sizeof(label), "processes %d", workers);
+    PrintEnvRun(label, elapsed, envSteps, cfg.frameSkip, directNs, &totals, &reference);
+    if (memcmp(&totals, &reference, sizeof(totals)) != 0) result = 1;
+    return result;
+}
+
+static int RunBatch(int count, long long frames, unsigned int seed, float dt) {
+    const PongBatchKernel kernels[] = { PONG_BATCH_SCALAR, PONG_BATCH_SSE2, PONG_BATCH_AVX2 };
+    double scalarRate = 0.0;
+    unsigned long long scalarHash = 0;
+    int result = 0;
+
+    printf("batch: %d matches x %lld frames\n", count, frames);
+    for (int k = 0; k < (int)(sizeof(kernels)/sizeof(kernels[0])); k++) {
+        PongBatchKernel kernel = kernels[k];
+        if (!PongBatch_KernelSupported(kernel)) {
+            printf("  %-12s  not supported on this CPU\n", PongBatch_KernelName(kernel));
+            continue;
+        }
+
+        PongBatch batch;
+        if (!PongBatch_Init(&batch, count, (float)MONITOR_W, (float)MONITOR_H, seed)) {
+            fprintf(stderr, "Failed to allocate batch of %d matches\n", count);
+            return 1;
+        }
+        // Spread the left paddle's skill across the batch
+        for (int i = 0; i < batch.capacity; i++) {
+            batch.difficulty1[i] = 0.4f + 0.6f * (float)(i % 64) / 63.0f;
+        }
+
+        double start = Pong_ClockSeconds();
+        for (long long f = 0; f < frames; f++) PongBatch_Step(&batch, dt, kernel);
+        double elapsed = Pong_ClockSeconds() - start;
+
+        double rate = elapsed > 0 ? (double)count * (double)frames / elapsed : 0.0;
+        unsigned long long hash = PongBatch_Hash(&batch);
+        if (kernel == PONG_BATCH_SCALAR) { scalarRate = rate; scalarHash = hash; }
+
+        bool match = (hash == scalarHash);
+        if (!match) result = 1;
+        printf("  %-12s  %8.3f s  %14.0f matches-frames/s  %5.2fx  hash %016llx%s\n",
+               PongBatch_KernelName(kernel), elapsed, rate, scalarRate > 0 ? rate / scalarRate : 0.0,
+               hash, match ? "" : "  MISMATCH");
+        PongBatch_Free(&batch);
+    }
+
+    // Fixed point, rates relative to the float scalar kernel
+    unsigned long long fixedHash = 0;
+    for (int k = 0; k < (int)(sizeof(kernels)/sizeof(kernels[0])); k++) {
+        PongBatchKernel kernel = kernels[k];
+        if (!PongBatch_KernelSupported(kernel)) continue;
+
+        PongFixedBatch batch;
+        if (!PongFixedBatch_Init(&batch, count, (float)MONITOR_W, (float)MONITOR_H, seed)) {
+            fprintf(stderr, "Failed to allocate batch of %d matches\n", count);
+            return 1;
+        }
+        for (int i = 0; i < batch.capacity; i++) {
+            batch.difficulty1[i] = PONG_FX(0.4) + PONG_FX(0.6) * (i % 64) / 63;
+        }
+
+        double start = Pong_ClockSeconds();
+        for (long long f = 0; f < frames; f++) PongFixedBatch_Step(&batch, dt, kernel);
+        double elapsed = Pong_ClockSeconds() - start;
+
+        double rate = elapsed > 0 ? (double)count * (double)frames / elapsed : 0.0;
+        unsigned long long hash = PongFixedBatch_Hash(&batch);
+        if (kernel == PONG_BATCH_SCALAR) fixedHash = hash;
+
+        bool match = (hash == fixedHash);
+        if (!match) result = 1;
+        char name[16];
+        snprintf(name, sizeof(name), "fixed %s", PongBatch_KernelName(kernel));
+        printf("  %-12s  %8.3f s  %14.0f matches-frames/s  %5.2fx  hash %016llx%s\n",
+               name, elapsed, rate, scalarRate > 0 ? rate / scalarRate : 0.0,
+               hash, match ? "" : "  MISMATCH");
+        PongFixedBatch_Free(&batch);
+    }
+    return result;
+}
+
+int main(int argc, char** argv) {
+    long long frames = 100000;
+    int matches = 1;
+    unsigned int seed = 1;
+    float dt = PONG_FIXED_DT;
+    bool quiet = false;
+    bool fixedPoint = false;
+    Script script = { 0 };
+    bool scripted = false;
+    int batchCount = 0;
+    int multiBalls = 0;
+    double pacingHz = -1.0;
+    bool windowStats = false;
+    bool drawStats = false;
+    bool netplay = false;
+    float netDelayMs = 40.0f, netJitterMs = 10.0f, netLoss = 0.02f;
+    const char* recordPath = NULL;
+    const char* replayPath = NULL;
+    const char* streamPath = NULL;
+    const char* savePath = NULL;
+    const char* resumePath = NULL;
+    const char* spectatePath = NULL;
+    bool overlayThread = false;
+    bool inputLatency = false;
+    float overlayLatencyMs = 20.0f;
+    int envCount = 0, envWorkers = 0;
+    const char* videoPath = NULL;
+    const char* analyticsPath = NULL;
+    const char* reportPath = NULL;
+    bool framesGiven = false;
+    PongVideoConfig videoCfg;
+    PongVideo_DefaultConfig(&videoCfg);
+    PongAIParams aiParams;
+    Pong_DefaultAIParams(&aiParams);
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        bool hasValue = (i + 1 < argc);
+        if (strcmp(arg, "--frames") == 0 && hasValue) { frames = atoll(argv[++i]); framesGiven = true; }
+        else if (strcmp(arg, "--matches") == 0 && hasValue) matches = atoi(argv[++i]);
+        else if (strcmp(arg, "--seed") == 0 && hasValue) seed = (unsigned int)strtoul(argv[++i], NULL, 10);
+        else if (strcmp(arg, "--dt") == 0 && hasValue) dt = (float)atof(argv[++i]);
+        else if (strcmp(arg, "--script") == 0 && hasValue) {
+            if (!ParseScript(argv[++i], &script)) {
+                fprintf(stderr, "Invalid script: %s\n", argv[i]);
+                return 1;
+            }
+            scripted = true;
+        }
+        else if (strcmp(arg, "--batch") == 0 && hasValue) batchCount = atoi(argv[++i]);
+        else if (strcmp(arg, "--window-stats") == 0) windowStats = true;
+        else if (strcmp(arg, "--draw-stats") == 0) drawStats = true;
+        else if (strcmp(arg, "--netplay") == 0) netplay = true;
+        else if (strcmp(arg, "--multiball") == 0 && hasValue) multiBalls = atoi(argv[++i]);
+        else if (strcmp(arg, "--pacing") == 0 && hasValue) pacingHz = atof(argv[++i]);
+        else if (strcmp(arg, "--delay") == 0 && hasValue) netDelayMs = (float)atof(argv[++i]);
+        else if (strcmp(arg, "--jitter") == 0 && hasValue) netJitterMs = (float)atof(argv[++i]);
+        else if (strcmp(arg, "--loss") == 0 && hasValue) netLoss = (float)atof(argv[++i]);
+        else if (strcmp(arg, "--record") == 0 && hasValue) recordPath = argv[++i];
+        else if (strcmp(arg, "--replay") == 0 && hasValue) replayPath = argv[++i];
+        else if (strcmp(arg, "--stream") == 0 && hasValue) streamPath = argv[++i];
+        else if (strcmp(arg, "--save") == 0 && hasValue) savePath = argv[++i];
+        else if (strcmp(arg, "--resume") == 0 && hasValue) resumePath = argv[++i];
+        else if (strcmp(arg, "--spectate") == 0 && hasValue) spectatePath = argv[++i];
+        else if (strcmp(arg, "--overlay-thread") == 0) overlayThread = true;
+        else if (strcmp(arg, "--input-latency") == 0) inputLatency = true;
+        else if (strcmp(arg, "--env") == 0 && hasValue) envCount = atoi(argv[++i]);
+        else if (strcmp(arg, "--workers") == 0 && hasValue) envWorkers = atoi(argv[++i]);
+        else if (strcmp(arg, "--video") == 0 && hasValue) videoPath = argv[++i];
+        else if (strcmp(arg, "--analytics") == 0 && hasValue) analyticsPath = argv[++i];
+        else if (strcmp(arg, "--analytics-report") == 0 && hasValue) reportPath = argv[++i];
+        else if (strcmp(arg, "--size") == 0 && hasValue) {
+            if (sscanf(argv[++i], "%dx%d", &videoCfg.width, &videoCfg.height) != 2) { Usage(); return 1; }
+        }
+        else if (strcmp(arg, "--fps") == 0 && hasValue) videoCfg.fps = atoi(argv[++i]);
+        else if (strcmp(arg, "--threads") == 0 && hasValue) videoCfg.threads = atoi(argv[++i]);
+        else if (strcmp(arg, "--latency") == 0 && hasValue) overlayLatencyMs = (float)atof(argv[++i]);
+        else if (strcmp(arg, "--ai-params") == 0 && hasValue) {
+            if (!Pong_LoadAIParams(argv[++i], &aiParams)) {
+                fprintf(stderr, "Could not read AI parameters %s\n", argv[i]);
+                return 1;
+            }
+        }
+        else if (strcmp(arg, "--fixed") == 0) fixedPoint = true;
+        else if (strcmp(arg, "--quiet") == 0) quiet = true;
+        else { Usage(); return 1; }
+    }
+    if (frames <= 0 || matches <= 0) { Usage(); return 1; }
+
+    if (videoPath) {
+        if (!replayPath || videoCfg.width <= 0 || videoCfg.height <= 0 || videoCfg.fps <= 0) { Usage(); return 1; }
+        return RunVideo(videoPath, replayPath, framesGiven ? frames : 0, &videoCfg);
+    }
+    if (replayPath) return RunReplay(replayPath);
+    if (reportPath) {
+        if (Analytics_Report(reportPath, stdout)) return 0;
+        fprintf(stderr, "Could not read analytics log %s\n", reportPath);
+        return 1;
+    }
+    if (spectatePath) return RunSpectate(spectatePath);
+    if (overlayThread) return RunOverlayThread(frames, seed, overlayLatencyMs, netJitterMs);
+    if (inputLatency) return RunInputLatency(frames, seed, recordPath);
+    if (envCount > 0) return RunEnv(envCount, frames, seed, envWorkers);
+    if (batchCount > 0) return RunBatch(batchCount, frames, seed, dt);
+    if (windowStats) return RunWindowStats(frames, seed);
+    if (drawStats) return RunDrawStats(frames, seed, &aiParams);
+    if (netplay) return RunNetplay(frames, seed, netDelayMs, netJitterMs, netLoss);
+    if (multiBalls > 0) return RunMultiBall(multiBalls, frames, seed);
+    if (pacingHz >= 0.0) return RunPacing(pacingHz, frames, seed, dt);
+
+    // The main window sits centered on the monitor, as it does after launch
+    float windowX = MONITOR_W/2.0f - INITIAL_WIDTH/2.0f;
+    float windowY = MONITOR_H/2.0f - INITIAL_HEIGHT/2.0f;
+
+    AnalyticsLog* analytics = NULL;
+    if (analyticsPath) {
+        analytics = Analytics_Open(analyticsPath);
+        if (!analytics || !Analytics_AttachThread(analytics)) {
+            fprintf(stderr, "Could not create analytics log %s\n", analyticsPath);
+            return 1;
+        }
+    }
+
+    long long totalScore1 = 0, totalScore2 = 0, totalAiHits = 0;
+    double start = Pong_ClockSeconds();
+
+    for (int m = 0; m < matches; m++) {
+        PongState game;
+        Pong_Init(&game, windowX, windowY, MONITOR_W, MONITOR_H, seed + (unsigned int)m);
+        game.ai = aiParams;
+        if (resumePath && !Snapshot_Load(resumePath, &game)) {
+            fprintf(stderr, "Could not read snapshot %s\n", resumePath);
+            return 1;
+        }
+        if (fixedPoint && !game.fixedPoint) Pong_UseFixedPoint(&game);
+
+        SnapshotStream stream = { 0 };
+        if (streamPath && m == 0 && !SnapshotStream_Open(&stream, streamPath)) {
+            fprintf(stderr, "Could not create stream %s\n", streamPath);
+            return 1;
+        }
+
+        ReplayWriter writer = { 0 };
+        if (recordPath && m == 0) {
+            ReplayHeader header = { seed, (int)(1.0f / dt + 0.5f), MONITOR_W, MONITOR_H, windowX, windowY, aiParams, game.fixedPoint };
+            if (!ReplayWriter_Open(&writer, recordPath, &header)) {
+                fprintf(stderr, "Could not create replay %s\n", recordPath);
+                return 1;
+            }
+        }
+
+        int scriptIndex = 0, scriptLeft = scripted ? script.frames[0] : 0;
+        for (long long f = 0; f < frames; f++) {
+            PongInput input = { 0, windowX, windowY };
+            if (scripted) {
+                input.keys = script.keys[scriptIndex];
+                if (--scriptLeft == 0) {
+                    scriptIndex = (scriptIndex + 1) % script.count;
+                    scriptLeft = script.frames[scriptIndex];
+                }
+            } else {
+                input.keys = Pong_AutoPlayerKeys(&game);
+            }
+            Pong_Step(&game, &input, dt);
+            if (writer.file) ReplayWriter_Frame(&writer, &input, &game);
+            if (stream.file) {
+                SnapshotStream_Frame(&stream, &game);
+                if (game.frame % (PONG_PHYSICS_HZ / RENDER_HZ) == 0) SnapshotStream_Flush(&stream);
+            }
+        }
+        if (writer.file) ReplayWriter_Close(&writer, &game);
+        if (stream.file) {
+            printf("stream: %llu states, %lld bytes (%.1f per state), %lld keyframes\n",
+                   stream.states, stream.bytes, (double)stream.bytes / (double)stream.states, stream.keyframes);
+            SnapshotStream_Close(&stream);
+        }
+        if (savePath && m == 0 && !Snapshot_Save(savePath, &game)) {
+            fprintf(stderr, "Could not write snapshot %s\n", savePath);
+            return 1;
+        }
+
+        if (!quiet) {
+            printf("match %d: score %d - %d, ai hits %d, expanded %s, state %016llx\n",
+                   m, game.score1, game.score2, game.aiHitsTotal, game.isExpanded ? "yes" : "no", Pong_HashState(&game));
+        }
+        totalScore1 += game.score1;
+        totalScore2 += game.score2;
+        totalAiHits += game.aiHitsTotal;
+    }
+
+    double elapsed = Pong_ClockSeconds() - start;
+    PROFILE_DUMP("headless_profile.json", "headless_profile.csv");
+    if (analytics) {
+        Analytics_DetachThread();
+        if (!Analytics_Close(analytics)) {
+            fprintf(stderr, "Could not write analytics log %s\n", analyticsPath);
+            return 1;
+        }
+    }
+    double totalFrames = (double)frames * (double)matches;
+    printf("frames: %.0f, elapsed: %.3f s, %.0f frames/s\n", totalFrames, elapsed, elapsed > 0 ? totalFrames / elapsed : 0.0);
+    printf("total score %lld - %lld, ai hits %lld\n", totalScore1, totalScore2, totalAiHits);
+    return 0;
+}
@@ -0,0 +1,248 @@
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200112L
+#endif
+#include "input_queue.h"
+#include "pong_clock.h"
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#elif defined(PONG_X11)
+#include <X11/Xlib.h>
+#include <X11/keysym.h>
+#include <pthread.h>
+#include <stdint.h>
+#endif
+
+const int INPUT_LATENCY_BUCKET_US[INPUT_LATENCY_BUCKETS - 1] = { 1000, 2000, 4000, 8000, 12000, 16000, 24000, 33000 };
+
+void InputQueue_Init(InputQueue* q) {
+    memset(q, 0, sizeof(*q));
+}
+
+// ---------------------------------------------------------------------------
+// Producer
+// ---------------------------------------------------------------------------
+
+bool InputQueue_Push(InputQueue* q, unsigned char key, bool down, unsigned long long timeNs) {
+    unsigned int head = __atomic_load_n(&q->head, __ATOMIC_RELAXED);
+    unsigned int tail = __atomic_load_n(&q->tail, __ATOMIC_ACQUIRE);
+    if (head - tail >= INPUT_QUEUE_CAPACITY) {
+        __atomic_add_fetch(&q->dropped, 1, __ATOMIC_RELAXED);
+        return false;
+    }
+    InputEvent* e = &q->events[head % INPUT_QUEUE_CAPACITY];
+    e->timeNs = timeNs;
+    e->key = key;
+    e->down = down;
+    __atomic_store_n(&q->head, head + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+void InputQueue_PushKeys(InputQueue* q, unsigned char keys, unsigned long long timeNs) {
+    unsigned char changed = (unsigned char)(keys ^ q->producerKeys);
+    for (unsigned char key = PONG_KEY_W; key <= PONG_KEY_DOWN; key <<= 1) {
+        if (!(changed & key)) continue;
+        // Keep the old state for a key that didn't fit, so it is retried
+        if (InputQueue_Push(q, key, (keys & key) != 0, timeNs)) q->producerKeys ^= key;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Consumer
+// ---------------------------------------------------------------------------
+
+// Held time as sixteenths of the step, 0 for all of it or for a direction
+// that wasn't pressed during the step. A key that was pressed at all (even
+// released at the same instant) moves the paddle a little.
+static unsigned char HeldSubsteps(bool pressed, unsigned long long heldNs, unsigned long long spanNs) {
+    if (!pressed || spanNs == 0 || heldNs >= spanNs) return 0;
+    unsigned long long n = (heldNs * PONG_INPUT_SUBSTEPS + spanNs / 2) / spanNs;
+    if (n >= PONG_INPUT_SUBSTEPS) return 0;
+    return (unsigned char)(n > 0 ? n : 1);
+}
+
+void InputQueue_StepInput(InputQueue* q, unsigned long long startNs, unsigned long long endNs, PongInput* in) {
+    unsigned char state = q->keys, any = state;
+    unsigned long long cursor = startNs, upNs = 0, downNs = 0;
+    unsigned int tail = __atomic_load_n(&q->tail, __ATOMIC_RELAXED);
+    unsigned int head = __atomic_load_n(&q->head, __ATOMIC_ACQUIRE);
+
+    while (tail != head) {
+        const InputEvent* e = &q->events[tail % INPUT_QUEUE_CAPACITY];
+        if (e->timeNs >= endNs) break;
+        // Events from before the step (a late frame) take effect at its start
+        unsigned long long t = e->timeNs > cursor ? e->timeNs : cursor;
+        if (state & PONG_KEY_UP_ANY) upNs += t - cursor;
+        if (state & PONG_KEY_DOWN_ANY) downNs += t - cursor;
+        cursor = t;
+
+        unsigned char before = state;
+        state = e->down ? (unsigned char)(state | e->key) : (unsigned char)(state & ~e->key);
+        any |= state;
+        // Only a press that starts a direction moving counts for latency
+        bool starts = ((e->key & PONG_KEY_UP_ANY) && !(before & PONG_KEY_UP_ANY)) ||
+                      ((e->key & PONG_KEY_DOWN_ANY) && !(before & PONG_KEY_DOWN_ANY));
+        if (e->down && starts && q->pendingCount < INPUT_PENDING_PRESSES) q->pending[q->pendingCount++] = e->timeNs;
+        q->stats.events++;
+        tail++;
+    }
+    __atomic_store_n(&q->tail, tail, __ATOMIC_RELEASE);
+
+    if (endNs > cursor) {
+        if (state & PONG_KEY_UP_ANY) upNs += endNs - cursor;
+        if (state & PONG_KEY_DOWN_ANY) downNs += endNs - cursor;
+    }
+    q->keys = state;
+
+    unsigned long long span = endNs > startNs ? endNs - startNs : 0;
+    in->keys = any;
+    in->upHeld = HeldSubsteps((any & PONG_KEY_UP_ANY) != 0, upNs, span);
+    in->downHeld = HeldSubsteps((any & PONG_KEY_DOWN_ANY) != 0, downNs, span);
+}
+
+void InputQueue_FramePresented(InputQueue* q, unsigned long long presentNs) {
+    InputLatencyStats* st = &q->stats;
+    for (int i = 0; i < q->pendingCount; i++) {
+        unsigned long long latency = presentNs > q->pending[i] ? presentNs - q->pending[i] : 0;
+        int bucket = 0;
+        while (bucket < INPUT_LATENCY_BUCKETS - 1 && latency > (unsigned long long)INPUT_LATENCY_BUCKET_US[bucket] * 1000ULL) bucket++;
+        st->histogram[bucket]++;
+        st->presses++;
+        st->latencyNs += latency;
+        if (latency > st->maxLatencyNs) st->maxLatencyNs = latency;
+    }
+    q->pendingCount = 0;
+}
+
+void InputQueue_GetStats(const InputQueue* q, InputLatencyStats* stats) {
+    *stats = q->stats;
+    stats->dropped = __atomic_load_n(&q->dropped, __ATOMIC_RELAXED);
+}
+
+// ---------------------------------------------------------------------------
+// Keyboard sampler thread
+// ---------------------------------------------------------------------------
+
+#if defined(_WIN32) || defined(PONG_X11)
+
+struct InputSampler {
+    InputQueue* queue;
+    WinHandle owner;
+    int quit;
+#ifdef _WIN32
+    HANDLE thread;
+#else
+    pthread_t thread;
+    Display* display;       // Our own connection, Xlib calls stay on this thread
+    KeyCode codes[4];       // W, S, UP, DOWN
+#endif
+};
+
+#ifdef _WIN32
+static unsigned char SampleKeys(InputSampler* s) {
+    if (s->owner && GetForegroundWindow() != (HWND)s->owner) return 0;
+    unsigned char keys = 0;
+    if (GetAsyncKeyState('W') & 0x8000) keys |= PONG_KEY_W;
+    if (GetAsyncKeyState('S') & 0x8000) keys |= PONG_KEY_S;
+    if (GetAsyncKeyState(VK_UP) & 0x8000) keys |= PONG_KEY_UP;
+    if (GetAsyncKeyState(VK_DOWN) & 0x8000) keys |= PONG_KEY_DOWN;
+    return keys;
+}
+#else
+static unsigned char SampleKeys(InputSampler* s) {
+    Window focus;
+    int revert;
+    XGetInputFocus(s->display, &focus, &revert);
+    if (s->owner && focus != (Window)(uintptr_t)s->owner) return 0;
+    char map[32];
+    XQueryKeymap(s->display, map);
+    static const unsigned char bits[4] = { PONG_KEY_W, PONG_KEY_S, PONG_KEY_UP, PONG_KEY_DOWN };
+    unsigned char keys = 0;
+    for (int i = 0; i < 4; i++) {
+        KeyCode c = s->codes[i];
+        if (c && (map[c >> 3] & (1 << (c & 7)))) keys |= bits[i];
+    }
+    return keys;
+}
+#endif
+
+// A transition is only seen at the sample after it, so it is stamped halfway
+// between that sample and the previous one
+static void SamplerLoop(InputSampler* s) {
+    unsigned long long period = 1000000000ULL / INPUT_SAMPLER_HZ;
+    unsigned long long last = Pong_ClockNs();
+    while (!__atomic_load_n(&s->quit, __ATOMIC_ACQUIRE)) {
+        unsigned char keys = SampleKeys(s);
+        unsigned long long now = Pong_ClockNs();
+        InputQueue_PushKeys(s->queue, keys, last + (now - last) / 2);
+        last = now;
+        Pong_SleepNs(period);
+    }
+}
+
+#ifdef _WIN32
+static DWORD WINAPI SamplerMain(LPVOID arg) {
+    SamplerLoop((InputSampler*)arg);
+    return 0;
+}
+#else
+static void* SamplerMain(void* arg) {
+    SamplerLoop((InputSampler*)arg);
+    return NULL;
+}
+#endif
+
+InputSampler* InputSampler_Start(InputQueue* q, WinHandle owner) {
+    InputSampler* s = (InputSampler*)calloc(1, sizeof(InputSampler));
+    if (!s) return NULL;
+    s->queue = q;
+    s->owner = owner;
+#ifdef _WIN32
+    s->thread = CreateThread(NULL, 0, SamplerMain, s, 0, NULL);
+    if (!s->thread) { free(s); return NULL; }
+    SetThreadPriority(s->thread, THREAD_PRIORITY_ABOVE_NORMAL);
+#else
+    s->display = XOpenDisplay(NULL);
+    if (!s->display) { free(s); return NULL; }
+    s->codes[0] = XKeysymToKeycode(s->display, XK_w);
+    s->codes[1] = XKeysymToKeycode(s->display, XK_s);
+    s->codes[2] = XKeysymToKeycode(s->display, XK_Up);
+    s->codes[3] = XKeysymToKeycode(s->display, XK_Down);
+    if (pthread_create(&s->thread, NULL, SamplerMain, s) != 0) {
+        XCloseDisplay(s->display);
+        free(s);
+        return NULL;
+    }
+#endif
+    return s;
+}
+
+void InputSampler_Stop(InputSampler* s) {
+    if (!s) return;
+    __atomic_store_n(&s->quit, 1, __ATOMIC_RELEASE);
+#ifdef _WIN32
+    WaitForSingleObject(s->thread, INFINITE);
+    CloseHandle(s->thread);
+#else
+    pthread_join(s->thread, NULL);
+    XCloseDisplay(s->display);
+#endif
+    free(s);
+}
+
+#else
+
+// No way to read the keyboard off the main thread here (headless builds)
+InputSampler* InputSampler_Start(InputQueue* q, WinHandle owner) {
+    (void)q;
+    (void)owner;
+    return NULL;
+}
+
+void InputSampler_Stop(InputSampler* s) {
+    (void)s;
+}
+
+#endif
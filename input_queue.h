@@ -0,0 +1,82 @@
+#ifndef INPUT_QUEUE_H
+#define INPUT_QUEUE_H
+#include <stdbool.h>
+#include "pong_core.h"
+#include "win_wrapper.h"
+
+// Timestamped player 1 input. Key transitions are queued with the time they
+// happened on the monotonic clock, and each physics step takes the ones that
+// fall inside the stretch of time it simulates: a key pressed a quarter into
+// a step moves the paddle for the remaining three quarters of it
+// (PongInput.upHeld/downHeld), instead of a whole frame early or late.
+//
+// The queue is single-producer single-consumer and lock-free. The producer is
+// an InputSampler thread polling the keyboard at about 1 kHz where the
+// platform allows it from another thread (GetAsyncKeyState on Windows,
+// XQueryKeymap in PONG_X11 builds), otherwise the game loop itself, once per
+// frame. Headless tests push synthetic events directly.
+//
+// The queue also measures input latency: from the timestamp of a press that
+// starts the paddle moving to the frame that shows the movement.
+
+#define INPUT_QUEUE_CAPACITY 256
+#define INPUT_SAMPLER_HZ 1000
+
+// Input latency buckets, upper bounds in microseconds (last: above)
+#define INPUT_LATENCY_BUCKETS 9
+extern const int INPUT_LATENCY_BUCKET_US[INPUT_LATENCY_BUCKETS - 1];
+
+typedef struct {
+    unsigned long long timeNs;
+    unsigned char key;      // One PONG_KEY_* bit
+    bool down;
+} InputEvent;
+
+typedef struct {
+    long long events;
+    long long dropped;                      // Queue full, lost
+    long long presses;                      // Presses that moved the paddle and were presented
+    long long histogram[INPUT_LATENCY_BUCKETS];
+    unsigned long long latencyNs;           // Sum of press-to-present times
+    unsigned long long maxLatencyNs;
+} InputLatencyStats;
+
+#define INPUT_PENDING_PRESSES 16
+
+typedef struct {
+    InputEvent events[INPUT_QUEUE_CAPACITY];
+    unsigned int head;      // Next slot the producer writes, only accessed atomically
+    unsigned int tail;      // Next slot the consumer reads, only accessed atomically
+    unsigned char producerKeys;     // Producer's view, for InputQueue_PushKeys
+    long long dropped;              // Producer's, read atomically
+    unsigned char keys;             // Keys down after the last consumed event
+    // Presses consumed by steps whose frame isn't presented yet
+    unsigned long long pending[INPUT_PENDING_PRESSES];
+    int pendingCount;
+    InputLatencyStats stats;        // Consumer's
+} InputQueue;
+
+void InputQueue_Init(InputQueue* q);
+
+// Producer side. Events must be pushed in time order.
+bool InputQueue_Push(InputQueue* q, unsigned char key, bool down, unsigned long long timeNs);
+// Pushes the transitions from the previously pushed key state to keys
+void InputQueue_PushKeys(InputQueue* q, unsigned char keys, unsigned long long timeNs);
+
+// Consumer side. Fills in->keys (every key down at some point of
+// [startNs, endNs)) and in->upHeld/downHeld for the physics step simulating
+// that time, consuming the events before endNs. Later events stay queued.
+void InputQueue_StepInput(InputQueue* q, unsigned long long startNs, unsigned long long endNs, PongInput* in);
+// Call when a frame reaches the screen: every press consumed since the
+// previous call is now visible
+void InputQueue_FramePresented(InputQueue* q, unsigned long long presentNs);
+void InputQueue_GetStats(const InputQueue* q, InputLatencyStats* stats);
+
+// Keyboard polling thread feeding a queue. Returns NULL where keys can't be
+// read off the main thread; the game then pushes ReadKeys() every frame.
+// Keys only count while owner has the focus.
+typedef struct InputSampler InputSampler;
+InputSampler* InputSampler_Start(InputQueue* q, WinHandle owner);
+void InputSampler_Stop(InputSampler* s);
+
+#endif
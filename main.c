@@ -1,375 +1,295 @@
 #include "raylib.h"
 #include "win_wrapper.h"
+#include "pong_core.h"
+#include "profiler.h"
+#include "replay.h"
+#include "ai_params.h"
+#include "pong_render.h"
+#include "netplay.h"
+#include "net_udp.h"
+#include "pong_multiball.h"
+#include "pong_pacer.h"
+#include "snapshot.h"
+#include "overlay_presenter.h"
+#include "input_queue.h"
+#include "analytics.h"
+#include "pong_clock.h"
+#include <stdio.h>
 #include <stdbool.h>
-#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
 #include "resource.h"
 
-#define INITIAL_WIDTH 800
-#define INITIAL_HEIGHT 600
-#define PADDLE_WIDTH 15
-#define PADDLE_HEIGHT 100
-#define BALL_SIZE 25 
-#define BALL_RADIUS (BALL_SIZE/2.0f)
-#define BASE_BALL_SPEED 7.0f
-#define MAX_BALL_SPEED (BASE_BALL_SPEED * 2.0f) // Limit set to 14.0f
-
-float EaseInOutCubic(float t) {
-    return t < 0.5f ? 4.0f * t * t * t : 1.0f - (-2.0f * t + 2.0f) * (-2.0f * t + 2.0f) * (-2.0f * t + 2.0f) / 2.0f;
+static unsigned char ReadKeys(void) {
+    unsigned char keys = 0;
+    if (IsKeyDown(KEY_W)) keys |= PONG_KEY_W;
+    if (IsKeyDown(KEY_S)) keys |= PONG_KEY_S;
+    if (IsKeyDown(KEY_UP)) keys |= PONG_KEY_UP;
+    if (IsKeyDown(KEY_DOWN)) keys |= PONG_KEY_DOWN;
+    return keys;
 }
 
-typedef struct {
-    float x, y, width, height;
-} Arena;
+// Multi-ball stress mode: the window covers the monitor and the balls are
+// stepped at the fixed rate and drawn as one sprite batch. The title shows
+// the mean frame time and FPS once a second.
+static void RunStress(int balls, int monitorW, int monitorH, unsigned long long seed, PongPacer* pacer) {
+    PongMultiBall m;
+    if (!PongMultiBall_Init(&m, balls, (float)monitorW, (float)monitorH, seed)) return;
+    SetWindowPosition(0, 0);
+    SetWindowSize(monitorW, monitorH);
+
+    PongRenderer renderer;
+    PongRenderer_Init(&renderer, DrawBackend_Raylib());
+    float accumulator = 0.0f, titleTime = 0.0f;
+    int titleFrames = 0;
+    while (!WindowShouldClose()) {
+        float frameTime = (float)PongPacer_Wait(pacer);
+        if (frameTime > 0.25f) frameTime = 0.25f;
+        accumulator += frameTime;
+        while (accumulator >= PONG_FIXED_DT) {
+            PongMultiBall_Step(&m, PONG_FIXED_DT);
+            accumulator -= PONG_FIXED_DT;
+        }
+        PongRenderer_MultiBallFrame(&renderer, &m);
+
+        titleTime += frameTime;
+        titleFrames++;
+        if (titleTime >= 1.0f) {
+            char title[64];
+            snprintf(title, sizeof(title), "Pong - %d balls, %.2f ms/frame, %.0f FPS",
+                     balls, 1000.0f * titleTime / titleFrames, titleFrames / titleTime);
+            SetWindowTitle(title);
+            titleTime = 0.0f;
+            titleFrames = 0;
+        }
+    }
+    PongRenderer_Shutdown(&renderer);
+    PongMultiBall_Free(&m);
+}
 
-int main(void)
+int main(int argc, char** argv)
 {
-    SetRandomSeed(GetTime());
+    // Versus over the network: --host PORT, or --join ADDRESS PORT
+    // Multi-ball stress mode: --stress BALLS
+    // Presentation rate: --fps HZ, --fps uncapped or --fps display (default 60)
+    // Simulation rate: --sim-hz HZ (default PONG_PHYSICS_HZ, not in versus)
+    // Snapshots: --resume FILE (saved with F5), --stream FILE for spectators
+    // Fixed-point simulation: --fixed (not in versus)
+    // Gameplay analytics log: --analytics FILE (not in versus)
+    int hostPort = 0, joinPort = 0, stressBalls = 0, simHz = PONG_PHYSICS_HZ;
+    const char* joinAddress = NULL;
+    const char* fps = "60";
+    const char* resumePath = NULL;
+    const char* streamPath = NULL;
+    const char* analyticsPath = NULL;
+    bool fixedPoint = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--host") == 0 && i + 1 < argc) hostPort = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--join") == 0 && i + 2 < argc) { joinAddress = argv[++i]; joinPort = atoi(argv[++i]); }
+        else if (strcmp(argv[i], "--stress") == 0 && i + 1 < argc) stressBalls = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--fps") == 0 && i + 1 < argc) fps = argv[++i];
+        else if (strcmp(argv[i], "--sim-hz") == 0 && i + 1 < argc) simHz = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--resume") == 0 && i + 1 < argc) resumePath = argv[++i];
+        else if (strcmp(argv[i], "--stream") == 0 && i + 1 < argc) streamPath = argv[++i];
+        else if (strcmp(argv[i], "--analytics") == 0 && i + 1 < argc) analyticsPath = argv[++i];
+        else if (strcmp(argv[i], "--fixed") == 0) fixedPoint = true;
+    }
+    bool networked = (hostPort > 0 || joinAddress);
+    // Rollback peers must step identically
+    if (networked || simHz <= 0) simHz = PONG_PHYSICS_HZ;
+    float simDt = 1.0f / (float)simHz;
+
+    unsigned long long seed = (unsigned long long)time(NULL);
     InitWindow(INITIAL_WIDTH, INITIAL_HEIGHT, "Pong");
-    SetTargetFPS(60);
+    // Raylib doesn't wait in EndDrawing: frames are paced by PongPacer
+    SetTargetFPS(0);
 
     WinHandle mainWinHandle = GetWindowHandle();
     Win32_ApplyEmbeddedIcon();
     Win32_UseDarkMode(true);
     int monitorW = GetMonitorWidth(0);
     int monitorH = GetMonitorHeight(0);
-    
-    // Animation and Arena Variables
-    Vector2 initialPos = GetWindowPosition();
-    Arena currentArena = { initialPos.x, initialPos.y, (float)INITIAL_WIDTH, (float)INITIAL_HEIGHT };
-    Arena startArena = currentArena;
-    Arena targetArena = { 0, 0, (float)monitorW, (float)monitorH };
-    
-    // Raylib Window Variables
-    Vector2 windowStartPos = { 0, 0 };
-    Vector2 windowTargetPos = { monitorW/2.0f - INITIAL_WIDTH/2.0f, monitorH/2.0f - INITIAL_HEIGHT/2.0f };
-
-    // Secondary Windows (Handles)
-    WinHandle hPaddle1 = Win32_CreateWindow(0, 0, PADDLE_WIDTH, PADDLE_HEIGHT, mainWinHandle);
-    WinHandle hPaddle2 = Win32_CreateWindow(0, 0, PADDLE_WIDTH, PADDLE_HEIGHT, mainWinHandle);
-    WinHandle hBall    = Win32_CreateWindow(0, 0, BALL_SIZE, BALL_SIZE, mainWinHandle);
-    Win32_MakeRound(hBall, BALL_SIZE, BALL_SIZE);
-
-    // Set the focus back to the main Raylib window
-    // Corrected: Using Win32 function instead of the undefined Raylib flag
-    Win32_SetForegroundWindow(mainWinHandle);
-
-    // Game Entities
-    Rectangle p1 = { 50, INITIAL_HEIGHT/2.0f - PADDLE_HEIGHT/2.0f, PADDLE_WIDTH, PADDLE_HEIGHT };
-    Rectangle p2 = { INITIAL_WIDTH - 50 - PADDLE_WIDTH, INITIAL_HEIGHT/2.0f - PADDLE_HEIGHT/2.0f, PADDLE_WIDTH, PADDLE_HEIGHT };
-    Vector2 ballPos = { INITIAL_WIDTH / 2.0f, INITIAL_HEIGHT / 2.0f };
-    // Initializing with base speed
-    Vector2 ballSpeed = { BASE_BALL_SPEED, BASE_BALL_SPEED }; 
-    
-    float p1LockedWorldY = 0;
-    float p2LockedWorldY = 0;
-
-    // Game/Animation States
-    bool gameStarted = false;
-    bool isExpanded = false; 
-    bool isAnimating = false; 
-    bool isLocked = false; 
 
-    // Counters and Timers
-    int score1 = 0, score2 = 0;
-    int playerHits = 0; 
-    int aiHitsTotal = 0; 
-    float animTimer = 0.0f;
-    float animDuration = 2.5f; 
-    
-    // AI Difficulty Variables
-    float targetY = INITIAL_HEIGHT / 2.0f; 
-    float reactionTimer = 0.0f;
-    float reactionDelay = 0.2f; 
-
-    while (!WindowShouldClose())
-    {
-        // 1. ANIMATION AND LOCKING LOGIC
-        if (isAnimating) {
-            animTimer += GetFrameTime();
-            float t = animTimer / animDuration;
-            
-            if (t >= 1.0f) { 
-                t = 1.0f; 
-                isAnimating = false; 
-                isExpanded = true;
-                isLocked = true; 
-                SetWindowPosition((int)windowTargetPos.x, (int)windowTargetPos.y); 
-            }
-            
-            float val = EaseInOutCubic(t);
+    double presentHz = 60.0;
+    if (strcmp(fps, "uncapped") == 0) presentHz = PONG_PACE_UNCAPPED;
+    else if (strcmp(fps, "display") == 0) presentHz = GetMonitorRefreshRate(GetCurrentMonitor());
+    else presentHz = atof(fps);
+    if (presentHz < 0.0 || (presentHz == 0.0 && strcmp(fps, "uncapped") != 0)) presentHz = 60.0;
+    PongPacer pacer;
+    PongPacer_Init(&pacer, presentHz);
+
+    if (stressBalls > 0) {
+        RunStress(stressBalls, monitorW, monitorH, seed, &pacer);
+        CloseWindow();
+        return 0;
+    }
 
-            // Interpolation for Arena Bounds Expansion
-            currentArena.x = startArena.x + (targetArena.x - startArena.x) * val;
-            currentArena.y = startArena.y + (targetArena.y - startArena.y) * val;
-            currentArena.width = startArena.width + (targetArena.width - startArena.width) * val;
-            currentArena.height = startArena.height + (targetArena.height - startArena.height) * val;
-            
-            // Interpolation for Raylib Window Position
-            int newX = (int)(windowStartPos.x + (windowTargetPos.x - windowStartPos.x) * val);
-            int newY = (int)(windowStartPos.y + (windowTargetPos.y - windowStartPos.y) * val);
-            SetWindowPosition(newX, newY); 
-            
-            // Update Paddle Positions
-            p1.y = p1LockedWorldY - currentArena.y;
-            p2.y = p2LockedWorldY - currentArena.y;
-            p2.x = currentArena.width - 50 - PADDLE_WIDTH;
-            
-        } 
-        else if (isLocked) {
-            // LOCKING TO THE CENTER
-            SetWindowPosition((int)windowTargetPos.x, (int)windowTargetPos.y);
-            currentArena = targetArena;
+    // Game state (arena, paddles, ball, scores, AI and animation)
+    Vector2 initialPos = GetWindowPosition();
+    PongState game;
+    Pong_Init(&game, initialPos.x, initialPos.y, monitorW, monitorH, seed);
+    // Tuned AI parameters (written by pong_tune), defaults if the file is missing
+    Pong_LoadAIParams("ai_params.txt", &game.ai);
+    if (fixedPoint && !networked) Pong_UseFixedPoint(&game);
+    // A saved game brings its own AI parameters, arena and window position
+    bool resumed = !networked && resumePath && Snapshot_Load(resumePath, &game);
+    if (resumed) SetWindowPosition((int)game.windowPos.x, (int)game.windowPos.y);
+
+    // Versus: wait for the other player, then both sides start from the
+    // host's seed, window position and monitor size. Player 2 is the peer
+    // instead of the AI, and window drags are no longer synced.
+    NetUdp udp = { 0 };
+    NetSession net;
+    if (networked) {
+        bool opened = (hostPort > 0) ? NetUdp_Open(&udp, hostPort)
+                                     : NetUdp_Open(&udp, 0) && NetUdp_SetPeer(&udp, joinAddress, joinPort);
+        NetTransport link = NetUdp_Transport(&udp);
+        NetStart start = { seed, initialPos.x, initialPos.y, monitorW, monitorH };
+        bool ready = false;
+        while (opened && !ready && !WindowShouldClose()) {
+            PongPacer_Wait(&pacer);
+            ready = (hostPort > 0) ? NetPlay_HostPoll(&link, &start) : NetPlay_JoinPoll(&link, &start);
+            BeginDrawing();
+                ClearBackground(BLACK);
+                DrawText(hostPort > 0 ? "Waiting for player 2..." : "Connecting...", 20, 20, 30, WHITE);
+            EndDrawing();
         }
-        else if (!isExpanded) {
-            // Drag Synchronization (Initial Phase)
-            Vector2 winPos = GetWindowPosition();
-            currentArena.x = winPos.x;
-            currentArena.y = winPos.y;
+        if (!ready) {
+            NetUdp_Close(&udp);
+            CloseWindow();
+            return 1;
         }
+        NetSession_Init(&net, link, hostPort > 0 ? 0 : 1, &start);
+        game = net.game;
+        SetWindowPosition((int)start.windowX, (int)start.windowY);
+    }
 
+    // Every single-player match is streamed to disk so it can be replayed with pong_headless --replay
+    // (not a resumed one: replays start from the seed)
+    ReplayWriter replay = { 0 };
+    ReplayHeader replayHeader = { seed, simHz, monitorW, monitorH, initialPos.x, initialPos.y, game.ai, game.fixedPoint };
+    if (!networked && !resumed) ReplayWriter_Open(&replay, "pong_last.replay", &replayHeader);
+    // Rollback re-simulates steps, which would log their events twice
+    AnalyticsLog* analytics = (analyticsPath && !networked) ? Analytics_Open(analyticsPath) : NULL;
+    if (analytics) Analytics_AttachThread(analytics);
+
+    // Spectators follow the state with pong_headless --spectate FILE
+    SnapshotStream stream = { 0 };
+    if (streamPath) SnapshotStream_Open(&stream, streamPath);
+
+    // Secondary windows live on the presenter thread, so a slow window
+    // manager can't stall the game loop. It also gives the focus back to the
+    // main window once they exist.
+    OverlayPresenter* presenter = OverlayPresenter_Create(mainWinHandle);
+
+    // Player 1's keys are timestamped as they change and applied within the
+    // step they fall in. A sampler thread reads the keyboard at 1 kHz where
+    // the platform allows it; otherwise the loop pushes the keys each frame.
+    // Versus peers exchange whole-step keys, so they keep per-frame polling.
+    InputQueue inputQueue;
+    InputQueue_Init(&inputQueue);
+    InputSampler* sampler = networked ? NULL : InputSampler_Start(&inputQueue, mainWinHandle);
+    unsigned long long simDtNs = 1000000000ULL / (unsigned long long)simHz;
+    unsigned long long stepEndNs = Pong_ClockNs();
+
+    // Net line and scores are cached in render targets
+    PongRenderer renderer;
+    PongRenderer_Init(&renderer, DrawBackend_Raylib());
+
+    // Fixed-timestep physics, rendering interpolates between the last two steps
+    PongState previous = game;
+    PongState view = game;
+    float accumulator = 0.0f;
+    // A game resumed in the expanded arena needs its overlays at once
+    bool overlaysVisible = game.isExpanded || game.isAnimating;
 
-        // 2. INPUT (Player 1)
-        float moveSpeed = 9.0f;
-        if (IsKeyDown(KEY_W) || IsKeyDown(KEY_UP)) { 
-            p1.y -= moveSpeed; gameStarted = true;
-            if (isAnimating || isLocked) p1LockedWorldY -= moveSpeed;
-        }
-        if (IsKeyDown(KEY_S) || IsKeyDown(KEY_DOWN)) { 
-            p1.y += moveSpeed; gameStarted = true;
-            if (isAnimating || isLocked) p1LockedWorldY += moveSpeed;
+    while (!WindowShouldClose())
+    {
+        PROFILE_BEGIN(PROF_FRAME);
+
+        // 1-4. ANIMATION, INPUT, AI, PHYSICS AND CLAMPING
+        float frameTime = (float)PongPacer_Wait(&pacer);
+        if (frameTime > 0.25f) frameTime = 0.25f; // Avoid a spiral after a stall
+        accumulator += frameTime;
+
+        Vector2 winPos = GetWindowPosition();
+        PongInput input = { ReadKeys(), winPos.x, winPos.y };
+        unsigned long long nowNs = Pong_ClockNs();
+        if (!networked && !sampler) InputQueue_PushKeys(&inputQueue, input.keys, nowNs);
+        unsigned int frameEvents = 0;
+        if (networked) {
+            // Late remote inputs may roll the game back and re-simulate it
+            NetSession_Poll(&net);
+            game = net.game;
         }
-
-        // 3. GAME AND AI LOGIC
-        if (gameStarted) {
-            
-            // --- 3A. ADAPTIVE DIFFICULTY CALCULATION BY SCORE ---
-            float aiDifficulty;
-            float scoreDiff = (float)score1 - (float)score2;
-
-            if (aiHitsTotal <= 2) {
-                // 1. GUARANTEED INITIAL HIT
-                aiDifficulty = 1.0f; 
-            } 
-            else if (scoreDiff <= -3.0f) {
-                // 2. FACILITATE (Player 1 losing by 3 or more)
-                aiDifficulty = 0.4f; 
-            } 
-            else if (scoreDiff >= 3.0f) {
-                // 3. INVINCIBLE (Player 1 winning by 3 or more)
-                aiDifficulty = 1.0f; 
-            }
-            else {
-                // 4. NORMAL PROGRESSIVE (Score is close)
-                float baseDiff = 0.7f;
-                float scalingFactor = 0.03f;
-                float hitsForCalc = (float)aiHitsTotal - 2.0f;
-                
-                aiDifficulty = baseDiff + sqrtf(hitsForCalc) * scalingFactor;
-                if (aiDifficulty > 0.95f) aiDifficulty = 0.95f; 
-            }
-            
-            // Flag to check if the AI should be perfect (max difficulty)
-            bool isPerfect = (aiDifficulty == 1.0f);
-            // -------------------------------------------------------------------
-            
-            // --- 3B. CONDITIONAL AI MOVEMENT LOGIC (P2) ---
-            
-            if (isPerfect) 
-            {
-                // ** PERFECT/INVINCIBLE LOGIC (Direct Movement) **
-                // Tracks the ball perfectly, without delay, error, or damping
-                float aiSpeedPerfect = 9.5f; 
-                float centerP2 = p2.y + PADDLE_HEIGHT / 2.0f;
-
-                if (ballPos.y > centerP2) {
-                    p2.y += aiSpeedPerfect;
-                    if (isAnimating || isLocked) p2LockedWorldY += aiSpeedPerfect;
-                }
-                else if (ballPos.y < centerP2) {
-                    p2.y -= aiSpeedPerfect;
-                    if (isAnimating || isLocked) p2LockedWorldY -= aiSpeedPerfect;
-                }
-                
+        while (accumulator >= simDt) {
+            previous = game;
+            if (networked) {
+                // Too far ahead of the peer: hold until its inputs arrive
+                if (!NetSession_Step(&net, input.keys)) { accumulator = 0.0f; break; }
+                game = net.game;
             } else {
-                
-                // ** ADAPTIVE LOGIC (Error, Reaction, and Smoothing) **
-
-                // 1. Reaction Time: Update the target
-                reactionTimer += GetFrameTime();
-                if (reactionTimer >= reactionDelay) {
-                    reactionTimer = 0.0f;
-
-                    float maxError = 100.0f * (1.0f - aiDifficulty); 
-                    float errorOffset = (float)GetRandomValue(-(int)maxError/2, (int)maxError/2); 
-
-                    targetY = ballPos.y + BALL_RADIUS + errorOffset;
-                    
-                    float minTarget = PADDLE_HEIGHT / 2.0f;
-                    float maxTarget = currentArena.height - PADDLE_HEIGHT / 2.0f;
-                    if (targetY < minTarget) targetY = minTarget;
-                    if (targetY > maxTarget) targetY = maxTarget;
-                }
-
-                // 2. Proportional Smooth Movement (Damping)
-                float aiSpeed = 5.0f + (4.0f * aiDifficulty); 
-                float centerP2 = p2.y + PADDLE_HEIGHT / 2.0f;
-                
-                float diff = targetY - centerP2;
-                float moveStep = 0.0f;
-                
-                float smoothingFactor = 0.15f; 
-                moveStep = diff * smoothingFactor;
-
-                if (fabsf(moveStep) > aiSpeed) {
-                    moveStep = (moveStep > 0) ? aiSpeed : -aiSpeed;
-                }
-
-                if (fabsf(diff) > 0.01f) 
-                {
-                    p2.y += moveStep;
-                    if (isAnimating || isLocked) {
-                        p2LockedWorldY += moveStep;
-                    }
-                }
-            }
-            // -------------------------------------------------------------------
-
-            // --- 3C. PHYSICS, COLLISION, AND SCORING ---
-            
-            ballPos.x += ballSpeed.x;
-            ballPos.y += ballSpeed.y;
-
-            if (ballPos.y <= 0 || ballPos.y + BALL_SIZE >= currentArena.height) ballSpeed.y *= -1;
-            
-            // SCORING (Ball goes left)
-            if (ballPos.x < 0) { 
-                score2++; 
-                ballPos = (Vector2){currentArena.width/2, currentArena.height/2}; 
-                gameStarted = false; 
-                playerHits = 0; 
-                
-                // Reset Paddle Positions and Speed
-                float paddleY = currentArena.height/2.0f - PADDLE_HEIGHT/2.0f;
-                p1.y = paddleY;
-                p2.y = paddleY;
-                p1LockedWorldY = currentArena.y + p1.y;
-                p2LockedWorldY = currentArena.y + p2.y;
-                targetY = currentArena.height/2.0f;
-                reactionTimer = 0.0f;
-                ballSpeed = (Vector2){ BASE_BALL_SPEED, BASE_BALL_SPEED }; // Reset speed
-            }
-            
-            // SCORING (Ball goes right)
-            if (ballPos.x > currentArena.width) { 
-                score1++; 
-                ballPos = (Vector2){currentArena.width/2, currentArena.height/2}; 
-                gameStarted = false; 
-                playerHits = 0; 
-                
-                // Reset Paddle Positions and Speed
-                float paddleY = currentArena.height/2.0f - PADDLE_HEIGHT/2.0f;
-                p1.y = paddleY;
-                p2.y = paddleY;
-                p1LockedWorldY = currentArena.y + p1.y;
-                p2LockedWorldY = currentArena.y + p2.y;
-                targetY = currentArena.height/2.0f;
-                reactionTimer = 0.0f;
-                ballSpeed = (Vector2){ BASE_BALL_SPEED, BASE_BALL_SPEED }; // Reset speed
-            }
-
-            // Player 1 Collision
-            bool hitP1 = (ballPos.x < p1.x + p1.width && ballPos.x + BALL_SIZE > p1.x && ballPos.y < p1.y + p1.height && ballPos.y + BALL_SIZE > p1.y);
-            if (hitP1) { 
-                ballSpeed.x *= -1; 
-                ballPos.x = p1.x + p1.width + 1; 
-                
-                // Increase speed
-                ballSpeed.x += (ballSpeed.x > 0) ? 1.0f : -1.0f;
-                
-                // NEW: Limit speed to the maximum allowed
-                if (fabsf(ballSpeed.x) > MAX_BALL_SPEED) {
-                    ballSpeed.x = (ballSpeed.x > 0) ? MAX_BALL_SPEED : -MAX_BALL_SPEED;
-                }
-                
-                if (!isExpanded && !isAnimating) {
-                    playerHits++;
-                    if (playerHits >= 2) {
-                        isAnimating = true;
-                        Vector2 winPos = GetWindowPosition();
-                        startArena = (Arena){ winPos.x, winPos.y, (float)INITIAL_WIDTH, (float)INITIAL_HEIGHT };
-                        windowStartPos = winPos;
-                        p1LockedWorldY = startArena.y + p1.y;
-                        p2LockedWorldY = startArena.y + p2.y;
-
-                        Win32_SetVisibleMode(hPaddle1, true);
-                        Win32_SetVisibleMode(hPaddle2, true);
-                        Win32_SetVisibleMode(hBall, true);
-                        Win32_SetTopMost(hPaddle1, true);
-                        Win32_SetTopMost(hPaddle2, true);
-                        Win32_SetTopMost(hBall, true);
-                    }
-                }
-            }
-            
-            // Player 2 (AI) Collision
-            bool hitP2 = (ballPos.x < p2.x + p2.width && ballPos.x + BALL_SIZE > p2.x && ballPos.y < p2.y + p2.height && ballPos.y + BALL_SIZE > p2.y);
-            if (hitP2) { 
-                ballSpeed.x *= -1; 
-                ballPos.x = p2.x - BALL_SIZE - 1;
-                aiHitsTotal++; 
+                // The steps of this frame end where the leftover time starts
+                unsigned long long startNs = stepEndNs;
+                stepEndNs = nowNs - (unsigned long long)((accumulator - simDt) * 1e9f);
+                if (stepEndNs < startNs || stepEndNs - startNs > 2 * simDtNs) startNs = stepEndNs - simDtNs;
+                InputQueue_StepInput(&inputQueue, startNs, stepEndNs, &input);
+                Pong_Step(&game, &input, simDt);
+                ReplayWriter_Frame(&replay, &input, &game);
             }
+            SnapshotStream_Frame(&stream, &game);
+            frameEvents |= game.events;
+            accumulator -= simDt;
         }
+        if (networked) NetSession_Send(&net);
+        SnapshotStream_Flush(&stream);
+        if (IsKeyPressed(KEY_F5)) Snapshot_Save("pong_save.snap", &game);
+        Pong_Interpolate(&previous, &game, accumulator / simDt, &view);
 
-        // 4. Clamping
-        if (p1.y < 0) { p1.y = 0; if(isAnimating || isLocked) p1LockedWorldY = currentArena.y; }
-        if (p1.y + PADDLE_HEIGHT > currentArena.height) { p1.y = currentArena.height - PADDLE_HEIGHT; if(isAnimating || isLocked) p1LockedWorldY = currentArena.y + p1.y; }
-        if (isExpanded && !isAnimating) p2.x = currentArena.width - 50 - PADDLE_WIDTH;
-        if (p2.y < 0) { p2.y = 0; if(isAnimating || isLocked) p2LockedWorldY = currentArena.y; }
-        if (p2.y + PADDLE_HEIGHT > currentArena.height) { p2.y = currentArena.height - PADDLE_HEIGHT; if(isAnimating || isLocked) p2LockedWorldY = currentArena.y + p2.y; }
-
-
-        // 5. UPDATE SECONDARY WINDOWS
-        int globalOffsetX = (int)currentArena.x;
-        int globalOffsetY = (int)currentArena.y;
-        
-        int titleBarOffset = 0;
-        if (!isExpanded) titleBarOffset = 35; 
-        
-        if (isAnimating) {
-            float t = animTimer / animDuration;
-            float val = EaseInOutCubic(t);
-            titleBarOffset = (int)(35.0f * (1.0f - val));
+        if (view.isAnimating || view.isLocked) {
+            SetWindowPosition((int)view.windowPos.x, (int)view.windowPos.y);
         }
 
-        Win32_SetWindowPos(hPaddle1, globalOffsetX + (int)p1.x, globalOffsetY + (int)p1.y + titleBarOffset, PADDLE_WIDTH, PADDLE_HEIGHT);
-        Win32_SetWindowPos(hPaddle2, globalOffsetX + (int)p2.x, globalOffsetY + (int)p2.y + titleBarOffset, PADDLE_WIDTH, PADDLE_HEIGHT);
-        Win32_SetWindowPos(hBall, globalOffsetX + (int)ballPos.x - 12, globalOffsetY + (int)ballPos.y, BALL_SIZE, BALL_SIZE);
-        
-        Win32_ProcessMessages();
-
-        // 6. RAYLIB DRAWING
-        BeginDrawing();
-            ClearBackground(BLACK);
-            
-            // Scoreboard 
-            DrawText(TextFormat("%d", score1), INITIAL_WIDTH/4, 50, 60, WHITE);
-            DrawText(TextFormat("%d", score2), 3*INITIAL_WIDTH/4, 50, 60, WHITE);
+        if (frameEvents & PONG_EVENT_EXPAND_START) overlaysVisible = true;
+
+        // 5. UPDATE SECONDARY WINDOWS (handed to the presenter thread, never waits)
+        PROFILE_BEGIN(PROF_WINDOWS);
+        OverlayFrame overlayFrame;
+        Pong_GetOverlayRects(&view, overlayFrame.rects);
+        // The overlays aren't owned by the main window, so they don't
+        // minimise with it
+        overlayFrame.visible = overlaysVisible && !IsWindowMinimized();
+        OverlayPresenter_Publish(presenter, &overlayFrame);
+        PROFILE_END(PROF_WINDOWS);
+
+        // 6. RAYLIB DRAWING (retained: only what changed is redrawn)
+        PROFILE_BEGIN(PROF_DRAW);
+        PongRenderer_Frame(&renderer, &view);
+        PROFILE_END(PROF_DRAW);
+        InputQueue_FramePresented(&inputQueue, Pong_ClockNs());
+
+        PROFILE_END(PROF_FRAME);
+    }
 
-            DrawLine(INITIAL_WIDTH/2, 0, INITIAL_WIDTH/2, INITIAL_HEIGHT, DARKGRAY);
-            
-            // Raylib Drawing only during windowed phase (Fake)
-            if (!isExpanded && !isAnimating) {
-                DrawRectangleRec(p1, WHITE);
-                DrawRectangleRec(p2, WHITE);
-                DrawCircle(ballPos.x + BALL_RADIUS - 12, ballPos.y + BALL_RADIUS, BALL_RADIUS, WHITE);
-            }
-            
-        EndDrawing();
+    PROFILE_DUMP("pong_profile.json", "pong_profile.csv");
+    InputSampler_Stop(sampler);
+    InputLatencyStats inputStats;
+    InputQueue_GetStats(&inputQueue, &inputStats);
+    if (inputStats.presses > 0) {
+        printf("input latency: %lld presses, mean %.2f ms, max %.2f ms\n", inputStats.presses,
+               inputStats.latencyNs / (double)inputStats.presses / 1e6, inputStats.maxLatencyNs / 1e6);
+    }
+    ReplayWriter_Close(&replay, &game);
+    SnapshotStream_Close(&stream);
+    if (analytics) {
+        Analytics_DetachThread();
+        Analytics_Close(analytics);
     }
 
-    Win32_DestroyWindow(hPaddle1);
-    Win32_DestroyWindow(hPaddle2);
-    Win32_DestroyWindow(hBall);
+    PongRenderer_Shutdown(&renderer);
+    if (networked) NetUdp_Close(&udp);
+    OverlayPresenter_Destroy(presenter, NULL);
     CloseWindow();
 
     return 0;
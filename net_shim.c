@@ -0,0 +1,59 @@
+#include "net_shim.h"
+#include <string.h>
+
+static float NextUnit(NetShim* shim) {
+    // xorshift64*, same generator as the game state
+    unsigned long long x = shim->rngState;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    shim->rngState = x;
+    return (float)((x * 2685821657736338717ULL) >> 40) / (float)(1 << 24);
+}
+
+void NetShim_Init(NetShim* shim, NetTransport inner, float delayMs, float jitterMs, float lossRate,
+                  unsigned long long seed) {
+    memset(shim, 0, sizeof(*shim));
+    shim->inner = inner;
+    shim->delayMs = delayMs;
+    shim->jitterMs = jitterMs;
+    shim->lossRate = lossRate;
+    shim->rngState = seed ? seed : 0x9E3779B97F4A7C15ULL;
+}
+
+static int Shim_Send(void* ctx, const void* data, int size) {
+    NetShim* shim = (NetShim*)ctx;
+    shim->sent++;
+    if (NextUnit(shim) < shim->lossRate || shim->queued == NET_SHIM_CAPACITY || size > NET_MAX_PACKET) {
+        shim->dropped++;
+        return size;
+    }
+    float delayMs = shim->delayMs + NextUnit(shim) * shim->jitterMs;
+    NetShimPacket* p = &shim->queue[shim->queued++];
+    p->deliverNs = shim->nowNs + (unsigned long long)(delayMs * 1e6f);
+    p->size = size;
+    memcpy(p->data, data, (size_t)size);
+    return size;
+}
+
+static int Shim_Receive(void* ctx, void* data, int capacity) {
+    NetShim* shim = (NetShim*)ctx;
+    return shim->inner.receive(shim->inner.ctx, data, capacity);
+}
+
+void NetShim_Pump(NetShim* shim, unsigned long long nowNs) {
+    shim->nowNs = nowNs;
+    int kept = 0;
+    for (int i = 0; i < shim->queued; i++) {
+        NetShimPacket* p = &shim->queue[i];
+        if (p->deliverNs <= nowNs) shim->inner.send(shim->inner.ctx, p->data, p->size);
+        else if (kept != i) shim->queue[kept++] = *p;
+        else kept++;
+    }
+    shim->queued = kept;
+}
+
+NetTransport NetShim_Transport(NetShim* shim) {
+    NetTransport t = { shim, Shim_Send, Shim_Receive };
+    return t;
+}
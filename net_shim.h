@@ -0,0 +1,35 @@
+#ifndef NET_SHIM_H
+#define NET_SHIM_H
+#include "netplay.h"
+
+// Sits in front of a transport and makes the link worse on purpose: every
+// sent datagram is dropped with probability lossRate, or held back for
+// delayMs plus up to jitterMs (so packets can also arrive out of order).
+// Time is whatever the caller passes to NetShim_Pump, so tests can run on a
+// virtual clock.
+
+#define NET_SHIM_CAPACITY 512
+
+typedef struct {
+    unsigned long long deliverNs;
+    int size;
+    unsigned char data[NET_MAX_PACKET];
+} NetShimPacket;
+
+typedef struct {
+    NetTransport inner;
+    float delayMs, jitterMs, lossRate;
+    unsigned long long rngState;
+    unsigned long long nowNs;
+    NetShimPacket queue[NET_SHIM_CAPACITY];
+    int queued;
+    long long sent, dropped;
+} NetShim;
+
+void NetShim_Init(NetShim* shim, NetTransport inner, float delayMs, float jitterMs, float lossRate,
+                  unsigned long long seed);
+// Advances the clock and forwards every datagram that is due
+void NetShim_Pump(NetShim* shim, unsigned long long nowNs);
+NetTransport NetShim_Transport(NetShim* shim);
+
+#endif
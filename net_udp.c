@@ -0,0 +1,115 @@
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200112L
+#endif
+#include "net_udp.h"
+#include <string.h>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+typedef int socklen_t;
+#define CLOSE_SOCKET closesocket
+#else
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <fcntl.h>
+#include <unistd.h>
+#define CLOSE_SOCKET close
+#endif
+
+// The peer is kept as an IPv4 sockaddr_in inside NetUdp.peer
+typedef char PeerFitsCheck[sizeof(struct sockaddr_in) <= 16 ? 1 : -1];
+
+static bool SetNonBlocking(long long s) {
+#ifdef _WIN32
+    u_long mode = 1;
+    return ioctlsocket((SOCKET)s, FIONBIO, &mode) == 0;
+#else
+    int flags = fcntl((int)s, F_GETFL, 0);
+    return flags >= 0 && fcntl((int)s, F_SETFL, flags | O_NONBLOCK) == 0;
+#endif
+}
+
+bool NetUdp_Open(NetUdp* u, int localPort) {
+    memset(u, 0, sizeof(*u));
+    u->socket = -1;
+#ifdef _WIN32
+    WSADATA wsa;
+    if (WSAStartup(MAKEWORD(2, 2), &wsa) != 0) return false;
+#endif
+    long long s = (long long)socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (s < 0) return false;
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons((unsigned short)localPort);
+    if (bind(s, (struct sockaddr*)&addr, sizeof(addr)) != 0 || !SetNonBlocking(s)) {
+        CLOSE_SOCKET(s);
+        return false;
+    }
+    u->socket = s;
+    return true;
+}
+
+bool NetUdp_SetPeer(NetUdp* u, const char* host, int port) {
+    struct addrinfo hints, *result = NULL;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_DGRAM;
+    if (getaddrinfo(host, NULL, &hints, &result) != 0 || !result) return false;
+
+    struct sockaddr_in addr;
+    memcpy(&addr, result->ai_addr, sizeof(addr));
+    addr.sin_port = htons((unsigned short)port);
+    freeaddrinfo(result);
+
+    memcpy(u->peer, &addr, sizeof(addr));
+    u->hasPeer = true;
+    return true;
+}
+
+int NetUdp_LocalPort(const NetUdp* u) {
+    struct sockaddr_in addr;
+    socklen_t size = sizeof(addr);
+    if (getsockname(u->socket, (struct sockaddr*)&addr, &size) != 0) return 0;
+    return ntohs(addr.sin_port);
+}
+
+void NetUdp_Close(NetUdp* u) {
+    if (u->socket < 0) return;
+    CLOSE_SOCKET(u->socket);
+    u->socket = -1;
+#ifdef _WIN32
+    WSACleanup();
+#endif
+}
+
+static int Udp_Send(void* ctx, const void* data, int size) {
+    NetUdp* u = (NetUdp*)ctx;
+    if (!u->hasPeer) return 0;
+    return (int)sendto(u->socket, (const char*)data, size, 0, (const struct sockaddr*)u->peer,
+                       sizeof(struct sockaddr_in));
+}
+
+static int Udp_Receive(void* ctx, void* data, int capacity) {
+    NetUdp* u = (NetUdp*)ctx;
+    struct sockaddr_in from;
+    socklen_t fromSize = sizeof(from);
+    int size = (int)recvfrom(u->socket, (char*)data, capacity, 0, (struct sockaddr*)&from, &fromSize);
+    if (size < 0) return 0;     // Nothing waiting (or a transient error)
+    if (!u->hasPeer) {
+        memcpy(u->peer, &from, sizeof(from));
+        u->hasPeer = true;
+    }
+    return size;
+}
+
+NetTransport NetUdp_Transport(NetUdp* u) {
+    NetTransport t = { u, Udp_Send, Udp_Receive };
+    return t;
+}
@@ -0,0 +1,20 @@
+#ifndef NET_UDP_H
+#define NET_UDP_H
+#include <stdbool.h>
+#include "netplay.h"
+
+// Non-blocking UDP socket talking to one peer. A socket opened without a
+// peer (the host) adopts the address of the first datagram it receives.
+typedef struct {
+    long long socket;   // SOCKET on Windows, fd elsewhere; -1 when closed
+    unsigned char peer[16];
+    bool hasPeer;
+} NetUdp;
+
+bool NetUdp_Open(NetUdp* u, int localPort);  // 0 picks a free port
+bool NetUdp_SetPeer(NetUdp* u, const char* host, int port);
+int NetUdp_LocalPort(const NetUdp* u);
+void NetUdp_Close(NetUdp* u);
+NetTransport NetUdp_Transport(NetUdp* u);
+
+#endif
@@ -0,0 +1,261 @@
+#include "netplay.h"
+#include "pong_clock.h"
+#include <string.h>
+#include <limits.h>
+
+#define PACKET_MAGIC 'P'
+#define PACKET_JOIN  'J'
+#define PACKET_START 'S'
+#define PACKET_INPUT 'I'
+
+#define NO_ROLLBACK ULLONG_MAX
+
+// ---------------------------------------------------------------------------
+// Little-endian packing
+// ---------------------------------------------------------------------------
+
+static unsigned char* PutU32(unsigned char* p, unsigned long v) {
+    p[0] = (unsigned char)v; p[1] = (unsigned char)(v >> 8);
+    p[2] = (unsigned char)(v >> 16); p[3] = (unsigned char)(v >> 24);
+    return p + 4;
+}
+
+static unsigned char* PutU64(unsigned char* p, unsigned long long v) {
+    p = PutU32(p, (unsigned long)(v & 0xFFFFFFFFu));
+    return PutU32(p, (unsigned long)(v >> 32));
+}
+
+static unsigned char* PutF32(unsigned char* p, float v) {
+    unsigned int bits;
+    memcpy(&bits, &v, sizeof(bits));
+    return PutU32(p, bits);
+}
+
+static unsigned long GetU32(const unsigned char* p) {
+    return (unsigned long)p[0] | ((unsigned long)p[1] << 8) | ((unsigned long)p[2] << 16) | ((unsigned long)p[3] << 24);
+}
+
+static unsigned long long GetU64(const unsigned char* p) {
+    return (unsigned long long)GetU32(p) | ((unsigned long long)GetU32(p + 4) << 32);
+}
+
+static float GetF32(const unsigned char* p) {
+    unsigned int bits = (unsigned int)GetU32(p);
+    float v;
+    memcpy(&v, &bits, sizeof(v));
+    return v;
+}
+
+// ---------------------------------------------------------------------------
+// Lobby
+// ---------------------------------------------------------------------------
+
+#define START_PACKET_SIZE (2 + 8 + 4 + 4 + 4 + 4)
+
+static void SendStart(NetTransport* t, const NetStart* start) {
+    unsigned char packet[START_PACKET_SIZE];
+    unsigned char* p = packet;
+    *p++ = PACKET_MAGIC;
+    *p++ = PACKET_START;
+    p = PutU64(p, start->seed);
+    p = PutF32(p, start->windowX);
+    p = PutF32(p, start->windowY);
+    p = PutU32(p, (unsigned long)start->monitorW);
+    PutU32(p, (unsigned long)start->monitorH);
+    t->send(t->ctx, packet, START_PACKET_SIZE);
+}
+
+bool NetPlay_HostPoll(NetTransport* t, const NetStart* start) {
+    unsigned char packet[NET_MAX_PACKET];
+    int size;
+    while ((size = t->receive(t->ctx, packet, sizeof(packet))) > 0) {
+        if (size >= 2 && packet[0] == PACKET_MAGIC && packet[1] == PACKET_JOIN) {
+            SendStart(t, start);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool NetPlay_JoinPoll(NetTransport* t, NetStart* start) {
+    unsigned char packet[NET_MAX_PACKET];
+    int size;
+    while ((size = t->receive(t->ctx, packet, sizeof(packet))) > 0) {
+        if (size == START_PACKET_SIZE && packet[0] == PACKET_MAGIC && packet[1] == PACKET_START) {
+            start->seed = GetU64(packet + 2);
+            start->windowX = GetF32(packet + 10);
+            start->windowY = GetF32(packet + 14);
+            start->monitorW = (int)GetU32(packet + 18);
+            start->monitorH = (int)GetU32(packet + 22);
+            return true;
+        }
+    }
+    unsigned char join[2] = { PACKET_MAGIC, PACKET_JOIN };
+    t->send(t->ctx, join, sizeof(join));
+    return false;
+}
+
+// ---------------------------------------------------------------------------
+// Session
+// ---------------------------------------------------------------------------
+
+void NetSession_Init(NetSession* n, NetTransport transport, int localPlayer, const NetStart* start) {
+    memset(n, 0, sizeof(*n));
+    n->transport = transport;
+    n->localPlayer = localPlayer;
+    n->start = *start;
+    n->rollbackFrom = NO_ROLLBACK;
+    Pong_Init(&n->game, start->windowX, start->windowY, start->monitorW, start->monitorH, start->seed);
+    n->game.versus = true;
+}
+
+static bool RemoteKnown(const NetSession* n, unsigned long long f) {
+    return n->remoteFrame[f % NET_RING] == f + 1;
+}
+
+// Repeats the peer's last confirmed keys
+static unsigned char PredictRemote(const NetSession* n) {
+    unsigned long long last = n->remoteKnownUpTo;
+    return last > 0 ? n->remoteKeys[(last - 1) % NET_RING] : 0;
+}
+
+static void SimulateStep(NetSession* n, unsigned long long f) {
+    unsigned char local = n->localKeys[f % NET_RING];
+    unsigned char remote = n->remoteKeys[f % NET_RING];
+    PongInput input = { 0, n->start.windowX, n->start.windowY, 0 };
+    input.keys = (n->localPlayer == 0) ? local : remote;
+    input.keys2 = (n->localPlayer == 0) ? remote : local;
+    n->snapshots[f % NET_RING] = n->game;
+    Pong_Step(&n->game, &input, PONG_FIXED_DT);
+}
+
+const PongState* NetSession_StateAt(const NetSession* n, unsigned long long f) {
+    if (f == n->frame) return &n->game;
+    if (f > n->frame || n->frame - f > NET_RING) return NULL;
+    return &n->snapshots[f % NET_RING];
+}
+
+static void ReceiveInput(NetSession* n, const unsigned char* packet, int size) {
+    if (size < 2 + 4 + 4 + 1) return;
+    unsigned long long ack = GetU32(packet + 2);
+    unsigned long long first = GetU32(packet + 6);
+    int count = packet[10];
+    if (size < 11 + count + 12) return;
+    const unsigned char* keys = packet + 11;
+    unsigned long long checkFrame = GetU32(packet + 11 + count);
+    unsigned long long checkHash = GetU64(packet + 15 + count);
+
+    if (ack > n->peerAck) n->peerAck = ack;
+
+    for (int i = 0; i < count; i++) {
+        unsigned long long f = first + (unsigned long long)i;
+        // Already confirmed, or too far ahead for the ring
+        if (f < n->remoteKnownUpTo || f >= n->remoteKnownUpTo + NET_RING) continue;
+        if (RemoteKnown(n, f)) continue;
+
+        // A step we already ran on a guess: was the guess right?
+        if (f < n->frame && n->remoteKeys[f % NET_RING] != keys[i] && f < n->rollbackFrom) n->rollbackFrom = f;
+        n->remoteKeys[f % NET_RING] = keys[i];
+        n->remoteFrame[f % NET_RING] = f + 1;
+    }
+    while (RemoteKnown(n, n->remoteKnownUpTo)) n->remoteKnownUpTo++;
+
+    // Compare the peer's checkpoint with ours if we still have it
+    if (checkFrame == 0) return;
+    for (int i = 0; i < NET_CHECK_RING; i++) {
+        if (n->checkFrame[i] != checkFrame) continue;
+        if (n->checkHash[i] == checkHash) n->stats.checksMatched++;
+        else n->stats.desyncs++;
+        break;
+    }
+}
+
+static void Rollback(NetSession* n) {
+    unsigned long long from = n->rollbackFrom;
+    n->rollbackFrom = NO_ROLLBACK;
+    if (from >= n->frame) return;
+
+    unsigned long long startNs = Pong_ClockNs();
+    int depth = (int)(n->frame - from);
+    n->game = n->snapshots[from % NET_RING];
+    for (unsigned long long f = from; f < n->frame; f++) {
+        if (!RemoteKnown(n, f)) n->remoteKeys[f % NET_RING] = PredictRemote(n);
+        SimulateStep(n, f);
+    }
+    unsigned long long elapsed = Pong_ClockNs() - startNs;
+
+    n->stats.rollbacks++;
+    n->stats.resimSteps += depth;
+    n->stats.resimNs += elapsed;
+    if (elapsed > n->stats.maxResimNs) n->stats.maxResimNs = elapsed;
+    if (depth > n->stats.maxRollback) n->stats.maxRollback = depth;
+    n->stats.depthHistogram[depth < NET_MAX_PREDICTION ? depth : NET_MAX_PREDICTION]++;
+}
+
+// Hashes every checkpoint whose inputs are now all confirmed
+static void UpdateChecks(NetSession* n) {
+    unsigned long long confirmed = n->remoteKnownUpTo < n->frame ? n->remoteKnownUpTo : n->frame;
+    unsigned long long next = n->lastCheck + NET_CHECK_INTERVAL;
+    while (next <= confirmed) {
+        const PongState* s = NetSession_StateAt(n, next);
+        if (s) {
+            int slot = (int)((next / NET_CHECK_INTERVAL) % NET_CHECK_RING);
+            n->checkFrame[slot] = next;
+            n->checkHash[slot] = Pong_HashState(s);
+        }
+        n->lastCheck = next;
+        next += NET_CHECK_INTERVAL;
+    }
+}
+
+void NetSession_Poll(NetSession* n) {
+    unsigned char packet[NET_MAX_PACKET];
+    int size;
+    while ((size = n->transport.receive(n->transport.ctx, packet, sizeof(packet))) > 0) {
+        if (size < 2 || packet[0] != PACKET_MAGIC) continue;
+        n->stats.packetsReceived++;
+        if (packet[1] == PACKET_INPUT) ReceiveInput(n, packet, size);
+        // The guest didn't get our start packet: send it again
+        else if (packet[1] == PACKET_JOIN && n->localPlayer == 0) SendStart(&n->transport, &n->start);
+    }
+    if (n->rollbackFrom != NO_ROLLBACK) Rollback(n);
+    UpdateChecks(n);
+}
+
+bool NetSession_Step(NetSession* n, unsigned char localKeys) {
+    if (n->frame >= n->remoteKnownUpTo + NET_MAX_PREDICTION) {
+        n->stats.stalls++;
+        return false;
+    }
+    unsigned long long f = n->frame;
+    n->localKeys[f % NET_RING] = localKeys;
+    if (!RemoteKnown(n, f)) n->remoteKeys[f % NET_RING] = PredictRemote(n);
+    SimulateStep(n, f);
+    n->frame++;
+    n->stats.steps++;
+    return true;
+}
+
+void NetSession_Send(NetSession* n) {
+    unsigned long long first = n->peerAck;
+    if (n->frame - first > NET_RING) first = n->frame - NET_RING;  // Can't happen while the peer keeps up
+    int count = (int)(n->frame - first);
+    if (count > NET_INPUTS_PER_PACKET) count = NET_INPUTS_PER_PACKET;
+
+    unsigned char packet[NET_MAX_PACKET];
+    unsigned char* p = packet;
+    *p++ = PACKET_MAGIC;
+    *p++ = PACKET_INPUT;
+    p = PutU32(p, (unsigned long)n->remoteKnownUpTo);
+    p = PutU32(p, (unsigned long)first);
+    *p++ = (unsigned char)count;
+    for (int i = 0; i < count; i++) *p++ = n->localKeys[(first + (unsigned long long)i) % NET_RING];
+
+    int slot = (int)((n->lastCheck / NET_CHECK_INTERVAL) % NET_CHECK_RING);
+    bool hasCheck = n->lastCheck > 0 && n->checkFrame[slot] == n->lastCheck;
+    p = PutU32(p, hasCheck ? (unsigned long)n->lastCheck : 0);
+    p = PutU64(p, hasCheck ? n->checkHash[slot] : 0);
+
+    n->transport.send(n->transport.ctx, packet, (int)(p - packet));
+    n->stats.packetsSent++;
+}
@@ -0,0 +1,95 @@
+#ifndef NETPLAY_H
+#define NETPLAY_H
+#include <stdbool.h>
+#include "pong_core.h"
+
+// Two-player versus over an unreliable datagram link, with rollback.
+//
+// Every physics step runs immediately with the local input; the peer's input
+// for that step is predicted (its last confirmed keys) when it hasn't
+// arrived yet. The state before each step is kept in a ring, so when a
+// remote input turns out different from the prediction the session restores
+// the snapshot of that step and re-simulates up to the present. Local input
+// therefore never waits on the network; RTT only shows up as rollbacks.
+//
+// Packets carry every local input the peer hasn't acknowledged yet (so a
+// lost packet is repaired by the next one), the acknowledgement of the
+// peer's inputs, and the state hash of the latest fully confirmed checkpoint
+// so both sides can detect a desync.
+
+#define NET_RING 128                // Snapshots and inputs kept, in steps
+#define NET_MAX_PREDICTION 48       // Steps we may run ahead of the peer's inputs (200 ms at 240 Hz)
+#define NET_INPUTS_PER_PACKET 64
+#define NET_MAX_PACKET 256
+#define NET_CHECK_INTERVAL 64       // Steps between desync checkpoints
+#define NET_CHECK_RING 8
+
+// Datagram link. send/receive never block; receive returns the size of one
+// datagram, 0 when none is waiting, negative on error.
+typedef struct {
+    void* ctx;
+    int (*send)(void* ctx, const void* data, int size);
+    int (*receive)(void* ctx, void* data, int capacity);
+} NetTransport;
+
+// What both sides need to start from the same state (sent by the host)
+typedef struct {
+    unsigned long long seed;
+    float windowX, windowY;
+    int monitorW, monitorH;
+} NetStart;
+
+typedef struct {
+    long long steps;            // Steps simulated the first time
+    long long rollbacks;
+    long long resimSteps;       // Steps simulated again after a misprediction
+    int maxRollback;            // Deepest rollback, in steps
+    long long depthHistogram[NET_MAX_PREDICTION + 1];
+    unsigned long long resimNs; // Time spent re-simulating
+    unsigned long long maxResimNs;
+    long long stalls;           // Steps refused because the peer was too far behind
+    long long packetsSent;
+    long long packetsReceived;
+    long long checksMatched;
+    long long desyncs;
+} NetStats;
+
+typedef struct {
+    NetTransport transport;
+    int localPlayer;            // 0: left paddle (host), 1: right paddle
+    NetStart start;
+    PongState game;
+    unsigned long long frame;   // Next step to simulate
+
+    PongState snapshots[NET_RING];              // State before step f
+    unsigned char localKeys[NET_RING];
+    unsigned char remoteKeys[NET_RING];         // Confirmed or predicted
+    unsigned long long remoteFrame[NET_RING];   // f + 1 once remoteKeys[f] is confirmed
+    unsigned long long remoteKnownUpTo;         // Every remote input below this is confirmed
+    unsigned long long peerAck;                 // The peer has our inputs below this
+    unsigned long long rollbackFrom;            // Earliest mispredicted step (ULLONG_MAX if none)
+
+    unsigned long long checkFrame[NET_CHECK_RING];
+    unsigned long long checkHash[NET_CHECK_RING];
+    unsigned long long lastCheck;               // Latest checkpoint hashed, 0 if none
+
+    NetStats stats;
+} NetSession;
+
+// Lobby: call every frame until it returns true. The host answers the first
+// join request with its NetStart; the guest retries until that arrives.
+bool NetPlay_HostPoll(NetTransport* transport, const NetStart* start);
+bool NetPlay_JoinPoll(NetTransport* transport, NetStart* start);
+
+void NetSession_Init(NetSession* n, NetTransport transport, int localPlayer, const NetStart* start);
+// Reads every waiting packet and re-simulates if a prediction was wrong
+void NetSession_Poll(NetSession* n);
+// Runs one step with the local keys. Returns false (and does nothing) when
+// the peer's inputs lag by NET_MAX_PREDICTION steps.
+bool NetSession_Step(NetSession* n, unsigned char localKeys);
+// Sends the unacknowledged local inputs; once per rendered frame is enough
+void NetSession_Send(NetSession* n);
+// State before step f if it is still in the ring (f <= n->frame)
+const PongState* NetSession_StateAt(const NetSession* n, unsigned long long f);
+
+#endif
@@ -0,0 +1,241 @@
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200112L
+#endif
+#include "overlay_presenter.h"
+#include "pong_clock.h"
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+typedef HANDLE Thread;
+typedef HANDLE Signal;
+#else
+#include <pthread.h>
+#include <semaphore.h>
+#include <errno.h>
+#include <time.h>
+typedef pthread_t Thread;
+typedef sem_t Signal;
+#endif
+
+// How long the presenter waits for a frame before pumping messages anyway
+#define IDLE_WAIT_MS 16
+
+#define FRESH 4u    // Set in middle when it holds a frame the reader hasn't taken
+
+typedef struct {
+    OverlayFrame frame;
+    long long seq;
+    unsigned long long publishNs;
+} Slot;
+
+struct OverlayPresenter {
+    // Triple buffer: the writer fills slots[back], then swaps it with middle;
+    // the reader swaps front with middle when FRESH is set. Each side only
+    // ever touches the slot it owns.
+    Slot slots[3];
+    unsigned int middle;    // Slot index | FRESH, only accessed atomically
+    int back;               // Writer's
+    int front;              // Reader's
+
+    Thread thread;
+    Signal wake;            // Posted on publish and on quit
+    Signal ready;           // Posted once the windows exist
+    int quit;
+
+    WinHandle owner;
+    WinHandle windows[PONG_OVERLAY_COUNT];
+    bool visible;
+    long long published;    // Writer's
+    OverlayPresenterStats stats;    // Reader's until the thread is joined
+};
+
+// ---------------------------------------------------------------------------
+// Platform threads and signals
+// ---------------------------------------------------------------------------
+
+#ifdef _WIN32
+static bool SignalInit(Signal* s) { *s = CreateEventA(NULL, FALSE, FALSE, NULL); return *s != NULL; }
+static void SignalPost(Signal* s) { SetEvent(*s); }
+static void SignalWait(Signal* s) { WaitForSingleObject(*s, INFINITE); }
+static void SignalWaitMs(Signal* s, int ms) { WaitForSingleObject(*s, (DWORD)ms); }
+static void SignalFree(Signal* s) { CloseHandle(*s); }
+
+static DWORD WINAPI PresenterMain(LPVOID arg);
+static bool ThreadStart(OverlayPresenter* p) {
+    p->thread = CreateThread(NULL, 0, PresenterMain, p, 0, NULL);
+    return p->thread != NULL;
+}
+static void ThreadJoin(OverlayPresenter* p) {
+    WaitForSingleObject(p->thread, INFINITE);
+    CloseHandle(p->thread);
+}
+#else
+static bool SignalInit(Signal* s) { return sem_init(s, 0, 0) == 0; }
+static void SignalPost(Signal* s) { sem_post(s); }
+static void SignalWait(Signal* s) { while (sem_wait(s) != 0 && errno == EINTR) {} }
+static void SignalFree(Signal* s) { sem_destroy(s); }
+
+static void SignalWaitMs(Signal* s, int ms) {
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_nsec += (long)ms * 1000000L;
+    deadline.tv_sec += deadline.tv_nsec / 1000000000L;
+    deadline.tv_nsec %= 1000000000L;
+    while (sem_timedwait(s, &deadline) != 0 && errno == EINTR) {}
+}
+
+static void* PresenterMain(void* arg);
+static bool ThreadStart(OverlayPresenter* p) {
+    return pthread_create(&p->thread, NULL, PresenterMain, p) == 0;
+}
+static void ThreadJoin(OverlayPresenter* p) {
+    pthread_join(p->thread, NULL);
+}
+#endif
+
+// ---------------------------------------------------------------------------
+// Presenter thread
+// ---------------------------------------------------------------------------
+
+static void CreateWindows(OverlayPresenter* p) {
+#ifdef _WIN32
+    // A window owned by one on another thread attaches the two threads'
+    // input queues, so either could stall on the other's messages. The
+    // overlays are unowned tool windows instead, kept above the main window
+    // by Apply making them topmost while they are shown.
+    WinHandle owner = NULL;
+#else
+    WinHandle owner = p->owner;     // Transient for the main window
+#endif
+    p->windows[PONG_OVERLAY_PADDLE1] = Win32_CreateWindow(0, 0, PADDLE_WIDTH, PADDLE_HEIGHT, owner);
+    p->windows[PONG_OVERLAY_PADDLE2] = Win32_CreateWindow(0, 0, PADDLE_WIDTH, PADDLE_HEIGHT, owner);
+    p->windows[PONG_OVERLAY_BALL] = Win32_CreateWindow(0, 0, BALL_SIZE, BALL_SIZE, owner);
+    Win32_MakeRound(p->windows[PONG_OVERLAY_BALL], BALL_SIZE, BALL_SIZE);
+    // Creating them may have taken the focus from the main window
+    if (p->owner) Win32_SetForegroundWindow(p->owner);
+}
+
+static void Apply(OverlayPresenter* p, const Slot* slot) {
+    unsigned long long start = Pong_ClockNs();
+    const OverlayFrame* f = &slot->frame;
+    if (f->visible != p->visible) {
+        for (int i = 0; i < PONG_OVERLAY_COUNT; i++) {
+            Win32_SetVisibleMode(p->windows[i], f->visible);
+            Win32_SetTopMost(p->windows[i], f->visible);
+        }
+        p->visible = f->visible;
+    }
+    Win32_BeginWindowMoves(PONG_OVERLAY_COUNT);
+    for (int i = 0; i < PONG_OVERLAY_COUNT; i++) {
+        Win32_SetWindowPos(p->windows[i], f->rects[i].x, f->rects[i].y, f->rects[i].width, f->rects[i].height);
+    }
+    Win32_EndWindowMoves();
+    unsigned long long end = Pong_ClockNs();
+
+    OverlayPresenterStats* st = &p->stats;
+    st->presented++;
+    st->applyNs += end - start;
+    if (end - start > st->maxApplyNs) st->maxApplyNs = end - start;
+    unsigned long long latency = end - slot->publishNs;
+    st->latencyNs += latency;
+    if (latency > st->maxLatencyNs) st->maxLatencyNs = latency;
+}
+
+// Takes the newest published frame, if there is one we haven't applied
+static const Slot* TakeNewest(OverlayPresenter* p) {
+    if (!(__atomic_load_n(&p->middle, __ATOMIC_ACQUIRE) & FRESH)) return NULL;
+    unsigned int old = __atomic_exchange_n(&p->middle, (unsigned int)p->front, __ATOMIC_ACQ_REL);
+    p->front = (int)(old & 3u);
+    return &p->slots[p->front];
+}
+
+#ifdef _WIN32
+static DWORD WINAPI PresenterMain(LPVOID arg) {
+#else
+static void* PresenterMain(void* arg) {
+#endif
+    OverlayPresenter* p = (OverlayPresenter*)arg;
+    CreateWindows(p);
+    SignalPost(&p->ready);
+
+    long long lastSeq = 0;
+    for (;;) {
+        SignalWaitMs(&p->wake, IDLE_WAIT_MS);
+        bool quit = __atomic_load_n(&p->quit, __ATOMIC_ACQUIRE) != 0;
+        const Slot* slot = TakeNewest(p);
+        if (slot) {
+            Apply(p, slot);
+            lastSeq = slot->seq;
+        }
+        Win32_ProcessMessages();
+        if (quit) break;
+    }
+
+    // Quit is set after the last publish, so that frame was taken above
+    p->stats.presentedNewest = (lastSeq == __atomic_load_n(&p->published, __ATOMIC_ACQUIRE));
+    for (int i = 0; i < PONG_OVERLAY_COUNT; i++) Win32_DestroyWindow(p->windows[i]);
+#ifdef _WIN32
+    return 0;
+#else
+    return NULL;
+#endif
+}
+
+// ---------------------------------------------------------------------------
+// Game thread
+// ---------------------------------------------------------------------------
+
+OverlayPresenter* OverlayPresenter_Create(WinHandle owner) {
+    OverlayPresenter* p = (OverlayPresenter*)calloc(1, sizeof(*p));
+    if (!p) return NULL;
+    p->owner = owner;
+    p->front = 0;
+    p->middle = 1;
+    p->back = 2;
+    if (!SignalInit(&p->wake)) {
+        free(p);
+        return NULL;
+    }
+    if (!SignalInit(&p->ready)) {
+        SignalFree(&p->wake);
+        free(p);
+        return NULL;
+    }
+    if (!ThreadStart(p)) {
+        SignalFree(&p->wake);
+        SignalFree(&p->ready);
+        free(p);
+        return NULL;
+    }
+    SignalWait(&p->ready);
+    return p;
+}
+
+void OverlayPresenter_Publish(OverlayPresenter* p, const OverlayFrame* frame) {
+    if (!p) return;
+    Slot* slot = &p->slots[p->back];
+    slot->frame = *frame;
+    slot->seq = p->published + 1;
+    slot->publishNs = Pong_ClockNs();
+    unsigned int old = __atomic_exchange_n(&p->middle, (unsigned int)p->back | FRESH, __ATOMIC_ACQ_REL);
+    p->back = (int)(old & 3u);
+    __atomic_store_n(&p->published, p->published + 1, __ATOMIC_RELEASE);
+    SignalPost(&p->wake);
+}
+
+void OverlayPresenter_Destroy(OverlayPresenter* p, OverlayPresenterStats* stats) {
+    if (!p) return;
+    __atomic_store_n(&p->quit, 1, __ATOMIC_RELEASE);
+    SignalPost(&p->wake);
+    ThreadJoin(p);
+    SignalFree(&p->wake);
+    SignalFree(&p->ready);
+    if (stats) {
+        *stats = p->stats;
+        stats->published = p->published;
+        stats->dropped = p->published - p->stats.presented;
+    }
+    free(p);
+}
@@ -0,0 +1,51 @@
+#ifndef OVERLAY_PRESENTER_H
+#define OVERLAY_PRESENTER_H
+#include <stdbool.h>
+#include "pong_core.h"
+#include "win_wrapper.h"
+
+// Overlay windows (paddles and ball) driven from their own thread, so a slow
+// window manager or compositor never stalls the game loop.
+//
+// The presenter thread creates the overlay windows itself: on Windows a
+// window's messages are handled by the thread that created it, and moving a
+// window from another thread would block until that thread pumps them. The
+// game thread only publishes the newest overlay rectangles into a lock-free
+// triple buffer (one atomic exchange, never a wait). The presenter takes the
+// newest frame when it is ready for one; frames published meanwhile are
+// dropped, since only the latest positions matter.
+//
+// On Windows the overlays have no owner: an owner on the game thread would
+// tie the two threads' input queues together. They don't follow the main
+// window when it is minimised, so the caller hides them (visible = false).
+//
+// All Win32_* calls for the overlays happen on the presenter thread, so the
+// window backend and the dirty-tracking layer see a single thread.
+
+typedef struct {
+    PongWinRect rects[PONG_OVERLAY_COUNT];
+    bool visible;       // Shown and kept on top (expanded arena)
+} OverlayFrame;
+
+typedef struct {
+    long long published;
+    long long presented;
+    long long dropped;              // Published but replaced before being presented
+    unsigned long long latencyNs;   // Sum of publish-to-applied times
+    unsigned long long maxLatencyNs;
+    unsigned long long applyNs;     // Sum of time spent in window calls
+    unsigned long long maxApplyNs;
+    bool presentedNewest;           // The last frame published was applied
+} OverlayPresenterStats;
+
+typedef struct OverlayPresenter OverlayPresenter;
+
+// Starts the thread and returns once it has created the windows
+OverlayPresenter* OverlayPresenter_Create(WinHandle owner);
+// Never blocks
+void OverlayPresenter_Publish(OverlayPresenter* p, const OverlayFrame* frame);
+// Applies the newest frame, destroys the windows and joins the thread.
+// stats may be NULL.
+void OverlayPresenter_Destroy(OverlayPresenter* p, OverlayPresenterStats* stats);
+
+#endif
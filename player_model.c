@@ -0,0 +1,67 @@
+#include "player_model.h"
+
+static const PongPlayerSkill skills[PONG_SKILL_COUNT] = {
+    //  name        reaction  error   dead zone
+    { "novice",     0.45f,    280.0f, 20.0f },
+    { "average",    0.30f,    200.0f, 12.0f },
+    { "expert",     0.18f,    140.0f, 6.0f  },
+};
+
+const PongPlayerSkill* Pong_PlayerSkill(PongSkill skill) {
+    return (skill >= 0 && skill < PONG_SKILL_COUNT) ? &skills[skill] : &skills[PONG_SKILL_AVERAGE];
+}
+
+static float NextUnit(PongPlayerModel* m) {
+    // xorshift64*, same generator as the game state
+    unsigned long long x = m->rngState;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    m->rngState = x;
+    return (float)((x * 2685821657736338717ULL) >> 40) / (float)(1 << 24);
+}
+
+void PlayerModel_Init(PongPlayerModel* m, const PongPlayerSkill* skill, unsigned long long seed) {
+    m->skill = *skill;
+    m->rngState = seed ? seed : 0x9E3779B97F4A7C15ULL;
+    m->lastVelocity = (PongVec2){ 0.0f, 0.0f };
+    m->reactionTimer = 0.0f;
+    m->targetY = INITIAL_HEIGHT / 2.0f;
+    m->tracking = false;
+}
+
+unsigned char PlayerModel_Keys(PongPlayerModel* m, const PongState* s, float dt) {
+    // Serve as soon as the point is reset
+    if (!s->gameStarted) {
+        m->tracking = false;
+        m->lastVelocity = (PongVec2){ 0.0f, 0.0f };
+        return PONG_KEY_S;
+    }
+
+    // A new trajectory (serve, bounce or hit) restarts the reaction
+    if (s->ballSpeed.x != m->lastVelocity.x || s->ballSpeed.y != m->lastVelocity.y) {
+        m->lastVelocity = s->ballSpeed;
+        m->reactionTimer = 0.0f;
+        m->tracking = false;
+    }
+
+    if (!m->tracking) {
+        m->reactionTimer += dt;
+        if (m->reactionTimer >= m->skill.reactionDelay) {
+            m->tracking = true;
+            if (s->ballSpeed.x < 0.0f) {
+                float contactX = s->p1.x + s->p1.width;
+                float y = Pong_PredictInterceptY(s->ballPos, s->ballSpeed, contactX, s->currentArena.height);
+                m->targetY = y + BALL_RADIUS + (NextUnit(m) - 0.5f) * m->skill.aimError;
+            } else {
+                // Ball going away: recenter
+                m->targetY = s->currentArena.height / 2.0f;
+            }
+        }
+    }
+
+    float center = s->p1.y + PADDLE_HEIGHT / 2.0f;
+    if (center < m->targetY - m->skill.deadZone) return PONG_KEY_S;
+    if (center > m->targetY + m->skill.deadZone) return PONG_KEY_W;
+    return 0;
+}
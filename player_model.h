@@ -0,0 +1,38 @@
+#ifndef PLAYER_MODEL_H
+#define PLAYER_MODEL_H
+#include "pong_core.h"
+
+// Scripted stand-ins for a human on the left paddle, used by pong_tune to see
+// how the adaptive AI treats players of different skill. Like the AI, a model
+// reacts to each new ball trajectory after a delay and aims at the predicted
+// intercept plus a random error. The model has its own RNG so it never
+// disturbs the game's.
+typedef enum {
+    PONG_SKILL_NOVICE,
+    PONG_SKILL_AVERAGE,
+    PONG_SKILL_EXPERT,
+    PONG_SKILL_COUNT
+} PongSkill;
+
+typedef struct {
+    const char* name;
+    float reactionDelay;    // Seconds before reacting to a new trajectory
+    float aimError;         // Uniform aim error range, in pixels
+    float deadZone;         // Distance to the target at which it stops moving
+} PongPlayerSkill;
+
+typedef struct {
+    PongPlayerSkill skill;
+    unsigned long long rngState;
+    PongVec2 lastVelocity;
+    float reactionTimer;
+    float targetY;          // Paddle center it is moving towards
+    bool tracking;
+} PongPlayerModel;
+
+const PongPlayerSkill* Pong_PlayerSkill(PongSkill skill);
+void PlayerModel_Init(PongPlayerModel* m, const PongPlayerSkill* skill, unsigned long long seed);
+// Keys for player 1 this step; dt is the physics step the game is run at
+unsigned char PlayerModel_Keys(PongPlayerModel* m, const PongState* s, float dt);
+
+#endif
@@ -0,0 +1,1016 @@
+#include "pong_batch.h"
+#include "pong_core.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define PONG_BATCH_X86 1
+#include <immintrin.h>
+#define PONG_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+#define BATCH_LANES 8
+#define BATCH_ALIGN 32
+#define BATCH_FLOAT_ARRAYS 12
+#define BATCH_INT_ARRAYS 4
+
+#define AI_REACTION_DELAY 0.2f
+#define PADDLE_MARGIN 50.0f
+
+// Every array has 4-byte elements (float, PongFixed or int)
+static void* NextArray(unsigned char** cursor, int capacity) {
+    void* array = *cursor;
+    *cursor += (size_t)capacity * sizeof(float);
+    return array;
+}
+
+bool PongBatch_Init(PongBatch* b, int count, float arenaWidth, float arenaHeight, unsigned int seed) {
+    memset(b, 0, sizeof(*b));
+    if (count <= 0) return false;
+
+    int capacity = (count + BATCH_LANES - 1) / BATCH_LANES * BATCH_LANES;
+    size_t bytes = (size_t)capacity * sizeof(float) * (BATCH_FLOAT_ARRAYS + BATCH_INT_ARRAYS);
+    b->memory = calloc(1, bytes + BATCH_ALIGN);
+    if (!b->memory) return false;
+
+    unsigned char* cursor = (unsigned char*)(((uintptr_t)b->memory + BATCH_ALIGN - 1) & ~(uintptr_t)(BATCH_ALIGN - 1));
+    b->ballX = NextArray(&cursor, capacity);
+    b->ballY = NextArray(&cursor, capacity);
+    b->speedX = NextArray(&cursor, capacity);
+    b->speedY = NextArray(&cursor, capacity);
+    b->p1Y = NextArray(&cursor, capacity);
+    b->p2Y = NextArray(&cursor, capacity);
+    b->target1 = NextArray(&cursor, capacity);
+    b->target2 = NextArray(&cursor, capacity);
+    b->reaction1 = NextArray(&cursor, capacity);
+    b->reaction2 = NextArray(&cursor, capacity);
+    b->difficulty1 = NextArray(&cursor, capacity);
+    b->difficulty2 = NextArray(&cursor, capacity);
+    b->rng = (unsigned int*)NextArray(&cursor, capacity);
+    b->score1 = (int*)NextArray(&cursor, capacity);
+    b->score2 = (int*)NextArray(&cursor, capacity);
+    b->hits = (int*)NextArray(&cursor, capacity);
+
+    b->count = count;
+    b->capacity = capacity;
+    b->arenaWidth = arenaWidth;
+    b->arenaHeight = arenaHeight;
+    b->p1X = PADDLE_MARGIN;
+    b->p2X = arenaWidth - PADDLE_MARGIN - PADDLE_WIDTH;
+
+    unsigned int state = seed ? seed : 1u;
+    for (int i = 0; i < capacity; i++) {
+        // Spread the seeds so neighbouring lanes don't start correlated
+        state = state * 1664525u + 1013904223u;
+        b->rng[i] = state ? state : 1u;
+        b->difficulty1[i] = 0.7f;
+        b->difficulty2[i] = 0.7f;
+    }
+    PongBatch_ResetAll(b);
+    return true;
+}
+
+void PongBatch_Free(PongBatch* b) {
+    free(b->memory);
+    memset(b, 0, sizeof(*b));
+}
+
+void PongBatch_ResetAll(PongBatch* b) {
+    float paddleY = b->arenaHeight/2.0f - PADDLE_HEIGHT/2.0f;
+    for (int i = 0; i < b->capacity; i++) {
+        b->ballX[i] = b->arenaWidth/2.0f;
+        b->ballY[i] = b->arenaHeight/2.0f;
+        b->speedX[i] = BASE_BALL_SPEED;
+        b->speedY[i] = BASE_BALL_SPEED;
+        b->p1Y[i] = paddleY;
+        b->p2Y[i] = paddleY;
+        b->target1[i] = b->arenaHeight/2.0f;
+        b->target2[i] = b->arenaHeight/2.0f;
+        b->reaction1[i] = 0.0f;
+        b->reaction2[i] = 0.0f;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Scalar reference kernel
+// ---------------------------------------------------------------------------
+
+static inline unsigned int XorShift32(unsigned int x) {
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return x;
+}
+
+// Uniform value in [-0.5, 0.5)
+static inline float UnitNoise(unsigned int x) {
+    return (float)(x >> 8) * (1.0f / 16777216.0f) - 0.5f;
+}
+
+static inline void ScalarAI(float* y, float* target, float* reaction, float difficulty,
+                            float ballY, float noise, float dt, float frames, float smoothing, float height) {
+    *reaction += dt;
+    if (*reaction >= AI_REACTION_DELAY) {
+        *reaction = 0.0f;
+        float maxError = 100.0f * (1.0f - difficulty);
+        float t = ballY + BALL_RADIUS + noise * maxError;
+        float minTarget = PADDLE_HEIGHT / 2.0f;
+        float maxTarget = height - PADDLE_HEIGHT / 2.0f;
+        if (t < minTarget) t = minTarget;
+        if (t > maxTarget) t = maxTarget;
+        *target = t;
+    }
+
+    float aiSpeed = (5.0f + (4.0f * difficulty)) * frames;
+    float diff = *target - (*y + PADDLE_HEIGHT / 2.0f);
+    float moveStep = diff * smoothing;
+    if (moveStep > aiSpeed) moveStep = aiSpeed;
+    if (moveStep < -aiSpeed) moveStep = -aiSpeed;
+    if (diff > 0.01f || diff < -0.01f) *y += moveStep;
+}
+
+static void StepScalar(PongBatch* b, float dt, float frames, float smoothing) {
+    const float width = b->arenaWidth;
+    const float height = b->arenaHeight;
+    const float paddleY = height/2.0f - PADDLE_HEIGHT/2.0f;
+    const float maxPaddleY = height - PADDLE_HEIGHT;
+
+    for (int i = 0; i < b->count; i++) {
+        unsigned int r1 = XorShift32(b->rng[i]);
+        unsigned int r2 = XorShift32(r1);
+        b->rng[i] = r2;
+
+        ScalarAI(&b->p1Y[i], &b->target1[i], &b->reaction1[i], b->difficulty1[i], b->ballY[i], UnitNoise(r1), dt, frames, smoothing, height);
+        ScalarAI(&b->p2Y[i], &b->target2[i], &b->reaction2[i], b->difficulty2[i], b->ballY[i], UnitNoise(r2), dt, frames, smoothing, height);
+
+        float x = b->ballX[i] + b->speedX[i] * frames;
+        float y = b->ballY[i] + b->speedY[i] * frames;
+        float vx = b->speedX[i];
+        float vy = b->speedY[i];
+        if (y <= 0.0f || y + BALL_SIZE >= height) vy = -vy;
+
+        bool goalLeft = x < 0.0f;
+        bool goalRight = x > width;
+        if (goalLeft || goalRight) {
+            if (goalLeft) b->score2[i]++; else b->score1[i]++;
+            x = width/2.0f; y = height/2.0f;
+            vx = BASE_BALL_SPEED; vy = BASE_BALL_SPEED;
+            b->p1Y[i] = paddleY; b->p2Y[i] = paddleY;
+            b->target1[i] = height/2.0f; b->target2[i] = height/2.0f;
+            b->reaction1[i] = 0.0f; b->reaction2[i] = 0.0f;
+        }
+
+        float p1Y = b->p1Y[i];
+        if (x < b->p1X + PADDLE_WIDTH && x + BALL_SIZE > b->p1X && y < p1Y + PADDLE_HEIGHT && y + BALL_SIZE > p1Y) {
+            vx = -vx;
+            x = b->p1X + PADDLE_WIDTH + 1.0f;
+            vx += (vx > 0.0f) ? 1.0f : -1.0f;
+            if (vx > MAX_BALL_SPEED) vx = MAX_BALL_SPEED;
+            if (vx < -MAX_BALL_SPEED) vx = -MAX_BALL_SPEED;
+            b->hits[i]++;
+        }
+
+        float p2Y = b->p2Y[i];
+        if (x < b->p2X + PADDLE_WIDTH && x + BALL_SIZE > b->p2X && y < p2Y + PADDLE_HEIGHT && y + BALL_SIZE > p2Y) {
+            vx = -vx;
+            x = b->p2X - BALL_SIZE - 1.0f;
+            b->hits[i]++;
+        }
+
+        if (b->p1Y[i] < 0.0f) b->p1Y[i] = 0.0f;
+        if (b->p1Y[i] > maxPaddleY) b->p1Y[i] = maxPaddleY;
+        if (b->p2Y[i] < 0.0f) b->p2Y[i] = 0.0f;
+        if (b->p2Y[i] > maxPaddleY) b->p2Y[i] = maxPaddleY;
+
+        b->ballX[i] = x; b->ballY[i] = y;
+        b->speedX[i] = vx; b->speedY[i] = vy;
+    }
+}
+
+#ifdef PONG_BATCH_X86
+
+// ---------------------------------------------------------------------------
+// SSE2 kernel (4 matches per iteration, masks instead of branches)
+// ---------------------------------------------------------------------------
+
+static inline __m128 Sse_Select(__m128 mask, __m128 a, __m128 b) {
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+static inline __m128i Sse_XorShift(__m128i x) {
+    x = _mm_xor_si128(x, _mm_slli_epi32(x, 13));
+    x = _mm_xor_si128(x, _mm_srli_epi32(x, 17));
+    x = _mm_xor_si128(x, _mm_slli_epi32(x, 5));
+    return x;
+}
+
+static inline __m128 Sse_UnitNoise(__m128i x) {
+    __m128 f = _mm_cvtepi32_ps(_mm_srli_epi32(x, 8));
+    return _mm_sub_ps(_mm_mul_ps(f, _mm_set1_ps(1.0f / 16777216.0f)), _mm_set1_ps(0.5f));
+}
+
+static inline void Sse_AI(float* yPtr, float* targetPtr, float* reactionPtr, __m128 difficulty,
+                          __m128 ballY, __m128 noise, __m128 dt, __m128 frames, __m128 smoothing, __m128 height) {
+    __m128 y = _mm_load_ps(yPtr);
+    __m128 target = _mm_load_ps(targetPtr);
+    __m128 reaction = _mm_add_ps(_mm_load_ps(reactionPtr), dt);
+
+    __m128 fire = _mm_cmpge_ps(reaction, _mm_set1_ps(AI_REACTION_DELAY));
+    __m128 maxError = _mm_mul_ps(_mm_set1_ps(100.0f), _mm_sub_ps(_mm_set1_ps(1.0f), difficulty));
+    __m128 t = _mm_add_ps(_mm_add_ps(ballY, _mm_set1_ps(BALL_RADIUS)), _mm_mul_ps(noise, maxError));
+    t = _mm_max_ps(t, _mm_set1_ps(PADDLE_HEIGHT / 2.0f));
+    t = _mm_min_ps(t, _mm_sub_ps(height, _mm_set1_ps(PADDLE_HEIGHT / 2.0f)));
+    target = Sse_Select(fire, t, target);
+    reaction = _mm_andnot_ps(fire, reaction);
+
+    __m128 aiSpeed = _mm_mul_ps(_mm_add_ps(_mm_set1_ps(5.0f), _mm_mul_ps(_mm_set1_ps(4.0f), difficulty)), frames);
+    __m128 diff = _mm_sub_ps(target, _mm_add_ps(y, _mm_set1_ps(PADDLE_HEIGHT / 2.0f)));
+    __m128 moveStep = _mm_mul_ps(diff, smoothing);
+    moveStep = _mm_min_ps(moveStep, aiSpeed);
+    moveStep = _mm_max_ps(moveStep, _mm_sub_ps(_mm_setzero_ps(), aiSpeed));
+    __m128 moving = _mm_or_ps(_mm_cmpgt_ps(diff, _mm_set1_ps(0.01f)), _mm_cmplt_ps(diff, _mm_set1_ps(-0.01f)));
+    y = _mm_add_ps(y, _mm_and_ps(moving, moveStep));
+
+    _mm_store_ps(yPtr, y);
+    _mm_store_ps(targetPtr, target);
+    _mm_store_ps(reactionPtr, reaction);
+}
+
+static void StepSSE2(PongBatch* b, float dt, float frameScale, float smoothingFactor) {
+    const __m128 vdt = _mm_set1_ps(dt);
+    const __m128 frames = _mm_set1_ps(frameScale);
+    const __m128 smoothing = _mm_set1_ps(smoothingFactor);
+    const __m128 width = _mm_set1_ps(b->arenaWidth);
+    const __m128 height = _mm_set1_ps(b->arenaHeight);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 ballSize = _mm_set1_ps(BALL_SIZE);
+    const __m128 paddleW = _mm_set1_ps(PADDLE_WIDTH);
+    const __m128 paddleH = _mm_set1_ps(PADDLE_HEIGHT);
+    const __m128 p1X = _mm_set1_ps(b->p1X);
+    const __m128 p2X = _mm_set1_ps(b->p2X);
+    const __m128 baseSpeed = _mm_set1_ps(BASE_BALL_SPEED);
+    const __m128 maxSpeed = _mm_set1_ps(MAX_BALL_SPEED);
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 centerX = _mm_set1_ps(b->arenaWidth/2.0f);
+    const __m128 centerY = _mm_set1_ps(b->arenaHeight/2.0f);
+    const __m128 paddleY = _mm_set1_ps(b->arenaHeight/2.0f - PADDLE_HEIGHT/2.0f);
+    const __m128 maxPaddleY = _mm_set1_ps(b->arenaHeight - PADDLE_HEIGHT);
+
+    for (int i = 0; i < b->count; i += 4) {
+        __m128i r1 = Sse_XorShift(_mm_load_si128((const __m128i*)&b->rng[i]));
+        __m128i r2 = Sse_XorShift(r1);
+        _mm_store_si128((__m128i*)&b->rng[i], r2);
+
+        __m128 ballY = _mm_load_ps(&b->ballY[i]);
+        Sse_AI(&b->p1Y[i], &b->target1[i], &b->reaction1[i], _mm_load_ps(&b->difficulty1[i]), ballY, Sse_UnitNoise(r1), vdt, frames, smoothing, height);
+        Sse_AI(&b->p2Y[i], &b->target2[i], &b->reaction2[i], _mm_load_ps(&b->difficulty2[i]), ballY, Sse_UnitNoise(r2), vdt, frames, smoothing, height);
+
+        __m128 vx = _mm_load_ps(&b->speedX[i]);
+        __m128 vy = _mm_load_ps(&b->speedY[i]);
+        __m128 x = _mm_add_ps(_mm_load_ps(&b->ballX[i]), _mm_mul_ps(vx, frames));
+        __m128 y = _mm_add_ps(ballY, _mm_mul_ps(vy, frames));
+
+        __m128 wall = _mm_or_ps(_mm_cmple_ps(y, zero), _mm_cmpge_ps(_mm_add_ps(y, ballSize), height));
+        vy = Sse_Select(wall, _mm_sub_ps(zero, vy), vy);
+
+        // Scoring
+        __m128 goalLeft = _mm_cmplt_ps(x, zero);
+        __m128 goalRight = _mm_cmpgt_ps(x, width);
+        __m128 goal = _mm_or_ps(goalLeft, goalRight);
+        __m128i s1 = _mm_load_si128((const __m128i*)&b->score1[i]);
+        __m128i s2 = _mm_load_si128((const __m128i*)&b->score2[i]);
+        _mm_store_si128((__m128i*)&b->score1[i], _mm_sub_epi32(s1, _mm_castps_si128(_mm_andnot_ps(goalLeft, goalRight))));
+        _mm_store_si128((__m128i*)&b->score2[i], _mm_sub_epi32(s2, _mm_castps_si128(goalLeft)));
+        x = Sse_Select(goal, centerX, x);
+        y = Sse_Select(goal, centerY, y);
+        vx = Sse_Select(goal, baseSpeed, vx);
+        vy = Sse_Select(goal, baseSpeed, vy);
+        __m128 p1Y = Sse_Select(goal, paddleY, _mm_load_ps(&b->p1Y[i]));
+        __m128 p2Y = Sse_Select(goal, paddleY, _mm_load_ps(&b->p2Y[i]));
+        _mm_store_ps(&b->target1[i], Sse_Select(goal, centerY, _mm_load_ps(&b->target1[i])));
+        _mm_store_ps(&b->target2[i], Sse_Select(goal, centerY, _mm_load_ps(&b->target2[i])));
+        _mm_store_ps(&b->reaction1[i], _mm_andnot_ps(goal, _mm_load_ps(&b->reaction1[i])));
+        _mm_store_ps(&b->reaction2[i], _mm_andnot_ps(goal, _mm_load_ps(&b->reaction2[i])));
+
+        __m128i hits = _mm_load_si128((const __m128i*)&b->hits[i]);
+
+        // Player 1 collision
+        __m128 hit1 = _mm_and_ps(_mm_and_ps(_mm_cmplt_ps(x, _mm_add_ps(p1X, paddleW)), _mm_cmpgt_ps(_mm_add_ps(x, ballSize), p1X)),
+                                 _mm_and_ps(_mm_cmplt_ps(y, _mm_add_ps(p1Y, paddleH)), _mm_cmpgt_ps(_mm_add_ps(y, ballSize), p1Y)));
+        __m128 bounced = _mm_sub_ps(zero, vx);
+        bounced = _mm_add_ps(bounced, Sse_Select(_mm_cmpgt_ps(bounced, zero), one, _mm_sub_ps(zero, one)));
+        bounced = _mm_max_ps(_mm_min_ps(bounced, maxSpeed), _mm_sub_ps(zero, maxSpeed));
+        vx = Sse_Select(hit1, bounced, vx);
+        x = Sse_Select(hit1, _mm_add_ps(_mm_add_ps(p1X, paddleW), one), x);
+        hits = _mm_sub_epi32(hits, _mm_castps_si128(hit1));
+
+        // Player 2 collision
+        __m128 hit2 = _mm_and_ps(_mm_and_ps(_mm_cmplt_ps(x, _mm_add_ps(p2X, paddleW)), _mm_cmpgt_ps(_mm_add_ps(x, ballSize), p2X)),
+                                 _mm_and_ps(_mm_cmplt_ps(y, _mm_add_ps(p2Y, paddleH)), _mm_cmpgt_ps(_mm_add_ps(y, ballSize), p2Y)));
+        vx = Sse_Select(hit2, _mm_sub_ps(zero, vx), vx);
+        x = Sse_Select(hit2, _mm_sub_ps(_mm_sub_ps(p2X, ballSize), one), x);
+        hits = _mm_sub_epi32(hits, _mm_castps_si128(hit2));
+        _mm_store_si128((__m128i*)&b->hits[i], hits);
+
+        // Clamping
+        _mm_store_ps(&b->p1Y[i], _mm_min_ps(_mm_max_ps(p1Y, zero), maxPaddleY));
+        _mm_store_ps(&b->p2Y[i], _mm_min_ps(_mm_max_ps(p2Y, zero), maxPaddleY));
+        _mm_store_ps(&b->ballX[i], x);
+        _mm_store_ps(&b->ballY[i], y);
+        _mm_store_ps(&b->speedX[i], vx);
+        _mm_store_ps(&b->speedY[i], vy);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// AVX2 kernel (8 matches per iteration), same operations as the SSE2 kernel
+// ---------------------------------------------------------------------------
+
+PONG_TARGET_AVX2 static inline __m256 Avx_Select(__m256 mask, __m256 a, __m256 b) {
+    return _mm256_blendv_ps(b, a, mask);
+}
+
+PONG_TARGET_AVX2 static inline __m256i Avx_XorShift(__m256i x) {
+    x = _mm256_xor_si256(x, _mm256_slli_epi32(x, 13));
+    x = _mm256_xor_si256(x, _mm256_srli_epi32(x, 17));
+    x = _mm256_xor_si256(x, _mm256_slli_epi32(x, 5));
+    return x;
+}
+
+PONG_TARGET_AVX2 static inline __m256 Avx_UnitNoise(__m256i x) {
+    __m256 f = _mm256_cvtepi32_ps(_mm256_srli_epi32(x, 8));
+    return _mm256_sub_ps(_mm256_mul_ps(f, _mm256_set1_ps(1.0f / 16777216.0f)), _mm256_set1_ps(0.5f));
+}
+
+PONG_TARGET_AVX2 static inline void Avx_AI(float* yPtr, float* targetPtr, float* reactionPtr, __m256 difficulty,
+                                           __m256 ballY, __m256 noise, __m256 dt, __m256 frames, __m256 smoothing, __m256 height) {
+    __m256 y = _mm256_load_ps(yPtr);
+    __m256 target = _mm256_load_ps(targetPtr);
+    __m256 reaction = _mm256_add_ps(_mm256_load_ps(reactionPtr), dt);
+
+    __m256 fire = _mm256_cmp_ps(reaction, _mm256_set1_ps(AI_REACTION_DELAY), _CMP_GE_OQ);
+    __m256 maxError = _mm256_mul_ps(_mm256_set1_ps(100.0f), _mm256_sub_ps(_mm256_set1_ps(1.0f), difficulty));
+    __m256 t = _mm256_add_ps(_mm256_add_ps(ballY, _mm256_set1_ps(BALL_RADIUS)), _mm256_mul_ps(noise, maxError));
+    t = _mm256_max_ps(t, _mm256_set1_ps(PADDLE_HEIGHT / 2.0f));
+    t = _mm256_min_ps(t, _mm256_sub_ps(height, _mm256_set1_ps(PADDLE_HEIGHT / 2.0f)));
+    target = Avx_Select(fire, t, target);
+    reaction = _mm256_andnot_ps(fire, reaction);
+
+    __m256 aiSpeed = _mm256_mul_ps(_mm256_add_ps(_mm256_set1_ps(5.0f), _mm256_mul_ps(_mm256_set1_ps(4.0f), difficulty)), frames);
+    __m256 diff = _mm256_sub_ps(target, _mm256_add_ps(y, _mm256_set1_ps(PADDLE_HEIGHT / 2.0f)));
+    __m256 moveStep = _mm256_mul_ps(diff, smoothing);
+    moveStep = _mm256_min_ps(moveStep, aiSpeed);
+    moveStep = _mm256_max_ps(moveStep, _mm256_sub_ps(_mm256_setzero_ps(), aiSpeed));
+    __m256 moving = _mm256_or_ps(_mm256_cmp_ps(diff, _mm256_set1_ps(0.01f), _CMP_GT_OQ),
+                                 _mm256_cmp_ps(diff, _mm256_set1_ps(-0.01f), _CMP_LT_OQ));
+    y = _mm256_add_ps(y, _mm256_and_ps(moving, moveStep));
+
+    _mm256_store_ps(yPtr, y);
+    _mm256_store_ps(targetPtr, target);
+    _mm256_store_ps(reactionPtr, reaction);
+}
+
+PONG_TARGET_AVX2 static void StepAVX2(PongBatch* b, float dt, float frameScale, float smoothingFactor) {
+    const __m256 vdt = _mm256_set1_ps(dt);
+    const __m256 frames = _mm256_set1_ps(frameScale);
+    const __m256 smoothing = _mm256_set1_ps(smoothingFactor);
+    const __m256 width = _mm256_set1_ps(b->arenaWidth);
+    const __m256 height = _mm256_set1_ps(b->arenaHeight);
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 ballSize = _mm256_set1_ps(BALL_SIZE);
+    const __m256 paddleW = _mm256_set1_ps(PADDLE_WIDTH);
+    const __m256 paddleH = _mm256_set1_ps(PADDLE_HEIGHT);
+    const __m256 p1X = _mm256_set1_ps(b->p1X);
+    const __m256 p2X = _mm256_set1_ps(b->p2X);
+    const __m256 baseSpeed = _mm256_set1_ps(BASE_BALL_SPEED);
+    const __m256 maxSpeed = _mm256_set1_ps(MAX_BALL_SPEED);
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 centerX = _mm256_set1_ps(b->arenaWidth/2.0f);
+    const __m256 centerY = _mm256_set1_ps(b->arenaHeight/2.0f);
+    const __m256 paddleY = _mm256_set1_ps(b->arenaHeight/2.0f - PADDLE_HEIGHT/2.0f);
+    const __m256 maxPaddleY = _mm256_set1_ps(b->arenaHeight - PADDLE_HEIGHT);
+
+    for (int i = 0; i < b->count; i += 8) {
+        __m256i r1 = Avx_XorShift(_mm256_load_si256((const __m256i*)&b->rng[i]));
+        __m256i r2 = Avx_XorShift(r1);
+        _mm256_store_si256((__m256i*)&b->rng[i], r2);
+
+        __m256 ballY = _mm256_load_ps(&b->ballY[i]);
+        Avx_AI(&b->p1Y[i], &b->target1[i], &b->reaction1[i], _mm256_load_ps(&b->difficulty1[i]), ballY, Avx_UnitNoise(r1), vdt, frames, smoothing, height);
+        Avx_AI(&b->p2Y[i], &b->target2[i], &b->reaction2[i], _mm256_load_ps(&b->difficulty2[i]), ballY, Avx_UnitNoise(r2), vdt, frames, smoothing, height);
+
+        __m256 vx = _mm256_load_ps(&b->speedX[i]);
+        __m256 vy = _mm256_load_ps(&b->speedY[i]);
+        __m256 x = _mm256_add_ps(_mm256_load_ps(&b->ballX[i]), _mm256_mul_ps(vx, frames));
+        __m256 y = _mm256_add_ps(ballY, _mm256_mul_ps(vy, frames));
+
+        __m256 wall = _mm256_or_ps(_mm256_cmp_ps(y, zero, _CMP_LE_OQ), _mm256_cmp_ps(_mm256_add_ps(y, ballSize), height, _CMP_GE_OQ));
+        vy = Avx_Select(wall, _mm256_sub_ps(zero, vy), vy);
+
+        // Scoring
+        __m256 goalLeft = _mm256_cmp_ps(x, zero, _CMP_LT_OQ);
+        __m256 goalRight = _mm256_cmp_ps(x, width, _CMP_GT_OQ);
+        __m256 goal = _mm256_or_ps(goalLeft, goalRight);
+        __m256i s1 = _mm256_load_si256((const __m256i*)&b->score1[i]);
+        __m256i s2 = _mm256_load_si256((const __m256i*)&b->score2[i]);
+        _mm256_store_si256((__m256i*)&b->score1[i], _mm256_sub_epi32(s1, _mm256_castps_si256(_mm256_andnot_ps(goalLeft, goalRight))));
+        _mm256_store_si256((__m256i*)&b->score2[i], _mm256_sub_epi32(s2, _mm256_castps_si256(goalLeft)));
+        x = Avx_Select(goal, centerX, x);
+        y = Avx_Select(goal, centerY, y);
+        vx = Avx_Select(goal, baseSpeed, vx);
+        vy = Avx_Select(goal, baseSpeed, vy);
+        __m256 p1Y = Avx_Select(goal, paddleY, _mm256_load_ps(&b->p1Y[i]));
+        __m256 p2Y = Avx_Select(goal, paddleY, _mm256_load_ps(&b->p2Y[i]));
+        _mm256_store_ps(&b->target1[i], Avx_Select(goal, centerY, _mm256_load_ps(&b->target1[i])));
+        _mm256_store_ps(&b->target2[i], Avx_Select(goal, centerY, _mm256_load_ps(&b->target2[i])));
+        _mm256_store_ps(&b->reaction1[i], _mm256_andnot_ps(goal, _mm256_load_ps(&b->reaction1[i])));
+        _mm256_store_ps(&b->reaction2[i], _mm256_andnot_ps(goal, _mm256_load_ps(&b->reaction2[i])));
+
+        __m256i hits = _mm256_load_si256((const __m256i*)&b->hits[i]);
+
+        // Player 1 collision
+        __m256 hit1 = _mm256_and_ps(
+            _mm256_and_ps(_mm256_cmp_ps(x, _mm256_add_ps(p1X, paddleW), _CMP_LT_OQ), _mm256_cmp_ps(_mm256_add_ps(x, ballSize), p1X, _CMP_GT_OQ)),
+            _mm256_and_ps(_mm256_cmp_ps(y, _mm256_add_ps(p1Y, paddleH), _CMP_LT_OQ), _mm256_cmp_ps(_mm256_add_ps(y, ballSize), p1Y, _CMP_GT_OQ)));
+        __m256 bounced = _mm256_sub_ps(zero, vx);
+        bounced = _mm256_add_ps(bounced, Avx_Select(_mm256_cmp_ps(bounced, zero, _CMP_GT_OQ), one, _mm256_sub_ps(zero, one)));
+        bounced = _mm256_max_ps(_mm256_min_ps(bounced, maxSpeed), _mm256_sub_ps(zero, maxSpeed));
+        vx = Avx_Select(hit1, bounced, vx);
+        x = Avx_Select(hit1, _mm256_add_ps(_mm256_add_ps(p1X, paddleW), one), x);
+        hits = _mm256_sub_epi32(hits, _mm256_castps_si256(hit1));
+
+        // Player 2 collision
+        __m256 hit2 = _mm256_and_ps(
+            _mm256_and_ps(_mm256_cmp_ps(x, _mm256_add_ps(p2X, paddleW), _CMP_LT_OQ), _mm256_cmp_ps(_mm256_add_ps(x, ballSize), p2X, _CMP_GT_OQ)),
+            _mm256_and_ps(_mm256_cmp_ps(y, _mm256_add_ps(p2Y, paddleH), _CMP_LT_OQ), _mm256_cmp_ps(_mm256_add_ps(y, ballSize), p2Y, _CMP_GT_OQ)));
+        vx = Avx_Select(hit2, _mm256_sub_ps(zero, vx), vx);
+        x = Avx_Select(hit2, _mm256_sub_ps(_mm256_sub_ps(p2X, ballSize), one), x);
+        hits = _mm256_sub_epi32(hits, _mm256_castps_si256(hit2));
+        _mm256_store_si256((__m256i*)&b->hits[i], hits);
+
+        // Clamping
+        _mm256_store_ps(&b->p1Y[i], _mm256_min_ps(_mm256_max_ps(p1Y, zero), maxPaddleY));
+        _mm256_store_ps(&b->p2Y[i], _mm256_min_ps(_mm256_max_ps(p2Y, zero), maxPaddleY));
+        _mm256_store_ps(&b->ballX[i], x);
+        _mm256_store_ps(&b->ballY[i], y);
+        _mm256_store_ps(&b->speedX[i], vx);
+        _mm256_store_ps(&b->speedY[i], vy);
+    }
+}
+
+#endif
+
+bool PongBatch_KernelSupported(PongBatchKernel kernel) {
+    switch (kernel) {
+        case PONG_BATCH_AUTO:
+        case PONG_BATCH_SCALAR: return true;
+#ifdef PONG_BATCH_X86
+        case PONG_BATCH_SSE2: return true;
+        case PONG_BATCH_AVX2: return __builtin_cpu_supports("avx2");
+#endif
+        default: return false;
+    }
+}
+
+PongBatchKernel PongBatch_BestKernel(void) {
+    if (PongBatch_KernelSupported(PONG_BATCH_AVX2)) return PONG_BATCH_AVX2;
+    if (PongBatch_KernelSupported(PONG_BATCH_SSE2)) return PONG_BATCH_SSE2;
+    return PONG_BATCH_SCALAR;
+}
+
+const char* PongBatch_KernelName(PongBatchKernel kernel) {
+    switch (kernel) {
+        case PONG_BATCH_SCALAR: return "scalar";
+        case PONG_BATCH_SSE2: return "sse2";
+        case PONG_BATCH_AVX2: return "avx2";
+        default: return "auto";
+    }
+}
+
+void PongBatch_Step(PongBatch* b, float dt, PongBatchKernel kernel) {
+    if (kernel == PONG_BATCH_AUTO || !PongBatch_KernelSupported(kernel)) kernel = PongBatch_BestKernel();
+
+    // Same time scaling as Pong_Step: speeds are per 60 Hz frame
+    float frames = dt * PONG_REFERENCE_HZ;
+    float smoothing = 1.0f - powf(1.0f - 0.15f, frames);
+
+    switch (kernel) {
+#ifdef PONG_BATCH_X86
+        case PONG_BATCH_SSE2: StepSSE2(b, dt, frames, smoothing); break;
+        case PONG_BATCH_AVX2: StepAVX2(b, dt, frames, smoothing); break;
+#endif
+        default: StepScalar(b, dt, frames, smoothing); break;
+    }
+}
+
+static unsigned long long HashBytes(unsigned long long h, const void* data, size_t size) {
+    const unsigned char* p = (const unsigned char*)data;
+    for (size_t i = 0; i < size; i++) {
+        h ^= p[i];
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+unsigned long long PongBatch_Hash(const PongBatch* b) {
+    unsigned long long h = 14695981039346656037ULL;
+    size_t n = (size_t)b->count;
+    h = HashBytes(h, b->ballX, n * sizeof(float));
+    h = HashBytes(h, b->ballY, n * sizeof(float));
+    h = HashBytes(h, b->speedX, n * sizeof(float));
+    h = HashBytes(h, b->speedY, n * sizeof(float));
+    h = HashBytes(h, b->p1Y, n * sizeof(float));
+    h = HashBytes(h, b->p2Y, n * sizeof(float));
+    h = HashBytes(h, b->score1, n * sizeof(int));
+    h = HashBytes(h, b->score2, n * sizeof(int));
+    h = HashBytes(h, b->hits, n * sizeof(int));
+    return h;
+}
+
+// ---------------------------------------------------------------------------
+// Fixed-point batch
+// ---------------------------------------------------------------------------
+
+#define FX_ONE PONG_FIXED_ONE
+#define FX_REACTION_DELAY PONG_FX(0.2)
+#define FX_BALL_SIZE PONG_FX_INT(BALL_SIZE)
+#define FX_BALL_RADIUS (FX_BALL_SIZE / 2)
+#define FX_PADDLE_WIDTH PONG_FX_INT(PADDLE_WIDTH)
+#define FX_PADDLE_HEIGHT PONG_FX_INT(PADDLE_HEIGHT)
+#define FX_HALF_PADDLE (FX_PADDLE_HEIGHT / 2)
+#define FX_MOVE_EPSILON PONG_FX(0.01)
+
+bool PongFixedBatch_Init(PongFixedBatch* b, int count, float arenaWidth, float arenaHeight, unsigned int seed) {
+    memset(b, 0, sizeof(*b));
+    if (count <= 0) return false;
+
+    int capacity = (count + BATCH_LANES - 1) / BATCH_LANES * BATCH_LANES;
+    size_t bytes = (size_t)capacity * sizeof(PongFixed) * (BATCH_FLOAT_ARRAYS + BATCH_INT_ARRAYS);
+    b->memory = calloc(1, bytes + BATCH_ALIGN);
+    if (!b->memory) return false;
+
+    unsigned char* cursor = (unsigned char*)(((uintptr_t)b->memory + BATCH_ALIGN - 1) & ~(uintptr_t)(BATCH_ALIGN - 1));
+    b->ballX = NextArray(&cursor, capacity);
+    b->ballY = NextArray(&cursor, capacity);
+    b->speedX = NextArray(&cursor, capacity);
+    b->speedY = NextArray(&cursor, capacity);
+    b->p1Y = NextArray(&cursor, capacity);
+    b->p2Y = NextArray(&cursor, capacity);
+    b->target1 = NextArray(&cursor, capacity);
+    b->target2 = NextArray(&cursor, capacity);
+    b->reaction1 = NextArray(&cursor, capacity);
+    b->reaction2 = NextArray(&cursor, capacity);
+    b->difficulty1 = NextArray(&cursor, capacity);
+    b->difficulty2 = NextArray(&cursor, capacity);
+    b->rng = NextArray(&cursor, capacity);
+    b->score1 = NextArray(&cursor, capacity);
+    b->score2 = NextArray(&cursor, capacity);
+    b->hits = NextArray(&cursor, capacity);
+
+    b->count = count;
+    b->capacity = capacity;
+    b->arenaWidth = PongFixed_FromFloat(arenaWidth);
+    b->arenaHeight = PongFixed_FromFloat(arenaHeight);
+    b->p1X = PONG_FX_INT(PADDLE_MARGIN);
+    b->p2X = b->arenaWidth - PONG_FX_INT(PADDLE_MARGIN) - FX_PADDLE_WIDTH;
+
+    // Same seeds as PongBatch_Init, so the two batches play comparable matches
+    unsigned int state = seed ? seed : 1u;
+    for (int i = 0; i < capacity; i++) {
+        state = state * 1664525u + 1013904223u;
+        b->rng[i] = state ? state : 1u;
+        b->difficulty1[i] = PONG_FX(0.7);
+        b->difficulty2[i] = PONG_FX(0.7);
+    }
+    PongFixedBatch_ResetAll(b);
+    return true;
+}
+
+void PongFixedBatch_Free(PongFixedBatch* b) {
+    free(b->memory);
+    memset(b, 0, sizeof(*b));
+}
+
+void PongFixedBatch_ResetAll(PongFixedBatch* b) {
+    PongFixed paddleY = b->arenaHeight/2 - FX_HALF_PADDLE;
+    for (int i = 0; i < b->capacity; i++) {
+        b->ballX[i] = b->arenaWidth/2;
+        b->ballY[i] = b->arenaHeight/2;
+        b->speedX[i] = PONG_FX(BASE_BALL_SPEED);
+        b->speedY[i] = PONG_FX(BASE_BALL_SPEED);
+        b->p1Y[i] = paddleY;
+        b->p2Y[i] = paddleY;
+        b->target1[i] = b->arenaHeight/2;
+        b->target2[i] = b->arenaHeight/2;
+        b->reaction1[i] = 0;
+        b->reaction2[i] = 0;
+    }
+}
+
+static inline PongFixed FixedMul(PongFixed a, PongFixed b) {
+    return (PongFixed)(((long long)a * b) >> PONG_FIXED_SHIFT);
+}
+
+// Uniform value in [-0.5, 0.5), from the top 16 bits
+static inline PongFixed FixedNoise(unsigned int x) {
+    return (PongFixed)(x >> 16) - FX_ONE / 2;
+}
+
+static inline void FixedScalarAI(PongFixed* y, PongFixed* target, PongFixed* reaction, PongFixed difficulty,
+                                 PongFixed ballY, PongFixed noise, PongFixed dt, PongFixed frames, PongFixed smoothing, PongFixed height) {
+    *reaction += dt;
+    if (*reaction >= FX_REACTION_DELAY) {
+        *reaction = 0;
+        PongFixed maxError = FixedMul(PONG_FX_INT(100), FX_ONE - difficulty);
+        PongFixed t = ballY + FX_BALL_RADIUS + FixedMul(noise, maxError);
+        if (t < FX_HALF_PADDLE) t = FX_HALF_PADDLE;
+        if (t > height - FX_HALF_PADDLE) t = height - FX_HALF_PADDLE;
+        *target = t;
+    }
+
+    PongFixed aiSpeed = FixedMul(PONG_FX_INT(5) + 4 * difficulty, frames);
+    PongFixed diff = *target - (*y + FX_HALF_PADDLE);
+    PongFixed moveStep = FixedMul(diff, smoothing);
+    if (moveStep > aiSpeed) moveStep = aiSpeed;
+    if (moveStep < -aiSpeed) moveStep = -aiSpeed;
+    if (diff > FX_MOVE_EPSILON || diff < -FX_MOVE_EPSILON) *y += moveStep;
+}
+
+static void FixedStepScalar(PongFixedBatch* b, PongFixed dt, PongFixed frames, PongFixed smoothing) {
+    const PongFixed width = b->arenaWidth;
+    const PongFixed height = b->arenaHeight;
+    const PongFixed paddleY = height/2 - FX_HALF_PADDLE;
+    const PongFixed maxPaddleY = height - FX_PADDLE_HEIGHT;
+    const PongFixed maxSpeed = PONG_FX(MAX_BALL_SPEED);
+
+    for (int i = 0; i < b->count; i++) {
+        unsigned int r1 = XorShift32(b->rng[i]);
+        unsigned int r2 = XorShift32(r1);
+        b->rng[i] = r2;
+
+        FixedScalarAI(&b->p1Y[i], &b->target1[i], &b->reaction1[i], b->difficulty1[i], b->ballY[i], FixedNoise(r1), dt, frames, smoothing, height);
+        FixedScalarAI(&b->p2Y[i], &b->target2[i], &b->reaction2[i], b->difficulty2[i], b->ballY[i], FixedNoise(r2), dt, frames, smoothing, height);
+
+        PongFixed x = b->ballX[i] + FixedMul(b->speedX[i], frames);
+        PongFixed y = b->ballY[i] + FixedMul(b->speedY[i], frames);
+        PongFixed vx = b->speedX[i];
+        PongFixed vy = b->speedY[i];
+        if (y <= 0 || y + FX_BALL_SIZE >= height) vy = -vy;
+
+        bool goalLeft = x < 0;
+        bool goalRight = x > width;
+        if (goalLeft || goalRight) {
+            if (goalLeft) b->score2[i]++; else b->score1[i]++;
+            x = width/2; y = height/2;
+            vx = PONG_FX(BASE_BALL_SPEED); vy = PONG_FX(BASE_BALL_SPEED);
+            b->p1Y[i] = paddleY; b->p2Y[i] = paddleY;
+            b->target1[i] = height/2; b->target2[i] = height/2;
+            b->reaction1[i] = 0; b->reaction2[i] = 0;
+        }
+
+        PongFixed p1Y = b->p1Y[i];
+        if (x < b->p1X + FX_PADDLE_WIDTH && x + FX_BALL_SIZE > b->p1X && y < p1Y + FX_PADDLE_HEIGHT && y + FX_BALL_SIZE > p1Y) {
+            vx = -vx;
+            x = b->p1X + FX_PADDLE_WIDTH + FX_ONE;
+            vx += (vx > 0) ? FX_ONE : -FX_ONE;
+            if (vx > maxSpeed) vx = maxSpeed;
+            if (vx < -maxSpeed) vx = -maxSpeed;
+            b->hits[i]++;
+        }
+
+        PongFixed p2Y = b->p2Y[i];
+        if (x < b->p2X + FX_PADDLE_WIDTH && x + FX_BALL_SIZE > b->p2X && y < p2Y + FX_PADDLE_HEIGHT && y + FX_BALL_SIZE > p2Y) {
+            vx = -vx;
+            x = b->p2X - FX_BALL_SIZE - FX_ONE;
+            b->hits[i]++;
+        }
+
+        if (b->p1Y[i] < 0) b->p1Y[i] = 0;
+        if (b->p1Y[i] > maxPaddleY) b->p1Y[i] = maxPaddleY;
+        if (b->p2Y[i] < 0) b->p2Y[i] = 0;
+        if (b->p2Y[i] > maxPaddleY) b->p2Y[i] = maxPaddleY;
+
+        b->ballX[i] = x; b->ballY[i] = y;
+        b->speedX[i] = vx; b->speedY[i] = vy;
+    }
+}
+
+#ifdef PONG_BATCH_X86
+
+// ---------------------------------------------------------------------------
+// SSE2 fixed-point kernel. SSE2 has no signed 32-bit min/max or multiply, so
+// those are built from compares and the unsigned 32x32->64 multiply.
+// ---------------------------------------------------------------------------
+
+static inline __m128i Sse_SelectI(__m128i mask, __m128i a, __m128i b) {
+    return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+static inline __m128i Sse_MinI(__m128i a, __m128i b) {
+    return Sse_SelectI(_mm_cmplt_epi32(a, b), a, b);
+}
+
+static inline __m128i Sse_MaxI(__m128i a, __m128i b) {
+    return Sse_SelectI(_mm_cmpgt_epi32(a, b), a, b);
+}
+
+// Bits 16..47 of the unsigned products, minus the signed correction
+// ((a < 0 ? b : 0) + (b < 0 ? a : 0)) << 32 shifted down with them
+static inline __m128i Sse_MulFixed(__m128i a, __m128i b) {
+    __m128i even = _mm_srli_epi64(_mm_mul_epu32(a, b), PONG_FIXED_SHIFT);
+    __m128i odd = _mm_srli_epi64(_mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32)), PONG_FIXED_SHIFT);
+    __m128i r = _mm_or_si128(_mm_and_si128(even, _mm_set_epi32(0, -1, 0, -1)), _mm_slli_epi64(odd, 32));
+    __m128i correction = _mm_add_epi32(_mm_and_si128(_mm_srai_epi32(a, 31), b), _mm_and_si128(_mm_srai_epi32(b, 31), a));
+    return _mm_sub_epi32(r, _mm_slli_epi32(correction, PONG_FIXED_SHIFT));
+}
+
+static inline __m128i Sse_FixedNoise(__m128i x) {
+    return _mm_sub_epi32(_mm_srli_epi32(x, 16), _mm_set1_epi32(FX_ONE / 2));
+}
+
+static inline void Sse_FixedAI(PongFixed* yPtr, PongFixed* targetPtr, PongFixed* reactionPtr, __m128i difficulty,
+                               __m128i ballY, __m128i noise, __m128i dt, __m128i frames, __m128i smoothing, __m128i height) {
+    __m128i y = _mm_load_si128((const __m128i*)yPtr);
+    __m128i target = _mm_load_si128((const __m128i*)targetPtr);
+    __m128i reaction = _mm_add_epi32(_mm_load_si128((const __m128i*)reactionPtr), dt);
+
+    __m128i fire = _mm_cmpgt_epi32(reaction, _mm_set1_epi32(FX_REACTION_DELAY - 1));
+    __m128i maxError = Sse_MulFixed(_mm_set1_epi32(PONG_FX_INT(100)), _mm_sub_epi32(_mm_set1_epi32(FX_ONE), difficulty));
+    __m128i t = _mm_add_epi32(_mm_add_epi32(ballY, _mm_set1_epi32(FX_BALL_RADIUS)), Sse_MulFixed(noise, maxError));
+    t = Sse_MaxI(t, _mm_set1_epi32(FX_HALF_PADDLE));
+    t = Sse_MinI(t, _mm_sub_epi32(height, _mm_set1_epi32(FX_HALF_PADDLE)));
+    target = Sse_SelectI(fire, t, target);
+    reaction = _mm_andnot_si128(fire, reaction);
+
+    __m128i aiSpeed = Sse_MulFixed(_mm_add_epi32(_mm_set1_epi32(PONG_FX_INT(5)), _mm_slli_epi32(difficulty, 2)), frames);
+    __m128i diff = _mm_sub_epi32(target, _mm_add_epi32(y, _mm_set1_epi32(FX_HALF_PADDLE)));
+    __m128i moveStep = Sse_MulFixed(diff, smoothing);
+    moveStep = Sse_MinI(moveStep, aiSpeed);
+    moveStep = Sse_MaxI(moveStep, _mm_sub_epi32(_mm_setzero_si128(), aiSpeed));
+    __m128i moving = _mm_or_si128(_mm_cmpgt_epi32(diff, _mm_set1_epi32(FX_MOVE_EPSILON)), _mm_cmplt_epi32(diff, _mm_set1_epi32(-FX_MOVE_EPSILON)));
+    y = _mm_add_epi32(y, _mm_and_si128(moving, moveStep));
+
+    _mm_store_si128((__m128i*)yPtr, y);
+    _mm_store_si128((__m128i*)targetPtr, target);
+    _mm_store_si128((__m128i*)reactionPtr, reaction);
+}
+
+static void FixedStepSSE2(PongFixedBatch* b, PongFixed dt, PongFixed frameScale, PongFixed smoothingFactor) {
+    const __m128i vdt = _mm_set1_epi32(dt);
+    const __m128i frames = _mm_set1_epi32(frameScale);
+    const __m128i smoothing = _mm_set1_epi32(smoothingFactor);
+    const __m128i width = _mm_set1_epi32(b->arenaWidth);
+    const __m128i height = _mm_set1_epi32(b->arenaHeight);
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i ballSize = _mm_set1_epi32(FX_BALL_SIZE);
+    const __m128i paddleW = _mm_set1_epi32(FX_PADDLE_WIDTH);
+    const __m128i paddleH = _mm_set1_epi32(FX_PADDLE_HEIGHT);
+    const __m128i p1X = _mm_set1_epi32(b->p1X);
+    const __m128i p2X = _mm_set1_epi32(b->p2X);
+    const __m128i baseSpeed = _mm_set1_epi32(PONG_FX(BASE_BALL_SPEED));
+    const __m128i maxSpeed = _mm_set1_epi32(PONG_FX(MAX_BALL_SPEED));
+    const __m128i one = _mm_set1_epi32(FX_ONE);
+    const __m128i centerX = _mm_set1_epi32(b->arenaWidth/2);
+    const __m128i centerY = _mm_set1_epi32(b->arenaHeight/2);
+    const __m128i paddleY = _mm_set1_epi32(b->arenaHeight/2 - FX_HALF_PADDLE);
+    const __m128i maxPaddleY = _mm_set1_epi32(b->arenaHeight - FX_PADDLE_HEIGHT);
+
+    for (int i = 0; i < b->count; i += 4) {
+        __m128i r1 = Sse_XorShift(_mm_load_si128((const __m128i*)&b->rng[i]));
+        __m128i r2 = Sse_XorShift(r1);
+        _mm_store_si128((__m128i*)&b->rng[i], r2);
+
+        __m128i ballY = _mm_load_si128((const __m128i*)&b->ballY[i]);
+        Sse_FixedAI(&b->p1Y[i], &b->target1[i], &b->reaction1[i], _mm_load_si128((const __m128i*)&b->difficulty1[i]), ballY, Sse_FixedNoise(r1), vdt, frames, smoothing, height);
+        Sse_FixedAI(&b->p2Y[i], &b->target2[i], &b->reaction2[i], _mm_load_si128((const __m128i*)&b->difficulty2[i]), ballY, Sse_FixedNoise(r2), vdt, frames, smoothing, height);
+
+        __m128i vx = _mm_load_si128((const __m128i*)&b->speedX[i]);
+        __m128i vy = _mm_load_si128((const __m128i*)&b->speedY[i]);
+        __m128i x = _mm_add_epi32(_mm_load_si128((const __m128i*)&b->ballX[i]), Sse_MulFixed(vx, frames));
+        __m128i y = _mm_add_epi32(ballY, Sse_MulFixed(vy, frames));
+
+        // y <= 0 or y + size >= height
+        __m128i wall = _mm_or_si128(_mm_cmplt_epi32(y, _mm_set1_epi32(1)),
+                                    _mm_cmpgt_epi32(_mm_add_epi32(y, ballSize), _mm_sub_epi32(height, _mm_set1_epi32(1))));
+        vy = Sse_SelectI(wall, _mm_sub_epi32(zero, vy), vy);
+
+        // Scoring
+        __m128i goalLeft = _mm_cmplt_epi32(x, zero);
+        __m128i goalRight = _mm_cmpgt_epi32(x, width);
+        __m128i goal = _mm_or_si128(goalLeft, goalRight);
+        __m128i s1 = _mm_load_si128((const __m128i*)&b->score1[i]);
+        __m128i s2 = _mm_load_si128((const __m128i*)&b->score2[i]);
+        _mm_store_si128((__m128i*)&b->score1[i], _mm_sub_epi32(s1, _mm_andnot_si128(goalLeft, goalRight)));
+        _mm_store_si128((__m128i*)&b->score2[i], _mm_sub_epi32(s2, goalLeft));
+        x = Sse_SelectI(goal, centerX, x);
+        y = Sse_SelectI(goal, centerY, y);
+        vx = Sse_SelectI(goal, baseSpeed, vx);
+        vy = Sse_SelectI(goal, baseSpeed, vy);
+        __m128i p1Y = Sse_SelectI(goal, paddleY, _mm_load_si128((const __m128i*)&b->p1Y[i]));
+        __m128i p2Y = Sse_SelectI(goal, paddleY, _mm_load_si128((const __m128i*)&b->p2Y[i]));
+        _mm_store_si128((__m128i*)&b->target1[i], Sse_SelectI(goal, centerY, _mm_load_si128((const __m128i*)&b->target1[i])));
+        _mm_store_si128((__m128i*)&b->target2[i], Sse_SelectI(goal, centerY, _mm_load_si128((const __m128i*)&b->target2[i])));
+        _mm_store_si128((__m128i*)&b->reaction1[i], _mm_andnot_si128(goal, _mm_load_si128((const __m128i*)&b->reaction1[i])));
+        _mm_store_si128((__m128i*)&b->reaction2[i], _mm_andnot_si128(goal, _mm_load_si128((const __m128i*)&b->reaction2[i])));
+
+        __m128i hits = _mm_load_si128((const __m128i*)&b->hits[i]);
+
+        // Player 1 collision
+        __m128i hit1 = _mm_and_si128(_mm_and_si128(_mm_cmplt_epi32(x, _mm_add_epi32(p1X, paddleW)), _mm_cmpgt_epi32(_mm_add_epi32(x, ballSize), p1X)),
+                                     _mm_and_si128(_mm_cmplt_epi32(y, _mm_add_epi32(p1Y, paddleH)), _mm_cmpgt_epi32(_mm_add_epi32(y, ballSize), p1Y)));
+        __m128i bounced = _mm_sub_epi32(zero, vx);
+        bounced = _mm_add_epi32(bounced, Sse_SelectI(_mm_cmpgt_epi32(bounced, zero), one, _mm_sub_epi32(zero, one)));
+        bounced = Sse_MaxI(Sse_MinI(bounced, maxSpeed), _mm_sub_epi32(zero, maxSpeed));
+        vx = Sse_SelectI(hit1, bounced, vx);
+        x = Sse_SelectI(hit1, _mm_add_epi32(_mm_add_epi32(p1X, paddleW), one), x);
+        hits = _mm_sub_epi32(hits, hit1);
+
+        // Player 2 collision
+        __m128i hit2 = _mm_and_si128(_mm_and_si128(_mm_cmplt_epi32(x, _mm_add_epi32(p2X, paddleW)), _mm_cmpgt_epi32(_mm_add_epi32(x, ballSize), p2X)),
+                                     _mm_and_si128(_mm_cmplt_epi32(y, _mm_add_epi32(p2Y, paddleH)), _mm_cmpgt_epi32(_mm_add_epi32(y, ballSize), p2Y)));
+        vx = Sse_SelectI(hit2, _mm_sub_epi32(zero, vx), vx);
+        x = Sse_SelectI(hit2, _mm_sub_epi32(_mm_sub_epi32(p2X, ballSize), one), x);
+        hits = _mm_sub_epi32(hits, hit2);
+        _mm_store_si128((__m128i*)&b->hits[i], hits);
+
+        // Clamping
+        _mm_store_si128((__m128i*)&b->p1Y[i], Sse_MinI(Sse_MaxI(p1Y, zero), maxPaddleY));
+        _mm_store_si128((__m128i*)&b->p2Y[i], Sse_MinI(Sse_MaxI(p2Y, zero), maxPaddleY));
+        _mm_store_si128((__m128i*)&b->ballX[i], x);
+        _mm_store_si128((__m128i*)&b->ballY[i], y);
+        _mm_store_si128((__m128i*)&b->speedX[i], vx);
+        _mm_store_si128((__m128i*)&b->speedY[i], vy);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// AVX2 fixed-point kernel (8 matches per iteration)
+// ---------------------------------------------------------------------------
+
+// Signed 32x32->64 products of the even and odd lanes, bits 16..47 of each
+PONG_TARGET_AVX2 static inline __m256i Avx_MulFixed(__m256i a, __m256i b) {
+    __m256i even = _mm256_srli_epi64(_mm256_mul_epi32(a, b), PONG_FIXED_SHIFT);
+    __m256i odd = _mm256_srli_epi64(_mm256_mul_epi32(_mm256_srli_epi64(a, 32), _mm256_srli_epi64(b, 32)), PONG_FIXED_SHIFT);
+    return _mm256_blend_epi32(even, _mm256_slli_epi64(odd, 32), 0xAA);
+}
+
+PONG_TARGET_AVX2 static inline __m256i Avx_SelectI(__m256i mask, __m256i a, __m256i b) {
+    return _mm256_blendv_epi8(b, a, mask);
+}
+
+PONG_TARGET_AVX2 static inline __m256i Avx_FixedNoise(__m256i x) {
+    return _mm256_sub_epi32(_mm256_srli_epi32(x, 16), _mm256_set1_epi32(FX_ONE / 2));
+}
+
+PONG_TARGET_AVX2 static inline void Avx_FixedAI(PongFixed* yPtr, PongFixed* targetPtr, PongFixed* reactionPtr, __m256i difficulty,
+                                                __m256i ballY, __m256i noise, __m256i dt, __m256i frames, __m256i smoothing, __m256i height) {
+    __m256i y = _mm256_load_si256((const __m256i*)yPtr);
+    __m256i target = _mm256_load_si256((const __m256i*)targetPtr);
+    __m256i reaction = _mm256_add_epi32(_mm256_load_si256((const __m256i*)reactionPtr), dt);
+
+    __m256i fire = _mm256_cmpgt_epi32(reaction, _mm256_set1_epi32(FX_REACTION_DELAY - 1));
+    __m256i maxError = Avx_MulFixed(_mm256_set1_epi32(PONG_FX_INT(100)), _mm256_sub_epi32(_mm256_set1_epi32(FX_ONE), difficulty));
+    __m256i t = _mm256_add_epi32(_mm256_add_epi32(ballY, _mm256_set1_epi32(FX_BALL_RADIUS)), Avx_MulFixed(noise, maxError));
+    t = _mm256_max_epi32(t, _mm256_set1_epi32(FX_HALF_PADDLE));
+    t = _mm256_min_epi32(t, _mm256_sub_epi32(height, _mm256_set1_epi32(FX_HALF_PADDLE)));
+    target = Avx_SelectI(fire, t, target);
+    reaction = _mm256_andnot_si256(fire, reaction);
+
+    __m256i aiSpeed = Avx_MulFixed(_mm256_add_epi32(_mm256_set1_epi32(PONG_FX_INT(5)), _mm256_slli_epi32(difficulty, 2)), frames);
+    __m256i diff = _mm256_sub_epi32(target, _mm256_add_epi32(y, _mm256_set1_epi32(FX_HALF_PADDLE)));
+    __m256i moveStep = Avx_MulFixed(diff, smoothing);
+    moveStep = _mm256_min_epi32(moveStep, aiSpeed);
+    moveStep = _mm256_max_epi32(moveStep, _mm256_sub_epi32(_mm256_setzero_si256(), aiSpeed));
+    __m256i moving = _mm256_or_si256(_mm256_cmpgt_epi32(diff, _mm256_set1_epi32(FX_MOVE_EPSILON)),
+                                     _mm256_cmpgt_epi32(_mm256_set1_epi32(-FX_MOVE_EPSILON), diff));
+    y = _mm256_add_epi32(y, _mm256_and_si256(moving, moveStep));
+
+    _mm256_store_si256((__m256i*)yPtr, y);
+    _mm256_store_si256((__m256i*)targetPtr, target);
+    _mm256_store_si256((__m256i*)reactionPtr, reaction);
+}
+
+PONG_TARGET_AVX2 static void FixedStepAVX2(PongFixedBatch* b, PongFixed dt, PongFixed frameScale, PongFixed smoothingFactor) {
+    const __m256i vdt = _mm256_set1_epi32(dt);
+    const __m256i frames = _mm256_set1_epi32(frameScale);
+    const __m256i smoothing = _mm256_set1_epi32(smoothingFactor);
+    const __m256i width = _mm256_set1_epi32(b->arenaWidth);
+    const __m256i height = _mm256_set1_epi32(b->arenaHeight);
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i ballSize = _mm256_set1_epi32(FX_BALL_SIZE);
+    const __m256i paddleW = _mm256_set1_epi32(FX_PADDLE_WIDTH);
+    const __m256i paddleH = _mm256_set1_epi32(FX_PADDLE_HEIGHT);
+    const __m256i p1X = _mm256_set1_epi32(b->p1X);
+    const __m256i p2X = _mm256_set1_epi32(b->p2X);
+    const __m256i baseSpeed = _mm256_set1_epi32(PONG_FX(BASE_BALL_SPEED));
+    const __m256i maxSpeed = _mm256_set1_epi32(PONG_FX(MAX_BALL_SPEED));
+    const __m256i one = _mm256_set1_epi32(FX_ONE);
+    const __m256i centerX = _mm256_set1_epi32(b->arenaWidth/2);
+    const __m256i centerY = _mm256_set1_epi32(b->arenaHeight/2);
+    const __m256i paddleY = _mm256_set1_epi32(b->arenaHeight/2 - FX_HALF_PADDLE);
+    const __m256i maxPaddleY = _mm256_set1_epi32(b->arenaHeight - FX_PADDLE_HEIGHT);
+
+    for (int i = 0; i < b->count; i += 8) {
+        __m256i r1 = Avx_XorShift(_mm256_load_si256((const __m256i*)&b->rng[i]));
+        __m256i r2 = Avx_XorShift(r1);
+        _mm256_store_si256((__m256i*)&b->rng[i], r2);
+
+        __m256i ballY = _mm256_load_si256((const __m256i*)&b->ballY[i]);
+        Avx_FixedAI(&b->p1Y[i], &b->target1[i], &b->reaction1[i], _mm256_load_si256((const __m256i*)&b->difficulty1[i]), ballY, Avx_FixedNoise(r1), vdt, frames, smoothing, height);
+        Avx_FixedAI(&b->p2Y[i], &b->target2[i], &b->reaction2[i], _mm256_load_si256((const __m256i*)&b->difficulty2[i]), ballY, Avx_FixedNoise(r2), vdt, frames, smoothing, height);
+
+        __m256i vx = _mm256_load_si256((const __m256i*)&b->speedX[i]);
+        __m256i vy = _mm256_load_si256((const __m256i*)&b->speedY[i]);
+        __m256i x = _mm256_add_epi32(_mm256_load_si256((const __m256i*)&b->ballX[i]), Avx_MulFixed(vx, frames));
+        __m256i y = _mm256_add_epi32(ballY, Avx_MulFixed(vy, frames));
+
+        // y <= 0 or y + size >= height
+        __m256i wall = _mm256_or_si256(_mm256_cmpgt_epi32(_mm256_set1_epi32(1), y),
+                                       _mm256_cmpgt_epi32(_mm256_add_epi32(y, ballSize), _mm256_sub_epi32(height, _mm256_set1_epi32(1))));
+        vy = Avx_SelectI(wall, _mm256_sub_epi32(zero, vy), vy);
+
+        // Scoring
+        __m256i goalLeft = _mm256_cmpgt_epi32(zero, x);
+        __m256i goalRight = _mm256_cmpgt_epi32(x, width);
+        __m256i goal = _mm256_or_si256(goalLeft, goalRight);
+        __m256i s1 = _mm256_load_si256((const __m256i*)&b->score1[i]);
+        __m256i s2 = _mm256_load_si256((const __m256i*)&b->score2[i]);
+        _mm256_store_si256((__m256i*)&b->score1[i], _mm256_sub_epi32(s1, _mm256_andnot_si256(goalLeft, goalRight)));
+        _mm256_store_si256((__m256i*)&b->score2[i], _mm256_sub_epi32(s2, goalLeft));
+        x = Avx_SelectI(goal, centerX, x);
+        y = Avx_SelectI(goal, centerY, y);
+        vx = Avx_SelectI(goal, baseSpeed, vx);
+        vy = Avx_SelectI(goal, baseSpeed, vy);
+        __m256i p1Y = Avx_SelectI(goal, paddleY, _mm256_load_si256((const __m256i*)&b->p1Y[i]));
+        __m256i p2Y = Avx_SelectI(goal, paddleY, _mm256_load_si256((const __m256i*)&b->p2Y[i]));
+        _mm256_store_si256((__m256i*)&b->target1[i], Avx_SelectI(goal, centerY, _mm256_load_si256((const __m256i*)&b->target1[i])));
+        _mm256_store_si256((__m256i*)&b->target2[i], Avx_SelectI(goal, centerY, _mm256_load_si256((const __m256i*)&b->target2[i])));
+        _mm256_store_si256((__m256i*)&b->reaction1[i], _mm256_andnot_si256(goal, _mm256_load_si256((const __m256i*)&b->reaction1[i])));
+        _mm256_store_si256((__m256i*)&b->reaction2[i], _mm256_andnot_si256(goal, _mm256_load_si256((const __m256i*)&b->reaction2[i])));
+
+        __m256i hits = _mm256_load_si256((const __m256i*)&b->hits[i]);
+
+        // Player 1 collision
+        __m256i hit1 = _mm256_and_si256(
+            _mm256_and_si256(_mm256_cmpgt_epi32(_mm256_add_epi32(p1X, paddleW), x), _mm256_cmpgt_epi32(_mm256_add_epi32(x, ballSize), p1X)),
+            _mm256_and_si256(_mm256_cmpgt_epi32(_mm256_add_epi32(p1Y, paddleH), y), _mm256_cmpgt_epi32(_mm256_add_epi32(y, ballSize), p1Y)));
+        __m256i bounced = _mm256_sub_epi32(zero, vx);
+        bounced = _mm256_add_epi32(bounced, Avx_SelectI(_mm256_cmpgt_epi32(bounced, zero), one, _mm256_sub_epi32(zero, one)));
+        bounced = _mm256_max_epi32(_mm256_min_epi32(bounced, maxSpeed), _mm256_sub_epi32(zero, maxSpeed));
+        vx = Avx_SelectI(hit1, bounced, vx);
+        x = Avx_SelectI(hit1, _mm256_add_epi32(_mm256_add_epi32(p1X, paddleW), one), x);
+        hits = _mm256_sub_epi32(hits, hit1);
+
+        // Player 2 collision
+        __m256i hit2 = _mm256_and_si256(
+            _mm256_and_si256(_mm256_cmpgt_epi32(_mm256_add_epi32(p2X, paddleW), x), _mm256_cmpgt_epi32(_mm256_add_epi32(x, ballSize), p2X)),
+            _mm256_and_si256(_mm256_cmpgt_epi32(_mm256_add_epi32(p2Y, paddleH), y), _mm256_cmpgt_epi32(_mm256_add_epi32(y, ballSize), p2Y)));
+        vx = Avx_SelectI(hit2, _mm256_sub_epi32(zero, vx), vx);
+        x = Avx_SelectI(hit2, _mm256_sub_epi32(_mm256_sub_epi32(p2X, ballSize), one), x);
+        hits = _mm256_sub_epi32(hits, hit2);
+        _mm256_store_si256((__m256i*)&b->hits[i], hits);
+
+        // Clamping
+        _mm256_store_si256((__m256i*)&b->p1Y[i], _mm256_min_epi32(_mm256_max_epi32(p1Y, zero), maxPaddleY));
+        _mm256_store_si256((__m256i*)&b->p2Y[i], _mm256_min_epi32(_mm256_max_epi32(p2Y, zero), maxPaddleY));
+        _mm256_store_si256((__m256i*)&b->ballX[i], x);
+        _mm256_store_si256((__m256i*)&b->ballY[i], y);
+        _mm256_store_si256((__m256i*)&b->speedX[i], vx);
+        _mm256_store_si256((__m256i*)&b->speedY[i], vy);
+    }
+}
+
+#endif
+
+void PongFixedBatch_Step(PongFixedBatch* b, float dt, PongBatchKernel kernel) {
+    if (kernel == PONG_BATCH_AUTO || !PongBatch_KernelSupported(kernel)) kernel = PongBatch_BestKernel();
+
+    PongFixed fdt = PongFixed_FromFloat(dt);
+    PongFixed frames = fdt * (int)PONG_REFERENCE_HZ;
+    PongFixed smoothing = PongFixed_Damping(frames);
+
+    switch (kernel) {
+#ifdef PONG_BATCH_X86
+        case PONG_BATCH_SSE2: FixedStepSSE2(b, fdt, frames, smoothing); break;
+        case PONG_BATCH_AVX2: FixedStepAVX2(b, fdt, frames, smoothing); break;
+#endif
+        default: FixedStepScalar(b, fdt, frames, smoothing); break;
+    }
+}
+
+unsigned long long PongFixedBatch_Hash(const PongFixedBatch* b) {
+    unsigned long long h = 14695981039346656037ULL;
+    size_t n = (size_t)b->count;
+    h = HashBytes(h, b->ballX, n * sizeof(PongFixed));
+    h = HashBytes(h, b->ballY, n * sizeof(PongFixed));
+    h = HashBytes(h, b->speedX, n * sizeof(PongFixed));
+    h = HashBytes(h, b->speedY, n * sizeof(PongFixed));
+    h = HashBytes(h, b->p1Y, n * sizeof(PongFixed));
+    h = HashBytes(h, b->p2Y, n * sizeof(PongFixed));
+    h = HashBytes(h, b->score1, n * sizeof(int));
+    h = HashBytes(h, b->score2, n * sizeof(int));
+    h = HashBytes(h, b->hits, n * sizeof(int));
+    return h;
+}
@@ -0,0 +1,99 @@
+#ifndef PONG_BATCH_H
+#define PONG_BATCH_H
+#include <stdbool.h>
+#include "pong_fixed.h"
+
+// Structure-of-arrays batch of independent AI-vs-AI matches for balance
+// sweeps. Every match plays in a fixed (already expanded) arena; both paddles
+// use the proportional-damping AI from section 3B with a per-match difficulty.
+// All kernels produce bit-identical results, only the throughput differs.
+//
+// Collision here is a discrete overlap test rather than the swept test in
+// Pong_UpdatePhysics. At PONG_FIXED_DT the ball moves at most
+// MAX_BALL_SPEED / 4 = 3.5 px per step, well under PADDLE_WIDTH, so it cannot
+// tunnel as long as the batch is stepped at the fixed rate.
+
+typedef enum {
+    PONG_BATCH_AUTO,
+    PONG_BATCH_SCALAR,
+    PONG_BATCH_SSE2,
+    PONG_BATCH_AVX2
+} PongBatchKernel;
+
+typedef struct {
+    int count;      // Number of matches
+    int capacity;   // count rounded up to the widest SIMD lane count
+    float arenaWidth, arenaHeight;
+    float p1X, p2X;
+
+    float* ballX;
+    float* ballY;
+    float* speedX;
+    float* speedY;
+    float* p1Y;
+    float* p2Y;
+    float* target1;
+    float* target2;
+    float* reaction1;
+    float* reaction2;
+    float* difficulty1;     // Skill of the left paddle, 0..1
+    float* difficulty2;     // Skill of the right paddle, 0..1
+    unsigned int* rng;      // Per-match xorshift32 state
+    int* score1;
+    int* score2;
+    int* hits;              // Paddle hits, both sides
+
+    void* memory;
+} PongBatch;
+
+bool PongBatch_Init(PongBatch* b, int count, float arenaWidth, float arenaHeight, unsigned int seed);
+void PongBatch_Free(PongBatch* b);
+
+// Resets every match to the serve position, keeping difficulties and scores
+void PongBatch_ResetAll(PongBatch* b);
+
+void PongBatch_Step(PongBatch* b, float dt, PongBatchKernel kernel);
+
+PongBatchKernel PongBatch_BestKernel(void);
+bool PongBatch_KernelSupported(PongBatchKernel kernel);
+const char* PongBatch_KernelName(PongBatchKernel kernel);
+
+// FNV-1a over all per-match arrays, used to check kernels against each other
+unsigned long long PongBatch_Hash(const PongBatch* b);
+
+// The same batch in 16.16 fixed point (pong_fixed.h). Same rules and the
+// same kernel choice, on integer lanes: the hash then also matches across
+// compilers and flags, not just across kernels.
+typedef struct {
+    int count;
+    int capacity;
+    PongFixed arenaWidth, arenaHeight;
+    PongFixed p1X, p2X;
+
+    PongFixed* ballX;
+    PongFixed* ballY;
+    PongFixed* speedX;
+    PongFixed* speedY;
+    PongFixed* p1Y;
+    PongFixed* p2Y;
+    PongFixed* target1;
+    PongFixed* target2;
+    PongFixed* reaction1;
+    PongFixed* reaction2;
+    PongFixed* difficulty1;
+    PongFixed* difficulty2;
+    unsigned int* rng;
+    int* score1;
+    int* score2;
+    int* hits;
+
+    void* memory;
+} PongFixedBatch;
+
+bool PongFixedBatch_Init(PongFixedBatch* b, int count, float arenaWidth, float arenaHeight, unsigned int seed);
+void PongFixedBatch_Free(PongFixedBatch* b);
+void PongFixedBatch_ResetAll(PongFixedBatch* b);
+void PongFixedBatch_Step(PongFixedBatch* b, float dt, PongBatchKernel kernel);
+unsigned long long PongFixedBatch_Hash(const PongFixedBatch* b);
+
+#endif
@@ -0,0 +1,52 @@
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 199309L
+#endif
+#include "pong_clock.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#include <mmsystem.h>
+
+unsigned long long Pong_ClockNs(void) {
+    static LARGE_INTEGER frequency = { 0 };
+    LARGE_INTEGER counter;
+    if (frequency.QuadPart == 0) QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    // Split to avoid overflowing 64 bits on long uptimes
+    unsigned long long seconds = (unsigned long long)(counter.QuadPart / frequency.QuadPart);
+    unsigned long long rest = (unsigned long long)(counter.QuadPart % frequency.QuadPart);
+    return seconds * 1000000000ULL + rest * 1000000000ULL / (unsigned long long)frequency.QuadPart;
+}
+
+bool Pong_SleepNs(unsigned long long ns) {
+    static bool periodSet = false;
+    if (!periodSet) {
+        timeBeginPeriod(1);
+        periodSet = true;
+    }
+    DWORD ms = (DWORD)(ns / 1000000ULL);
+    if (ms == 0) return false;
+    Sleep(ms);
+    return true;
+}
+#else
+#include <time.h>
+
+unsigned long long Pong_ClockNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long)ts.tv_sec * 1000000000ULL + (unsigned long long)ts.tv_nsec;
+}
+
+bool Pong_SleepNs(unsigned long long ns) {
+    struct timespec ts;
+    ts.tv_sec = (time_t)(ns / 1000000000ULL);
+    ts.tv_nsec = (long)(ns % 1000000000ULL);
+    nanosleep(&ts, NULL);
+    return true;
+}
+#endif
+
+double Pong_ClockSeconds(void) {
+    return (double)Pong_ClockNs() * 1e-9;
+}
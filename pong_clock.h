@@ -0,0 +1,16 @@
+#ifndef PONG_CLOCK_H
+#define PONG_CLOCK_H
+#include <stdbool.h>
+
+// Monotonic high-resolution clock (QueryPerformanceCounter on Windows,
+// CLOCK_MONOTONIC elsewhere).
+unsigned long long Pong_ClockNs(void);
+double Pong_ClockSeconds(void);
+
+// Sleeps for about ns nanoseconds. The OS may oversleep by up to a scheduler
+// tick; callers that need precision sleep short and spin the rest (see
+// pong_pacer.h). On Windows the first call raises the timer resolution to 1 ms
+// and requests under 1 ms return at once. Returns false if it didn't sleep.
+bool Pong_SleepNs(unsigned long long ns);
+
+#endif
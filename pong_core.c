@@ -0,0 +1,613 @@
+#include "pong_core.h"
+#include "profiler.h"
+#include "analytics.h"
+#include <string.h>
+#include <stddef.h>
+#include <math.h>
+
+static unsigned int Pong_NextRandom(PongState* s) {
+    unsigned long long x = s->rngState;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    s->rngState = x;
+    return (unsigned int)((x * 2685821657736338717ULL) >> 32);
+}
+
+int Pong_RandomInt(PongState* s, int min, int max) {
+    if (min > max) { int tmp = max; max = min; min = tmp; }
+    unsigned int range = (unsigned int)(max - min) + 1u;
+    return min + (int)(Pong_NextRandom(s) % range);
+}
+
+void Pong_DefaultAIParams(PongAIParams* params) {
+    params->baseDifficulty = 0.7f;
+    params->scalingFactor = 0.03f;
+    params->difficultyCap = 0.95f;
+    params->scoreThreshold = 3.0f;
+    params->facilitateDifficulty = 0.4f;
+    params->reactionDelay = 0.2f;
+    params->maxErrorScale = 100.0f;
+    params->guaranteedHits = 2;
+}
+
+void Pong_Init(PongState* s, float windowX, float windowY, int monitorW, int monitorH, unsigned long long seed) {
+    *s = (PongState){ 0 };
+    // xorshift must never hold zero
+    s->rngState = seed ? seed : 0x9E3779B97F4A7C15ULL;
+
+    s->currentArena = (Arena){ windowX, windowY, (float)INITIAL_WIDTH, (float)INITIAL_HEIGHT };
+    s->startArena = s->currentArena;
+    s->targetArena = (Arena){ 0, 0, (float)monitorW, (float)monitorH };
+
+    s->windowStartPos = (PongVec2){ 0, 0 };
+    s->windowTargetPos = (PongVec2){ monitorW/2.0f - INITIAL_WIDTH/2.0f, monitorH/2.0f - INITIAL_HEIGHT/2.0f };
+    s->windowPos = (PongVec2){ windowX, windowY };
+
+    s->p1 = (PongRect){ 50, INITIAL_HEIGHT/2.0f - PADDLE_HEIGHT/2.0f, PADDLE_WIDTH, PADDLE_HEIGHT };
+    s->p2 = (PongRect){ INITIAL_WIDTH - 50 - PADDLE_WIDTH, INITIAL_HEIGHT/2.0f - PADDLE_HEIGHT/2.0f, PADDLE_WIDTH, PADDLE_HEIGHT };
+    s->ballPos = (PongVec2){ INITIAL_WIDTH / 2.0f, INITIAL_HEIGHT / 2.0f };
+    // Initializing with base speed
+    s->ballSpeed = (PongVec2){ BASE_BALL_SPEED, BASE_BALL_SPEED };
+
+    s->animDuration = 2.5f;
+    s->titleBarOffset = (float)TITLE_BAR_HEIGHT;
+    s->scorePop1 = 1.0f;
+    s->scorePop2 = 1.0f;
+    s->targetY = INITIAL_HEIGHT / 2.0f;
+    Pong_DefaultAIParams(&s->ai);
+}
+
+const size_t PONG_TWEEN_OFFSETS[PONG_TWEEN_PROP_COUNT] = {
+    offsetof(PongState, currentArena.x), offsetof(PongState, currentArena.y),
+    offsetof(PongState, currentArena.width), offsetof(PongState, currentArena.height),
+    offsetof(PongState, windowPos.x), offsetof(PongState, windowPos.y),
+    offsetof(PongState, titleBarOffset),
+    offsetof(PongState, scorePop1), offsetof(PongState, scorePop2),
+};
+
+// Every property of the arena expansion, in one tween group. The tweens
+// start where the expansion clock is, so a game saved mid-expansion by a
+// build without tweens still finishes it.
+static void Pong_StartExpansion(PongState* s) {
+    PongTweens* tw = &s->tweens;
+    float d = s->animDuration;
+    int first = tw->count;
+    PongTween_Add(tw, PONG_TWEEN_ARENA_X, s->startArena.x, s->targetArena.x, d, 0.0f, PONG_EASE_IN_OUT_CUBIC, 0, PONG_TWEEN_GROUP_EXPAND);
+    PongTween_Add(tw, PONG_TWEEN_ARENA_Y, s->startArena.y, s->targetArena.y, d, 0.0f, PONG_EASE_IN_OUT_CUBIC, 0, PONG_TWEEN_GROUP_EXPAND);
+    PongTween_Add(tw, PONG_TWEEN_ARENA_W, s->startArena.width, s->targetArena.width, d, 0.0f, PONG_EASE_IN_OUT_CUBIC, 0, PONG_TWEEN_GROUP_EXPAND);
+    PongTween_Add(tw, PONG_TWEEN_ARENA_H, s->startArena.height, s->targetArena.height, d, 0.0f, PONG_EASE_IN_OUT_CUBIC, 0, PONG_TWEEN_GROUP_EXPAND);
+    PongTween_Add(tw, PONG_TWEEN_WINDOW_X, s->windowStartPos.x, s->windowTargetPos.x, d, 0.0f, PONG_EASE_IN_OUT_CUBIC, PONG_TWEEN_TRUNCATE, PONG_TWEEN_GROUP_EXPAND);
+    PongTween_Add(tw, PONG_TWEEN_WINDOW_Y, s->windowStartPos.y, s->windowTargetPos.y, d, 0.0f, PONG_EASE_IN_OUT_CUBIC, PONG_TWEEN_TRUNCATE, PONG_TWEEN_GROUP_EXPAND);
+    PongTween_Add(tw, PONG_TWEEN_TITLE_BAR, (float)TITLE_BAR_HEIGHT, 0.0f, d, 0.0f, PONG_EASE_IN_OUT_CUBIC, 0, PONG_TWEEN_GROUP_EXPAND);
+    for (int i = first; i < tw->count; i++) tw->elapsed[i] = s->animTimer;
+}
+
+// The score jumps up, then settles back with a wobble. A goal during the
+// previous pop restarts it.
+void Pong_StartScorePop(PongState* s, int player) {
+    PongTweens* tw = &s->tweens;
+    int group = (player == 1) ? PONG_TWEEN_GROUP_POP1 : PONG_TWEEN_GROUP_POP2;
+    int target = (player == 1) ? PONG_TWEEN_SCORE_POP1 : PONG_TWEEN_SCORE_POP2;
+    PongTween_CancelGroup(tw, group);
+    PongTween_Add(tw, target, 1.0f, 1.5f, 0.08f, 0.0f, PONG_EASE_OUT_CUBIC, 0, group);
+    PongTween_Add(tw, target, 1.5f, 1.0f, 0.5f, PongTween_GroupEnd(tw, group), PONG_EASE_OUT_ELASTIC, PONG_TWEEN_LUT, group);
+}
+
+// 1. ANIMATION AND LOCKING LOGIC
+void Pong_UpdateAnimation(PongState* s, const PongInput* in, float dt) {
+    if (s->isAnimating) {
+        if (!PongTween_GroupActive(&s->tweens, PONG_TWEEN_GROUP_EXPAND)) Pong_StartExpansion(s);
+        s->animTimer += dt;
+    }
+
+    // Expansion and score pops advance together
+    unsigned int finished = PongTween_Update(&s->tweens, s, PONG_TWEEN_OFFSETS, dt);
+
+    if (s->isAnimating) {
+        if (finished & (1u << PONG_TWEEN_GROUP_EXPAND)) {
+            s->isAnimating = false;
+            s->isExpanded = true;
+            s->isLocked = true;
+            s->windowPos = s->windowTargetPos;
+            s->events |= PONG_EVENT_EXPAND_DONE;
+        }
+
+        // Update Paddle Positions
+        s->p1.y = s->p1LockedWorldY - s->currentArena.y;
+        s->p2.y = s->p2LockedWorldY - s->currentArena.y;
+        s->p2.x = s->currentArena.width - 50 - PADDLE_WIDTH;
+    }
+    else if (s->isLocked) {
+        // LOCKING TO THE CENTER
+        s->windowPos = s->windowTargetPos;
+        s->currentArena = s->targetArena;
+    }
+    else if (!s->isExpanded) {
+        // Drag Synchronization (Initial Phase)
+        s->windowPos = (PongVec2){ in->windowX, in->windowY };
+        s->currentArena.x = in->windowX;
+        s->currentArena.y = in->windowY;
+    }
+}
+
+// 2. INPUT (Player 1, and player 2 in versus mode)
+void Pong_ApplyInput(PongState* s, const PongInput* in, float dt) {
+    float moveSpeed = 9.0f * dt * PONG_REFERENCE_HZ;
+    // A key pressed or released during the step moves the paddle for the
+    // part of the step it was held
+    float up = in->upHeld ? moveSpeed * (float)in->upHeld / PONG_INPUT_SUBSTEPS : moveSpeed;
+    float down = in->downHeld ? moveSpeed * (float)in->downHeld / PONG_INPUT_SUBSTEPS : moveSpeed;
+    if (in->keys & PONG_KEY_UP_ANY) {
+        s->p1.y -= up; s->gameStarted = true;
+        if (s->isAnimating || s->isLocked) s->p1LockedWorldY -= up;
+    }
+    if (in->keys & PONG_KEY_DOWN_ANY) {
+        s->p1.y += down; s->gameStarted = true;
+        if (s->isAnimating || s->isLocked) s->p1LockedWorldY += down;
+    }
+    if (!s->versus) return;
+
+    if (in->keys2 & (PONG_KEY_W | PONG_KEY_UP)) {
+        s->p2.y -= moveSpeed; s->gameStarted = true;
+        if (s->isAnimating || s->isLocked) s->p2LockedWorldY -= moveSpeed;
+    }
+    if (in->keys2 & (PONG_KEY_S | PONG_KEY_DOWN)) {
+        s->p2.y += moveSpeed; s->gameStarted = true;
+        if (s->isAnimating || s->isLocked) s->p2LockedWorldY += moveSpeed;
+    }
+}
+
+// 3A. ADAPTIVE DIFFICULTY CALCULATION BY SCORE
+float Pong_ComputeDifficulty(const PongState* s) {
+    const PongAIParams* ai = &s->ai;
+    float aiDifficulty;
+    float scoreDiff = (float)s->score1 - (float)s->score2;
+
+    if (s->aiHitsTotal <= ai->guaranteedHits) {
+        // 1. GUARANTEED INITIAL HIT
+        aiDifficulty = 1.0f;
+    }
+    else if (scoreDiff <= -ai->scoreThreshold) {
+        // 2. FACILITATE (Player 1 losing by the threshold or more)
+        aiDifficulty = ai->facilitateDifficulty;
+    }
+    else if (scoreDiff >= ai->scoreThreshold) {
+        // 3. INVINCIBLE (Player 1 winning by the threshold or more)
+        aiDifficulty = 1.0f;
+    }
+    else {
+        // 4. NORMAL PROGRESSIVE (Score is close)
+        float hitsForCalc = (float)(s->aiHitsTotal - ai->guaranteedHits);
+
+        aiDifficulty = ai->baseDifficulty + sqrtf(hitsForCalc) * ai->scalingFactor;
+        if (aiDifficulty > ai->difficultyCap) aiDifficulty = ai->difficultyCap;
+    }
+    return aiDifficulty;
+}
+
+float Pong_PredictInterceptY(PongVec2 ballPos, PongVec2 velocity, float targetX, float arenaHeight) {
+    float range = arenaHeight - BALL_SIZE;
+    if (range <= 0.0f) return 0.0f;
+
+    // Unfold the bounces: the path is a straight line in a mirrored arena of
+    // period 2 * range, then fold the result back into [0, range]
+    float t = (targetX - ballPos.x) / velocity.x;
+    float y = ballPos.y + velocity.y * t;
+    float period = 2.0f * range;
+    y = fmodf(y, period);
+    if (y < 0.0f) y += period;
+    if (y > range) y = period - y;
+    return y;
+}
+
+static void Pong_InvalidatePrediction(PongState* s) {
+    s->aiPredictionValid = false;
+    s->reactionTimer = 0.0f;
+}
+
+static void Pong_UpdateTarget(PongState* s) {
+    if (s->ballSpeed.x > 0.0f) {
+        float contactX = s->p2.x - BALL_SIZE;
+        s->aiInterceptY = Pong_PredictInterceptY(s->ballPos, s->ballSpeed, contactX, s->currentArena.height);
+    } else {
+        // Ball moving away: drift back towards the middle
+        s->aiInterceptY = s->currentArena.height / 2.0f - BALL_RADIUS;
+    }
+
+    s->targetY = s->aiInterceptY + BALL_RADIUS + s->aiErrorOffset;
+
+    float minTarget = PADDLE_HEIGHT / 2.0f;
+    float maxTarget = s->currentArena.height - PADDLE_HEIGHT / 2.0f;
+    if (s->targetY < minTarget) s->targetY = minTarget;
+    if (s->targetY > maxTarget) s->targetY = maxTarget;
+}
+
+// 3B. CONDITIONAL AI MOVEMENT LOGIC (P2)
+// The AI aims at the predicted intercept, which only changes when the ball's
+// velocity does. Lower difficulty means a later reaction to the new path and
+// more noise on where it aims.
+void Pong_UpdateAI(PongState* s, float dt) {
+    float frames = dt * PONG_REFERENCE_HZ;
+    s->aiDifficulty = Pong_ComputeDifficulty(s);
+
+    // Flag to check if the AI should be perfect (max difficulty)
+    bool isPerfect = (s->aiDifficulty == 1.0f);
+
+    // 1. Reaction Time: predict once the new trajectory has been "seen"
+    bool refresh = false;
+    if (!s->aiPredictionValid) {
+        s->reactionTimer += dt;
+        if (isPerfect || s->reactionTimer >= s->ai.reactionDelay) {
+            s->reactionTimer = 0.0f;
+            if (isPerfect) {
+                s->aiErrorOffset = 0.0f;
+            } else {
+                float maxError = s->ai.maxErrorScale * (1.0f - s->aiDifficulty);
+                s->aiErrorOffset = (float)Pong_RandomInt(s, -(int)maxError/2, (int)maxError/2);
+                Analytics_Emit(ANALYTICS_AIM, 2, s->rallyHits, s->frame, s->aiDifficulty, s->aiErrorOffset);
+            }
+            s->aiPredictionValid = true;
+            refresh = true;
+        }
+    }
+    // The arena (and paddle x) move while expanding, so re-fold every step
+    if (s->aiPredictionValid && (refresh || s->isAnimating)) Pong_UpdateTarget(s);
+
+    float centerP2 = s->p2.y + PADDLE_HEIGHT / 2.0f;
+    float diff = s->targetY - centerP2;
+    float moveStep;
+
+    if (isPerfect)
+    {
+        // ** PERFECT/INVINCIBLE LOGIC (Direct Movement) **
+        // Heads straight for the exact intercept at full speed
+        float aiSpeedPerfect = 9.5f * frames;
+        moveStep = diff;
+        if (moveStep > aiSpeedPerfect) moveStep = aiSpeedPerfect;
+        if (moveStep < -aiSpeedPerfect) moveStep = -aiSpeedPerfect;
+    }
+    else
+    {
+        // ** ADAPTIVE LOGIC: Proportional Smooth Movement (Damping) **
+        float aiSpeed = (5.0f + (4.0f * s->aiDifficulty)) * frames;
+        // 0.15 per 60 Hz frame, compounded over the length of this step
+        float smoothingFactor = 1.0f - powf(1.0f - 0.15f, frames);
+        moveStep = diff * smoothingFactor;
+
+        if (fabsf(moveStep) > aiSpeed) {
+            moveStep = (moveStep > 0) ? aiSpeed : -aiSpeed;
+        }
+    }
+
+    if (fabsf(diff) > 0.01f)
+    {
+        s->p2.y += moveStep;
+        if (s->isAnimating || s->isLocked) {
+            s->p2LockedWorldY += moveStep;
+        }
+    }
+}
+
+bool Pong_CheckPaddleHit(PongVec2 ballPos, PongRect paddle) {
+    return ballPos.x < paddle.x + paddle.width && ballPos.x + BALL_SIZE > paddle.x &&
+           ballPos.y < paddle.y + paddle.height && ballPos.y + BALL_SIZE > paddle.y;
+}
+
+bool Pong_SweepPaddleHit(PongVec2 ballPos, PongVec2 delta, PongRect paddle, float* toi) {
+    // Minkowski-expanded paddle: the ball's top-left corner must enter it
+    float minX = paddle.x - BALL_SIZE, maxX = paddle.x + paddle.width;
+    float minY = paddle.y - BALL_SIZE, maxY = paddle.y + paddle.height;
+
+    float enterX, exitX, enterY, exitY;
+    if (delta.x == 0.0f) {
+        if (ballPos.x <= minX || ballPos.x >= maxX) return false;
+        enterX = -INFINITY; exitX = INFINITY;
+    } else {
+        float t1 = (minX - ballPos.x) / delta.x;
+        float t2 = (maxX - ballPos.x) / delta.x;
+        enterX = fminf(t1, t2); exitX = fmaxf(t1, t2);
+    }
+    if (delta.y == 0.0f) {
+        if (ballPos.y <= minY || ballPos.y >= maxY) return false;
+        enterY = -INFINITY; exitY = INFINITY;
+    } else {
+        float t1 = (minY - ballPos.y) / delta.y;
+        float t2 = (maxY - ballPos.y) / delta.y;
+        enterY = fminf(t1, t2); exitY = fmaxf(t1, t2);
+    }
+
+    float enter = fmaxf(enterX, enterY);
+    float exit = fminf(exitX, exitY);
+    if (enter >= exit || enter > 1.0f || exit <= 0.0f) return false;
+
+    *toi = (enter < 0.0f) ? 0.0f : enter;
+    return true;
+}
+
+static void Pong_ResetPoint(PongState* s) {
+    s->ballPos = (PongVec2){ s->currentArena.width/2, s->currentArena.height/2 };
+    s->gameStarted = false;
+    s->playerHits = 0;
+    s->rallyHits = 0;
+
+    // Reset Paddle Positions and Speed
+    float paddleY = s->currentArena.height/2.0f - PADDLE_HEIGHT/2.0f;
+    s->p1.y = paddleY;
+    s->p2.y = paddleY;
+    s->p1LockedWorldY = s->currentArena.y + s->p1.y;
+    s->p2LockedWorldY = s->currentArena.y + s->p2.y;
+    s->targetY = s->currentArena.height/2.0f;
+    s->ballSpeed = (PongVec2){ BASE_BALL_SPEED, BASE_BALL_SPEED }; // Reset speed
+    Pong_InvalidatePrediction(s);
+}
+
+// Where the ball's center met the paddle: -1 at the top edge, 1 at the bottom
+static float Pong_HitContact(PongVec2 ballPos, PongRect paddle) {
+    float offset = ballPos.y + BALL_RADIUS - (paddle.y + PADDLE_HEIGHT / 2.0f);
+    return offset / (PADDLE_HEIGHT / 2.0f + BALL_RADIUS);
+}
+
+static void Pong_HitPlayer1(PongState* s, const PongInput* in) {
+    Analytics_Emit(ANALYTICS_HIT, 1, ++s->rallyHits, s->frame, s->aiDifficulty, Pong_HitContact(s->ballPos, s->p1));
+    bool belowMax = fabsf(s->ballSpeed.x) < MAX_BALL_SPEED;
+    s->ballSpeed.x *= -1;
+    s->ballPos.x = s->p1.x + s->p1.width + 1;
+    s->events |= PONG_EVENT_HIT_P1;
+
+    // Increase speed
+    s->ballSpeed.x += (s->ballSpeed.x > 0) ? 1.0f : -1.0f;
+
+    // Limit speed to the maximum allowed
+    if (fabsf(s->ballSpeed.x) > MAX_BALL_SPEED) {
+        s->ballSpeed.x = (s->ballSpeed.x > 0) ? MAX_BALL_SPEED : -MAX_BALL_SPEED;
+    }
+    if (belowMax && fabsf(s->ballSpeed.x) >= MAX_BALL_SPEED) {
+        Analytics_Emit(ANALYTICS_MAX_SPEED, 1, s->rallyHits, s->frame, fabsf(s->ballSpeed.x), 0.0f);
+    }
+
+    if (!s->isExpanded && !s->isAnimating) {
+        s->playerHits++;
+        if (s->playerHits >= 2) {
+            s->isAnimating = true;
+            s->events |= PONG_EVENT_EXPAND_START;
+            s->startArena = (Arena){ in->windowX, in->windowY, (float)INITIAL_WIDTH, (float)INITIAL_HEIGHT };
+            s->windowStartPos = (PongVec2){ in->windowX, in->windowY };
+            s->p1LockedWorldY = s->startArena.y + s->p1.y;
+            s->p2LockedWorldY = s->startArena.y + s->p2.y;
+        }
+    }
+}
+
+static void Pong_HitPlayer2(PongState* s) {
+    Analytics_Emit(ANALYTICS_HIT, 2, ++s->rallyHits, s->frame, s->aiDifficulty, Pong_HitContact(s->ballPos, s->p2));
+    s->ballSpeed.x *= -1;
+    s->ballPos.x = s->p2.x - BALL_SIZE - 1;
+    s->aiHitsTotal++;
+    s->events |= PONG_EVENT_HIT_P2;
+}
+
+#define SWEEP_NONE 0
+#define SWEEP_WALL 1
+#define SWEEP_P1   2
+#define SWEEP_P2   3
+#define SWEEP_MAX_ITERATIONS 4
+
+// 3C. PHYSICS, COLLISION, AND SCORING
+// The ball is swept against the walls and both paddles, so it cannot tunnel
+// through a paddle no matter how far it travels in one step.
+void Pong_UpdatePhysics(PongState* s, const PongInput* in, float dt) {
+    float remaining = 1.0f;
+    float frames = dt * PONG_REFERENCE_HZ;
+    float floorY = s->currentArena.height - BALL_SIZE;
+
+    for (int i = 0; i < SWEEP_MAX_ITERATIONS && remaining > 0.0f; i++) {
+        PongVec2 delta = { s->ballSpeed.x * frames * remaining, s->ballSpeed.y * frames * remaining };
+        float toi = 1.0f;
+        int hit = SWEEP_NONE;
+        float t;
+
+        if (delta.y < 0.0f) {
+            t = (0.0f - s->ballPos.y) / delta.y;
+            if (t < toi) { toi = (t < 0.0f) ? 0.0f : t; hit = SWEEP_WALL; }
+        } else if (delta.y > 0.0f) {
+            t = (floorY - s->ballPos.y) / delta.y;
+            if (t < toi) { toi = (t < 0.0f) ? 0.0f : t; hit = SWEEP_WALL; }
+        }
+        // Paddles only stop the ball when it is moving towards them
+        if (delta.x < 0.0f && Pong_SweepPaddleHit(s->ballPos, delta, s->p1, &t) && t <= toi) { toi = t; hit = SWEEP_P1; }
+        if (delta.x > 0.0f && Pong_SweepPaddleHit(s->ballPos, delta, s->p2, &t) && t <= toi) { toi = t; hit = SWEEP_P2; }
+
+        s->ballPos.x += delta.x * toi;
+        s->ballPos.y += delta.y * toi;
+        remaining *= (1.0f - toi);
+
+        if (hit == SWEEP_NONE) break;
+        if (hit == SWEEP_WALL) s->ballSpeed.y *= -1;
+        else if (hit == SWEEP_P1) Pong_HitPlayer1(s, in);
+        else Pong_HitPlayer2(s);
+        Pong_InvalidatePrediction(s);
+    }
+
+    // SCORING (Ball goes left)
+    if (s->ballPos.x < 0) {
+        s->score2++;
+        s->events |= PONG_EVENT_SCORE_P2;
+        Analytics_Emit(ANALYTICS_POINT, 2, s->rallyHits, s->frame, fabsf(s->ballSpeed.x), 0.0f);
+        Pong_StartScorePop(s, 2);
+        Pong_ResetPoint(s);
+    }
+
+    // SCORING (Ball goes right)
+    if (s->ballPos.x > s->currentArena.width) {
+        s->score1++;
+        s->events |= PONG_EVENT_SCORE_P1;
+        Analytics_Emit(ANALYTICS_POINT, 1, s->rallyHits, s->frame, fabsf(s->ballSpeed.x), 0.0f);
+        Pong_StartScorePop(s, 1);
+        Pong_ResetPoint(s);
+    }
+}
+
+// 4. Clamping
+void Pong_ClampPaddles(PongState* s) {
+    bool worldLocked = s->isAnimating || s->isLocked;
+    if (s->p1.y < 0) { s->p1.y = 0; if (worldLocked) s->p1LockedWorldY = s->currentArena.y; }
+    if (s->p1.y + PADDLE_HEIGHT > s->currentArena.height) { s->p1.y = s->currentArena.height - PADDLE_HEIGHT; if (worldLocked) s->p1LockedWorldY = s->currentArena.y + s->p1.y; }
+    if (s->isExpanded && !s->isAnimating) s->p2.x = s->currentArena.width - 50 - PADDLE_WIDTH;
+    if (s->p2.y < 0) { s->p2.y = 0; if (worldLocked) s->p2LockedWorldY = s->currentArena.y; }
+    if (s->p2.y + PADDLE_HEIGHT > s->currentArena.height) { s->p2.y = s->currentArena.height - PADDLE_HEIGHT; if (worldLocked) s->p2LockedWorldY = s->currentArena.y + s->p2.y; }
+}
+
+void Pong_Step(PongState* s, const PongInput* in, float dt) {
+    if (s->fixedPoint) {
+        Pong_StepFixed(s, in, dt);
+        return;
+    }
+    s->events = 0;
+
+    PROFILE_BEGIN(PROF_ANIMATION);
+    Pong_UpdateAnimation(s, in, dt);
+    PROFILE_END(PROF_ANIMATION);
+
+    PROFILE_BEGIN(PROF_INPUT);
+    Pong_ApplyInput(s, in, dt);
+    PROFILE_END(PROF_INPUT);
+
+    if (s->gameStarted) {
+        PROFILE_BEGIN(PROF_AI_PHYSICS);
+        if (!s->versus) Pong_UpdateAI(s, dt);
+        Pong_UpdatePhysics(s, in, dt);
+        PROFILE_END(PROF_AI_PHYSICS);
+    }
+
+    PROFILE_BEGIN(PROF_CLAMP);
+    Pong_ClampPaddles(s);
+    PROFILE_END(PROF_CLAMP);
+
+    s->frame++;
+}
+
+static unsigned long long HashBytes(unsigned long long h, const void* data, size_t size) {
+    const unsigned char* p = (const unsigned char*)data;
+    for (size_t i = 0; i < size; i++) {
+        h ^= p[i];
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+static unsigned long long HashFloat(unsigned long long h, float value) {
+    unsigned int bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return HashBytes(h, &bits, sizeof(bits));
+}
+
+static unsigned long long HashInt(unsigned long long h, long long value) {
+    return HashBytes(h, &value, sizeof(value));
+}
+
+static unsigned long long HashFixed(const PongState* s) {
+    const PongFixedBody* f = &s->fx;
+    unsigned long long h = 14695981039346656037ULL;
+    h = HashInt(h, f->arenaX); h = HashInt(h, f->arenaY); h = HashInt(h, f->arenaW); h = HashInt(h, f->arenaH);
+    h = HashInt(h, f->windowX); h = HashInt(h, f->windowY);
+    h = HashInt(h, f->p1Y); h = HashInt(h, f->p2X); h = HashInt(h, f->p2Y);
+    h = HashInt(h, f->ballX); h = HashInt(h, f->ballY); h = HashInt(h, f->speedX); h = HashInt(h, f->speedY);
+    h = HashInt(h, f->p1LockedY); h = HashInt(h, f->p2LockedY);
+    h = HashInt(h, s->gameStarted); h = HashInt(h, s->isExpanded);
+    h = HashInt(h, s->isAnimating); h = HashInt(h, s->isLocked); h = HashInt(h, s->versus);
+    h = HashInt(h, s->score1); h = HashInt(h, s->score2);
+    h = HashInt(h, s->playerHits); h = HashInt(h, s->aiHitsTotal);
+    h = HashInt(h, f->animTimer);
+    h = HashInt(h, f->difficulty); h = HashInt(h, f->targetY); h = HashInt(h, f->reactionTimer);
+    h = HashInt(h, s->aiPredictionValid); h = HashInt(h, f->interceptY); h = HashInt(h, f->errorOffset);
+    h = HashInt(h, (long long)s->rngState);
+    h = HashInt(h, (long long)s->frame);
+    return h;
+}
+
+unsigned long long Pong_HashState(const PongState* s) {
+    if (s->fixedPoint) return HashFixed(s);
+    // Field by field, so struct padding never leaks into the hash
+    unsigned long long h = 14695981039346656037ULL;
+    h = HashFloat(h, s->currentArena.x); h = HashFloat(h, s->currentArena.y);
+    h = HashFloat(h, s->currentArena.width); h = HashFloat(h, s->currentArena.height);
+    h = HashFloat(h, s->windowPos.x); h = HashFloat(h, s->windowPos.y);
+    h = HashFloat(h, s->p1.x); h = HashFloat(h, s->p1.y);
+    h = HashFloat(h, s->p2.x); h = HashFloat(h, s->p2.y);
+    h = HashFloat(h, s->ballPos.x); h = HashFloat(h, s->ballPos.y);
+    h = HashFloat(h, s->ballSpeed.x); h = HashFloat(h, s->ballSpeed.y);
+    h = HashFloat(h, s->p1LockedWorldY); h = HashFloat(h, s->p2LockedWorldY);
+    h = HashInt(h, s->gameStarted); h = HashInt(h, s->isExpanded);
+    h = HashInt(h, s->isAnimating); h = HashInt(h, s->isLocked);
+    // Only versus matches hash the flag, so hashes (and replays) of AI
+    // matches are the same as before versus mode existed
+    if (s->versus) h = HashInt(h, s->versus);
+    h = HashInt(h, s->score1); h = HashInt(h, s->score2);
+    h = HashInt(h, s->playerHits); h = HashInt(h, s->aiHitsTotal);
+    h = HashFloat(h, s->animTimer);
+    h = HashFloat(h, s->aiDifficulty); h = HashFloat(h, s->targetY); h = HashFloat(h, s->reactionTimer);
+    h = HashInt(h, s->aiPredictionValid); h = HashFloat(h, s->aiInterceptY); h = HashFloat(h, s->aiErrorOffset);
+    h = HashInt(h, (long long)s->rngState);
+    h = HashInt(h, (long long)s->frame);
+    return h;
+}
+
+static float Lerp(float a, float b, float t) {
+    return a + (b - a) * t;
+}
+
+void Pong_Interpolate(const PongState* prev, const PongState* cur, float alpha, PongState* out) {
+    *out = *cur;
+    // Don't blend across a reset, the ball would streak through the arena
+    if (cur->events & (PONG_EVENT_SCORE_P1 | PONG_EVENT_SCORE_P2)) return;
+
+    out->p1.y = Lerp(prev->p1.y, cur->p1.y, alpha);
+    out->p2.x = Lerp(prev->p2.x, cur->p2.x, alpha);
+    out->p2.y = Lerp(prev->p2.y, cur->p2.y, alpha);
+    out->ballPos.x = Lerp(prev->ballPos.x, cur->ballPos.x, alpha);
+    out->ballPos.y = Lerp(prev->ballPos.y, cur->ballPos.y, alpha);
+    out->scorePop1 = Lerp(prev->scorePop1, cur->scorePop1, alpha);
+    out->scorePop2 = Lerp(prev->scorePop2, cur->scorePop2, alpha);
+    if (cur->isAnimating) {
+        out->animTimer = Lerp(prev->animTimer, cur->animTimer, alpha);
+        out->titleBarOffset = Lerp(prev->titleBarOffset, cur->titleBarOffset, alpha);
+        out->currentArena.x = Lerp(prev->currentArena.x, cur->currentArena.x, alpha);
+        out->currentArena.y = Lerp(prev->currentArena.y, cur->currentArena.y, alpha);
+        out->currentArena.width = Lerp(prev->currentArena.width, cur->currentArena.width, alpha);
+        out->currentArena.height = Lerp(prev->currentArena.height, cur->currentArena.height, alpha);
+        out->windowPos.x = (float)(int)Lerp(prev->windowPos.x, cur->windowPos.x, alpha);
+        out->windowPos.y = (float)(int)Lerp(prev->windowPos.y, cur->windowPos.y, alpha);
+    }
+}
+
+// 5. SECONDARY WINDOW PLACEMENT
+void Pong_GetOverlayRects(const PongState* s, PongWinRect out[PONG_OVERLAY_COUNT]) {
+    int globalOffsetX = (int)s->currentArena.x;
+    int globalOffsetY = (int)s->currentArena.y;
+
+    // Tweened down to 0 with the expansion
+    int titleBarOffset = s->isExpanded ? 0 : (int)s->titleBarOffset;
+
+    out[PONG_OVERLAY_PADDLE1] = (PongWinRect){ globalOffsetX + (int)s->p1.x, globalOffsetY + (int)s->p1.y + titleBarOffset, PADDLE_WIDTH, PADDLE_HEIGHT };
+    out[PONG_OVERLAY_PADDLE2] = (PongWinRect){ globalOffsetX + (int)s->p2.x, globalOffsetY + (int)s->p2.y + titleBarOffset, PADDLE_WIDTH, PADDLE_HEIGHT };
+    out[PONG_OVERLAY_BALL]    = (PongWinRect){ globalOffsetX + (int)s->ballPos.x - 12, globalOffsetY + (int)s->ballPos.y, BALL_SIZE, BALL_SIZE };
+}
+
+unsigned char Pong_AutoPlayerKeys(const PongState* s) {
+    // Serve as soon as the point is reset
+    if (!s->gameStarted) return PONG_KEY_S;
+
+    if (s->fixedPoint) {
+        PongFixed center = s->fx.p1Y + PONG_FX_INT(PADDLE_HEIGHT) / 2;
+        PongFixed ball = s->fx.ballY + PONG_FX_INT(BALL_SIZE) / 2;
+        if (ball < center - PONG_FX_INT(10)) return PONG_KEY_W;
+        if (ball > center + PONG_FX_INT(10)) return PONG_KEY_S;
+        return 0;
+    }
+    float centerP1 = s->p1.y + PADDLE_HEIGHT / 2.0f;
+    float ballCenter = s->ballPos.y + BALL_RADIUS;
+    if (ballCenter < centerP1 - 10.0f) return PONG_KEY_W;
+    if (ballCenter > centerP1 + 10.0f) return PONG_KEY_S;
+    return 0;
+}
@@ -0,0 +1,220 @@
+#ifndef PONG_CORE_H
+#define PONG_CORE_H
+#include <stdbool.h>
+#include "pong_tween.h"
+#include "pong_fixed.h"
+
+// Pure game simulation. No raylib or Win32 calls in here, so the same code
+// drives the real game (main.c) and the headless runner (headless.c).
+
+#define INITIAL_WIDTH 800
+#define INITIAL_HEIGHT 600
+#define PADDLE_WIDTH 15
+#define PADDLE_HEIGHT 100
+#define BALL_SIZE 25
+#define BALL_RADIUS (BALL_SIZE/2.0f)
+#define BASE_BALL_SPEED 7.0f
+#define MAX_BALL_SPEED (BASE_BALL_SPEED * 2.0f) // Limit set to 14.0f
+#define TITLE_BAR_HEIGHT 35
+
+// Physics runs on a fixed timestep. Speeds above are expressed in pixels per
+// 60 Hz frame (the rate the game was tuned at) and scaled by dt.
+#define PONG_PHYSICS_HZ 240
+#define PONG_FIXED_DT (1.0f / PONG_PHYSICS_HZ)
+#define PONG_REFERENCE_HZ 60.0f
+
+// Input bits (one per physical key, so W and UP can be told apart)
+#define PONG_KEY_W    0x01
+#define PONG_KEY_S    0x02
+#define PONG_KEY_UP   0x04
+#define PONG_KEY_DOWN 0x08
+#define PONG_KEY_UP_ANY   (PONG_KEY_W | PONG_KEY_UP)
+#define PONG_KEY_DOWN_ANY (PONG_KEY_S | PONG_KEY_DOWN)
+#define PONG_INPUT_SUBSTEPS 16
+
+// Events raised during the last Pong_Step (cleared at the start of each step)
+#define PONG_EVENT_EXPAND_START 0x01
+#define PONG_EVENT_EXPAND_DONE  0x02
+#define PONG_EVENT_SCORE_P1     0x04
+#define PONG_EVENT_SCORE_P2     0x08
+#define PONG_EVENT_HIT_P1       0x10
+#define PONG_EVENT_HIT_P2       0x20
+
+// Tween groups of PongState.tweens
+#define PONG_TWEEN_GROUP_EXPAND 0   // Arena, window and title bar during the expansion
+#define PONG_TWEEN_GROUP_POP1   1   // Score pop of player 1
+#define PONG_TWEEN_GROUP_POP2   2
+
+// Properties PongState.tweens animates. Snapshots store these IDs, not byte
+// offsets, so they keep their values: new properties are only appended.
+typedef enum {
+    PONG_TWEEN_ARENA_X,     // currentArena, in the order the expansion adds them
+    PONG_TWEEN_ARENA_Y,
+    PONG_TWEEN_ARENA_W,
+    PONG_TWEEN_ARENA_H,
+    PONG_TWEEN_WINDOW_X,    // windowPos
+    PONG_TWEEN_WINDOW_Y,
+    PONG_TWEEN_TITLE_BAR,   // titleBarOffset
+    PONG_TWEEN_SCORE_POP1,
+    PONG_TWEEN_SCORE_POP2,
+    PONG_TWEEN_PROP_COUNT
+} PongTweenProp;
+
+typedef struct {
+    float x, y;
+} PongVec2;
+
+// Same layout as raylib's Rectangle
+typedef struct {
+    float x, y, width, height;
+} PongRect;
+
+typedef struct {
+    float x, y, width, height;
+} Arena;
+
+typedef struct {
+    int x, y, width, height;
+} PongWinRect;
+
+enum {
+    PONG_OVERLAY_PADDLE1,
+    PONG_OVERLAY_PADDLE2,
+    PONG_OVERLAY_BALL,
+    PONG_OVERLAY_COUNT
+};
+
+// Tunables of the adaptive AI (sections 3A/3B). Pong_DefaultAIParams gives
+// the hand-written values; pong_tune searches for better ones.
+typedef struct {
+    float baseDifficulty;       // Difficulty once the guaranteed hits are over
+    float scalingFactor;        // Growth per sqrt(hit)
+    float difficultyCap;        // Upper bound of the progressive difficulty
+    float scoreThreshold;       // Score lead that switches to facilitate/invincible
+    float facilitateDifficulty; // Used while player 1 trails by scoreThreshold
+    float reactionDelay;        // Seconds before the AI reacts to a new trajectory
+    float maxErrorScale;        // Aim error range at difficulty 0, in pixels
+    int guaranteedHits;         // AI never misses its first N hits
+} PongAIParams;
+
+typedef struct {
+    unsigned char keys;     // PONG_KEY_* bits held this frame
+    float windowX, windowY; // Current position of the main window (drag sync)
+    unsigned char keys2;    // Player 2's PONG_KEY_W/S bits, versus mode only
+    // Sub-step timing of player 1's keys (input_queue.h): how much of the
+    // step up and down were held, in 1/PONG_INPUT_SUBSTEPS. 0 means the
+    // whole step for a direction whose key bit is set.
+    unsigned char upHeld, downHeld;
+} PongInput;
+
+typedef struct {
+    // Animation and Arena Variables
+    Arena currentArena;
+    Arena startArena;
+    Arena targetArena;
+
+    // Main Window Variables (windowPos is where the window should be placed)
+    PongVec2 windowStartPos;
+    PongVec2 windowTargetPos;
+    PongVec2 windowPos;
+
+    // Game Entities
+    PongRect p1, p2;
+    PongVec2 ballPos;
+    PongVec2 ballSpeed;
+    float p1LockedWorldY;
+    float p2LockedWorldY;
+
+    // Game/Animation States
+    bool gameStarted;
+    bool isExpanded;
+    bool isAnimating;
+    bool isLocked;
+    bool versus;            // Player 2 is driven by PongInput.keys2 instead of the AI
+    bool fixedPoint;        // Simulated in 16.16 fixed point (fx), see Pong_UseFixedPoint
+
+    // Counters and Timers
+    int score1, score2;
+    int playerHits;
+    int aiHitsTotal;
+    float animTimer;        // Seconds into the arena expansion
+    float animDuration;     // Length of the expansion tweens
+
+    // AI Difficulty Variables
+    float aiDifficulty;
+    PongAIParams ai;
+    float targetY;
+    float reactionTimer;
+
+    // Cached intercept prediction, valid until the ball's velocity changes
+    bool aiPredictionValid;
+    float aiInterceptY;     // Ball top y where it will reach the AI paddle
+    float aiErrorOffset;    // Noise sampled with the prediction (difficulty)
+
+    // Seeded PRNG owned by the match (xorshift64*), so runs can be replayed
+    unsigned long long rngState;
+
+    unsigned int events;
+    unsigned long long frame;
+
+    // Presentation only: driven by tweens, never read by the simulation and
+    // left out of the hash
+    float titleBarOffset;   // Overlay y offset while the title bar is still on screen
+    float scorePop1, scorePop2; // Scale of the score glyphs, 1 at rest
+
+    // Running tweens (arena expansion, score pops), stepped with the state
+    PongTweens tweens;
+
+    // Authoritative simulated values in fixed-point mode
+    PongFixedBody fx;
+
+    int rallyHits;          // Paddle hits since the serve, both sides (analytics, not hashed)
+} PongState;
+
+// Byte offset in PongState of each PongTweenProp, for PongTween_Update
+extern const size_t PONG_TWEEN_OFFSETS[PONG_TWEEN_PROP_COUNT];
+
+void Pong_DefaultAIParams(PongAIParams* params);
+void Pong_Init(PongState* s, float windowX, float windowY, int monitorW, int monitorH, unsigned long long seed);
+void Pong_Step(PongState* s, const PongInput* in, float dt);
+
+// Switches the match to the fixed-point simulation (pong_fixed.c), starting
+// from its current float values. Pong_Step then runs Pong_StepFixed, whose
+// results are bit-identical across compilers, flags and CPUs; the float
+// fields keep being written for rendering.
+void Pong_UseFixedPoint(PongState* s);
+void Pong_StepFixed(PongState* s, const PongInput* in, float dt);
+
+// Individual phases of Pong_Step, exposed for benchmarking and tools
+void Pong_UpdateAnimation(PongState* s, const PongInput* in, float dt);
+void Pong_ApplyInput(PongState* s, const PongInput* in, float dt);
+float Pong_ComputeDifficulty(const PongState* s);
+void Pong_UpdateAI(PongState* s, float dt);
+void Pong_UpdatePhysics(PongState* s, const PongInput* in, float dt);
+bool Pong_CheckPaddleHit(PongVec2 ballPos, PongRect paddle);
+// Ball top y once the ball's x reaches targetX, folding the straight-line
+// path across the top and bottom walls. Requires velocity.x != 0.
+float Pong_PredictInterceptY(PongVec2 ballPos, PongVec2 velocity, float targetX, float arenaHeight);
+// Swept test of the ball box moving by delta against a paddle. Returns the
+// fraction of delta at which they first touch (0 if already overlapping).
+bool Pong_SweepPaddleHit(PongVec2 ballPos, PongVec2 delta, PongRect paddle, float* toi);
+void Pong_ClampPaddles(PongState* s);
+// Starts the score pop tween of player 1 or 2
+void Pong_StartScorePop(PongState* s, int player);
+
+// Render state between two physics steps (alpha in 0..1)
+void Pong_Interpolate(const PongState* prev, const PongState* cur, float alpha, PongState* out);
+
+// Screen rectangles of the overlay windows (phase 5)
+void Pong_GetOverlayRects(const PongState* s, PongWinRect out[PONG_OVERLAY_COUNT]);
+
+// Simple ball-tracking player, used for AI-vs-AI matches
+unsigned char Pong_AutoPlayerKeys(const PongState* s);
+
+int Pong_RandomInt(PongState* s, int min, int max);
+
+// FNV-1a over every simulated field, used to verify replays. In fixed-point
+// mode the fixed values are hashed instead of the floats.
+unsigned long long Pong_HashState(const PongState* s);
+
+#endif
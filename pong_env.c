@@ -0,0 +1,402 @@
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200112L
+#endif
+#include "pong_env.h"
+#include "pong_clock.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sched.h>
+#endif
+
+// Environments per thread pool task: enough to amortise the task, small
+// enough to balance
+#define PONG_ENV_CHUNK 64
+
+struct PongEnv {
+    int count;
+    PongEnvConfig cfg;
+    PongEnvBuffers buf;
+    void* owned;            // Buffers allocated here, one block
+    float windowX, windowY; // Main window position, as after launch
+    PongState* games;
+    PongPlayerModel* models;
+    int* steps;             // Environment steps into the episode
+    unsigned long long* seeds;  // Seed of each environment's next episode
+    ThreadPool* pool;
+};
+
+void PongEnv_DefaultConfig(PongEnvConfig* cfg) {
+    cfg->frameSkip = 4;
+    cfg->pointsPerEpisode = 5;
+    cfg->maxSteps = 0;
+    cfg->opponent = PONG_SKILL_AVERAGE;
+    cfg->hitReward = 0.0f;
+    cfg->monitorW = 1920;
+    cfg->monitorH = 1080;
+    cfg->seed = 1;
+    cfg->threads = 0;
+}
+
+static void WriteObs(const PongState* s, float* o) {
+    o[PONG_ENV_OBS_BALL_X] = s->ballPos.x;
+    o[PONG_ENV_OBS_BALL_Y] = s->ballPos.y;
+    o[PONG_ENV_OBS_BALL_VX] = s->ballSpeed.x;
+    o[PONG_ENV_OBS_BALL_VY] = s->ballSpeed.y;
+    o[PONG_ENV_OBS_PADDLE_Y] = s->p2.y;
+    o[PONG_ENV_OBS_OPPONENT_Y] = s->p1.y;
+    o[PONG_ENV_OBS_ARENA_W] = s->currentArena.width;
+    o[PONG_ENV_OBS_ARENA_H] = s->currentArena.height;
+}
+
+static void ResetEnv(PongEnv* env, int i) {
+    PongState* s = &env->games[i];
+    unsigned long long seed = env->seeds[i];
+    Pong_Init(s, env->windowX, env->windowY, env->cfg.monitorW, env->cfg.monitorH, seed);
+    s->versus = true;
+    // Its own stream, so the model's aim never follows the serve
+    PlayerModel_Init(&env->models[i], Pong_PlayerSkill(env->cfg.opponent), seed * 0x9E3779B97F4A7C15ULL + 1);
+    // Next episode's seed depends on this one only, so a slice of the
+    // environments replays the same episodes as the whole batch
+    env->seeds[i] = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+    env->steps[i] = 0;
+    WriteObs(s, &env->buf.obs[(size_t)i * PONG_ENV_OBS]);
+}
+
+static void StepEnv(PongEnv* env, int i) {
+    PongState* s = &env->games[i];
+    signed char action = env->buf.actions[i];
+    if (action == PONG_ENV_ACTION_RESET) {
+        ResetEnv(env, i);
+        env->buf.rewards[i] = 0.0f;
+        env->buf.dones[i] = 0;
+        return;
+    }
+
+    PongInput in = { 0, env->windowX, env->windowY };
+    if (action == PONG_ENV_ACTION_UP) in.keys2 = PONG_KEY_W;
+    else if (action == PONG_ENV_ACTION_DOWN) in.keys2 = PONG_KEY_S;
+
+    float reward = 0.0f;
+    for (int k = 0; k < env->cfg.frameSkip; k++) {
+        in.keys = PlayerModel_Keys(&env->models[i], s, PONG_FIXED_DT);
+        Pong_Step(s, &in, PONG_FIXED_DT);
+        if (s->events & PONG_EVENT_SCORE_P2) reward += 1.0f;
+        if (s->events & PONG_EVENT_SCORE_P1) reward -= 1.0f;
+        if (s->events & PONG_EVENT_HIT_P2) reward += env->cfg.hitReward;
+    }
+
+    int points = env->cfg.pointsPerEpisode;
+    int steps = ++env->steps[i];
+    bool done = s->score1 >= points || s->score2 >= points || (env->cfg.maxSteps > 0 && steps >= env->cfg.maxSteps);
+    env->buf.rewards[i] = reward;
+    env->buf.dones[i] = done;
+    if (done) ResetEnv(env, i);
+    else WriteObs(s, &env->buf.obs[(size_t)i * PONG_ENV_OBS]);
+}
+
+PongEnv* PongEnv_Create(int count, const PongEnvConfig* cfg, const PongEnvBuffers* buffers) {
+    if (count <= 0 || cfg->frameSkip <= 0 || cfg->pointsPerEpisode <= 0) return NULL;
+    PongEnv* env = (PongEnv*)calloc(1, sizeof(PongEnv));
+    if (!env) return NULL;
+    env->count = count;
+    env->cfg = *cfg;
+    if (buffers) env->buf = *buffers;
+    env->windowX = cfg->monitorW/2.0f - INITIAL_WIDTH/2.0f;
+    env->windowY = cfg->monitorH/2.0f - INITIAL_HEIGHT/2.0f;
+
+    // Whatever the caller didn't provide, in one block
+    size_t obsSize = env->buf.obs ? 0 : (size_t)count * PONG_ENV_OBS * sizeof(float);
+    size_t rewardSize = env->buf.rewards ? 0 : (size_t)count * sizeof(float);
+    size_t doneSize = env->buf.dones ? 0 : (size_t)count;
+    size_t actionSize = env->buf.actions ? 0 : (size_t)count;
+    size_t total = obsSize + rewardSize + doneSize + actionSize;
+    if (total > 0) {
+        unsigned char* block = (unsigned char*)calloc(1, total);
+        if (!block) { free(env); return NULL; }
+        env->owned = block;
+        if (obsSize) { env->buf.obs = (float*)block; block += obsSize; }
+        if (rewardSize) { env->buf.rewards = (float*)block; block += rewardSize; }
+        if (doneSize) { env->buf.dones = block; block += doneSize; }
+        if (actionSize) env->buf.actions = (signed char*)block;
+    }
+
+    env->games = (PongState*)malloc((size_t)count * sizeof(PongState));
+    env->models = (PongPlayerModel*)malloc((size_t)count * sizeof(PongPlayerModel));
+    env->steps = (int*)malloc((size_t)count * sizeof(int));
+    env->seeds = (unsigned long long*)malloc((size_t)count * sizeof(unsigned long long));
+    if (cfg->threads > 1 && count > PONG_ENV_CHUNK) env->pool = ThreadPool_Create(cfg->threads);
+    if (!env->games || !env->models || !env->steps || !env->seeds || (cfg->threads > 1 && count > PONG_ENV_CHUNK && !env->pool)) {
+        PongEnv_Destroy(env);
+        return NULL;
+    }
+
+    for (int i = 0; i < count; i++) env->seeds[i] = cfg->seed + (unsigned long long)i;
+    PongEnv_Reset(env);
+    return env;
+}
+
+void PongEnv_Destroy(PongEnv* env) {
+    if (!env) return;
+    if (env->pool) ThreadPool_Destroy(env->pool);
+    free(env->games);
+    free(env->models);
+    free(env->steps);
+    free(env->seeds);
+    free(env->owned);
+    free(env);
+}
+
+int PongEnv_Count(const PongEnv* env) {
+    return env->count;
+}
+
+PongEnvBuffers PongEnv_Buffers(const PongEnv* env) {
+    return env->buf;
+}
+
+const PongState* PongEnv_Game(const PongEnv* env, int i) {
+    return &env->games[i];
+}
+
+void PongEnv_Reset(PongEnv* env) {
+    for (int i = 0; i < env->count; i++) {
+        ResetEnv(env, i);
+        env->buf.rewards[i] = 0.0f;
+        env->buf.dones[i] = 0;
+    }
+}
+
+void PongEnv_StepRange(PongEnv* env, int first, int count) {
+    int end = first + count < env->count ? first + count : env->count;
+    for (int i = first < 0 ? 0 : first; i < end; i++) StepEnv(env, i);
+}
+
+static void StepChunk(void* ctx, int index, int worker) {
+    (void)worker;
+    PongEnv_StepRange((PongEnv*)ctx, index * PONG_ENV_CHUNK, PONG_ENV_CHUNK);
+}
+
+void PongEnv_Step(PongEnv* env) {
+    if (env->pool) ThreadPool_ParallelFor(env->pool, (env->count + PONG_ENV_CHUNK - 1) / PONG_ENV_CHUNK, StepChunk, env);
+    else PongEnv_StepRange(env, 0, env->count);
+}
+
+// ---------------------------------------------------------------------------
+// Shared memory
+// ---------------------------------------------------------------------------
+
+static const char SHARED_MAGIC[8] = { 'P', 'O', 'N', 'G', 'E', 'N', 'V', '1' };
+#define SHARED_ALIGN 64
+
+// The trainer's and the workers' counters on separate cache lines
+typedef struct {
+    char magic[8];
+    int count;
+    char pad0[SHARED_ALIGN - 12];
+    unsigned long long request;     // Steps asked for by the trainer
+    char pad1[SHARED_ALIGN - 8];
+    unsigned long long done;        // One per worker when ready, then one per worker per step
+    int quit;
+    char pad2[SHARED_ALIGN - 12];
+} SharedHeader;
+
+struct PongEnvShared {
+    SharedHeader* header;
+    size_t size;
+    size_t obsOffset, rewardOffset, doneOffset, actionOffset;
+    char name[64];
+#ifdef _WIN32
+    HANDLE mapping;
+#endif
+};
+
+static size_t AlignUp(size_t n) {
+    return (n + SHARED_ALIGN - 1) & ~(size_t)(SHARED_ALIGN - 1);
+}
+
+// Every buffer starts on its own cache line
+static void SharedLayout(PongEnvShared* s, int count) {
+    s->obsOffset = AlignUp(sizeof(SharedHeader));
+    s->rewardOffset = AlignUp(s->obsOffset + (size_t)count * PONG_ENV_OBS * sizeof(float));
+    s->doneOffset = AlignUp(s->rewardOffset + (size_t)count * sizeof(float));
+    s->actionOffset = AlignUp(s->doneOffset + (size_t)count);
+    s->size = AlignUp(s->actionOffset + (size_t)count);
+}
+
+#ifdef _WIN32
+static void* MapShared(PongEnvShared* s, bool create) {
+    char path[80];
+    snprintf(path, sizeof(path), "Local\\%s", s->name);
+    s->mapping = create ? CreateFileMappingA(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, 0, (DWORD)s->size, path)
+                        : OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, path);
+    if (!s->mapping) return NULL;
+    void* view = MapViewOfFile(s->mapping, FILE_MAP_ALL_ACCESS, 0, 0, 0);
+    if (!view) { CloseHandle(s->mapping); return NULL; }
+    if (!create) {
+        MEMORY_BASIC_INFORMATION info;
+        VirtualQuery(view, &info, sizeof(info));
+        s->size = info.RegionSize;
+    }
+    return view;
+}
+
+static void UnmapShared(PongEnvShared* s, bool unlink) {
+    (void)unlink;   // The mapping goes away with its last handle
+    UnmapViewOfFile(s->header);
+    CloseHandle(s->mapping);
+}
+
+static void Backoff(int* spins) {
+    if (++*spins < 256) return;
+    if (*spins < 4096) SwitchToThread();
+    else Pong_SleepNs(50000);
+}
+#else
+static void* MapShared(PongEnvShared* s, bool create) {
+    char path[80];
+    snprintf(path, sizeof(path), "/%s", s->name);
+    int fd;
+    if (create) {
+        shm_unlink(path);
+        fd = shm_open(path, O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (fd < 0) return NULL;
+        if (ftruncate(fd, (off_t)s->size) != 0) { close(fd); shm_unlink(path); return NULL; }
+    } else {
+        fd = shm_open(path, O_RDWR, 0);
+        if (fd < 0) return NULL;
+        struct stat st;
+        if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(SharedHeader)) { close(fd); return NULL; }
+        s->size = (size_t)st.st_size;
+    }
+    void* view = mmap(NULL, s->size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);  // The mapping keeps the region
+    if (view == MAP_FAILED) {
+        if (create) shm_unlink(path);
+        return NULL;
+    }
+    return view;
+}
+
+static void UnmapShared(PongEnvShared* s, bool unlink) {
+    munmap(s->header, s->size);
+    if (unlink) {
+        char path[80];
+        snprintf(path, sizeof(path), "/%s", s->name);
+        shm_unlink(path);
+    }
+}
+
+// Steps take microseconds, so spin first; an idle trainer costs a sleep
+static void Backoff(int* spins) {
+    if (++*spins < 256) return;
+    if (*spins < 4096) sched_yield();
+    else Pong_SleepNs(50000);
+}
+#endif
+
+PongEnvShared* PongEnvShared_Create(const char* name, int count) {
+    if (count <= 0 || strlen(name) >= sizeof(((PongEnvShared*)0)->name)) return NULL;
+    PongEnvShared* s = (PongEnvShared*)calloc(1, sizeof(PongEnvShared));
+    if (!s) return NULL;
+    strcpy(s->name, name);
+    SharedLayout(s, count);
+    s->header = (SharedHeader*)MapShared(s, true);
+    if (!s->header) { free(s); return NULL; }
+
+    memset(s->header, 0, s->size);
+    s->header->count = count;
+    memcpy(s->header->magic, SHARED_MAGIC, sizeof(SHARED_MAGIC));
+    return s;
+}
+
+PongEnvShared* PongEnvShared_Open(const char* name) {
+    if (strlen(name) >= sizeof(((PongEnvShared*)0)->name)) return NULL;
+    PongEnvShared* s = (PongEnvShared*)calloc(1, sizeof(PongEnvShared));
+    if (!s) return NULL;
+    strcpy(s->name, name);
+    s->header = (SharedHeader*)MapShared(s, false);
+    if (!s->header) { free(s); return NULL; }
+
+    // The layout of a well-formed region fits in what was mapped
+    size_t mapped = s->size;
+    bool valid = memcmp(s->header->magic, SHARED_MAGIC, sizeof(SHARED_MAGIC)) == 0 && s->header->count > 0;
+    if (valid) SharedLayout(s, s->header->count);
+    valid = valid && s->size <= mapped;
+    s->size = mapped;
+    if (!valid) {
+        UnmapShared(s, false);
+        free(s);
+        return NULL;
+    }
+    return s;
+}
+
+void PongEnvShared_Close(PongEnvShared* s, bool unlink) {
+    if (!s) return;
+    UnmapShared(s, unlink);
+    free(s);
+}
+
+int PongEnvShared_Count(const PongEnvShared* s) {
+    return s->header->count;
+}
+
+PongEnvBuffers PongEnvShared_Buffers(const PongEnvShared* s, int first) {
+    unsigned char* base = (unsigned char*)s->header;
+    PongEnvBuffers b;
+    b.obs = (float*)(base + s->obsOffset) + (size_t)first * PONG_ENV_OBS;
+    b.rewards = (float*)(base + s->rewardOffset) + first;
+    b.dones = base + s->doneOffset + first;
+    b.actions = (signed char*)(base + s->actionOffset) + first;
+    return b;
+}
+
+bool PongEnvShared_WaitWorkers(PongEnvShared* s, int workers, PongEnvAliveFn alive, void* ctx) {
+    SharedHeader* h = s->header;
+    unsigned long long target = (unsigned long long)workers * (__atomic_load_n(&h->request, __ATOMIC_RELAXED) + 1);
+    int spins = 0;
+    while (__atomic_load_n(&h->done, __ATOMIC_ACQUIRE) < target) {
+        Backoff(&spins);
+        // Only once the wait has got to sleeping, so a fast step costs nothing
+        if (spins >= 4096 && alive && !alive(ctx)) return false;
+    }
+    return true;
+}
+
+bool PongEnvShared_Step(PongEnvShared* s, int workers, PongEnvAliveFn alive, void* ctx) {
+    // Release: the actions written before this are visible to the workers
+    __atomic_add_fetch(&s->header->request, 1, __ATOMIC_RELEASE);
+    return PongEnvShared_WaitWorkers(s, workers, alive, ctx);
+}
+
+void PongEnvShared_Quit(PongEnvShared* s) {
+    __atomic_store_n(&s->header->quit, 1, __ATOMIC_RELEASE);
+}
+
+void PongEnvShared_Serve(PongEnvShared* s, PongEnv* env) {
+    SharedHeader* h = s->header;
+    unsigned long long seen = __atomic_load_n(&h->request, __ATOMIC_ACQUIRE);
+    __atomic_add_fetch(&h->done, 1, __ATOMIC_RELEASE);
+    for (;;) {
+        int spins = 0;
+        unsigned long long request;
+        while ((request = __atomic_load_n(&h->request, __ATOMIC_ACQUIRE)) == seen) {
+            if (__atomic_load_n(&h->quit, __ATOMIC_ACQUIRE)) return;
+            Backoff(&spins);
+        }
+        // The trainer waits for every worker, so this is always seen + 1
+        seen = request;
+        PongEnv_Step(env);
+        __atomic_add_fetch(&h->done, 1, __ATOMIC_RELEASE);
+    }
+}
@@ -0,0 +1,119 @@
+#ifndef PONG_ENV_H
+#define PONG_ENV_H
+#include <stdbool.h>
+#include "pong_core.h"
+#include "player_model.h"
+#include "threadpool.h"
+
+// Batched training environments. A PongEnv runs N independent matches in
+// which the agent plays player 2 (the side the AI normally plays) against a
+// player model, the same way the game plays out: small arena first,
+// expansion after the rally, adaptive scoring. PongEnv_Step reads one action
+// per environment and writes observations, rewards and done flags straight
+// into the buffers given at creation, so a step allocates and copies nothing
+// beyond the per-environment match state.
+//
+// The buffers can live in shared memory (PongEnvShared): a trainer process
+// then maps them by name, writes actions and reads observations in place,
+// while worker processes each step their own slice of the environments.
+
+// Observation of one environment, PONG_ENV_OBS floats in pixels (speeds in
+// pixels per 60 Hz frame), arena-relative
+enum {
+    PONG_ENV_OBS_BALL_X,
+    PONG_ENV_OBS_BALL_Y,
+    PONG_ENV_OBS_BALL_VX,
+    PONG_ENV_OBS_BALL_VY,
+    PONG_ENV_OBS_PADDLE_Y,      // Agent's paddle (top)
+    PONG_ENV_OBS_OPPONENT_Y,    // Player model's paddle (top)
+    PONG_ENV_OBS_ARENA_W,
+    PONG_ENV_OBS_ARENA_H,
+    PONG_ENV_OBS
+};
+
+// Actions, one signed byte per environment
+#define PONG_ENV_ACTION_UP     (-1)
+#define PONG_ENV_ACTION_NONE   0
+#define PONG_ENV_ACTION_DOWN   1
+#define PONG_ENV_ACTION_RESET  2     // Start a new episode instead of stepping
+
+typedef struct {
+    int frameSkip;          // Physics steps per environment step (action repeat)
+    int pointsPerEpisode;   // Episode ends when either side has this many
+    int maxSteps;           // Environment steps before the episode is cut (0: none)
+    PongSkill opponent;     // Skill of the player model on the left
+    float hitReward;        // Added when the agent returns the ball (0: points only)
+    int monitorW, monitorH; // Size the arena expands to
+    unsigned long long seed;    // Environment i uses seed + i, advanced every episode
+    int threads;            // PongEnv_Step over a thread pool (0 or 1: calling thread only)
+} PongEnvConfig;
+
+void PongEnv_DefaultConfig(PongEnvConfig* cfg);
+
+// Row i of each buffer belongs to environment i. Any pointer left NULL is
+// allocated by PongEnv_Create and freed with the environments.
+typedef struct {
+    float* obs;             // count * PONG_ENV_OBS
+    float* rewards;         // count: agent's reward for the last step
+    unsigned char* dones;   // count: 1 when the last step ended an episode
+    signed char* actions;   // count: PONG_ENV_ACTION_*, read by PongEnv_Step
+} PongEnvBuffers;
+
+typedef struct PongEnv PongEnv;
+
+// Creates count environments and resets them all (observations written,
+// rewards and dones cleared). Returns NULL on bad arguments or no memory.
+PongEnv* PongEnv_Create(int count, const PongEnvConfig* cfg, const PongEnvBuffers* buffers);
+void PongEnv_Destroy(PongEnv* env);
+int PongEnv_Count(const PongEnv* env);
+// The buffers in use, allocated ones included
+PongEnvBuffers PongEnv_Buffers(const PongEnv* env);
+
+void PongEnv_Reset(PongEnv* env);
+// Applies actions[i] to every environment for frameSkip physics steps and
+// writes obs, rewards and dones. An environment whose episode ends is reset
+// in the same step: its done flag and reward belong to the episode that
+// ended, its observation to the new one.
+void PongEnv_Step(PongEnv* env);
+// Same for environments [first, first + count) only, on the calling thread
+void PongEnv_StepRange(PongEnv* env, int first, int count);
+
+// Match state of environment i, for tools and verification
+const PongState* PongEnv_Game(const PongEnv* env, int i);
+
+// ---------------------------------------------------------------------------
+// Shared memory
+// ---------------------------------------------------------------------------
+
+// Named shared memory holding the buffers of count environments, plus the
+// counters a trainer and its worker processes step in lockstep with. Each
+// worker creates a PongEnv over PongEnvShared_Buffers of its slice and calls
+// PongEnvShared_Serve; the trainer writes actions, calls PongEnvShared_Step
+// and reads the results in place.
+typedef struct PongEnvShared PongEnvShared;
+
+// name is a plain identifier ("pong_env"); creating replaces an old region
+PongEnvShared* PongEnvShared_Create(const char* name, int count);
+PongEnvShared* PongEnvShared_Open(const char* name);
+// unlink removes the name (creator, once every process has it open)
+void PongEnvShared_Close(PongEnvShared* s, bool unlink);
+int PongEnvShared_Count(const PongEnvShared* s);
+// Buffers of environments [first, count), for a worker's PongEnv_Create
+PongEnvBuffers PongEnvShared_Buffers(const PongEnvShared* s, int first);
+
+// Returns false once a worker process has died (e.g. waitpid with WNOHANG)
+typedef bool (*PongEnvAliveFn)(void* ctx);
+
+// Trainer side. WaitWorkers returns once all of them have created their
+// environments (first observations written); Step asks every worker for one
+// step and returns when they are done; Quit stops them. Both return false,
+// instead of waiting forever, if alive (may be NULL) reports a dead worker;
+// it is polled while they sleep between checks.
+bool PongEnvShared_WaitWorkers(PongEnvShared* s, int workers, PongEnvAliveFn alive, void* ctx);
+bool PongEnvShared_Step(PongEnvShared* s, int workers, PongEnvAliveFn alive, void* ctx);
+void PongEnvShared_Quit(PongEnvShared* s);
+
+// Worker side: steps env once per trainer request until Quit
+void PongEnvShared_Serve(PongEnvShared* s, PongEnv* env);
+
+#endif
@@ -0,0 +1,520 @@
+#include "pong_core.h"
+#include "pong_fixed.h"
+#include "profiler.h"
+#include "analytics.h"
+
+// ---------------------------------------------------------------------------
+// Arithmetic
+// ---------------------------------------------------------------------------
+
+#define FX_ONE PONG_FIXED_ONE
+
+static inline PongFixed Saturate(long long v) {
+    if (v > PONG_FIXED_MAX) return PONG_FIXED_MAX;
+    if (v < PONG_FIXED_MIN) return PONG_FIXED_MIN;
+    return (PongFixed)v;
+}
+
+static inline PongFixed Mul(PongFixed a, PongFixed b) {
+    return (PongFixed)(((long long)a * b) >> PONG_FIXED_SHIFT);
+}
+
+static inline PongFixed Div(PongFixed a, PongFixed b) {
+    return Saturate((long long)a * FX_ONE / b);
+}
+
+static inline PongFixed Abs(PongFixed x) {
+    return x < 0 ? -x : x;
+}
+
+static inline PongFixed Clamp(PongFixed x, PongFixed lo, PongFixed hi) {
+    return x < lo ? lo : (x > hi ? hi : x);
+}
+
+// Whole pixels towards zero, like the (float)(int) of window positions
+static inline PongFixed Truncate(PongFixed x) {
+    return x < 0 ? -(-x & ~(FX_ONE - 1)) : (x & ~(FX_ONE - 1));
+}
+
+static inline PongFixed Lerp(PongFixed a, PongFixed b, PongFixed t) {
+    return a + Mul(b - a, t);
+}
+
+PongFixed PongFixed_FromFloat(float f) {
+    // Scaling by a power of two is exact, so only the rounding below decides
+    double v = (double)f * FX_ONE;
+    v += (v >= 0.0) ? 0.5 : -0.5;
+    if (v >= (double)PONG_FIXED_MAX) return PONG_FIXED_MAX;
+    if (v <= (double)PONG_FIXED_MIN) return PONG_FIXED_MIN;
+    return (PongFixed)v;
+}
+
+float PongFixed_ToFloat(PongFixed x) {
+    return (float)x / (float)FX_ONE;
+}
+
+PongFixed PongFixed_Mul(PongFixed a, PongFixed b) {
+    return Mul(a, b);
+}
+
+PongFixed PongFixed_Div(PongFixed a, PongFixed b) {
+    return Div(a, b);
+}
+
+PongFixed PongFixed_Sqrt(PongFixed x) {
+    if (x <= 0) return 0;
+    // Integer square root of x << 16, one result bit at a time
+    unsigned long long n = (unsigned long long)x << PONG_FIXED_SHIFT;
+    unsigned long long root = 0, bit = 1ULL << 62;
+    while (bit > n) bit >>= 2;
+    while (bit) {
+        if (n >= root + bit) {
+            n -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (PongFixed)root;
+}
+
+PongFixed PongFixed_EaseInOutCubic(PongFixed t) {
+    t = Clamp(t, 0, FX_ONE);
+    if (t < FX_ONE / 2) return 4 * Mul(Mul(t, t), t);
+    PongFixed u = 2 * FX_ONE - 2 * t;
+    return FX_ONE - Mul(Mul(u, u), u) / 2;
+}
+
+// 0.85^(2^-k) for k = 1..16 in 2.30, so any fraction of a frame is a
+// product of table entries
+static const int dampingRoots[16] = {
+    989941048, 1030990352, 1052148973, 1062890567, 1068302418, 1071018668, 1072379382, 1073060387,
+    1073401051, 1073571424, 1073656621, 1073699221, 1073720523, 1073731173, 1073736499, 1073739161,
+};
+#define DAMPING_BASE 912680550  // 0.85 in 2.30
+
+PongFixed PongFixed_Damping(PongFixed frames) {
+    if (frames <= 0) return 0;
+    long long keep = 1LL << 30;
+    for (int whole = frames >> PONG_FIXED_SHIFT; whole > 0 && keep > 0; whole--) keep = (keep * DAMPING_BASE) >> 30;
+    for (int k = 0; k < 16; k++) {
+        if (frames & (1 << (15 - k))) keep = (keep * dampingRoots[k]) >> 30;
+    }
+    return FX_ONE - (PongFixed)(keep >> (30 - PONG_FIXED_SHIFT));
+}
+
+// ---------------------------------------------------------------------------
+// Simulation. The same phases as pong_core.c, step for step, on the
+// fixed-point mirror in PongState.fx.
+// ---------------------------------------------------------------------------
+
+#define PADDLE_MARGIN PONG_FX_INT(50)
+#define FX_BALL_SIZE PONG_FX_INT(BALL_SIZE)
+#define FX_BALL_RADIUS (FX_BALL_SIZE / 2)
+#define FX_PADDLE_WIDTH PONG_FX_INT(PADDLE_WIDTH)
+#define FX_PADDLE_HEIGHT PONG_FX_INT(PADDLE_HEIGHT)
+#define FX_BASE_BALL_SPEED PONG_FX(BASE_BALL_SPEED)
+#define FX_MAX_BALL_SPEED PONG_FX(MAX_BALL_SPEED)
+
+// dt in fixed seconds to 60 Hz frames
+static inline PongFixed Frames(PongFixed dt) {
+    return dt * (int)PONG_REFERENCE_HZ;
+}
+
+void Pong_UseFixedPoint(PongState* s) {
+    PongFixedBody* f = &s->fx;
+    s->fixedPoint = true;
+    f->arenaX = PongFixed_FromFloat(s->currentArena.x);
+    f->arenaY = PongFixed_FromFloat(s->currentArena.y);
+    f->arenaW = PongFixed_FromFloat(s->currentArena.width);
+    f->arenaH = PongFixed_FromFloat(s->currentArena.height);
+    f->windowX = PongFixed_FromFloat(s->windowPos.x);
+    f->windowY = PongFixed_FromFloat(s->windowPos.y);
+    f->p1Y = PongFixed_FromFloat(s->p1.y);
+    f->p2X = PongFixed_FromFloat(s->p2.x);
+    f->p2Y = PongFixed_FromFloat(s->p2.y);
+    f->p1LockedY = PongFixed_FromFloat(s->p1LockedWorldY);
+    f->p2LockedY = PongFixed_FromFloat(s->p2LockedWorldY);
+    f->ballX = PongFixed_FromFloat(s->ballPos.x);
+    f->ballY = PongFixed_FromFloat(s->ballPos.y);
+    f->speedX = PongFixed_FromFloat(s->ballSpeed.x);
+    f->speedY = PongFixed_FromFloat(s->ballSpeed.y);
+    f->difficulty = PongFixed_FromFloat(s->aiDifficulty);
+    f->targetY = PongFixed_FromFloat(s->targetY);
+    f->interceptY = PongFixed_FromFloat(s->aiInterceptY);
+    f->errorOffset = PongFixed_FromFloat(s->aiErrorOffset);
+    f->reactionTimer = PongFixed_FromFloat(s->reactionTimer);
+    f->animTimer = PongFixed_FromFloat(s->animTimer);
+    // A running expansion continues from animTimer instead of its tweens
+    PongTween_CancelGroup(&s->tweens, PONG_TWEEN_GROUP_EXPAND);
+}
+
+// The float view of the state, for rendering and anything else reading it
+static void SyncFloats(PongState* s) {
+    const PongFixedBody* f = &s->fx;
+    s->currentArena = (Arena){ PongFixed_ToFloat(f->arenaX), PongFixed_ToFloat(f->arenaY),
+                               PongFixed_ToFloat(f->arenaW), PongFixed_ToFloat(f->arenaH) };
+    s->windowPos = (PongVec2){ PongFixed_ToFloat(f->windowX), PongFixed_ToFloat(f->windowY) };
+    s->p1.y = PongFixed_ToFloat(f->p1Y);
+    s->p2.x = PongFixed_ToFloat(f->p2X);
+    s->p2.y = PongFixed_ToFloat(f->p2Y);
+    s->p1LockedWorldY = PongFixed_ToFloat(f->p1LockedY);
+    s->p2LockedWorldY = PongFixed_ToFloat(f->p2LockedY);
+    s->ballPos = (PongVec2){ PongFixed_ToFloat(f->ballX), PongFixed_ToFloat(f->ballY) };
+    s->ballSpeed = (PongVec2){ PongFixed_ToFloat(f->speedX), PongFixed_ToFloat(f->speedY) };
+    s->aiDifficulty = PongFixed_ToFloat(f->difficulty);
+    s->targetY = PongFixed_ToFloat(f->targetY);
+    s->aiInterceptY = PongFixed_ToFloat(f->interceptY);
+    s->aiErrorOffset = PongFixed_ToFloat(f->errorOffset);
+    s->reactionTimer = PongFixed_ToFloat(f->reactionTimer);
+    s->animTimer = PongFixed_ToFloat(f->animTimer);
+}
+
+// 1. Animation. The expansion is evaluated here instead of by the float
+// tweens; score pops stay tweens, they are presentation only.
+static void UpdateAnimation(PongState* s, const PongInput* in, PongFixed dt, float dtSeconds) {
+    PongFixedBody* f = &s->fx;
+    PongTween_Update(&s->tweens, s, PONG_TWEEN_OFFSETS, dtSeconds);
+
+    if (s->isAnimating) {
+        f->animTimer += dt;
+        PongFixed duration = PongFixed_FromFloat(s->animDuration);
+        PongFixed t = f->animTimer >= duration ? FX_ONE : Div(f->animTimer, duration);
+        PongFixed e = PongFixed_EaseInOutCubic(t);
+        f->arenaX = Lerp(PongFixed_FromFloat(s->startArena.x), PongFixed_FromFloat(s->targetArena.x), e);
+        f->arenaY = Lerp(PongFixed_FromFloat(s->startArena.y), PongFixed_FromFloat(s->targetArena.y), e);
+        f->arenaW = Lerp(PongFixed_FromFloat(s->startArena.width), PongFixed_FromFloat(s->targetArena.width), e);
+        f->arenaH = Lerp(PongFixed_FromFloat(s->startArena.height), PongFixed_FromFloat(s->targetArena.height), e);
+        f->windowX = Truncate(Lerp(PongFixed_FromFloat(s->windowStartPos.x), PongFixed_FromFloat(s->windowTargetPos.x), e));
+        f->windowY = Truncate(Lerp(PongFixed_FromFloat(s->windowStartPos.y), PongFixed_FromFloat(s->windowTargetPos.y), e));
+        s->titleBarOffset = PongFixed_ToFloat(Mul(PONG_FX_INT(TITLE_BAR_HEIGHT), FX_ONE - e));
+
+        if (t >= FX_ONE) {
+            s->isAnimating = false;
+            s->isExpanded = true;
+            s->isLocked = true;
+            f->windowX = PongFixed_FromFloat(s->windowTargetPos.x);
+            f->windowY = PongFixed_FromFloat(s->windowTargetPos.y);
+            s->events |= PONG_EVENT_EXPAND_DONE;
+        }
+
+        f->p1Y = f->p1LockedY - f->arenaY;
+        f->p2Y = f->p2LockedY - f->arenaY;
+        f->p2X = f->arenaW - PADDLE_MARGIN - FX_PADDLE_WIDTH;
+    }
+    else if (s->isLocked) {
+        f->windowX = PongFixed_FromFloat(s->windowTargetPos.x);
+        f->windowY = PongFixed_FromFloat(s->windowTargetPos.y);
+        f->arenaX = PongFixed_FromFloat(s->targetArena.x);
+        f->arenaY = PongFixed_FromFloat(s->targetArena.y);
+        f->arenaW = PongFixed_FromFloat(s->targetArena.width);
+        f->arenaH = PongFixed_FromFloat(s->targetArena.height);
+    }
+    else if (!s->isExpanded) {
+        f->windowX = f->arenaX = PongFixed_FromFloat(in->windowX);
+        f->windowY = f->arenaY = PongFixed_FromFloat(in->windowY);
+    }
+}
+
+// 2. Input
+static void ApplyInput(PongState* s, const PongInput* in, PongFixed dt) {
+    PongFixedBody* f = &s->fx;
+    bool locked = s->isAnimating || s->isLocked;
+    PongFixed moveSpeed = 9 * Frames(dt);
+    PongFixed up = in->upHeld ? moveSpeed * in->upHeld / PONG_INPUT_SUBSTEPS : moveSpeed;
+    PongFixed down = in->downHeld ? moveSpeed * in->downHeld / PONG_INPUT_SUBSTEPS : moveSpeed;
+    if (in->keys & PONG_KEY_UP_ANY) {
+        f->p1Y -= up; s->gameStarted = true;
+        if (locked) f->p1LockedY -= up;
+    }
+    if (in->keys & PONG_KEY_DOWN_ANY) {
+        f->p1Y += down; s->gameStarted = true;
+        if (locked) f->p1LockedY += down;
+    }
+    if (!s->versus) return;
+
+    if (in->keys2 & (PONG_KEY_W | PONG_KEY_UP)) {
+        f->p2Y -= moveSpeed; s->gameStarted = true;
+        if (locked) f->p2LockedY -= moveSpeed;
+    }
+    if (in->keys2 & (PONG_KEY_S | PONG_KEY_DOWN)) {
+        f->p2Y += moveSpeed; s->gameStarted = true;
+        if (locked) f->p2LockedY += moveSpeed;
+    }
+}
+
+// 3A. Difficulty, with the square root done on integers
+static PongFixed ComputeDifficulty(const PongState* s) {
+    const PongAIParams* ai = &s->ai;
+    PongFixed scoreDiff = PONG_FX_INT(s->score1 - s->score2);
+    PongFixed threshold = PongFixed_FromFloat(ai->scoreThreshold);
+
+    if (s->aiHitsTotal <= ai->guaranteedHits) return FX_ONE;
+    if (scoreDiff <= -threshold) return PongFixed_FromFloat(ai->facilitateDifficulty);
+    if (scoreDiff >= threshold) return FX_ONE;
+
+    PongFixed hits = PONG_FX_INT(s->aiHitsTotal - ai->guaranteedHits);
+    PongFixed d = PongFixed_FromFloat(ai->baseDifficulty) + Mul(PongFixed_Sqrt(hits), PongFixed_FromFloat(ai->scalingFactor));
+    PongFixed cap = PongFixed_FromFloat(ai->difficultyCap);
+    return d > cap ? cap : d;
+}
+
+static PongFixed PredictInterceptY(PongFixed ballX, PongFixed ballY, PongFixed vx, PongFixed vy, PongFixed targetX, PongFixed arenaH) {
+    PongFixed range = arenaH - FX_BALL_SIZE;
+    if (range <= 0) return 0;
+
+    // Unfolded straight line, folded back with an exact integer modulo
+    PongFixed t = Div(targetX - ballX, vx);
+    long long period = 2LL * range;
+    long long y = (ballY + (((long long)vy * t) >> PONG_FIXED_SHIFT)) % period;
+    if (y < 0) y += period;
+    if (y > range) y = period - y;
+    return (PongFixed)y;
+}
+
+static void InvalidatePrediction(PongState* s) {
+    s->aiPredictionValid = false;
+    s->fx.reactionTimer = 0;
+}
+
+static void UpdateTarget(PongState* s) {
+    PongFixedBody* f = &s->fx;
+    if (f->speedX > 0) {
+        f->interceptY = PredictInterceptY(f->ballX, f->ballY, f->speedX, f->speedY, f->p2X - FX_BALL_SIZE, f->arenaH);
+    } else {
+        f->interceptY = f->arenaH / 2 - FX_BALL_RADIUS;
+    }
+    f->targetY = Clamp(f->interceptY + FX_BALL_RADIUS + f->errorOffset, FX_PADDLE_HEIGHT / 2, f->arenaH - FX_PADDLE_HEIGHT / 2);
+}
+
+// 3B. AI movement
+static void UpdateAI(PongState* s, PongFixed dt) {
+    PongFixedBody* f = &s->fx;
+    PongFixed frames = Frames(dt);
+    f->difficulty = ComputeDifficulty(s);
+    bool isPerfect = (f->difficulty == FX_ONE);
+
+    bool refresh = false;
+    if (!s->aiPredictionValid) {
+        f->reactionTimer += dt;
+        if (isPerfect || f->reactionTimer >= PongFixed_FromFloat(s->ai.reactionDelay)) {
+            f->reactionTimer = 0;
+            if (isPerfect) {
+                f->errorOffset = 0;
+            } else {
+                int maxError = Mul(PongFixed_FromFloat(s->ai.maxErrorScale), FX_ONE - f->difficulty) >> PONG_FIXED_SHIFT;
+                f->errorOffset = PONG_FX_INT(Pong_RandomInt(s, -maxError / 2, maxError / 2));
+                Analytics_Emit(ANALYTICS_AIM, 2, s->rallyHits, s->frame, PongFixed_ToFloat(f->difficulty), PongFixed_ToFloat(f->errorOffset));
+            }
+            s->aiPredictionValid = true;
+            refresh = true;
+        }
+    }
+    if (s->aiPredictionValid && (refresh || s->isAnimating)) UpdateTarget(s);
+
+    PongFixed diff = f->targetY - (f->p2Y + FX_PADDLE_HEIGHT / 2);
+    PongFixed moveStep;
+    if (isPerfect) {
+        PongFixed speed = Mul(PONG_FX(9.5), frames);
+        moveStep = Clamp(diff, -speed, speed);
+    } else {
+        PongFixed speed = Mul(PONG_FX_INT(5) + 4 * f->difficulty, frames);
+        moveStep = Clamp(Mul(diff, PongFixed_Damping(frames)), -speed, speed);
+    }
+
+    if (Abs(diff) > PONG_FX(0.01)) {
+        f->p2Y += moveStep;
+        if (s->isAnimating || s->isLocked) f->p2LockedY += moveStep;
+    }
+}
+
+// Swept ball box against a paddle, as Pong_SweepPaddleHit. Times are
+// fractions of delta; the range ends stand in for infinity.
+static bool SweepPaddleHit(PongFixed x, PongFixed y, PongFixed dx, PongFixed dy, PongFixed paddleX, PongFixed paddleY, PongFixed* toi) {
+    PongFixed minX = paddleX - FX_BALL_SIZE, maxX = paddleX + FX_PADDLE_WIDTH;
+    PongFixed minY = paddleY - FX_BALL_SIZE, maxY = paddleY + FX_PADDLE_HEIGHT;
+
+    // Integer division is slow: skip it unless the move's bounding box
+    // reaches the paddle
+    if ((dx >= 0 ? x + dx < minX : x + dx > maxX) || (dx >= 0 ? x > maxX : x < minX)) return false;
+    if ((dy >= 0 ? y + dy < minY : y + dy > maxY) || (dy >= 0 ? y > maxY : y < minY)) return false;
+
+    PongFixed enterX, exitX, enterY, exitY;
+    if (dx == 0) {
+        if (x <= minX || x >= maxX) return false;
+        enterX = PONG_FIXED_MIN; exitX = PONG_FIXED_MAX;
+    } else {
+        PongFixed t1 = Div(minX - x, dx), t2 = Div(maxX - x, dx);
+        enterX = t1 < t2 ? t1 : t2; exitX = t1 < t2 ? t2 : t1;
+    }
+    if (dy == 0) {
+        if (y <= minY || y >= maxY) return false;
+        enterY = PONG_FIXED_MIN; exitY = PONG_FIXED_MAX;
+    } else {
+        PongFixed t1 = Div(minY - y, dy), t2 = Div(maxY - y, dy);
+        enterY = t1 < t2 ? t1 : t2; exitY = t1 < t2 ? t2 : t1;
+    }
+
+    PongFixed enter = enterX > enterY ? enterX : enterY;
+    PongFixed exit = exitX < exitY ? exitX : exitY;
+    if (enter >= exit || enter > FX_ONE || exit <= 0) return false;
+    *toi = enter < 0 ? 0 : enter;
+    return true;
+}
+
+static void ResetPoint(PongState* s) {
+    PongFixedBody* f = &s->fx;
+    f->ballX = f->arenaW / 2;
+    f->ballY = f->arenaH / 2;
+    s->gameStarted = false;
+    s->playerHits = 0;
+    s->rallyHits = 0;
+
+    PongFixed paddleY = f->arenaH / 2 - FX_PADDLE_HEIGHT / 2;
+    f->p1Y = paddleY;
+    f->p2Y = paddleY;
+    f->p1LockedY = f->arenaY + f->p1Y;
+    f->p2LockedY = f->arenaY + f->p2Y;
+    f->targetY = f->arenaH / 2;
+    f->speedX = FX_BASE_BALL_SPEED;
+    f->speedY = FX_BASE_BALL_SPEED;
+    InvalidatePrediction(s);
+}
+
+// Contact point on the paddle for analytics, -1 (top edge) to 1 (bottom)
+static float HitContact(PongFixed ballY, PongFixed paddleY) {
+    PongFixed offset = ballY + FX_BALL_RADIUS - (paddleY + FX_PADDLE_HEIGHT / 2);
+    return PongFixed_ToFloat(offset) / (PADDLE_HEIGHT / 2.0f + BALL_RADIUS);
+}
+
+static void HitPlayer1(PongState* s, const PongInput* in) {
+    PongFixedBody* f = &s->fx;
+    Analytics_Emit(ANALYTICS_HIT, 1, ++s->rallyHits, s->frame, PongFixed_ToFloat(f->difficulty), HitContact(f->ballY, f->p1Y));
+    bool belowMax = f->speedX > -FX_MAX_BALL_SPEED && f->speedX < FX_MAX_BALL_SPEED;
+    f->speedX = -f->speedX;
+    f->ballX = PADDLE_MARGIN + FX_PADDLE_WIDTH + FX_ONE;
+    s->events |= PONG_EVENT_HIT_P1;
+
+    f->speedX += f->speedX > 0 ? FX_ONE : -FX_ONE;
+    f->speedX = Clamp(f->speedX, -FX_MAX_BALL_SPEED, FX_MAX_BALL_SPEED);
+    if (belowMax && (f->speedX == FX_MAX_BALL_SPEED || f->speedX == -FX_MAX_BALL_SPEED)) {
+        Analytics_Emit(ANALYTICS_MAX_SPEED, 1, s->rallyHits, s->frame, MAX_BALL_SPEED, 0.0f);
+    }
+
+    if (!s->isExpanded && !s->isAnimating) {
+        s->playerHits++;
+        if (s->playerHits >= 2) {
+            s->isAnimating = true;
+            s->events |= PONG_EVENT_EXPAND_START;
+            s->startArena = (Arena){ in->windowX, in->windowY, (float)INITIAL_WIDTH, (float)INITIAL_HEIGHT };
+            s->windowStartPos = (PongVec2){ in->windowX, in->windowY };
+            f->p1LockedY = PongFixed_FromFloat(in->windowY) + f->p1Y;
+            f->p2LockedY = PongFixed_FromFloat(in->windowY) + f->p2Y;
+        }
+    }
+}
+
+static void HitPlayer2(PongState* s) {
+    PongFixedBody* f = &s->fx;
+    Analytics_Emit(ANALYTICS_HIT, 2, ++s->rallyHits, s->frame, PongFixed_ToFloat(f->difficulty), HitContact(f->ballY, f->p2Y));
+    f->speedX = -f->speedX;
+    f->ballX = f->p2X - FX_BALL_SIZE - FX_ONE;
+    s->aiHitsTotal++;
+    s->events |= PONG_EVENT_HIT_P2;
+}
+
+#define SWEEP_NONE 0
+#define SWEEP_WALL 1
+#define SWEEP_P1   2
+#define SWEEP_P2   3
+#define SWEEP_MAX_ITERATIONS 4
+
+// 3C. Physics, collision and scoring
+static void UpdatePhysics(PongState* s, const PongInput* in, PongFixed dt) {
+    PongFixedBody* f = &s->fx;
+    PongFixed remaining = FX_ONE;
+    PongFixed frames = Frames(dt);
+    PongFixed floorY = f->arenaH - FX_BALL_SIZE;
+
+    for (int i = 0; i < SWEEP_MAX_ITERATIONS && remaining > 0; i++) {
+        PongFixed dx = Mul(Mul(f->speedX, frames), remaining);
+        PongFixed dy = Mul(Mul(f->speedY, frames), remaining);
+        PongFixed toi = FX_ONE, t;
+        int hit = SWEEP_NONE;
+
+        if (dy < 0) {
+            t = Div(-f->ballY, dy);
+            if (t < toi) { toi = t < 0 ? 0 : t; hit = SWEEP_WALL; }
+        } else if (dy > 0) {
+            t = Div(floorY - f->ballY, dy);
+            if (t < toi) { toi = t < 0 ? 0 : t; hit = SWEEP_WALL; }
+        }
+        if (dx < 0 && SweepPaddleHit(f->ballX, f->ballY, dx, dy, PADDLE_MARGIN, f->p1Y, &t) && t <= toi) { toi = t; hit = SWEEP_P1; }
+        if (dx > 0 && SweepPaddleHit(f->ballX, f->ballY, dx, dy, f->p2X, f->p2Y, &t) && t <= toi) { toi = t; hit = SWEEP_P2; }
+
+        f->ballX += Mul(dx, toi);
+        f->ballY += Mul(dy, toi);
+        remaining = Mul(remaining, FX_ONE - toi);
+
+        if (hit == SWEEP_NONE) break;
+        if (hit == SWEEP_WALL) f->speedY = -f->speedY;
+        else if (hit == SWEEP_P1) HitPlayer1(s, in);
+        else HitPlayer2(s);
+        InvalidatePrediction(s);
+    }
+
+    if (f->ballX < 0) {
+        s->score2++;
+        s->events |= PONG_EVENT_SCORE_P2;
+        Analytics_Emit(ANALYTICS_POINT, 2, s->rallyHits, s->frame, PongFixed_ToFloat(f->speedX < 0 ? -f->speedX : f->speedX), 0.0f);
+        Pong_StartScorePop(s, 2);
+        ResetPoint(s);
+    }
+    if (f->ballX > f->arenaW) {
+        s->score1++;
+        s->events |= PONG_EVENT_SCORE_P1;
+        Analytics_Emit(ANALYTICS_POINT, 1, s->rallyHits, s->frame, PongFixed_ToFloat(f->speedX < 0 ? -f->speedX : f->speedX), 0.0f);
+        Pong_StartScorePop(s, 1);
+        ResetPoint(s);
+    }
+}
+
+// 4. Clamping
+static void ClampPaddles(PongState* s) {
+    PongFixedBody* f = &s->fx;
+    bool worldLocked = s->isAnimating || s->isLocked;
+    PongFixed maxY = f->arenaH - FX_PADDLE_HEIGHT;
+    if (f->p1Y < 0) { f->p1Y = 0; if (worldLocked) f->p1LockedY = f->arenaY; }
+    if (f->p1Y > maxY) { f->p1Y = maxY; if (worldLocked) f->p1LockedY = f->arenaY + f->p1Y; }
+    if (s->isExpanded && !s->isAnimating) f->p2X = f->arenaW - PADDLE_MARGIN - FX_PADDLE_WIDTH;
+    if (f->p2Y < 0) { f->p2Y = 0; if (worldLocked) f->p2LockedY = f->arenaY; }
+    if (f->p2Y > maxY) { f->p2Y = maxY; if (worldLocked) f->p2LockedY = f->arenaY + f->p2Y; }
+}
+
+void Pong_StepFixed(PongState* s, const PongInput* in, float dt) {
+    PongFixed fdt = PongFixed_FromFloat(dt);
+    s->events = 0;
+
+    PROFILE_BEGIN(PROF_ANIMATION);
+    UpdateAnimation(s, in, fdt, dt);
+    PROFILE_END(PROF_ANIMATION);
+
+    PROFILE_BEGIN(PROF_INPUT);
+    ApplyInput(s, in, fdt);
+    PROFILE_END(PROF_INPUT);
+
+    if (s->gameStarted) {
+        PROFILE_BEGIN(PROF_AI_PHYSICS);
+        if (!s->versus) UpdateAI(s, fdt);
+        UpdatePhysics(s, in, fdt);
+        PROFILE_END(PROF_AI_PHYSICS);
+    }
+
+    PROFILE_BEGIN(PROF_CLAMP);
+    ClampPaddles(s);
+    PROFILE_END(PROF_CLAMP);
+
+    s->frame++;
+    SyncFloats(s);
+}
@@ -0,0 +1,50 @@
+#ifndef PONG_FIXED_H
+#define PONG_FIXED_H
+
+// 16.16 fixed point for the deterministic simulation mode
+// (PongState.fixedPoint). Integer arithmetic gives the same bits on every
+// compiler, optimisation level and CPU, where float results can change with
+// contraction into FMA, x87 precision or a different powf. Only conversions
+// from the float parameters (dt, AI tunables, window positions) touch floats,
+// and those are exact or correctly rounded.
+//
+// Values are pixels (speeds in pixels per 60 Hz frame) or seconds, with 16
+// fraction bits: about 32767 px of range and 1/65536 px of resolution.
+// Signed shifts are assumed arithmetic, as on every compiler we build with.
+
+typedef int PongFixed;
+
+#define PONG_FIXED_SHIFT 16
+#define PONG_FIXED_ONE (1 << PONG_FIXED_SHIFT)
+#define PONG_FIXED_MAX 0x7FFFFFFF
+#define PONG_FIXED_MIN (-0x7FFFFFFF - 1)
+// Constant from a literal, folded at compile time
+#define PONG_FX(x) ((PongFixed)((x) * 65536.0 + ((x) >= 0 ? 0.5 : -0.5)))
+#define PONG_FX_INT(n) ((PongFixed)(n) * PONG_FIXED_ONE)
+
+// Fixed-point mirror of the simulated values. When PongState.fixedPoint is
+// set these are the authoritative ones and the float fields are written from
+// them after every step, for rendering and tools.
+typedef struct {
+    PongFixed arenaX, arenaY, arenaW, arenaH;
+    PongFixed windowX, windowY;
+    PongFixed p1Y, p2X, p2Y;
+    PongFixed p1LockedY, p2LockedY;
+    PongFixed ballX, ballY, speedX, speedY;
+    PongFixed difficulty, targetY, interceptY, errorOffset;
+    PongFixed reactionTimer, animTimer;     // Seconds
+} PongFixedBody;
+
+// Nearest fixed value (saturated to the range)
+PongFixed PongFixed_FromFloat(float f);
+float PongFixed_ToFloat(PongFixed x);
+
+PongFixed PongFixed_Mul(PongFixed a, PongFixed b);
+// Saturates instead of overflowing; b must not be 0
+PongFixed PongFixed_Div(PongFixed a, PongFixed b);
+PongFixed PongFixed_Sqrt(PongFixed x);
+PongFixed PongFixed_EaseInOutCubic(PongFixed t);
+// 1 - 0.85^frames, the AI's damping for a step of that many 60 Hz frames
+PongFixed PongFixed_Damping(PongFixed frames);
+
+#endif
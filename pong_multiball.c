@@ -0,0 +1,232 @@
+#include "pong_multiball.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#define PADDLE_MARGIN 50.0f
+#define PADDLE_SPEED 9.5f
+
+static float NextUnit(PongMultiBall* m) {
+    // xorshift64*, same generator as the game state
+    unsigned long long x = m->rngState;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    m->rngState = x;
+    return (float)((x * 2685821657736338717ULL) >> 40) / (float)(1 << 24);
+}
+
+static void RandomVelocity(PongMultiBall* m, int i) {
+    float speed = BASE_BALL_SPEED + NextUnit(m) * (MAX_BALL_SPEED - BASE_BALL_SPEED);
+    // Mostly horizontal, so balls actually travel between the paddles
+    float angle = (NextUnit(m) - 0.5f) * 1.4f;
+    float side = NextUnit(m) < 0.5f ? -1.0f : 1.0f;
+    m->vx[i] = side * speed * cosf(angle);
+    m->vy[i] = speed * sinf(angle);
+}
+
+bool PongMultiBall_Init(PongMultiBall* m, int count, float arenaWidth, float arenaHeight, unsigned long long seed) {
+    memset(m, 0, sizeof(*m));
+    if (count <= 0) return false;
+
+    m->gridW = (int)ceilf(arenaWidth / PONG_MULTIBALL_CELL);
+    m->gridH = (int)ceilf(arenaHeight / PONG_MULTIBALL_CELL);
+    int cells = m->gridW * m->gridH;
+    size_t bytes = (size_t)count * (4 * sizeof(float) + 2 * sizeof(int)) + (size_t)(cells + 1) * sizeof(int);
+    m->memory = calloc(1, bytes);
+    if (!m->memory) return false;
+
+    // One block: the four float arrays, then the grid
+    unsigned char* cursor = (unsigned char*)m->memory;
+    m->x = (float*)cursor;  cursor += (size_t)count * sizeof(float);
+    m->y = (float*)cursor;  cursor += (size_t)count * sizeof(float);
+    m->vx = (float*)cursor; cursor += (size_t)count * sizeof(float);
+    m->vy = (float*)cursor; cursor += (size_t)count * sizeof(float);
+    m->cellBalls = (int*)cursor; cursor += (size_t)count * sizeof(int);
+    m->ballCell = (int*)cursor;  cursor += (size_t)count * sizeof(int);
+    m->cellStart = (int*)cursor;
+
+    m->count = count;
+    m->arenaWidth = arenaWidth;
+    m->arenaHeight = arenaHeight;
+    m->radius = PONG_MULTIBALL_RADIUS;
+    m->rngState = seed ? seed : 0x9E3779B97F4A7C15ULL;
+    m->p1 = (PongRect){ PADDLE_MARGIN, arenaHeight/2.0f - PADDLE_HEIGHT/2.0f, PADDLE_WIDTH, PADDLE_HEIGHT };
+    m->p2 = (PongRect){ arenaWidth - PADDLE_MARGIN - PADDLE_WIDTH, arenaHeight/2.0f - PADDLE_HEIGHT/2.0f, PADDLE_WIDTH, PADDLE_HEIGHT };
+
+    // Jittered lattice between the paddles so no two balls start overlapping
+    float left = PADDLE_MARGIN + PADDLE_WIDTH + 4.0f * m->radius;
+    float usableW = arenaWidth - 2.0f * left;
+    float spacing = sqrtf(usableW * arenaHeight / (float)count);
+    if (spacing < 2.2f * m->radius) spacing = 2.2f * m->radius;
+    int columns = (int)(usableW / spacing);
+    if (columns < 1) columns = 1;
+    float jitter = spacing - 2.2f * m->radius;
+    for (int i = 0; i < count; i++) {
+        int row = i / columns, column = i % columns;
+        m->x[i] = left + (column + 0.5f) * spacing + (NextUnit(m) - 0.5f) * jitter;
+        m->y[i] = fmodf((row + 0.5f) * spacing, arenaHeight - 2.0f * m->radius) + m->radius + (NextUnit(m) - 0.5f) * jitter;
+        RandomVelocity(m, i);
+    }
+    return true;
+}
+
+void PongMultiBall_Free(PongMultiBall* m) {
+    free(m->memory);
+    memset(m, 0, sizeof(*m));
+}
+
+static int CellOf(const PongMultiBall* m, float x, float y) {
+    int cx = (int)(x * (1.0f / PONG_MULTIBALL_CELL));
+    int cy = (int)(y * (1.0f / PONG_MULTIBALL_CELL));
+    if (cx < 0) cx = 0;
+    if (cx >= m->gridW) cx = m->gridW - 1;
+    if (cy < 0) cy = 0;
+    if (cy >= m->gridH) cy = m->gridH - 1;
+    return cy * m->gridW + cx;
+}
+
+// Counting sort of the balls by cell
+static void BuildGrid(PongMultiBall* m) {
+    int cells = m->gridW * m->gridH;
+    memset(m->cellStart, 0, (size_t)(cells + 1) * sizeof(int));
+    for (int i = 0; i < m->count; i++) {
+        int c = CellOf(m, m->x[i], m->y[i]);
+        m->ballCell[i] = c;
+        m->cellStart[c + 1]++;
+    }
+    for (int c = 0; c < cells; c++) m->cellStart[c + 1] += m->cellStart[c];
+    // cellStart[c] is now the first slot of cell c; fill using it as a cursor
+    for (int i = 0; i < m->count; i++) m->cellBalls[m->cellStart[m->ballCell[i]]++] = i;
+    // The cursors ended at the next cell's start: shift back by one cell
+    for (int c = cells; c > 0; c--) m->cellStart[c] = m->cellStart[c - 1];
+    m->cellStart[0] = 0;
+}
+
+static void Collide(PongMultiBall* m, int i, int j) {
+    m->pairTests++;
+    float dx = m->x[j] - m->x[i], dy = m->y[j] - m->y[i];
+    float minDist = 2.0f * m->radius;
+    float d2 = dx * dx + dy * dy;
+    if (d2 >= minDist * minDist || d2 == 0.0f) return;
+
+    float d = sqrtf(d2);
+    float nx = dx / d, ny = dy / d;
+    // Push apart, then exchange the normal velocity components (equal
+    // masses, elastic) if they are approaching
+    float push = 0.5f * (minDist - d);
+    m->x[i] -= nx * push; m->y[i] -= ny * push;
+    m->x[j] += nx * push; m->y[j] += ny * push;
+
+    float approach = (m->vx[i] - m->vx[j]) * nx + (m->vy[i] - m->vy[j]) * ny;
+    if (approach <= 0.0f) return;
+    m->vx[i] -= approach * nx; m->vy[i] -= approach * ny;
+    m->vx[j] += approach * nx; m->vy[j] += approach * ny;
+    m->ballHits++;
+}
+
+static void CollideBalls(PongMultiBall* m) {
+    // Each pair once: the ball's own cell (later balls only) and the four
+    // "forward" neighbours
+    static const int offsets[4][2] = { { 1, 0 }, { -1, 1 }, { 0, 1 }, { 1, 1 } };
+    for (int cy = 0; cy < m->gridH; cy++) {
+        for (int cx = 0; cx < m->gridW; cx++) {
+            int c = cy * m->gridW + cx;
+            int begin = m->cellStart[c], end = m->cellStart[c + 1];
+            for (int a = begin; a < end; a++) {
+                int i = m->cellBalls[a];
+                for (int b = a + 1; b < end; b++) Collide(m, i, m->cellBalls[b]);
+                for (int k = 0; k < 4; k++) {
+                    int nx = cx + offsets[k][0], ny = cy + offsets[k][1];
+                    if (nx < 0 || nx >= m->gridW || ny >= m->gridH) continue;
+                    int n = ny * m->gridW + nx;
+                    for (int b = m->cellStart[n]; b < m->cellStart[n + 1]; b++) Collide(m, i, m->cellBalls[b]);
+                }
+            }
+        }
+    }
+}
+
+// Only the balls in the cells under the paddle (grown by the radius) are tested
+static void CollidePaddle(PongMultiBall* m, const PongRect* p, float direction) {
+    float r = m->radius;
+    int x0 = (int)((p->x - r) / PONG_MULTIBALL_CELL), x1 = (int)((p->x + p->width + r) / PONG_MULTIBALL_CELL);
+    int y0 = (int)((p->y - r) / PONG_MULTIBALL_CELL), y1 = (int)((p->y + p->height + r) / PONG_MULTIBALL_CELL);
+    if (x0 < 0) x0 = 0;
+    if (y0 < 0) y0 = 0;
+    if (x1 >= m->gridW) x1 = m->gridW - 1;
+    if (y1 >= m->gridH) y1 = m->gridH - 1;
+
+    for (int cy = y0; cy <= y1; cy++) {
+        for (int cx = x0; cx <= x1; cx++) {
+            int c = cy * m->gridW + cx;
+            for (int a = m->cellStart[c]; a < m->cellStart[c + 1]; a++) {
+                int i = m->cellBalls[a];
+                // Circle vs rectangle, only for balls moving into the paddle
+                if (m->vx[i] * direction > 0.0f) continue;
+                float nearX = fminf(fmaxf(m->x[i], p->x), p->x + p->width);
+                float nearY = fminf(fmaxf(m->y[i], p->y), p->y + p->height);
+                float dx = m->x[i] - nearX, dy = m->y[i] - nearY;
+                if (dx * dx + dy * dy >= r * r) continue;
+                m->vx[i] = -m->vx[i];
+                m->x[i] = (direction > 0.0f) ? p->x + p->width + r : p->x - r;
+                m->paddleHits++;
+            }
+        }
+    }
+}
+
+// Each paddle follows the incoming ball that will reach it first
+static void MovePaddles(PongMultiBall* m, float frames) {
+    float best1 = INFINITY, best2 = INFINITY;
+    float target1 = m->arenaHeight / 2.0f, target2 = target1;
+    float face1 = m->p1.x + m->p1.width, face2 = m->p2.x;
+    for (int i = 0; i < m->count; i++) {
+        if (m->vx[i] < 0.0f) {
+            float t = (m->x[i] - face1) / -m->vx[i];
+            if (t >= 0.0f && t < best1) { best1 = t; target1 = m->y[i]; }
+        } else if (m->vx[i] > 0.0f) {
+            float t = (face2 - m->x[i]) / m->vx[i];
+            if (t >= 0.0f && t < best2) { best2 = t; target2 = m->y[i]; }
+        }
+    }
+
+    float maxMove = PADDLE_SPEED * frames;
+    PongRect* paddles[2] = { &m->p1, &m->p2 };
+    float targets[2] = { target1, target2 };
+    for (int k = 0; k < 2; k++) {
+        float move = targets[k] - (paddles[k]->y + PADDLE_HEIGHT / 2.0f);
+        if (move > maxMove) move = maxMove;
+        if (move < -maxMove) move = -maxMove;
+        paddles[k]->y += move;
+        if (paddles[k]->y < 0.0f) paddles[k]->y = 0.0f;
+        if (paddles[k]->y > m->arenaHeight - PADDLE_HEIGHT) paddles[k]->y = m->arenaHeight - PADDLE_HEIGHT;
+    }
+}
+
+void PongMultiBall_Step(PongMultiBall* m, float dt) {
+    float frames = dt * PONG_REFERENCE_HZ;
+    float r = m->radius;
+    float maxY = m->arenaHeight - r;
+
+    MovePaddles(m, frames);
+
+    // Integrate, bounce off the top and bottom, score at the sides
+    for (int i = 0; i < m->count; i++) {
+        m->x[i] += m->vx[i] * frames;
+        m->y[i] += m->vy[i] * frames;
+        if (m->y[i] < r) { m->y[i] = r; m->vy[i] = fabsf(m->vy[i]); }
+        if (m->y[i] > maxY) { m->y[i] = maxY; m->vy[i] = -fabsf(m->vy[i]); }
+        if (m->x[i] < -r || m->x[i] > m->arenaWidth + r) {
+            if (m->x[i] < 0.0f) m->score2++; else m->score1++;
+            m->x[i] = m->arenaWidth / 2.0f;
+            m->y[i] = r + NextUnit(m) * (m->arenaHeight - 2.0f * r);
+            RandomVelocity(m, i);
+        }
+    }
+
+    BuildGrid(m);
+    CollideBalls(m);
+    CollidePaddle(m, &m->p1, 1.0f);
+    CollidePaddle(m, &m->p2, -1.0f);
+}
@@ -0,0 +1,52 @@
+#ifndef PONG_MULTIBALL_H
+#define PONG_MULTIBALL_H
+#include <stdbool.h>
+#include "pong_core.h"
+
+// Multi-ball stress mode: thousands of balls bouncing off each other, the
+// walls and both paddles in the expanded (full monitor) arena. Balls live in
+// one contiguous structure-of-arrays pool; a uniform grid rebuilt every step
+// (counting sort by cell) limits ball-ball tests to neighbouring cells and
+// ball-paddle tests to the cells under each paddle.
+//
+// Balls are smaller than the real one (PONG_MULTIBALL_RADIUS): 5 000 balls
+// of BALL_SIZE would cover more than a 1920x1080 arena. Positions are ball
+// centers. A ball leaving the arena on either side scores for the other
+// paddle and respawns in the middle.
+
+#define PONG_MULTIBALL_RADIUS 5.0f
+#define PONG_MULTIBALL_CELL 16      // Grid cell size, at least one ball diameter
+
+typedef struct PongMultiBall {
+    int count;
+    float arenaWidth, arenaHeight;
+    float radius;
+
+    float* x;
+    float* y;
+    float* vx;          // px per 60 Hz frame, like PongState.ballSpeed
+    float* vy;
+
+    PongRect p1, p2;
+    int score1, score2;
+    unsigned long long rngState;
+
+    // Broadphase
+    int gridW, gridH;
+    int* cellStart;     // gridW * gridH + 1 offsets into cellBalls
+    int* cellBalls;     // Ball indices sorted by cell
+    int* ballCell;
+
+    // Counters since the last reset
+    long long pairTests;
+    long long ballHits;
+    long long paddleHits;
+
+    void* memory;
+} PongMultiBall;
+
+bool PongMultiBall_Init(PongMultiBall* m, int count, float arenaWidth, float arenaHeight, unsigned long long seed);
+void PongMultiBall_Free(PongMultiBall* m);
+void PongMultiBall_Step(PongMultiBall* m, float dt);
+
+#endif
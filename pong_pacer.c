@@ -0,0 +1,85 @@
+#include "pong_pacer.h"
+#include "pong_clock.h"
+#include <string.h>
+
+#define INITIAL_SPIN_MARGIN_NS 1000000ULL
+#define MIN_SPIN_MARGIN_NS 200000ULL
+#define MAX_SPIN_MARGIN_NS 4000000ULL
+
+const int PONG_PACE_BUCKET_US[PONG_PACE_BUCKETS - 1] = { 50, 100, 250, 500, 1000, 2000, 4000 };
+
+void PongPacer_Init(PongPacer* p, double hz) {
+    memset(p, 0, sizeof(*p));
+    p->spin = true;
+    p->spinMarginNs = INITIAL_SPIN_MARGIN_NS;
+    PongPacer_SetRate(p, hz);
+}
+
+void PongPacer_SetRate(PongPacer* p, double hz) {
+    p->periodNs = (hz > 0.0) ? (unsigned long long)(1e9 / hz + 0.5) : 0;
+    if (p->lastNs != 0) p->nextNs = p->lastNs + p->periodNs;
+}
+
+// Learns how much the OS oversleeps: jumps up at once, decays slowly
+static void TrackOversleep(PongPacer* p, unsigned long long oversleep) {
+    unsigned long long target = oversleep + MIN_SPIN_MARGIN_NS / 2;
+    if (target > p->spinMarginNs) p->spinMarginNs = target;
+    else p->spinMarginNs -= (p->spinMarginNs - target) / 64;
+    if (p->spinMarginNs < MIN_SPIN_MARGIN_NS) p->spinMarginNs = MIN_SPIN_MARGIN_NS;
+    if (p->spinMarginNs > MAX_SPIN_MARGIN_NS) p->spinMarginNs = MAX_SPIN_MARGIN_NS;
+}
+
+static void Record(PongPacer* p, unsigned long long interval) {
+    PongPaceStats* st = &p->stats;
+    st->frames++;
+    st->intervalNs += interval;
+    if (p->periodNs == 0) return;
+
+    unsigned long long error = interval > p->periodNs ? interval - p->periodNs : p->periodNs - interval;
+    st->errorNs += error;
+    if (error > st->maxErrorNs) st->maxErrorNs = error;
+    if (interval * 2 > p->periodNs * 3) st->missed++;
+    int bucket = 0;
+    while (bucket < PONG_PACE_BUCKETS - 1 && error >= (unsigned long long)PONG_PACE_BUCKET_US[bucket] * 1000ULL) bucket++;
+    st->histogram[bucket]++;
+}
+
+double PongPacer_Wait(PongPacer* p) {
+    unsigned long long now = Pong_ClockNs();
+    if (p->lastNs == 0) {
+        // First frame: nothing to wait for
+        p->lastNs = now;
+        p->nextNs = now + p->periodNs;
+        return 0.0;
+    }
+
+    if (p->periodNs > 0) {
+        if (now > p->nextNs + p->periodNs) {
+            p->nextNs = now;
+            p->stats.resyncs++;
+        }
+        while (now < p->nextNs) {
+            unsigned long long left = p->nextNs - now;
+            if (p->spin && left <= p->spinMarginNs) break;
+            unsigned long long request = p->spin ? left - p->spinMarginNs : left;
+            // Below the OS timer resolution (Windows): the spin covers it
+            if (!Pong_SleepNs(request)) break;
+            unsigned long long woke = Pong_ClockNs();
+            p->stats.sleepNs += woke - now;
+            if (p->spin && woke - now > request) TrackOversleep(p, woke - now - request);
+            now = woke;
+            if (!p->spin) break;
+        }
+        if (p->spin && now < p->nextNs) {
+            unsigned long long spinStart = now;
+            while (now < p->nextNs) now = Pong_ClockNs();
+            p->stats.spinNs += now - spinStart;
+        }
+        p->nextNs += p->periodNs;
+    }
+
+    unsigned long long interval = now - p->lastNs;
+    p->lastNs = now;
+    Record(p, interval);
+    return (double)interval * 1e-9;
+}
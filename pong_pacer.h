@@ -0,0 +1,52 @@
+#ifndef PONG_PACER_H
+#define PONG_PACER_H
+#include <stdbool.h>
+
+// Frame pacing on the monotonic clock, replacing SetTargetFPS. Each frame has
+// a deadline one period after the previous one; Wait sleeps until shortly
+// before it and spins the rest, so frames are not late by the OS scheduler
+// tick. The spin margin follows the oversleep actually measured, so on a
+// quiet system little time is spent spinning.
+//
+// Deadlines advance by exactly one period, so an early or late frame does not
+// shift the ones after it. After falling more than a period behind (a stall,
+// a dragged window) the schedule restarts from now instead of rushing frames.
+//
+// Presentation and simulation rates are independent: the pacer paces
+// presented frames and returns the real time since the previous one, which
+// the game feeds into its fixed-step accumulator.
+
+#define PONG_PACE_UNCAPPED 0.0
+
+// Frame interval error buckets, upper bounds in microseconds (last: above)
+#define PONG_PACE_BUCKETS 8
+extern const int PONG_PACE_BUCKET_US[PONG_PACE_BUCKETS - 1];
+
+typedef struct {
+    long long frames;
+    long long histogram[PONG_PACE_BUCKETS];    // |interval - period|
+    unsigned long long errorNs;                // Sum of |interval - period|
+    unsigned long long maxErrorNs;
+    unsigned long long intervalNs;             // Sum of intervals
+    long long missed;                          // Intervals over 1.5 periods
+    long long resyncs;
+    unsigned long long sleepNs;
+    unsigned long long spinNs;
+} PongPaceStats;
+
+typedef struct {
+    unsigned long long periodNs;    // 0: uncapped
+    unsigned long long nextNs;      // Deadline of the next frame
+    unsigned long long lastNs;      // When the previous Wait returned
+    unsigned long long spinMarginNs;
+    bool spin;                      // false: sleep only (for comparison)
+    PongPaceStats stats;
+} PongPacer;
+
+void PongPacer_Init(PongPacer* p, double hz);
+// Changes the rate; the next frame is due one new period after the last one
+void PongPacer_SetRate(PongPacer* p, double hz);
+// Waits for the next frame and returns the seconds since the previous one
+double PongPacer_Wait(PongPacer* p);
+
+#endif
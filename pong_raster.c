@@ -0,0 +1,158 @@
+#include "pong_raster.h"
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+// Luma of each surface (full range). The window contents use the colors of
+// pong_render.c: black arena, dark gray net line, white scores and movers.
+#define LUMA_BLACK     0
+#define LUMA_DESKTOP   24
+#define LUMA_TITLE_BAR 48
+#define LUMA_DARKGRAY  80
+#define LUMA_WHITE     255
+
+#define SCORE_FONT_SIZE 60
+
+// Digits of a 5x7 pixel font, one byte per row (bit 4 is the left column),
+// drawn like raylib's default font: one glyph pixel per fontSize/10 and one
+// pixel of spacing
+static const unsigned char DIGITS[10][7] = {
+    { 0x0E, 0x11, 0x13, 0x15, 0x19, 0x11, 0x0E },
+    { 0x04, 0x0C, 0x04, 0x04, 0x04, 0x04, 0x0E },
+    { 0x0E, 0x11, 0x01, 0x02, 0x04, 0x08, 0x1F },
+    { 0x1F, 0x02, 0x04, 0x02, 0x01, 0x11, 0x0E },
+    { 0x02, 0x06, 0x0A, 0x12, 0x1F, 0x02, 0x02 },
+    { 0x1F, 0x10, 0x1E, 0x01, 0x01, 0x11, 0x0E },
+    { 0x06, 0x08, 0x10, 0x1E, 0x11, 0x11, 0x0E },
+    { 0x1F, 0x01, 0x02, 0x04, 0x08, 0x08, 0x08 },
+    { 0x0E, 0x11, 0x11, 0x0E, 0x11, 0x11, 0x0E },
+    { 0x0E, 0x11, 0x11, 0x0F, 0x01, 0x02, 0x0C },
+};
+
+typedef struct {
+    unsigned char* luma;
+    int width, height;
+    float scale;                // Frame pixels per monitor pixel
+    float offsetX, offsetY;     // Frame position of the monitor's origin
+} Target;
+
+static inline unsigned char Blend(unsigned char dst, unsigned char src, float coverage) {
+    int a = (int)(coverage * 256.0f + 0.5f);
+    return (unsigned char)((dst * (256 - a) + src * a + 128) >> 8);
+}
+
+// Rectangle in frame pixels; partly covered edge pixels are blended
+static void FillRect(Target* t, float x0, float y0, float x1, float y1, unsigned char value) {
+    if (x0 < 0.0f) x0 = 0.0f;
+    if (y0 < 0.0f) y0 = 0.0f;
+    if (x1 > (float)t->width) x1 = (float)t->width;
+    if (y1 > (float)t->height) y1 = (float)t->height;
+    if (x0 >= x1 || y0 >= y1) return;
+
+    int px0 = (int)x0, py0 = (int)y0;
+    int px1 = (int)ceilf(x1), py1 = (int)ceilf(y1);
+    int ix0 = (int)ceilf(x0), ix1 = (int)x1;     // Fully covered columns
+
+    for (int y = py0; y < py1; y++) {
+        float cy = fminf(y1, (float)y + 1.0f) - fmaxf(y0, (float)y);
+        unsigned char* row = t->luma + (size_t)y * (size_t)t->width;
+        if (cy >= 1.0f && ix1 > ix0) {
+            memset(row + ix0, value, (size_t)(ix1 - ix0));
+            if (px0 < ix0) row[px0] = Blend(row[px0], value, (float)ix0 - x0);
+            if (ix1 < px1) row[ix1] = Blend(row[ix1], value, x1 - (float)ix1);
+            continue;
+        }
+        for (int x = px0; x < px1; x++) {
+            float cx = fminf(x1, (float)x + 1.0f) - fmaxf(x0, (float)x);
+            row[x] = Blend(row[x], value, cx * cy);
+        }
+    }
+}
+
+// Rectangle in monitor pixels
+static void FillMonitorRect(Target* t, float x, float y, float w, float h, unsigned char value) {
+    float x0 = t->offsetX + x * t->scale, y0 = t->offsetY + y * t->scale;
+    FillRect(t, x0, y0, x0 + w * t->scale, y0 + h * t->scale, value);
+}
+
+static void FillMonitorCircle(Target* t, float centerX, float centerY, float radius, unsigned char value) {
+    float cx = t->offsetX + centerX * t->scale, cy = t->offsetY + centerY * t->scale;
+    float r = radius * t->scale;
+    int x0 = (int)floorf(cx - r - 1.0f), y0 = (int)floorf(cy - r - 1.0f);
+    int x1 = (int)ceilf(cx + r + 1.0f), y1 = (int)ceilf(cy + r + 1.0f);
+    if (x0 < 0) x0 = 0;
+    if (y0 < 0) y0 = 0;
+    if (x1 > t->width) x1 = t->width;
+    if (y1 > t->height) y1 = t->height;
+
+    for (int y = y0; y < y1; y++) {
+        unsigned char* row = t->luma + (size_t)y * (size_t)t->width;
+        float dy = (float)y + 0.5f - cy;
+        for (int x = x0; x < x1; x++) {
+            float dx = (float)x + 0.5f - cx;
+            // Distance from the edge approximates the covered fraction
+            float coverage = r + 0.5f - sqrtf(dx * dx + dy * dy);
+            if (coverage >= 1.0f) row[x] = value;
+            else if (coverage > 0.0f) row[x] = Blend(row[x], value, coverage);
+        }
+    }
+}
+
+// Digits at a monitor position, one rectangle per run of lit glyph pixels
+static void DrawNumber(Target* t, int number, float x, float y, int fontSize, unsigned char value) {
+    char text[12];
+    snprintf(text, sizeof(text), "%d", number);
+    float cell = (float)fontSize / 10.0f;
+    for (const char* c = text; *c; c++, x += 6.0f * cell) {
+        if (*c < '0' || *c > '9') continue;
+        const unsigned char* glyph = DIGITS[*c - '0'];
+        for (int row = 0; row < 7; row++) {
+            for (int col = 0; col < 5; col++) {
+                if (!(glyph[row] & (0x10 >> col))) continue;
+                int run = 1;
+                while (col + run < 5 && (glyph[row] & (0x10 >> (col + run)))) run++;
+                FillMonitorRect(t, x + col * cell, y + row * cell, run * cell, cell, value);
+                col += run - 1;
+            }
+        }
+    }
+}
+
+static int ScoreSize(float pop) {
+    return (int)(SCORE_FONT_SIZE * pop + 0.5f);
+}
+
+void PongRaster_DrawState(unsigned char* luma, int width, int height, const PongState* s) {
+    float monitorW = s->targetArena.width, monitorH = s->targetArena.height;
+    Target t = { luma, width, height, 1.0f, 0.0f, 0.0f };
+    t.scale = fminf((float)width / monitorW, (float)height / monitorH);
+    t.offsetX = ((float)width - monitorW * t.scale) / 2.0f;
+    t.offsetY = ((float)height - monitorH * t.scale) / 2.0f;
+
+    memset(luma, LUMA_BLACK, (size_t)width * (size_t)height);
+    FillMonitorRect(&t, 0.0f, 0.0f, monitorW, monitorH, LUMA_DESKTOP);
+
+    // Main window: the title bar while it is still on screen, then the
+    // client area as pong_render.c draws it
+    float titleBar = s->isExpanded ? 0.0f : (float)(int)s->titleBarOffset;
+    float windowX = s->windowPos.x, clientY = s->windowPos.y + titleBar;
+    if (titleBar > 0.0f) FillMonitorRect(&t, windowX, s->windowPos.y, INITIAL_WIDTH, titleBar, LUMA_TITLE_BAR);
+    FillMonitorRect(&t, windowX, clientY, INITIAL_WIDTH, INITIAL_HEIGHT, LUMA_BLACK);
+
+    int size1 = ScoreSize(s->scorePop1), size2 = ScoreSize(s->scorePop2);
+    DrawNumber(&t, s->score1, windowX + (float)(INITIAL_WIDTH/4 - (size1 - SCORE_FONT_SIZE)/4),
+               clientY + (float)(50 - (size1 - SCORE_FONT_SIZE)/2), size1, LUMA_WHITE);
+    DrawNumber(&t, s->score2, windowX + (float)(3*INITIAL_WIDTH/4 - (size2 - SCORE_FONT_SIZE)/4),
+               clientY + (float)(50 - (size2 - SCORE_FONT_SIZE)/2), size2, LUMA_WHITE);
+    FillMonitorRect(&t, windowX + INITIAL_WIDTH/2, clientY, 1.0f, INITIAL_HEIGHT, LUMA_DARKGRAY);
+
+    // Paddles and the round ball window, where the overlays would be. Before
+    // the expansion the window draws them at the same place.
+    PongWinRect rects[PONG_OVERLAY_COUNT];
+    Pong_GetOverlayRects(s, rects);
+    for (int i = PONG_OVERLAY_PADDLE1; i <= PONG_OVERLAY_PADDLE2; i++) {
+        FillMonitorRect(&t, (float)rects[i].x, (float)rects[i].y, (float)rects[i].width, (float)rects[i].height, LUMA_WHITE);
+    }
+    const PongWinRect* ball = &rects[PONG_OVERLAY_BALL];
+    FillMonitorCircle(&t, ball->x + ball->width / 2.0f, ball->y + ball->height / 2.0f, ball->width / 2.0f, LUMA_WHITE);
+}
@@ -0,0 +1,19 @@
+#ifndef PONG_RASTER_H
+#define PONG_RASTER_H
+#include "pong_core.h"
+
+// Software rasteriser for offline video: draws what a screen capture of the
+// game would show, the whole monitor with the main window (title bar, net
+// line, scoreboard) and the paddle and ball overlay windows on top, scaled
+// to any output size. Needs no GPU and keeps no state, so any number of
+// threads can draw frames at once.
+//
+// The game only uses black, white and grays, so frames are a single 8-bit
+// luma plane (full range, as in Y4M's C420jpeg). Edges are anti-aliased by
+// pixel coverage.
+
+// Draws s into luma (width * height, row-major). The monitor is fitted to
+// the frame keeping its aspect ratio; the margins are black.
+void PongRaster_DrawState(unsigned char* luma, int width, int height, const PongState* s);
+
+#endif
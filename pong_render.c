@@ -0,0 +1,220 @@
+#include "pong_render.h"
+#include "pong_multiball.h"
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+static const PongColor COLOR_BLACK    = { 0, 0, 0, 255 };
+static const PongColor COLOR_WHITE    = { 255, 255, 255, 255 };
+static const PongColor COLOR_DARKGRAY = { 80, 80, 80, 255 };
+
+#define SCORE_FONT_SIZE 60
+
+static PongDrawCommand* Push(PongRenderer* r, PongDrawOp op, int target) {
+    if (r->list.count >= PONG_DRAW_LIST_CAPACITY) return NULL;
+    PongDrawCommand* c = &r->list.commands[r->list.count++];
+    memset(c, 0, sizeof(*c));
+    c->op = op;
+    c->target = target;
+    return c;
+}
+
+static void PushCopy(PongRenderer* r, int source, int target, PongDrawRect rect) {
+    PongDrawCommand* c = Push(r, PONG_DRAW_COPY, target);
+    if (!c) return;
+    c->source = source;
+    c->x = (float)rect.x; c->y = (float)rect.y;
+    c->w = (float)rect.width; c->h = (float)rect.height;
+}
+
+static PongDrawRect FullRect(void) {
+    return (PongDrawRect){ 0, 0, INITIAL_WIDTH, INITIAL_HEIGHT };
+}
+
+// Pixel bounds of a float rectangle, padded for anti-aliased edges
+static PongDrawRect Bounds(float x, float y, float w, float h) {
+    int x0 = (int)floorf(x) - 1, y0 = (int)floorf(y) - 1;
+    int x1 = (int)ceilf(x + w) + 1, y1 = (int)ceilf(y + h) + 1;
+    return (PongDrawRect){ x0, y0, x1 - x0, y1 - y0 };
+}
+
+static bool Intersects(PongDrawRect a, PongDrawRect b) {
+    return a.x < b.x + b.width && b.x < a.x + a.width && a.y < b.y + b.height && b.y < a.y + a.height;
+}
+
+static bool SameRect(PongDrawRect a, PongDrawRect b) {
+    return a.x == b.x && a.y == b.y && a.width == b.width && a.height == b.height;
+}
+
+void PongRenderer_Init(PongRenderer* r, const PongDrawBackend* backend) {
+    memset(r, 0, sizeof(*r));
+    r->backend = backend;
+    r->layersReady = backend->createLayer(PONG_LAYER_STATIC, INITIAL_WIDTH, INITIAL_HEIGHT) &&
+                     backend->createLayer(PONG_LAYER_SCENE, INITIAL_WIDTH, INITIAL_HEIGHT);
+}
+
+void PongRenderer_Shutdown(PongRenderer* r) {
+    r->backend->destroyLayer(PONG_LAYER_STATIC);
+    r->backend->destroyLayer(PONG_LAYER_SCENE);
+    r->layersReady = false;
+}
+
+static int ScoreSize(float pop) {
+    return (int)(SCORE_FONT_SIZE * pop + 0.5f);
+}
+
+static void BuildStaticLayer(PongRenderer* r, int target, const PongState* view) {
+    PongDrawCommand* c = Push(r, PONG_DRAW_CLEAR, target);
+    if (c) c->color = COLOR_BLACK;
+
+    // Scoreboard, grown around its top-left quarter while a score pops
+    int size1 = ScoreSize(view->scorePop1), size2 = ScoreSize(view->scorePop2);
+    c = Push(r, PONG_DRAW_TEXT, target);
+    if (c) {
+        snprintf(c->text, sizeof(c->text), "%d", view->score1);
+        c->x = INITIAL_WIDTH/4 - (size1 - SCORE_FONT_SIZE)/4; c->y = 50 - (size1 - SCORE_FONT_SIZE)/2;
+        c->size = size1; c->color = COLOR_WHITE;
+    }
+    c = Push(r, PONG_DRAW_TEXT, target);
+    if (c) {
+        snprintf(c->text, sizeof(c->text), "%d", view->score2);
+        c->x = 3*INITIAL_WIDTH/4 - (size2 - SCORE_FONT_SIZE)/4; c->y = 50 - (size2 - SCORE_FONT_SIZE)/2;
+        c->size = size2; c->color = COLOR_WHITE;
+    }
+
+    c = Push(r, PONG_DRAW_LINE, target);
+    if (c) {
+        c->x = INITIAL_WIDTH/2; c->y = 0; c->x2 = INITIAL_WIDTH/2; c->y2 = INITIAL_HEIGHT;
+        c->color = COLOR_DARKGRAY;
+    }
+}
+
+static void DrawMover(PongRenderer* r, int target, const PongState* view, int mover) {
+    PongDrawCommand* c;
+    if (mover == PONG_OVERLAY_BALL) {
+        c = Push(r, PONG_DRAW_CIRCLE, target);
+        if (!c) return;
+        c->x = view->ballPos.x + BALL_RADIUS - 12; c->y = view->ballPos.y + BALL_RADIUS;
+        c->w = BALL_RADIUS;
+    } else {
+        const PongRect* p = (mover == PONG_OVERLAY_PADDLE1) ? &view->p1 : &view->p2;
+        c = Push(r, PONG_DRAW_RECT, target);
+        if (!c) return;
+        c->x = p->x; c->y = p->y; c->w = p->width; c->h = p->height;
+    }
+    c->color = COLOR_WHITE;
+}
+
+static PongDrawRect MoverBounds(const PongState* view, int mover) {
+    if (mover == PONG_OVERLAY_BALL) {
+        float cx = view->ballPos.x + BALL_RADIUS - 12, cy = view->ballPos.y + BALL_RADIUS;
+        return Bounds(cx - BALL_RADIUS, cy - BALL_RADIUS, 2 * BALL_RADIUS, 2 * BALL_RADIUS);
+    }
+    const PongRect* p = (mover == PONG_OVERLAY_PADDLE1) ? &view->p1 : &view->p2;
+    return Bounds(p->x, p->y, p->width, p->height);
+}
+
+// Fallback without render targets: the old immediate-mode frame
+static void BuildImmediateFrame(PongRenderer* r, const PongState* view, bool showMovers) {
+    BuildStaticLayer(r, PONG_DRAW_SCREEN, view);
+    if (showMovers) {
+        for (int i = 0; i < PONG_OVERLAY_COUNT; i++) DrawMover(r, PONG_DRAW_SCREEN, view, i);
+    }
+}
+
+void PongRenderer_Frame(PongRenderer* r, const PongState* view) {
+    r->list.count = 0;
+    r->stats.frames++;
+
+    // Raylib Drawing only during windowed phase (Fake)
+    bool showMovers = !view->isExpanded && !view->isAnimating;
+
+    if (!r->layersReady) {
+        BuildImmediateFrame(r, view, showMovers);
+        r->backend->submit(&r->list);
+        return;
+    }
+
+    bool fullRedraw = false;
+    int size1 = ScoreSize(view->scorePop1), size2 = ScoreSize(view->scorePop2);
+    if (!r->staticValid || view->score1 != r->score1 || view->score2 != r->score2 ||
+        size1 != r->scoreSize1 || size2 != r->scoreSize2) {
+        BuildStaticLayer(r, PONG_LAYER_STATIC, view);
+        r->staticValid = true;
+        r->score1 = view->score1;
+        r->score2 = view->score2;
+        r->scoreSize1 = size1;
+        r->scoreSize2 = size2;
+        r->stats.staticRebuilds++;
+        fullRedraw = true;
+    }
+
+    PongDrawRect now[PONG_OVERLAY_COUNT];
+    bool redraw[PONG_OVERLAY_COUNT];
+    for (int i = 0; i < PONG_OVERLAY_COUNT; i++) {
+        now[i] = MoverBounds(view, i);
+        redraw[i] = showMovers && (fullRedraw || !r->drawn[i] || !SameRect(now[i], r->drawnRects[i]));
+    }
+
+    if (fullRedraw) {
+        PushCopy(r, PONG_LAYER_STATIC, PONG_LAYER_SCENE, FullRect());
+        r->stats.fullRedraws++;
+    } else {
+        // Erase movers that moved or disappeared
+        for (int i = 0; i < PONG_OVERLAY_COUNT; i++) {
+            if (!r->drawn[i] || (showMovers && !redraw[i])) continue;
+            PushCopy(r, PONG_LAYER_STATIC, PONG_LAYER_SCENE, r->drawnRects[i]);
+            r->stats.dirtyRects++;
+            // A mover that stayed put but was partly erased is drawn again
+            for (int j = 0; j < PONG_OVERLAY_COUNT; j++) {
+                if (showMovers && Intersects(r->drawnRects[i], now[j])) redraw[j] = true;
+            }
+        }
+    }
+
+    for (int i = 0; i < PONG_OVERLAY_COUNT; i++) {
+        if (redraw[i]) DrawMover(r, PONG_LAYER_SCENE, view, i);
+        r->drawn[i] = showMovers;
+        r->drawnRects[i] = now[i];
+    }
+
+    PushCopy(r, PONG_LAYER_SCENE, PONG_DRAW_SCREEN, FullRect());
+    r->backend->submit(&r->list);
+}
+
+void PongRenderer_MultiBallFrame(PongRenderer* r, const PongMultiBall* m) {
+    r->list.count = 0;
+    r->stats.frames++;
+
+    PongDrawCommand* c = Push(r, PONG_DRAW_CLEAR, PONG_DRAW_SCREEN);
+    if (c) c->color = COLOR_BLACK;
+
+    c = Push(r, PONG_DRAW_TEXT, PONG_DRAW_SCREEN);
+    if (c) {
+        snprintf(c->text, sizeof(c->text), "%d", m->score1);
+        c->x = m->arenaWidth/4; c->y = 50; c->size = SCORE_FONT_SIZE; c->color = COLOR_DARKGRAY;
+    }
+    c = Push(r, PONG_DRAW_TEXT, PONG_DRAW_SCREEN);
+    if (c) {
+        snprintf(c->text, sizeof(c->text), "%d", m->score2);
+        c->x = 3*m->arenaWidth/4; c->y = 50; c->size = SCORE_FONT_SIZE; c->color = COLOR_DARKGRAY;
+    }
+
+    const PongRect* paddles[2] = { &m->p1, &m->p2 };
+    for (int i = 0; i < 2; i++) {
+        c = Push(r, PONG_DRAW_RECT, PONG_DRAW_SCREEN);
+        if (!c) continue;
+        c->x = paddles[i]->x; c->y = paddles[i]->y;
+        c->w = paddles[i]->width; c->h = paddles[i]->height;
+        c->color = COLOR_WHITE;
+    }
+
+    c = Push(r, PONG_DRAW_SPRITES, PONG_DRAW_SCREEN);
+    if (c) {
+        c->xs = m->x; c->ys = m->y; c->count = m->count;
+        c->w = m->radius;
+        c->color = COLOR_WHITE;
+    }
+
+    r->backend->submit(&r->list);
+}
@@ -0,0 +1,124 @@
+#ifndef PONG_RENDER_H
+#define PONG_RENDER_H
+#include <stdbool.h>
+#include "pong_core.h"
+
+// Retained-mode rendering of the main window. The renderer keeps two
+// off-screen layers:
+//
+//   static  net line and score glyphs, rebuilt only when a score changes
+//           (and on the frames of its pop animation)
+//   scene   static layer plus the paddles and ball
+//
+// Each frame only the regions the paddles and ball left or entered are
+// repaired in the scene layer (restored from the static layer, then the
+// movers drawn again), and the scene is copied to the screen in one call.
+// Frames become a short list of PongDrawCommands executed by a backend, so
+// the same renderer runs against raylib or against a recorder on a machine
+// with no GPU.
+
+typedef struct {
+    unsigned char r, g, b, a;
+} PongColor;
+
+#define PONG_DRAW_SCREEN (-1)
+enum {
+    PONG_LAYER_STATIC,
+    PONG_LAYER_SCENE,
+    PONG_LAYER_COUNT
+};
+
+typedef enum {
+    PONG_DRAW_CLEAR,    // Fill the whole target with color
+    PONG_DRAW_RECT,     // x, y, w, h
+    PONG_DRAW_CIRCLE,   // Center x, y, radius w
+    PONG_DRAW_LINE,     // From x, y to x2, y2
+    PONG_DRAW_TEXT,     // text at x, y, font size
+    PONG_DRAW_COPY,     // Region x, y, w, h of layer source to the same place
+    PONG_DRAW_SPRITES,  // count circles of radius w centered at xs[i], ys[i]
+    PONG_DRAW_OP_COUNT
+} PongDrawOp;
+
+typedef struct {
+    PongDrawOp op;
+    int target;         // Layer, or PONG_DRAW_SCREEN
+    int source;         // Layer read by PONG_DRAW_COPY
+    float x, y, w, h;
+    float x2, y2;
+    int size;
+    PongColor color;
+    char text[12];
+    const float* xs;    // PONG_DRAW_SPRITES: caller-owned, valid until submit returns
+    const float* ys;
+    int count;
+} PongDrawCommand;
+
+#define PONG_DRAW_LIST_CAPACITY 32
+
+// Commands of one frame, layer targets first and the screen last
+typedef struct {
+    PongDrawCommand commands[PONG_DRAW_LIST_CAPACITY];
+    int count;
+} PongDrawList;
+
+// Executes draw lists. submit() is called once per frame and also begins and
+// ends the frame on the real backend.
+typedef struct {
+    const char* name;
+    bool (*createLayer)(int layer, int width, int height);
+    void (*destroyLayer)(int layer);
+    void (*submit)(const PongDrawList* list);
+} PongDrawBackend;
+
+const PongDrawBackend* DrawBackend_Raylib(void);     // draw_backend_raylib.c (game builds)
+const PongDrawBackend* DrawBackend_Recording(void);  // draw_backend_record.c
+
+// Counters kept by the recording backend
+typedef struct {
+    long frames;
+    long commands;
+    long lastFrameCommands;
+    long maxFrameCommands;
+    long ops[PONG_DRAW_OP_COUNT];
+    long sprites;           // Instances drawn by PONG_DRAW_SPRITES commands
+    long layerCreates;
+} PongDrawRecordCounts;
+
+void DrawRecord_GetCounts(PongDrawRecordCounts* counts);
+void DrawRecord_Reset(void);
+
+typedef struct {
+    int x, y, width, height;
+} PongDrawRect;
+
+typedef struct {
+    long frames;
+    long staticRebuilds;    // Score glyphs rasterised again
+    long fullRedraws;       // Scene rebuilt from scratch
+    long dirtyRects;        // Regions restored from the static layer
+} PongRenderStats;
+
+typedef struct {
+    const PongDrawBackend* backend;
+    PongDrawList list;
+    bool layersReady;
+    bool staticValid;
+    int score1, score2;     // Scores the static layer shows
+    int scoreSize1, scoreSize2; // and their font sizes
+    bool drawn[PONG_OVERLAY_COUNT];
+    PongDrawRect drawnRects[PONG_OVERLAY_COUNT];
+    PongRenderStats stats;
+} PongRenderer;
+
+void PongRenderer_Init(PongRenderer* r, const PongDrawBackend* backend);
+void PongRenderer_Shutdown(PongRenderer* r);
+// Builds and submits the frame for the (interpolated) state
+void PongRenderer_Frame(PongRenderer* r, const PongState* view);
+
+// Multi-ball stress frame, drawn straight to the screen: every ball is part
+// of one PONG_DRAW_SPRITES command, so the frame stays a handful of commands
+// whatever the ball count.
+struct PongMultiBall;
+void PongRenderer_MultiBallFrame(PongRenderer* r, const struct PongMultiBall* m);
+
+#endif
@@ -0,0 +1,175 @@
+#include "pong_tween.h"
+#include <string.h>
+#include <math.h>
+
+// ---------------------------------------------------------------------------
+// Easing curves
+// ---------------------------------------------------------------------------
+
+float EaseInOutCubic(float t) {
+    return t < 0.5f ? 4.0f * t * t * t : 1.0f - (-2.0f * t + 2.0f) * (-2.0f * t + 2.0f) * (-2.0f * t + 2.0f) / 2.0f;
+}
+
+static float EaseOutCubic(float t) {
+    float u = 1.0f - t;
+    return 1.0f - u * u * u;
+}
+
+// Overshoots by about 10% before settling
+static float EaseOutBack(float t) {
+    const float c1 = 1.70158f, c3 = c1 + 1.0f;
+    float u = t - 1.0f;
+    return 1.0f + c3 * u * u * u + c1 * u * u;
+}
+
+static float EaseOutElastic(float t) {
+    const float c4 = 2.0f * 3.14159265f / 3.0f;
+    if (t <= 0.0f) return 0.0f;
+    if (t >= 1.0f) return 1.0f;
+    return powf(2.0f, -10.0f * t) * sinf((t * 10.0f - 0.75f) * c4) + 1.0f;
+}
+
+float PongEase_Eval(PongEase ease, float t) {
+    switch (ease) {
+        case PONG_EASE_IN_OUT_CUBIC: return EaseInOutCubic(t);
+        case PONG_EASE_OUT_CUBIC:    return EaseOutCubic(t);
+        case PONG_EASE_OUT_BACK:     return EaseOutBack(t);
+        case PONG_EASE_OUT_ELASTIC:  return EaseOutElastic(t);
+        default:                     return t;
+    }
+}
+
+// One extra entry so t = 1 needs no special case
+static float easeLut[PONG_EASE_COUNT][PONG_EASE_LUT_SIZE + 1];
+static int easeLutState = 0;  // 0 not built, 1 being built, 2 ready
+
+static void BuildEaseLuts(void) {
+    int expected = 0;
+    if (__atomic_compare_exchange_n(&easeLutState, &expected, 1, false, __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE)) {
+        for (int e = 0; e < PONG_EASE_COUNT; e++) {
+            for (int i = 0; i <= PONG_EASE_LUT_SIZE; i++) {
+                easeLut[e][i] = PongEase_Eval((PongEase)e, (float)i / (float)PONG_EASE_LUT_SIZE);
+            }
+        }
+        __atomic_store_n(&easeLutState, 2, __ATOMIC_RELEASE);
+        return;
+    }
+    // Another thread is building them, and it only takes microseconds
+    while (__atomic_load_n(&easeLutState, __ATOMIC_ACQUIRE) != 2) { }
+}
+
+float PongEase_Sample(PongEase ease, float t) {
+    if (__atomic_load_n(&easeLutState, __ATOMIC_ACQUIRE) != 2) BuildEaseLuts();
+    if ((unsigned)ease >= PONG_EASE_COUNT) return t;
+    float x = t * (float)PONG_EASE_LUT_SIZE;
+    if (!(x > 0.0f)) return easeLut[ease][0];
+    if (x >= (float)PONG_EASE_LUT_SIZE) return easeLut[ease][PONG_EASE_LUT_SIZE];
+    int i = (int)x;
+    float frac = x - (float)i;
+    return easeLut[ease][i] + (easeLut[ease][i + 1] - easeLut[ease][i]) * frac;
+}
+
+// ---------------------------------------------------------------------------
+// Tween sets
+// ---------------------------------------------------------------------------
+
+void PongTween_Clear(PongTweens* tw) {
+    tw->count = 0;
+}
+
+int PongTween_Add(PongTweens* tw, int target, float from, float to, float duration, float delay,
+                  PongEase ease, int flags, int group) {
+    if (tw->count >= PONG_TWEEN_CAPACITY || target < 0 || group < 0 || group >= PONG_TWEEN_GROUPS) return -1;
+    int i = tw->count++;
+    tw->from[i] = from;
+    tw->to[i] = to;
+    tw->elapsed[i] = 0.0f;
+    tw->delay[i] = delay;
+    tw->duration[i] = duration > 0.0f ? duration : 1e-6f;
+    tw->target[i] = (unsigned short)target;
+    tw->ease[i] = (unsigned char)ease;
+    tw->flags[i] = (unsigned char)flags;
+    tw->group[i] = (unsigned char)group;
+    return i;
+}
+
+bool PongTween_GroupActive(const PongTweens* tw, int group) {
+    for (int i = 0; i < tw->count; i++) {
+        if (tw->group[i] == group) return true;
+    }
+    return false;
+}
+
+float PongTween_GroupEnd(const PongTweens* tw, int group) {
+    float end = 0.0f;
+    for (int i = 0; i < tw->count; i++) {
+        float left = tw->delay[i] + tw->duration[i] - tw->elapsed[i];
+        if (tw->group[i] == group && left > end) end = left;
+    }
+    return end;
+}
+
+static void MoveTween(PongTweens* tw, int to, int from) {
+    tw->from[to] = tw->from[from];
+    tw->to[to] = tw->to[from];
+    tw->elapsed[to] = tw->elapsed[from];
+    tw->delay[to] = tw->delay[from];
+    tw->duration[to] = tw->duration[from];
+    tw->target[to] = tw->target[from];
+    tw->ease[to] = tw->ease[from];
+    tw->flags[to] = tw->flags[from];
+    tw->group[to] = tw->group[from];
+}
+
+// Removal keeps the order, so of two tweens on one property the later one
+// still writes last
+void PongTween_CancelGroup(PongTweens* tw, int group) {
+    int kept = 0;
+    for (int i = 0; i < tw->count; i++) {
+        if (tw->group[i] == group) continue;
+        if (kept != i) MoveTween(tw, kept, i);
+        kept++;
+    }
+    tw->count = kept;
+}
+
+unsigned int PongTween_Update(PongTweens* tw, void* base, const size_t* offsets, float dt) {
+    int n = tw->count;
+    if (n == 0) return 0;
+
+    // Progress and value of every tween. Only the curve itself branches, the
+    // other two passes are straight float loops the compiler vectorises.
+    float progress[PONG_TWEEN_CAPACITY], t[PONG_TWEEN_CAPACITY], value[PONG_TWEEN_CAPACITY];
+    for (int i = 0; i < n; i++) {
+        tw->elapsed[i] += dt;
+        progress[i] = (tw->elapsed[i] - tw->delay[i]) / tw->duration[i];
+        t[i] = progress[i] < 0.0f ? 0.0f : (progress[i] > 1.0f ? 1.0f : progress[i]);
+    }
+    for (int i = 0; i < n; i++) {
+        t[i] = (tw->flags[i] & PONG_TWEEN_LUT) ? PongEase_Sample((PongEase)tw->ease[i], t[i])
+                                               : PongEase_Eval((PongEase)tw->ease[i], t[i]);
+    }
+    for (int i = 0; i < n; i++) {
+        value[i] = tw->from[i] + (tw->to[i] - tw->from[i]) * t[i];
+    }
+
+    unsigned char* bytes = (unsigned char*)base;
+    unsigned int finished = 0, running = 0;
+    int kept = 0;
+    for (int i = 0; i < n; i++) {
+        if (progress[i] >= 0.0f) {
+            float v = (tw->flags[i] & PONG_TWEEN_TRUNCATE) ? (float)(int)value[i] : value[i];
+            memcpy(bytes + offsets[tw->target[i]], &v, sizeof(v));
+        }
+        unsigned int bit = 1u << tw->group[i];
+        if (progress[i] >= 1.0f) {
+            finished |= bit;
+            continue;
+        }
+        running |= bit;
+        if (kept != i) MoveTween(tw, kept, i);
+        kept++;
+    }
+    tw->count = kept;
+    return finished & ~running;
+}
@@ -0,0 +1,74 @@
+#ifndef PONG_TWEEN_H
+#define PONG_TWEEN_H
+#include <stdbool.h>
+#include <stddef.h>
+
+// Batch tweens. An animated property is a float inside a plain struct,
+// named by an index into a table of byte offsets the caller passes to
+// PongTween_Update rather than by a pointer, so a tween set can live inside
+// the state it animates and be copied with it (rollback), and saved
+// (snapshots) in a form that doesn't depend on the struct's layout.
+// PongTween_Update advances every tween of a set in one pass over
+// structure-of-arrays storage and writes the results back.
+//
+// Tweens added to the same property run one after the other when the later
+// one is delayed until the first ends (PongTween_GroupEnd), and tweens of
+// different properties run side by side. A group (0..7) is a set of tweens
+// that finish together, e.g. every property of the arena expansion.
+
+#define PONG_TWEEN_CAPACITY 16
+#define PONG_TWEEN_GROUPS 8
+#define PONG_EASE_LUT_SIZE 256
+
+typedef enum {
+    PONG_EASE_LINEAR,
+    PONG_EASE_IN_OUT_CUBIC,
+    PONG_EASE_OUT_CUBIC,
+    PONG_EASE_OUT_BACK,
+    PONG_EASE_OUT_ELASTIC,
+    PONG_EASE_COUNT
+} PongEase;
+
+// Tween flags
+#define PONG_TWEEN_TRUNCATE 0x01    // Store (float)(int)value, for window coordinates
+#define PONG_TWEEN_LUT      0x02    // Sample the curve's lookup table instead of evaluating it
+
+typedef struct {
+    int count;
+    float from[PONG_TWEEN_CAPACITY];
+    float to[PONG_TWEEN_CAPACITY];
+    float elapsed[PONG_TWEEN_CAPACITY];     // Seconds since the tween was added
+    float delay[PONG_TWEEN_CAPACITY];       // Seconds before it starts moving
+    float duration[PONG_TWEEN_CAPACITY];
+    unsigned short target[PONG_TWEEN_CAPACITY];  // Property it drives (index into the offsets)
+    unsigned char ease[PONG_TWEEN_CAPACITY];
+    unsigned char flags[PONG_TWEEN_CAPACITY];
+    unsigned char group[PONG_TWEEN_CAPACITY];
+} PongTweens;
+
+float EaseInOutCubic(float t);
+
+// Exact curve value at t in [0, 1]
+float PongEase_Eval(PongEase ease, float t);
+// Same curve from a PONG_EASE_LUT_SIZE-entry table, linearly interpolated.
+// The tables are built on first use (from any thread).
+float PongEase_Sample(PongEase ease, float t);
+
+void PongTween_Clear(PongTweens* tw);
+// Animates property target from -> to over duration seconds, starting after
+// delay. Returns its index, -1 if the set is full.
+int PongTween_Add(PongTweens* tw, int target, float from, float to, float duration, float delay,
+                  PongEase ease, int flags, int group);
+bool PongTween_GroupActive(const PongTweens* tw, int group);
+// Seconds until every tween of group has finished (0 if none): the delay
+// that chains a new tween after them
+float PongTween_GroupEnd(const PongTweens* tw, int group);
+void PongTween_CancelGroup(PongTweens* tw, int group);
+
+// Advances every tween by dt, writes the started ones into the struct at
+// base (property p at byte offset offsets[p]) and drops the finished ones.
+// Returns a bit (1 << group) for every group whose last tween finished in
+// this update.
+unsigned int PongTween_Update(PongTweens* tw, void* base, const size_t* offsets, float dt);
+
+#endif
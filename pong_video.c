@@ -0,0 +1,241 @@
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200112L
+#endif
+#include "pong_video.h"
+#include "pong_raster.h"
+#include "pong_clock.h"
+#include "threadpool.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#define VIDEO_MAX_THREADS 64
+
+enum { SLOT_EMPTY, SLOT_QUEUED, SLOT_RENDERING, SLOT_DONE };
+
+// Frame n lives in slot n % queueFrames from Submit until it is written
+typedef struct {
+    PongState state;
+    unsigned char* luma;
+    int status;
+} Slot;
+
+struct PongVideo {
+    FILE* file;
+    bool ownsFile;
+    PongVideoConfig cfg;
+    Slot* slots;
+    unsigned char* chroma;      // Both chroma planes, all 128
+    size_t lumaSize, chromaSize;
+
+    pthread_t renderers[VIDEO_MAX_THREADS];
+    pthread_t writer;
+    int started;                // Render threads running
+
+    pthread_mutex_t lock;
+    pthread_cond_t work;        // A frame was queued (or closing)
+    pthread_cond_t done;        // A frame was drawn (or closing)
+    pthread_cond_t space;       // A slot was freed
+    unsigned long long submitted, nextRender, nextWrite;
+    int waiting;                // Drawn, not yet written
+    bool closing;
+    bool failed;
+
+    unsigned long long startNs, endNs;
+    unsigned long long renderNs;
+    unsigned long long bytes;
+    unsigned long long stalls;
+    int maxWaiting;
+};
+
+void PongVideo_DefaultConfig(PongVideoConfig* cfg) {
+    cfg->width = 1280;
+    cfg->height = 720;
+    cfg->fps = 60;
+    cfg->threads = 0;
+    cfg->queueFrames = 0;
+    cfg->raw = false;
+}
+
+static void* RenderThread(void* arg) {
+    PongVideo* v = (PongVideo*)arg;
+    pthread_mutex_lock(&v->lock);
+    for (;;) {
+        while (v->nextRender == v->submitted && !v->closing) pthread_cond_wait(&v->work, &v->lock);
+        if (v->nextRender == v->submitted) break;
+
+        // Oldest first, so the writer is never left waiting behind new frames
+        Slot* slot = &v->slots[v->nextRender++ % (unsigned long long)v->cfg.queueFrames];
+        slot->status = SLOT_RENDERING;
+        pthread_mutex_unlock(&v->lock);
+
+        unsigned long long t0 = Pong_ClockNs();
+        PongRaster_DrawState(slot->luma, v->cfg.width, v->cfg.height, &slot->state);
+        unsigned long long elapsed = Pong_ClockNs() - t0;
+
+        pthread_mutex_lock(&v->lock);
+        slot->status = SLOT_DONE;
+        v->renderNs += elapsed;
+        if (++v->waiting > v->maxWaiting) v->maxWaiting = v->waiting;
+        pthread_cond_signal(&v->done);
+    }
+    pthread_mutex_unlock(&v->lock);
+    return NULL;
+}
+
+static bool WriteFrame(PongVideo* v, const unsigned char* luma) {
+    if (!v->cfg.raw && fputs("FRAME\n", v->file) < 0) return false;
+    if (fwrite(luma, 1, v->lumaSize, v->file) != v->lumaSize) return false;
+    if (fwrite(v->chroma, 1, v->chromaSize, v->file) != v->chromaSize) return false;
+    v->bytes += (v->cfg.raw ? 0 : 6) + v->lumaSize + v->chromaSize;
+    return true;
+}
+
+static void* WriterThread(void* arg) {
+    PongVideo* v = (PongVideo*)arg;
+    pthread_mutex_lock(&v->lock);
+    for (;;) {
+        Slot* slot = &v->slots[v->nextWrite % (unsigned long long)v->cfg.queueFrames];
+        while (slot->status != SLOT_DONE && !(v->closing && v->nextWrite == v->submitted)) {
+            pthread_cond_wait(&v->done, &v->lock);
+        }
+        if (slot->status != SLOT_DONE) break;
+        bool failed = v->failed;
+        pthread_mutex_unlock(&v->lock);
+
+        // After a failed write the remaining frames are only drained
+        bool ok = failed || WriteFrame(v, slot->luma);
+
+        pthread_mutex_lock(&v->lock);
+        if (!ok) v->failed = true;
+        slot->status = SLOT_EMPTY;
+        v->nextWrite++;
+        v->waiting--;
+        pthread_cond_signal(&v->space);
+    }
+    v->endNs = Pong_ClockNs();
+    pthread_mutex_unlock(&v->lock);
+    return NULL;
+}
+
+static void Free(PongVideo* v) {
+    if (v->slots) {
+        for (int i = 0; i < v->cfg.queueFrames; i++) free(v->slots[i].luma);
+        free(v->slots);
+    }
+    free(v->chroma);
+    if (v->file && v->ownsFile) fclose(v->file);
+    free(v);
+}
+
+// Stops the render threads and the writer once everything submitted is out
+static void Shutdown(PongVideo* v, bool writerStarted) {
+    pthread_mutex_lock(&v->lock);
+    v->closing = true;
+    pthread_cond_broadcast(&v->work);
+    pthread_cond_broadcast(&v->done);
+    pthread_mutex_unlock(&v->lock);
+    for (int i = 0; i < v->started; i++) pthread_join(v->renderers[i], NULL);
+    if (writerStarted) pthread_join(v->writer, NULL);
+    pthread_mutex_destroy(&v->lock);
+    pthread_cond_destroy(&v->work);
+    pthread_cond_destroy(&v->done);
+    pthread_cond_destroy(&v->space);
+}
+
+PongVideo* PongVideo_Open(const char* path, const PongVideoConfig* cfg) {
+    if (cfg->width <= 0 || cfg->height <= 0 || cfg->fps <= 0) return NULL;
+    PongVideo* v = (PongVideo*)calloc(1, sizeof(PongVideo));
+    if (!v) return NULL;
+
+    v->cfg = *cfg;
+    v->cfg.width += v->cfg.width & 1;
+    v->cfg.height += v->cfg.height & 1;
+    if (v->cfg.threads <= 0) v->cfg.threads = ThreadPool_CpuCount();
+    if (v->cfg.threads > VIDEO_MAX_THREADS) v->cfg.threads = VIDEO_MAX_THREADS;
+    if (v->cfg.queueFrames <= 0) v->cfg.queueFrames = 2 * v->cfg.threads + 2;
+
+    v->lumaSize = (size_t)v->cfg.width * (size_t)v->cfg.height;
+    v->chromaSize = v->lumaSize / 2;
+    v->chroma = (unsigned char*)malloc(v->chromaSize);
+    v->slots = (Slot*)calloc((size_t)v->cfg.queueFrames, sizeof(Slot));
+    if (!v->chroma || !v->slots) { Free(v); return NULL; }
+    memset(v->chroma, 128, v->chromaSize);
+    for (int i = 0; i < v->cfg.queueFrames; i++) {
+        v->slots[i].luma = (unsigned char*)malloc(v->lumaSize);
+        if (!v->slots[i].luma) { Free(v); return NULL; }
+    }
+
+    if (strcmp(path, "-") == 0) v->file = stdout;
+    else {
+        v->file = fopen(path, "wb");
+        v->ownsFile = true;
+    }
+    if (!v->file) { Free(v); return NULL; }
+
+    if (!v->cfg.raw) {
+        int n = fprintf(v->file, "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C420jpeg\n", v->cfg.width, v->cfg.height, v->cfg.fps);
+        if (n < 0) { Free(v); return NULL; }
+        v->bytes = (unsigned long long)n;
+    }
+
+    pthread_mutex_init(&v->lock, NULL);
+    pthread_cond_init(&v->work, NULL);
+    pthread_cond_init(&v->done, NULL);
+    pthread_cond_init(&v->space, NULL);
+    v->startNs = Pong_ClockNs();
+
+    bool ok = pthread_create(&v->writer, NULL, WriterThread, v) == 0;
+    bool writerStarted = ok;
+    for (int i = 0; ok && i < v->cfg.threads; i++) {
+        ok = pthread_create(&v->renderers[i], NULL, RenderThread, v) == 0;
+        if (ok) v->started++;
+    }
+    if (!ok) {
+        Shutdown(v, writerStarted);
+        Free(v);
+        return NULL;
+    }
+    return v;
+}
+
+bool PongVideo_Submit(PongVideo* v, const PongState* s) {
+    pthread_mutex_lock(&v->lock);
+    Slot* slot = &v->slots[v->submitted % (unsigned long long)v->cfg.queueFrames];
+    if (slot->status != SLOT_EMPTY) {
+        v->stalls++;
+        while (slot->status != SLOT_EMPTY) pthread_cond_wait(&v->space, &v->lock);
+    }
+    bool ok = !v->failed;
+    if (ok) {
+        slot->state = *s;
+        slot->status = SLOT_QUEUED;
+        v->submitted++;
+        pthread_cond_signal(&v->work);
+    }
+    pthread_mutex_unlock(&v->lock);
+    return ok;
+}
+
+bool PongVideo_Close(PongVideo* v, PongVideoStats* stats) {
+    Shutdown(v, true);
+    bool ok = !v->failed && fflush(v->file) == 0;
+
+    if (stats) {
+        memset(stats, 0, sizeof(*stats));
+        stats->frames = v->nextWrite;
+        stats->bytes = v->bytes;
+        stats->seconds = (double)(v->endNs - v->startNs) / 1e9;
+        stats->framesPerSecond = stats->seconds > 0.0 ? (double)stats->frames / stats->seconds : 0.0;
+        stats->renderMs = stats->frames ? (double)v->renderNs / 1e6 / (double)stats->frames : 0.0;
+        stats->threads = v->cfg.threads;
+        stats->queueFrames = v->cfg.queueFrames;
+        stats->maxWaiting = v->maxWaiting;
+        stats->stalls = v->stalls;
+    }
+    if (v->ownsFile && fclose(v->file) != 0) ok = false;
+    v->file = NULL;
+    Free(v);
+    return ok;
+}
@@ -0,0 +1,51 @@
+#ifndef PONG_VIDEO_H
+#define PONG_VIDEO_H
+#include <stdbool.h>
+#include "pong_core.h"
+
+// Offline video encoder for recorded matches. Submitted states are drawn by
+// a pool of render threads (pong_raster.h) and a writer thread streams the
+// frames to the file in submission order. Frames finish out of order, so
+// they wait in a bounded reorder buffer; when every slot is taken, Submit
+// blocks until the writer frees the oldest one, which keeps memory constant
+// however long the match is.
+//
+// The output is Y4M (YUV4MPEG2, 4:2:0, full range), which ffmpeg and most
+// players read directly, or the same frames as bare I420 with no headers.
+// Chroma is constant (the game is grayscale).
+
+typedef struct {
+    int width, height;      // Frame size, rounded up to even for 4:2:0
+    int fps;                // Frame rate written to the Y4M header
+    int threads;            // Render threads (<= 0: one per CPU)
+    int queueFrames;        // Reorder buffer slots (<= 0: 2 * threads + 2)
+    bool raw;               // Bare I420 frames instead of Y4M
+} PongVideoConfig;
+
+typedef struct {
+    unsigned long long frames;
+    unsigned long long bytes;
+    double seconds;             // From Open to the last frame written
+    double framesPerSecond;
+    double renderMs;            // Mean time to draw one frame on one thread
+    int threads;
+    int queueFrames;
+    int maxWaiting;             // Most drawn frames waiting to be written
+    unsigned long long stalls;  // Submits that had to wait for a free slot
+} PongVideoStats;
+
+typedef struct PongVideo PongVideo;
+
+void PongVideo_DefaultConfig(PongVideoConfig* cfg);
+
+// path "-" writes to stdout. Returns NULL if the file can't be created or
+// the threads can't start.
+PongVideo* PongVideo_Open(const char* path, const PongVideoConfig* cfg);
+// Queues s as the next frame (copied, s can change right away). Returns
+// false once a write has failed; later frames are dropped.
+bool PongVideo_Submit(PongVideo* v, const PongState* s);
+// Writes every queued frame, stops the threads and closes the file. Returns
+// false if any write failed.
+bool PongVideo_Close(PongVideo* v, PongVideoStats* stats);
+
+#endif
@@ -0,0 +1,108 @@
+#include "profiler.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+typedef struct {
+    unsigned long long seq;     // Index + 1 once the slot is fully written
+    unsigned long long start;
+    unsigned long long end;
+    int phase;
+} ProfSample;
+
+static ProfSample ring[PROFILER_CAPACITY];
+static unsigned long long ringHead = 0;
+
+static const char* phaseNames[PROF_PHASE_COUNT] = {
+    "1_animation", "2_input", "3_ai_physics", "4_clamp", "5_windows", "6_draw", "frame"
+};
+
+const char* Profiler_PhaseName(ProfPhase phase) {
+    return (phase >= 0 && phase < PROF_PHASE_COUNT) ? phaseNames[phase] : "unknown";
+}
+
+void Profiler_Record(ProfPhase phase, unsigned long long startNs, unsigned long long endNs) {
+    // Claim a slot, fill it, then publish it by writing its sequence number
+    unsigned long long index = __atomic_fetch_add(&ringHead, 1, __ATOMIC_RELAXED);
+    ProfSample* slot = &ring[index & (PROFILER_CAPACITY - 1)];
+    __atomic_store_n(&slot->seq, 0, __ATOMIC_RELAXED);
+    slot->start = startNs;
+    slot->end = endNs;
+    slot->phase = (int)phase;
+    __atomic_store_n(&slot->seq, index + 1, __ATOMIC_RELEASE);
+}
+
+static int CompareU64(const void* a, const void* b) {
+    unsigned long long x = *(const unsigned long long*)a;
+    unsigned long long y = *(const unsigned long long*)b;
+    return (x > y) - (x < y);
+}
+
+// Copies the published samples out of the ring, oldest first
+static int Snapshot(ProfSample* out) {
+    unsigned long long head = __atomic_load_n(&ringHead, __ATOMIC_ACQUIRE);
+    unsigned long long first = head > PROFILER_CAPACITY ? head - PROFILER_CAPACITY : 0;
+    int count = 0;
+    for (unsigned long long i = first; i < head; i++) {
+        const ProfSample* slot = &ring[i & (PROFILER_CAPACITY - 1)];
+        if (__atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE) != i + 1) continue;
+        out[count++] = *slot;
+    }
+    return count;
+}
+
+void Profiler_Dump(const char* tracePath, const char* csvPath) {
+    ProfSample* samples = (ProfSample*)malloc(sizeof(ProfSample) * PROFILER_CAPACITY);
+    unsigned long long* durations = (unsigned long long*)malloc(sizeof(unsigned long long) * PROFILER_CAPACITY);
+    if (!samples || !durations) { free(samples); free(durations); return; }
+
+    int count = Snapshot(samples);
+    unsigned long long origin = count > 0 ? samples[0].start : 0;
+    for (int i = 0; i < count; i++) {
+        if (samples[i].start < origin) origin = samples[i].start;
+    }
+
+    if (tracePath) {
+        FILE* f = fopen(tracePath, "w");
+        if (f) {
+            fprintf(f, "{\"traceEvents\":[\n");
+            for (int i = 0; i < count; i++) {
+                fprintf(f, "%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":%.3f,\"dur\":%.3f}\n",
+                        i ? "," : "", phaseNames[samples[i].phase],
+                        (double)(samples[i].start - origin) / 1000.0,
+                        (double)(samples[i].end - samples[i].start) / 1000.0);
+            }
+            fprintf(f, "],\"displayTimeUnit\":\"ms\"}\n");
+            fclose(f);
+        }
+    }
+
+    if (csvPath) {
+        FILE* f = fopen(csvPath, "w");
+        if (f) {
+            fprintf(f, "phase,start_ns,duration_ns\n");
+            for (int i = 0; i < count; i++) {
+                fprintf(f, "%s,%llu,%llu\n", phaseNames[samples[i].phase],
+                        samples[i].start - origin, samples[i].end - samples[i].start);
+            }
+            fclose(f);
+        }
+    }
+
+    printf("profile: %d samples\n", count);
+    printf("  %-14s %8s %12s %12s %12s\n", "phase", "count", "p50 (us)", "p99 (us)", "max (us)");
+    for (int phase = 0; phase < PROF_PHASE_COUNT; phase++) {
+        int n = 0;
+        for (int i = 0; i < count; i++) {
+            if (samples[i].phase == phase) durations[n++] = samples[i].end - samples[i].start;
+        }
+        if (n == 0) continue;
+        qsort(durations, (size_t)n, sizeof(durations[0]), CompareU64);
+        printf("  %-14s %8d %12.3f %12.3f %12.3f\n", phaseNames[phase], n,
+               (double)durations[n / 2] / 1000.0,
+               (double)durations[(int)((long long)(n - 1) * 99 / 100)] / 1000.0,
+               (double)durations[n - 1] / 1000.0);
+    }
+
+    free(samples);
+    free(durations);
+}
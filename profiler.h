@@ -0,0 +1,40 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+// Per-phase frame profiler. Compiled in only when PONG_PROFILE is defined
+// (make PROFILE=1); otherwise every macro below expands to nothing.
+//
+// Samples go into a fixed-size lock-free ring buffer, so the most recent
+// PROFILER_CAPACITY phase timings are kept. PROFILE_DUMP writes them as a
+// Chrome trace (chrome://tracing, Perfetto) and as CSV, and prints
+// p50/p99/max per phase.
+
+typedef enum {
+    PROF_ANIMATION,     // 1. Animation and locking
+    PROF_INPUT,         // 2. Input
+    PROF_AI_PHYSICS,    // 3. AI and physics
+    PROF_CLAMP,         // 4. Clamping
+    PROF_WINDOWS,       // 5. Secondary window update
+    PROF_DRAW,          // 6. Raylib drawing
+    PROF_FRAME,         // Whole frame
+    PROF_PHASE_COUNT
+} ProfPhase;
+
+#define PROFILER_CAPACITY (1 << 16)
+
+void Profiler_Record(ProfPhase phase, unsigned long long startNs, unsigned long long endNs);
+void Profiler_Dump(const char* tracePath, const char* csvPath);
+const char* Profiler_PhaseName(ProfPhase phase);
+
+#ifdef PONG_PROFILE
+#include "pong_clock.h"
+#define PROFILE_BEGIN(phase) unsigned long long profStart_##phase = Pong_ClockNs()
+#define PROFILE_END(phase) Profiler_Record(phase, profStart_##phase, Pong_ClockNs())
+#define PROFILE_DUMP(tracePath, csvPath) Profiler_Dump(tracePath, csvPath)
+#else
+#define PROFILE_BEGIN(phase) ((void)0)
+#define PROFILE_END(phase) ((void)0)
+#define PROFILE_DUMP(tracePath, csvPath) ((void)0)
+#endif
+
+#endif
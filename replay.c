@@ -0,0 +1,290 @@
+#include "replay.h"
+#include <string.h>
+
+static const char REPLAY_MAGIC[8] = { 'P', 'O', 'N', 'G', 'R', 'P', 'L', 0 };
+
+#define CHUNK_INPUT      'I'
+#define CHUNK_WINDOW     'W'
+#define CHUNK_TIMING     'T'
+#define CHUNK_CHECKPOINT 'H'
+#define CHUNK_END        'E'
+
+// ---------------------------------------------------------------------------
+// Little-endian helpers
+// ---------------------------------------------------------------------------
+
+static void WriteU16(FILE* f, unsigned int v) {
+    unsigned char b[2] = { (unsigned char)v, (unsigned char)(v >> 8) };
+    fwrite(b, 1, 2, f);
+}
+
+static void WriteU32(FILE* f, unsigned long v) {
+    unsigned char b[4] = { (unsigned char)v, (unsigned char)(v >> 8), (unsigned char)(v >> 16), (unsigned char)(v >> 24) };
+    fwrite(b, 1, 4, f);
+}
+
+static void WriteU64(FILE* f, unsigned long long v) {
+    WriteU32(f, (unsigned long)(v & 0xFFFFFFFFu));
+    WriteU32(f, (unsigned long)(v >> 32));
+}
+
+static void WriteF32(FILE* f, float v) {
+    unsigned int bits;
+    memcpy(&bits, &v, sizeof(bits));
+    WriteU32(f, bits);
+}
+
+static bool ReadBytes(FILE* f, unsigned char* b, size_t n) {
+    return fread(b, 1, n, f) == n;
+}
+
+static bool ReadU16(FILE* f, unsigned int* v) {
+    unsigned char b[2];
+    if (!ReadBytes(f, b, 2)) return false;
+    *v = (unsigned int)b[0] | ((unsigned int)b[1] << 8);
+    return true;
+}
+
+static bool ReadU32(FILE* f, unsigned int* v) {
+    unsigned char b[4];
+    if (!ReadBytes(f, b, 4)) return false;
+    *v = (unsigned int)b[0] | ((unsigned int)b[1] << 8) | ((unsigned int)b[2] << 16) | ((unsigned int)b[3] << 24);
+    return true;
+}
+
+static bool ReadU64(FILE* f, unsigned long long* v) {
+    unsigned int lo, hi;
+    if (!ReadU32(f, &lo) || !ReadU32(f, &hi)) return false;
+    *v = (unsigned long long)lo | ((unsigned long long)hi << 32);
+    return true;
+}
+
+static bool ReadF32(FILE* f, float* v) {
+    unsigned int bits;
+    if (!ReadU32(f, &bits)) return false;
+    memcpy(v, &bits, sizeof(*v));
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Writer
+// ---------------------------------------------------------------------------
+
+bool ReplayWriter_Open(ReplayWriter* w, const char* path, const ReplayHeader* header) {
+    memset(w, 0, sizeof(*w));
+    w->file = fopen(path, "wb");
+    if (!w->file) return false;
+
+    fwrite(REPLAY_MAGIC, 1, sizeof(REPLAY_MAGIC), w->file);
+    WriteU16(w->file, REPLAY_VERSION);
+    WriteU16(w->file, (unsigned int)header->physicsHz);
+    WriteU64(w->file, header->seed);
+    WriteU32(w->file, (unsigned long)header->monitorW);
+    WriteU32(w->file, (unsigned long)header->monitorH);
+    WriteF32(w->file, header->windowX);
+    WriteF32(w->file, header->windowY);
+
+    // Constants the recording depends on, checked on playback
+    WriteF32(w->file, BASE_BALL_SPEED);
+    WriteF32(w->file, MAX_BALL_SPEED);
+    WriteU16(w->file, PADDLE_WIDTH);
+    WriteU16(w->file, PADDLE_HEIGHT);
+    WriteU16(w->file, BALL_SIZE);
+    WriteU16(w->file, header->fixedPoint ? REPLAY_FLAG_FIXED_POINT : 0);
+
+    // AI tuning the match was played with
+    WriteF32(w->file, header->ai.baseDifficulty);
+    WriteF32(w->file, header->ai.scalingFactor);
+    WriteF32(w->file, header->ai.difficultyCap);
+    WriteF32(w->file, header->ai.scoreThreshold);
+    WriteF32(w->file, header->ai.facilitateDifficulty);
+    WriteF32(w->file, header->ai.reactionDelay);
+    WriteF32(w->file, header->ai.maxErrorScale);
+    WriteU32(w->file, (unsigned long)header->ai.guaranteedHits);
+
+    w->windowX = header->windowX;
+    w->windowY = header->windowY;
+    return true;
+}
+
+static void FlushInputs(ReplayWriter* w) {
+    if (w->pending == 0) return;
+    fputc(CHUNK_INPUT, w->file);
+    fputc(w->pending, w->file);
+    for (int i = 0; i < w->pending; i += 2) {
+        unsigned char lo = w->keys[i] & 0x0F;
+        unsigned char hi = (i + 1 < w->pending) ? (w->keys[i + 1] & 0x0F) : 0;
+        fputc(lo | (hi << 4), w->file);
+    }
+    w->pending = 0;
+}
+
+void ReplayWriter_Frame(ReplayWriter* w, const PongInput* in, const PongState* after) {
+    if (!w->file) return;
+
+    if (in->windowX != w->windowX || in->windowY != w->windowY) {
+        FlushInputs(w);
+        fputc(CHUNK_WINDOW, w->file);
+        WriteF32(w->file, in->windowX);
+        WriteF32(w->file, in->windowY);
+        w->windowX = in->windowX;
+        w->windowY = in->windowY;
+    }
+
+    if (in->upHeld || in->downHeld) {
+        FlushInputs(w);
+        fputc(CHUNK_TIMING, w->file);
+        fputc(in->upHeld, w->file);
+        fputc(in->downHeld, w->file);
+        w->timingChunks++;
+    }
+
+    w->keys[w->pending++] = in->keys;
+    w->frames++;
+    if (w->pending == REPLAY_MAX_BLOCK) FlushInputs(w);
+
+    if (w->frames % REPLAY_CHECKPOINT_INTERVAL == 0) {
+        FlushInputs(w);
+        fputc(CHUNK_CHECKPOINT, w->file);
+        WriteU64(w->file, w->frames);
+        WriteU64(w->file, Pong_HashState(after));
+    }
+}
+
+void ReplayWriter_Close(ReplayWriter* w, const PongState* final) {
+    if (!w->file) return;
+    FlushInputs(w);
+    fputc(CHUNK_END, w->file);
+    WriteU64(w->file, w->frames);
+    WriteU32(w->file, (unsigned long)final->score1);
+    WriteU32(w->file, (unsigned long)final->score2);
+    WriteU64(w->file, Pong_HashState(final));
+    fclose(w->file);
+    w->file = NULL;
+}
+
+// ---------------------------------------------------------------------------
+// Player
+// ---------------------------------------------------------------------------
+
+static bool ReadHeader(FILE* f, ReplayHeader* header) {
+    char magic[sizeof(REPLAY_MAGIC)];
+    unsigned int version, hz, monitorW, monitorH, paddleW, paddleH, ballSize, flags, guaranteedHits;
+    float baseSpeed, maxSpeed;
+
+    if (!ReadBytes(f, (unsigned char*)magic, sizeof(magic)) || memcmp(magic, REPLAY_MAGIC, sizeof(magic)) != 0) return false;
+    if (!ReadU16(f, &version) || version < REPLAY_MIN_VERSION || version > REPLAY_VERSION) return false;
+    if (!ReadU16(f, &hz) || !ReadU64(f, &header->seed)) return false;
+    if (!ReadU32(f, &monitorW) || !ReadU32(f, &monitorH)) return false;
+    if (!ReadF32(f, &header->windowX) || !ReadF32(f, &header->windowY)) return false;
+    if (!ReadF32(f, &baseSpeed) || !ReadF32(f, &maxSpeed)) return false;
+    if (!ReadU16(f, &paddleW) || !ReadU16(f, &paddleH) || !ReadU16(f, &ballSize) || !ReadU16(f, &flags)) return false;
+    if (!ReadF32(f, &header->ai.baseDifficulty) || !ReadF32(f, &header->ai.scalingFactor) ||
+        !ReadF32(f, &header->ai.difficultyCap) || !ReadF32(f, &header->ai.scoreThreshold) ||
+        !ReadF32(f, &header->ai.facilitateDifficulty) || !ReadF32(f, &header->ai.reactionDelay) ||
+        !ReadF32(f, &header->ai.maxErrorScale) || !ReadU32(f, &guaranteedHits)) return false;
+    header->ai.guaranteedHits = (int)guaranteedHits;
+    // The field was reserved (always 0) before version 5
+    if (flags & ~REPLAY_FLAG_FIXED_POINT) return false;
+    header->fixedPoint = (flags & REPLAY_FLAG_FIXED_POINT) != 0;
+
+    // A recording made with different constants can't re-simulate
+    if (baseSpeed != BASE_BALL_SPEED || maxSpeed != MAX_BALL_SPEED) return false;
+    if (paddleW != PADDLE_WIDTH || paddleH != PADDLE_HEIGHT || ballSize != BALL_SIZE) return false;
+    if (hz == 0) return false;
+
+    header->physicsHz = (int)hz;
+    header->monitorW = (int)monitorW;
+    header->monitorH = (int)monitorH;
+    return true;
+}
+
+bool Replay_ReadHeader(const char* path, ReplayHeader* header) {
+    FILE* f = fopen(path, "rb");
+    if (!f) return false;
+    bool ok = ReadHeader(f, header);
+    fclose(f);
+    return ok;
+}
+
+bool Replay_Play(const char* path, ReplayResult* result, PongState* finalState) {
+    return Replay_Run(path, result, finalState, NULL, NULL);
+}
+
+bool Replay_Run(const char* path, ReplayResult* result, PongState* finalState, ReplayStepFn onStep, void* ctx) {
+    memset(result, 0, sizeof(*result));
+    FILE* f = fopen(path, "rb");
+    if (!f) return false;
+
+    ReplayHeader header;
+    if (!ReadHeader(f, &header)) { fclose(f); return false; }
+
+    PongState game;
+    Pong_Init(&game, header.windowX, header.windowY, header.monitorW, header.monitorH, header.seed);
+    game.ai = header.ai;
+    if (header.fixedPoint) Pong_UseFixedPoint(&game);
+    PongInput input = { 0, header.windowX, header.windowY };
+    float dt = 1.0f / (float)header.physicsHz;
+    bool ok = true;
+
+    int tag;
+    while ((tag = fgetc(f)) != EOF) {
+        if (tag == CHUNK_INPUT) {
+            int count = fgetc(f);
+            if (count == EOF) break;
+            unsigned char packed[(REPLAY_MAX_BLOCK + 1) / 2];
+            if (!ReadBytes(f, packed, (size_t)(count + 1) / 2)) break;
+            for (int i = 0; i < count; i++) {
+                input.keys = (i & 1) ? (packed[i / 2] >> 4) : (packed[i / 2] & 0x0F);
+                Pong_Step(&game, &input, dt);
+                input.upHeld = input.downHeld = 0;
+                if (onStep && !onStep(ctx, &game)) { result->stopped = true; break; }
+            }
+            if (result->stopped) break;
+        }
+        else if (tag == CHUNK_TIMING) {
+            int up = fgetc(f), down = fgetc(f);
+            if (down == EOF) break;
+            input.upHeld = (unsigned char)up;
+            input.downHeld = (unsigned char)down;
+        }
+        else if (tag == CHUNK_WINDOW) {
+            if (!ReadF32(f, &input.windowX) || !ReadF32(f, &input.windowY)) break;
+        }
+        else if (tag == CHUNK_CHECKPOINT) {
+            unsigned long long frame, hash;
+            if (!ReadU64(f, &frame) || !ReadU64(f, &hash)) break;
+            result->checkpoints++;
+            if ((frame != game.frame || hash != Pong_HashState(&game)) && result->divergedAtFrame == 0) {
+                result->divergedAtFrame = frame;
+                ok = false;
+            }
+        }
+        else if (tag == CHUNK_END) {
+            unsigned int score1, score2;
+            if (!ReadU64(f, &result->expectedFrames) || !ReadU32(f, &score1) || !ReadU32(f, &score2) ||
+                !ReadU64(f, &result->expectedHash)) break;
+            result->expectedScore1 = (int)score1;
+            result->expectedScore2 = (int)score2;
+            result->hasEnd = true;
+            break;
+        }
+        else {
+            ok = false;  // Corrupt stream
+            break;
+        }
+    }
+    fclose(f);
+
+    result->frames = game.frame;
+    result->score1 = game.score1;
+    result->score2 = game.score2;
+    result->hash = Pong_HashState(&game);
+    if (result->hasEnd && !result->stopped) {
+        ok = ok && result->frames == result->expectedFrames && result->hash == result->expectedHash &&
+             result->score1 == result->expectedScore1 && result->score2 == result->expectedScore2;
+    }
+    result->ok = ok;
+    if (finalState) *finalState = game;
+    return true;
+}
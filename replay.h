@@ -0,0 +1,78 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+#include <stdio.h>
+#include <stdbool.h>
+#include "pong_core.h"
+
+// Replay files: a header with the seed, the simulation constants, flags and
+// the AI parameters, followed by a stream of chunks (all values little-endian):
+//
+//   'I' u8 count, then count 4-bit key masks packed two per byte
+//   'W' f32 x, f32 y      main window moved (applies from the next frame)
+//   'T' u8 upHeld, u8 downHeld   sub-step key timing of the next frame only
+//   'H' u64 frame, u64 state hash       periodic checkpoint
+//   'E' u64 frames, i32 score1, i32 score2, u64 state hash    end of match
+//
+// Every chunk describes physics steps at the rate stored in the header, so a
+// replay re-simulates bit for bit. A file without an 'E' chunk (the game was
+// killed) still plays back, it just can't be verified at the end.
+
+#define REPLAY_VERSION 5
+#define REPLAY_MIN_VERSION 3     // Versions 3 and 4 have no flags, version 3 no 'T' chunks
+#define REPLAY_MAX_BLOCK 255
+#define REPLAY_CHECKPOINT_INTERVAL 1024
+
+// Header flags
+#define REPLAY_FLAG_FIXED_POINT 0x0001  // Played with Pong_UseFixedPoint
+
+typedef struct {
+    unsigned long long seed;
+    int physicsHz;
+    int monitorW, monitorH;
+    float windowX, windowY;
+    PongAIParams ai;
+    bool fixedPoint;
+} ReplayHeader;
+
+typedef struct {
+    FILE* file;
+    unsigned char keys[REPLAY_MAX_BLOCK];
+    int pending;
+    float windowX, windowY;
+    unsigned long long frames;
+    unsigned long long timingChunks;    // 'T' chunks written
+} ReplayWriter;
+
+typedef struct {
+    unsigned long long frames;
+    int score1, score2;
+    unsigned long long hash;
+    // Values stored in the file ('E' chunk), if present
+    bool hasEnd;
+    unsigned long long expectedFrames;
+    int expectedScore1, expectedScore2;
+    unsigned long long expectedHash;
+    // First checkpoint that didn't match (0 if none)
+    unsigned long long divergedAtFrame;
+    int checkpoints;
+    bool stopped;   // The step callback ended playback early
+    bool ok;
+} ReplayResult;
+
+// Called after every re-simulated physics step; return false to stop
+typedef bool (*ReplayStepFn)(void* ctx, const PongState* s);
+
+bool ReplayWriter_Open(ReplayWriter* w, const char* path, const ReplayHeader* header);
+// Call once per physics step, after Pong_Step, with the input it was given
+void ReplayWriter_Frame(ReplayWriter* w, const PongInput* in, const PongState* after);
+void ReplayWriter_Close(ReplayWriter* w, const PongState* final);
+
+// Re-simulates a replay as fast as possible. Returns false if the file can't
+// be read; result->ok tells whether the run matched the recording.
+bool Replay_Play(const char* path, ReplayResult* result, PongState* finalState);
+// Replay_Play that hands every step to onStep (e.g. to render it). A stopped
+// run is only checked against the checkpoints it reached.
+bool Replay_Run(const char* path, ReplayResult* result, PongState* finalState, ReplayStepFn onStep, void* ctx);
+bool Replay_ReadHeader(const char* path, ReplayHeader* header);
+
+#endif
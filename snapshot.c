@@ -0,0 +1,549 @@
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200112L
+#endif
+#include "snapshot.h"
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <stdint.h>
+#else
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+static const char SNAPSHOT_MAGIC[8] = { 'P', 'O', 'N', 'G', 'S', 'N', 'A', 'P' };
+static const char STREAM_MAGIC[8] = { 'P', 'O', 'N', 'G', 'S', 'T', 'R', 'M' };
+
+#define RECORD_KEYFRAME 'K'
+#define RECORD_DELTA    'D'
+#define RECORD_END      'E'
+#define RECORD_HEADER   3
+#define FILE_HEADER     12
+
+// ---------------------------------------------------------------------------
+// Field table. Append only: the position of a field is its word index in
+// every file written since.
+// ---------------------------------------------------------------------------
+
+typedef enum { FIELD_F32, FIELD_I32, FIELD_BOOL, FIELD_U32, FIELD_U64, FIELD_U16, FIELD_U8 } FieldKind;
+
+typedef struct {
+    size_t offset;
+    FieldKind kind;
+} Field;
+
+#define F(member, kind) { offsetof(PongState, member), kind }
+#define TWEEN(i) \
+    F(tweens.from[i], FIELD_F32), F(tweens.to[i], FIELD_F32), F(tweens.elapsed[i], FIELD_F32), \
+    F(tweens.delay[i], FIELD_F32), F(tweens.duration[i], FIELD_F32), F(tweens.target[i], FIELD_U16), \
+    F(tweens.ease[i], FIELD_U8), F(tweens.flags[i], FIELD_U8), F(tweens.group[i], FIELD_U8)
+
+static const Field fields[] = {
+    F(currentArena.x, FIELD_F32), F(currentArena.y, FIELD_F32),
+    F(currentArena.width, FIELD_F32), F(currentArena.height, FIELD_F32),
+    F(startArena.x, FIELD_F32), F(startArena.y, FIELD_F32),
+    F(startArena.width, FIELD_F32), F(startArena.height, FIELD_F32),
+    F(targetArena.x, FIELD_F32), F(targetArena.y, FIELD_F32),
+    F(targetArena.width, FIELD_F32), F(targetArena.height, FIELD_F32),
+    F(windowStartPos.x, FIELD_F32), F(windowStartPos.y, FIELD_F32),
+    F(windowTargetPos.x, FIELD_F32), F(windowTargetPos.y, FIELD_F32),
+    F(windowPos.x, FIELD_F32), F(windowPos.y, FIELD_F32),
+    F(p1.x, FIELD_F32), F(p1.y, FIELD_F32), F(p1.width, FIELD_F32), F(p1.height, FIELD_F32),
+    F(p2.x, FIELD_F32), F(p2.y, FIELD_F32), F(p2.width, FIELD_F32), F(p2.height, FIELD_F32),
+    F(ballPos.x, FIELD_F32), F(ballPos.y, FIELD_F32),
+    F(ballSpeed.x, FIELD_F32), F(ballSpeed.y, FIELD_F32),
+    F(p1LockedWorldY, FIELD_F32), F(p2LockedWorldY, FIELD_F32),
+    F(gameStarted, FIELD_BOOL), F(isExpanded, FIELD_BOOL), F(isAnimating, FIELD_BOOL),
+    F(isLocked, FIELD_BOOL), F(versus, FIELD_BOOL),
+    F(score1, FIELD_I32), F(score2, FIELD_I32),
+    F(playerHits, FIELD_I32), F(aiHitsTotal, FIELD_I32),
+    F(animTimer, FIELD_F32), F(animDuration, FIELD_F32),
+    F(aiDifficulty, FIELD_F32),
+    F(ai.baseDifficulty, FIELD_F32), F(ai.scalingFactor, FIELD_F32), F(ai.difficultyCap, FIELD_F32),
+    F(ai.scoreThreshold, FIELD_F32), F(ai.facilitateDifficulty, FIELD_F32), F(ai.reactionDelay, FIELD_F32),
+    F(ai.maxErrorScale, FIELD_F32), F(ai.guaranteedHits, FIELD_I32),
+    F(targetY, FIELD_F32), F(reactionTimer, FIELD_F32),
+    F(aiPredictionValid, FIELD_BOOL), F(aiInterceptY, FIELD_F32), F(aiErrorOffset, FIELD_F32),
+    F(rngState, FIELD_U64),
+    F(events, FIELD_U32),
+    F(frame, FIELD_U64),
+    // Version 2
+    F(titleBarOffset, FIELD_F32), F(scorePop1, FIELD_F32), F(scorePop2, FIELD_F32),
+    F(tweens.count, FIELD_I32),
+    TWEEN(0), TWEEN(1), TWEEN(2), TWEEN(3), TWEEN(4), TWEEN(5), TWEEN(6), TWEEN(7),
+    TWEEN(8), TWEEN(9), TWEEN(10), TWEEN(11), TWEEN(12), TWEEN(13), TWEEN(14), TWEEN(15),
+    // Version 3
+    F(fixedPoint, FIELD_BOOL),
+    F(fx.arenaX, FIELD_I32), F(fx.arenaY, FIELD_I32), F(fx.arenaW, FIELD_I32), F(fx.arenaH, FIELD_I32),
+    F(fx.windowX, FIELD_I32), F(fx.windowY, FIELD_I32),
+    F(fx.p1Y, FIELD_I32), F(fx.p2X, FIELD_I32), F(fx.p2Y, FIELD_I32),
+    F(fx.p1LockedY, FIELD_I32), F(fx.p2LockedY, FIELD_I32),
+    F(fx.ballX, FIELD_I32), F(fx.ballY, FIELD_I32), F(fx.speedX, FIELD_I32), F(fx.speedY, FIELD_I32),
+    F(fx.difficulty, FIELD_I32), F(fx.targetY, FIELD_I32), F(fx.interceptY, FIELD_I32), F(fx.errorOffset, FIELD_I32),
+    F(fx.reactionTimer, FIELD_I32), F(fx.animTimer, FIELD_I32),
+    // Version 4
+    F(rallyHits, FIELD_I32),
+    // Version 5: tweens.target holds PongTweenProp IDs instead of offsets
+};
+
+#undef TWEEN
+#undef F
+
+#define FIELD_COUNT ((int)(sizeof(fields) / sizeof(fields[0])))
+
+// Every field takes at least one word. 64-bit fields take two, which
+// Snapshot_WordCount checks when it first lays the words out.
+typedef char FieldTableFits[FIELD_COUNT <= SNAPSHOT_MAX_WORDS ? 1 : -1];
+
+// Field of each word, and which half of a 64-bit field it holds
+static unsigned char wordField[SNAPSHOT_MAX_WORDS];
+static unsigned char wordHigh[SNAPSHOT_MAX_WORDS];
+static int wordCount = 0;
+
+int Snapshot_WordCount(void) {
+    if (wordCount == 0) {
+        int w = 0;
+        for (int i = 0; i < FIELD_COUNT; i++) {
+            int size = (fields[i].kind == FIELD_U64) ? 2 : 1;
+            // Every buffer is sized by SNAPSHOT_MAX_WORDS: raise it along
+            // with the table
+            if (w + size > SNAPSHOT_MAX_WORDS) {
+                fprintf(stderr, "snapshot.c: the field table needs more than SNAPSHOT_MAX_WORDS (%d) words\n", SNAPSHOT_MAX_WORDS);
+                abort();
+            }
+            wordField[w] = (unsigned char)i;
+            wordHigh[w++] = 0;
+            if (size == 2) {
+                wordField[w] = (unsigned char)i;
+                wordHigh[w++] = 1;
+            }
+        }
+        wordCount = w;
+    }
+    return wordCount;
+}
+
+// State to words, in table order
+static void ToWords(const PongState* s, unsigned int* words) {
+    const unsigned char* base = (const unsigned char*)s;
+    int w = 0;
+    for (int i = 0; i < FIELD_COUNT; i++) {
+        const void* p = base + fields[i].offset;
+        switch (fields[i].kind) {
+            case FIELD_F32:
+            case FIELD_I32:
+            case FIELD_U32:  memcpy(&words[w++], p, 4); break;
+            case FIELD_BOOL: words[w++] = *(const bool*)p ? 1u : 0u; break;
+            case FIELD_U16:  words[w++] = *(const unsigned short*)p; break;
+            case FIELD_U8:   words[w++] = *(const unsigned char*)p; break;
+            case FIELD_U64: {
+                unsigned long long v;
+                memcpy(&v, p, sizeof(v));
+                words[w++] = (unsigned int)(v & 0xFFFFFFFFu);
+                words[w++] = (unsigned int)(v >> 32);
+                break;
+            }
+        }
+    }
+}
+
+// Sets the field word w belongs to. 64-bit fields are written a half at a
+// time, so a delta may change either half alone.
+static void SetWord(PongState* s, int w, unsigned int value) {
+    const Field* field = &fields[wordField[w]];
+    void* p = (unsigned char*)s + field->offset;
+    switch (field->kind) {
+        case FIELD_F32:
+        case FIELD_I32:
+        case FIELD_U32:  memcpy(p, &value, 4); break;
+        case FIELD_BOOL: *(bool*)p = (value != 0); break;
+        case FIELD_U16:  *(unsigned short*)p = (unsigned short)value; break;
+        case FIELD_U8:   *(unsigned char*)p = (unsigned char)value; break;
+        case FIELD_U64: {
+            unsigned long long v;
+            memcpy(&v, p, sizeof(v));
+            if (wordHigh[w]) v = (v & 0xFFFFFFFFULL) | ((unsigned long long)value << 32);
+            else v = (v & 0xFFFFFFFF00000000ULL) | value;
+            memcpy(p, &v, sizeof(v));
+            break;
+        }
+    }
+}
+
+#define VERSION_TWEEN_IDS 5
+
+// Before version 5 a tween's target was a byte offset into the PongState of
+// the build that wrote the file. Only the expansion (one tween per property,
+// added in PongTweenProp order) and the score pops wrote tweens, so the
+// property follows from the group and the order within it.
+static void MapLegacyTweens(PongTweens* tw) {
+    int expansion = 0;
+    for (int i = 0; i < tw->count; i++) {
+        switch (tw->group[i]) {
+            case PONG_TWEEN_GROUP_EXPAND:
+                tw->target[i] = (unsigned short)(expansion <= PONG_TWEEN_TITLE_BAR ? expansion++ : PONG_TWEEN_PROP_COUNT);
+                break;
+            case PONG_TWEEN_GROUP_POP1: tw->target[i] = PONG_TWEEN_SCORE_POP1; break;
+            case PONG_TWEEN_GROUP_POP2: tw->target[i] = PONG_TWEEN_SCORE_POP2; break;
+            default:                    tw->target[i] = PONG_TWEEN_PROP_COUNT; break;
+        }
+    }
+}
+
+// Tweens write through their targets: a damaged file that names a property
+// we don't have loses the whole set
+static void CheckTweens(PongState* s, int version) {
+    PongTweens* tw = &s->tweens;
+    if (tw->count < 0 || tw->count > PONG_TWEEN_CAPACITY) { tw->count = 0; return; }
+    if (version < VERSION_TWEEN_IDS) MapLegacyTweens(tw);
+    for (int i = 0; i < tw->count; i++) {
+        if (tw->target[i] >= PONG_TWEEN_PROP_COUNT || tw->group[i] >= PONG_TWEEN_GROUPS) {
+            tw->count = 0;
+            return;
+        }
+    }
+}
+
+// Words to state. Words past our table (a newer writer) are ignored.
+static void FromWords(PongState* s, const unsigned int* words, int count, int version) {
+    unsigned char* base = (unsigned char*)s;
+    int w = 0;
+    for (int i = 0; i < FIELD_COUNT; i++) {
+        int size = (fields[i].kind == FIELD_U64) ? 2 : 1;
+        if (w + size > count) break;
+        void* p = base + fields[i].offset;
+        switch (fields[i].kind) {
+            case FIELD_F32:
+            case FIELD_I32:
+            case FIELD_U32:  memcpy(p, &words[w], 4); break;
+            case FIELD_BOOL: *(bool*)p = (words[w] != 0); break;
+            case FIELD_U16:  *(unsigned short*)p = (unsigned short)words[w]; break;
+            case FIELD_U8:   *(unsigned char*)p = (unsigned char)words[w]; break;
+            case FIELD_U64: {
+                unsigned long long v = (unsigned long long)words[w] | ((unsigned long long)words[w + 1] << 32);
+                memcpy(p, &v, sizeof(v));
+                break;
+            }
+        }
+        w += size;
+    }
+    CheckTweens(s, version);
+}
+
+// ---------------------------------------------------------------------------
+// Little-endian packing
+// ---------------------------------------------------------------------------
+
+static unsigned char* PutU16(unsigned char* p, unsigned int v) {
+    p[0] = (unsigned char)v; p[1] = (unsigned char)(v >> 8);
+    return p + 2;
+}
+
+static unsigned char* PutU32(unsigned char* p, unsigned int v) {
+    p[0] = (unsigned char)v; p[1] = (unsigned char)(v >> 8);
+    p[2] = (unsigned char)(v >> 16); p[3] = (unsigned char)(v >> 24);
+    return p + 4;
+}
+
+static unsigned char* PutU64(unsigned char* p, unsigned long long v) {
+    p = PutU32(p, (unsigned int)(v & 0xFFFFFFFFu));
+    return PutU32(p, (unsigned int)(v >> 32));
+}
+
+static unsigned int GetU16(const unsigned char* p) {
+    return (unsigned int)p[0] | ((unsigned int)p[1] << 8);
+}
+
+static unsigned int GetU32(const unsigned char* p) {
+    return (unsigned int)p[0] | ((unsigned int)p[1] << 8) | ((unsigned int)p[2] << 16) | ((unsigned int)p[3] << 24);
+}
+
+static unsigned long long GetU64(const unsigned char* p) {
+    return (unsigned long long)GetU32(p) | ((unsigned long long)GetU32(p + 4) << 32);
+}
+
+static unsigned char* PutFileHeader(unsigned char* p, const char magic[8]) {
+    memcpy(p, magic, 8);
+    p = PutU16(p + 8, SNAPSHOT_VERSION);
+    return PutU16(p, (unsigned int)Snapshot_WordCount());
+}
+
+// ---------------------------------------------------------------------------
+// Full snapshots
+// ---------------------------------------------------------------------------
+
+int Snapshot_Encode(const PongState* s, unsigned char* buffer, int capacity) {
+    int words = Snapshot_WordCount();
+    if (capacity < FILE_HEADER + 4 * words) return 0;
+    unsigned int values[SNAPSHOT_MAX_WORDS];
+    ToWords(s, values);
+    unsigned char* p = PutFileHeader(buffer, SNAPSHOT_MAGIC);
+    for (int i = 0; i < words; i++) p = PutU32(p, values[i]);
+    return (int)(p - buffer);
+}
+
+bool Snapshot_Decode(const unsigned char* buffer, int size, PongState* s) {
+    if (size < FILE_HEADER || memcmp(buffer, SNAPSHOT_MAGIC, 8) != 0) return false;
+    int version = (int)GetU16(buffer + 8);
+    int words = (int)GetU16(buffer + 10);
+    if (words > SNAPSHOT_MAX_WORDS || size < FILE_HEADER + 4 * words) return false;
+    unsigned int values[SNAPSHOT_MAX_WORDS];
+    for (int i = 0; i < words; i++) values[i] = GetU32(buffer + FILE_HEADER + 4 * i);
+    FromWords(s, values, words, version);
+    return true;
+}
+
+bool Snapshot_Save(const char* path, const PongState* s) {
+    unsigned char buffer[SNAPSHOT_MAX_SIZE];
+    int size = Snapshot_Encode(s, buffer, sizeof(buffer));
+    FILE* f = fopen(path, "wb");
+    if (!f) return false;
+    bool ok = fwrite(buffer, 1, (size_t)size, f) == (size_t)size;
+    return fclose(f) == 0 && ok;
+}
+
+bool Snapshot_Load(const char* path, PongState* s) {
+    unsigned char buffer[SNAPSHOT_MAX_SIZE];
+    FILE* f = fopen(path, "rb");
+    if (!f) return false;
+    int size = (int)fread(buffer, 1, sizeof(buffer), f);
+    fclose(f);
+    return Snapshot_Decode(buffer, size, s);
+}
+
+// ---------------------------------------------------------------------------
+// Deltas
+// ---------------------------------------------------------------------------
+
+static int EncodeDeltaWords(const unsigned int* a, const unsigned int* b, unsigned char* buffer, int capacity) {
+    int words = Snapshot_WordCount();
+    int maskBytes = (words + 7) / 8;
+    if (capacity < maskBytes + 4 * words) return 0;
+    memset(buffer, 0, (size_t)maskBytes);
+    unsigned char* p = buffer + maskBytes;
+    for (int i = 0; i < words; i++) {
+        if (a[i] == b[i]) continue;
+        buffer[i >> 3] |= (unsigned char)(1u << (i & 7));
+        p = PutU32(p, b[i]);
+    }
+    return (int)(p - buffer);
+}
+
+int Snapshot_EncodeDelta(const PongState* prev, const PongState* cur, unsigned char* buffer, int capacity) {
+    unsigned int a[SNAPSHOT_MAX_WORDS], b[SNAPSHOT_MAX_WORDS];
+    ToWords(prev, a);
+    ToWords(cur, b);
+    return EncodeDeltaWords(a, b, buffer, capacity);
+}
+
+static bool ApplyDelta(const unsigned char* buffer, int size, int words, int version, PongState* s) {
+    int maskBytes = (words + 7) / 8;
+    if (size < maskBytes) return false;
+    const unsigned char* p = buffer + maskBytes;
+    const unsigned char* end = buffer + size;
+    int known = Snapshot_WordCount();
+    for (int i = 0; i < words; i++) {
+        if (!(buffer[i >> 3] & (1u << (i & 7)))) continue;
+        if (p + 4 > end) return false;
+        if (i < known) SetWord(s, i, GetU32(p));
+        p += 4;
+    }
+    CheckTweens(s, version);
+    return p == end;
+}
+
+bool Snapshot_ApplyDelta(const unsigned char* buffer, int size, int words, PongState* s) {
+    return ApplyDelta(buffer, size, words, SNAPSHOT_VERSION, s);
+}
+
+// ---------------------------------------------------------------------------
+// Stream writer
+// ---------------------------------------------------------------------------
+
+static void WriteRecord(SnapshotStream* w, int type, const unsigned char* payload, int size) {
+    unsigned char header[RECORD_HEADER] = { (unsigned char)type, (unsigned char)size, (unsigned char)(size >> 8) };
+    fwrite(header, 1, RECORD_HEADER, w->file);
+    if (size > 0) fwrite(payload, 1, (size_t)size, w->file);
+    w->bytes += RECORD_HEADER + size;
+}
+
+bool SnapshotStream_Open(SnapshotStream* w, const char* path) {
+    memset(w, 0, sizeof(*w));
+    w->file = fopen(path, "wb");
+    if (!w->file) return false;
+    unsigned char header[FILE_HEADER];
+    PutFileHeader(header, STREAM_MAGIC);
+    fwrite(header, 1, FILE_HEADER, w->file);
+    w->bytes = FILE_HEADER;
+    return true;
+}
+
+void SnapshotStream_Frame(SnapshotStream* w, const PongState* s) {
+    if (!w->file) return;
+    unsigned char payload[16 + SNAPSHOT_MAX_DELTA];
+    unsigned int values[SNAPSHOT_MAX_WORDS];
+    ToWords(s, values);
+    if (w->states % SNAPSHOT_KEYFRAME_INTERVAL == 0) {
+        unsigned char* p = PutU64(payload, w->states);
+        p = PutU64(p, Pong_HashState(s));
+        for (int i = 0; i < Snapshot_WordCount(); i++) p = PutU32(p, values[i]);
+        WriteRecord(w, RECORD_KEYFRAME, payload, (int)(p - payload));
+        w->keyframes++;
+    } else {
+        int size = EncodeDeltaWords(w->last, values, payload, sizeof(payload));
+        WriteRecord(w, RECORD_DELTA, payload, size);
+    }
+    memcpy(w->last, values, sizeof(w->last));
+    w->states++;
+}
+
+void SnapshotStream_Flush(SnapshotStream* w) {
+    if (w->file) fflush(w->file);
+}
+
+void SnapshotStream_Close(SnapshotStream* w) {
+    if (!w->file) return;
+    WriteRecord(w, RECORD_END, NULL, 0);
+    fclose(w->file);
+    w->file = NULL;
+}
+
+// ---------------------------------------------------------------------------
+// Memory-mapped stream reader
+// ---------------------------------------------------------------------------
+
+#ifdef _WIN32
+static size_t FileSize(SnapshotReader* r) {
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx((HANDLE)(intptr_t)r->file, &size)) return 0;
+    return (size_t)size.QuadPart;
+}
+
+static void Unmap(SnapshotReader* r) {
+    if (r->view) UnmapViewOfFile(r->view);
+    if (r->mapping) CloseHandle((HANDLE)(intptr_t)r->mapping);
+    r->view = NULL;
+    r->mapping = 0;
+    r->viewSize = 0;
+}
+
+static bool Map(SnapshotReader* r, size_t size) {
+    Unmap(r);
+    HANDLE mapping = CreateFileMappingA((HANDLE)(intptr_t)r->file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (!mapping) return false;
+    r->mapping = (long long)(intptr_t)mapping;
+    r->view = (const unsigned char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, size);
+    r->viewSize = r->view ? size : 0;
+    return r->view != NULL;
+}
+
+bool SnapshotReader_Open(SnapshotReader* r, const char* path) {
+    memset(r, 0, sizeof(*r));
+    // The writer still has the file open
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                              NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) return false;
+    r->file = (long long)(intptr_t)file;
+    return true;
+}
+
+void SnapshotReader_Close(SnapshotReader* r) {
+    Unmap(r);
+    if (r->file) CloseHandle((HANDLE)(intptr_t)r->file);
+    r->file = 0;
+}
+#else
+static size_t FileSize(SnapshotReader* r) {
+    struct stat st;
+    if (fstat((int)r->file, &st) != 0) return 0;
+    return (size_t)st.st_size;
+}
+
+static void Unmap(SnapshotReader* r) {
+    if (r->view) munmap((void*)r->view, r->viewSize);
+    r->view = NULL;
+    r->viewSize = 0;
+}
+
+static bool Map(SnapshotReader* r, size_t size) {
+    Unmap(r);
+    void* view = mmap(NULL, size, PROT_READ, MAP_SHARED, (int)r->file, 0);
+    if (view == MAP_FAILED) return false;
+    r->view = (const unsigned char*)view;
+    r->viewSize = size;
+    return true;
+}
+
+bool SnapshotReader_Open(SnapshotReader* r, const char* path) {
+    memset(r, 0, sizeof(*r));
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
+    r->file = fd;
+    return true;
+}
+
+void SnapshotReader_Close(SnapshotReader* r) {
+    Unmap(r);
+    close((int)r->file);
+    r->file = -1;
+}
+#endif
+
+static bool DecodeRecord(SnapshotReader* r, int type, const unsigned char* payload, int size) {
+    if (type == RECORD_END) {
+        r->ended = true;
+        return true;
+    }
+    if (type == RECORD_KEYFRAME) {
+        if (size != 16 + 4 * r->words) return false;
+        unsigned int values[SNAPSHOT_MAX_WORDS];
+        for (int i = 0; i < r->words; i++) values[i] = GetU32(payload + 16 + 4 * i);
+        FromWords(&r->state, values, r->words, r->version);
+        r->frame = GetU64(payload);
+        // Only comparable when both sides have the same fields
+        if (r->words == Snapshot_WordCount() && Pong_HashState(&r->state) != GetU64(payload + 8)) r->hashMismatches++;
+        r->synced = true;
+        r->keyframes++;
+        r->states++;
+        return true;
+    }
+    if (type == RECORD_DELTA) {
+        // Joined mid-stream: skip deltas until the first keyframe
+        if (!r->synced) return true;
+        if (!ApplyDelta(payload, size, r->words, r->version, &r->state)) return false;
+        r->frame++;
+        r->states++;
+        return true;
+    }
+    return false;
+}
+
+int SnapshotReader_Poll(SnapshotReader* r) {
+    size_t size = FileSize(r);
+    if (size > r->viewSize && !Map(r, size)) return -1;
+    if (r->viewSize < FILE_HEADER) return 0;
+
+    if (r->offset == 0) {
+        if (memcmp(r->view, STREAM_MAGIC, 8) != 0) return -1;
+        r->version = (int)GetU16(r->view + 8);
+        r->words = (int)GetU16(r->view + 10);
+        if (r->words > SNAPSHOT_MAX_WORDS) return -1;
+        r->offset = FILE_HEADER;
+    }
+
+    long long before = r->states;
+    while (!r->ended && r->offset + RECORD_HEADER <= r->viewSize) {
+        const unsigned char* record = r->view + r->offset;
+        int payloadSize = (int)GetU16(record + 1);
+        // The writer is still appending this one
+        if (r->offset + RECORD_HEADER + (size_t)payloadSize > r->viewSize) break;
+        if (!DecodeRecord(r, record[0], record + RECORD_HEADER, payloadSize)) return -1;
+        r->offset += RECORD_HEADER + (size_t)payloadSize;
+    }
+    return (int)(r->states - before);
+}
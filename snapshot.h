@@ -0,0 +1,94 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+#include <stdio.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "pong_core.h"
+
+// Binary snapshots of the whole PongState, for save/resume and spectating.
+//
+// The state is flattened into a fixed list of 32-bit little-endian words,
+// one per field (two for 64-bit ones), in the order of a field table in
+// snapshot.c. New fields are only ever appended to the table and
+// SNAPSHOT_VERSION bumped, so every file stores its word count: a reader
+// decodes the words it knows and ignores the rest, and fields an older file
+// doesn't have keep the value the caller initialised them to.
+//
+// Tween targets are stored as PongTweenProp IDs (offsets into PongState
+// before version 5, which are mapped to IDs on load).
+//
+// Snapshot file ('PONGSNAP'): u16 version, u16 word count, words.
+//
+// Stream file ('PONGSTRM'): u16 version, u16 word count, then records of
+// u8 type, u16 payload size, payload:
+//
+//   'K' u64 frame, u64 state hash, all words     keyframe
+//   'D' changed-word bitmask, changed words      delta from the previous state
+//   'E' (empty)                                  end of stream
+//
+// A keyframe is written every SNAPSHOT_KEYFRAME_INTERVAL states, so a
+// spectator that opens the stream late syncs at the next one, and its hash
+// lets the spectator check its decoded state.
+
+#define SNAPSHOT_VERSION 5
+#define SNAPSHOT_MAX_WORDS 256
+#define SNAPSHOT_MAX_SIZE (12 + 4 * SNAPSHOT_MAX_WORDS)
+#define SNAPSHOT_MAX_DELTA (1 + SNAPSHOT_MAX_WORDS / 8 + 4 * SNAPSHOT_MAX_WORDS)
+#define SNAPSHOT_KEYFRAME_INTERVAL 240
+
+int Snapshot_WordCount(void);
+
+// Whole state as a snapshot file image. Returns the size, 0 if it doesn't fit.
+int Snapshot_Encode(const PongState* s, unsigned char* buffer, int capacity);
+bool Snapshot_Decode(const unsigned char* buffer, int size, PongState* s);
+bool Snapshot_Save(const char* path, const PongState* s);
+bool Snapshot_Load(const char* path, PongState* s);
+
+// Only the words that differ from prev: a bitmask of Snapshot_WordCount()
+// bits, then the new values. Returns the size, 0 if it doesn't fit.
+int Snapshot_EncodeDelta(const PongState* prev, const PongState* cur, unsigned char* buffer, int capacity);
+// Applies a delta written against the state s holds. words is the word
+// count of the writer (Snapshot_WordCount() for deltas made by this build).
+bool Snapshot_ApplyDelta(const unsigned char* buffer, int size, int words, PongState* s);
+
+typedef struct {
+    FILE* file;
+    unsigned int last[SNAPSHOT_MAX_WORDS];  // Words of the previous state
+    unsigned long long states;
+    long long bytes;
+    long long keyframes;
+} SnapshotStream;
+
+bool SnapshotStream_Open(SnapshotStream* w, const char* path);
+// Call once per physics step with the state after it
+void SnapshotStream_Frame(SnapshotStream* w, const PongState* s);
+// Makes everything written so far visible to readers (once per rendered frame)
+void SnapshotStream_Flush(SnapshotStream* w);
+void SnapshotStream_Close(SnapshotStream* w);
+
+// Spectator side: maps the stream file read-only and decodes records as the
+// writer appends them. The mapping grows with the file.
+typedef struct {
+    long long file;             // fd, or HANDLE on Windows
+    long long mapping;          // Windows file mapping object
+    const unsigned char* view;
+    size_t viewSize;
+    size_t offset;              // Next record
+    int words;                  // Word count of the writer
+    int version;                // SNAPSHOT_VERSION of the writer
+    bool synced;                // Decoded a keyframe, state is valid
+    bool ended;
+    PongState state;
+    unsigned long long frame;   // Of state, counted from the last keyframe
+    long long states;
+    long long keyframes;
+    long long hashMismatches;
+} SnapshotReader;
+
+bool SnapshotReader_Open(SnapshotReader* r, const char* path);
+// Decodes every complete record. Returns the number of states decoded, or -1
+// if the stream is corrupt.
+int SnapshotReader_Poll(SnapshotReader* r);
+void SnapshotReader_Close(SnapshotReader* r);
+
+#endif
@@ -0,0 +1,179 @@
+#define _GNU_SOURCE
+#include "threadpool.h"
+#include <stdlib.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#define THREADPOOL_MAX 256
+
+// A worker's remaining indices [begin, end) packed into one word, so the
+// owner taking from the front and a thief taking from the back can both use
+// a single compare-and-swap.
+typedef struct {
+    unsigned long long range;
+    char pad[56];   // One cache line per worker
+} WorkerRange;
+
+typedef struct {
+    ThreadPool* pool;
+    int index;
+} WorkerArgs;
+
+struct ThreadPool {
+    int threads;
+    pthread_t handles[THREADPOOL_MAX];
+    WorkerArgs args[THREADPOOL_MAX];
+    WorkerRange ranges[THREADPOOL_MAX];
+
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    pthread_cond_t idle;
+    unsigned long generation;   // Bumped for every ParallelFor
+    int busy;                   // Helper threads still working on it
+    int quit;
+
+    ThreadPoolTask fn;
+    void* ctx;
+};
+
+static unsigned long long Pack(unsigned int begin, unsigned int end) {
+    return ((unsigned long long)begin << 32) | end;
+}
+
+static unsigned int Begin(unsigned long long range) { return (unsigned int)(range >> 32); }
+static unsigned int End(unsigned long long range) { return (unsigned int)range; }
+
+// Takes the next index from the front of the worker's own range
+static int PopOwn(ThreadPool* pool, int worker, unsigned int* index) {
+    unsigned long long* slot = &pool->ranges[worker].range;
+    unsigned long long cur = __atomic_load_n(slot, __ATOMIC_ACQUIRE);
+    while (Begin(cur) < End(cur)) {
+        unsigned long long next = Pack(Begin(cur) + 1, End(cur));
+        if (__atomic_compare_exchange_n(slot, &cur, next, 1, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            *index = Begin(cur);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Moves the back half of some other worker's range into ours
+static int Steal(ThreadPool* pool, int worker) {
+    for (int k = 1; k < pool->threads; k++) {
+        int victim = (worker + k) % pool->threads;
+        unsigned long long* slot = &pool->ranges[victim].range;
+        unsigned long long cur = __atomic_load_n(slot, __ATOMIC_ACQUIRE);
+        while (Begin(cur) < End(cur)) {
+            unsigned int begin = Begin(cur), end = End(cur);
+            unsigned int mid = begin + (end - begin) / 2;   // A single index is taken whole
+            unsigned long long kept = Pack(begin, mid);
+            if (__atomic_compare_exchange_n(slot, &cur, kept, 1, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+                __atomic_store_n(&pool->ranges[worker].range, Pack(mid, end), __ATOMIC_RELEASE);
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+static void RunWorker(ThreadPool* pool, int worker) {
+    unsigned int index;
+    for (;;) {
+        while (PopOwn(pool, worker, &index)) pool->fn(pool->ctx, (int)index, worker);
+        if (!Steal(pool, worker)) break;
+    }
+}
+
+static void* WorkerMain(void* arg) {
+    WorkerArgs* args = (WorkerArgs*)arg;
+    ThreadPool* pool = args->pool;
+    unsigned long seen = 0;
+
+    pthread_mutex_lock(&pool->lock);
+    for (;;) {
+        while (!pool->quit && pool->generation == seen) pthread_cond_wait(&pool->wake, &pool->lock);
+        if (pool->quit) break;
+        seen = pool->generation;
+        pthread_mutex_unlock(&pool->lock);
+
+        RunWorker(pool, args->index);
+
+        pthread_mutex_lock(&pool->lock);
+        if (--pool->busy == 0) pthread_cond_signal(&pool->idle);
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return NULL;
+}
+
+int ThreadPool_CpuCount(void) {
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (int)n : 1;
+}
+
+ThreadPool* ThreadPool_Create(int threads) {
+    if (threads <= 0) threads = ThreadPool_CpuCount();
+    if (threads > THREADPOOL_MAX) threads = THREADPOOL_MAX;
+
+    ThreadPool* pool = (ThreadPool*)calloc(1, sizeof(ThreadPool));
+    if (!pool) return NULL;
+    pool->threads = threads;
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->wake, NULL);
+    pthread_cond_init(&pool->idle, NULL);
+
+    for (int i = 1; i < threads; i++) {
+        pool->args[i] = (WorkerArgs){ pool, i };
+        if (pthread_create(&pool->handles[i], NULL, WorkerMain, &pool->args[i]) != 0) {
+            // Run with the threads we got
+            pool->threads = i;
+            break;
+        }
+    }
+    return pool;
+}
+
+void ThreadPool_Destroy(ThreadPool* pool) {
+    if (!pool) return;
+    pthread_mutex_lock(&pool->lock);
+    pool->quit = 1;
+    pthread_cond_broadcast(&pool->wake);
+    pthread_mutex_unlock(&pool->lock);
+    for (int i = 1; i < pool->threads; i++) pthread_join(pool->handles[i], NULL);
+    pthread_cond_destroy(&pool->idle);
+    pthread_cond_destroy(&pool->wake);
+    pthread_mutex_destroy(&pool->lock);
+    free(pool);
+}
+
+int ThreadPool_Threads(const ThreadPool* pool) {
+    return pool->threads;
+}
+
+void ThreadPool_ParallelFor(ThreadPool* pool, int count, ThreadPoolTask fn, void* ctx) {
+    if (count <= 0) return;
+    if (pool->threads == 1) {
+        for (int i = 0; i < count; i++) fn(ctx, i, 0);
+        return;
+    }
+
+    // Even initial split; stealing evens out whatever imbalance remains
+    for (int w = 0; w < pool->threads; w++) {
+        unsigned int begin = (unsigned int)((long long)count * w / pool->threads);
+        unsigned int end = (unsigned int)((long long)count * (w + 1) / pool->threads);
+        __atomic_store_n(&pool->ranges[w].range, Pack(begin, end), __ATOMIC_RELAXED);
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    pool->fn = fn;
+    pool->ctx = ctx;
+    pool->busy = pool->threads - 1;
+    pool->generation++;
+    pthread_cond_broadcast(&pool->wake);
+    pthread_mutex_unlock(&pool->lock);
+
+    RunWorker(pool, 0);
+
+    pthread_mutex_lock(&pool->lock);
+    while (pool->busy > 0) pthread_cond_wait(&pool->idle, &pool->lock);
+    pthread_mutex_unlock(&pool->lock);
+}
@@ -0,0 +1,23 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+// Persistent worker threads running parallel-for loops. Each worker starts
+// with an even slice of the index range and, when it runs dry, steals half of
+// what is left in another worker's slice, so uneven tasks (long and short
+// matches) still keep every thread busy. The calling thread works as worker 0.
+
+typedef struct ThreadPool ThreadPool;
+
+// fn is called once per index in [0, count); worker is in [0, threads)
+typedef void (*ThreadPoolTask)(void* ctx, int index, int worker);
+
+// threads <= 0 uses one per CPU
+ThreadPool* ThreadPool_Create(int threads);
+void ThreadPool_Destroy(ThreadPool* pool);
+int ThreadPool_Threads(const ThreadPool* pool);
+int ThreadPool_CpuCount(void);
+
+// Returns when every index has been processed
+void ThreadPool_ParallelFor(ThreadPool* pool, int count, ThreadPoolTask fn, void* ctx);
+
+#endif
@@ -0,0 +1,332 @@
+#include "pong_core.h"
+#include "player_model.h"
+#include "ai_params.h"
+#include "threadpool.h"
+#include "pong_clock.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+// Monte-Carlo tuner for the adaptive AI (PongAIParams). Every candidate plays
+// the same set of seeded matches against each scripted player model, and the
+// search keeps the parameters whose win rate and rally length come closest to
+// the targets for every skill level.
+//
+//   pong_tune [--generations N] [--population N] [--matches N] [--points N]
+//             [--target-winrate F] [--target-rally F] [--threads N]
+//             [--seed N] [--out FILE]
+//   pong_tune --scaling [--population N] [--matches N] [--threads N]
+//
+// Matches are first to --points; a match that hits the time cap counts as a
+// draw. Win rate is player 1's (the human side), rally length the number of
+// paddle hits per point. The search starts from the defaults plus random
+// samples, then samples around the best candidate with a shrinking radius.
+// Results don't depend on --threads: each match is seeded by its index.
+//
+// --scaling evaluates one fixed population with 1, 2, 4 ... threads (up to
+// --threads, default one per CPU) and reports the speedup of each.
+
+#define MONITOR_W 1920
+#define MONITOR_H 1080
+#define MAX_MATCH_SECONDS 180.0f
+#define RALLY_WEIGHT 0.25f
+
+typedef struct {
+    const char* name;
+    float min, max;
+} ParamRange;
+
+// Search space, in PongAIParams order (guaranteedHits is handled apart)
+static const ParamRange ranges[] = {
+    { "base_difficulty",       0.30f, 0.98f },
+    { "scaling_factor",        0.00f, 0.10f },
+    { "difficulty_cap",        0.50f, 1.00f },
+    { "score_threshold",       1.00f, 6.00f },
+    { "facilitate_difficulty", 0.00f, 0.90f },
+    { "reaction_delay",        0.05f, 0.50f },
+    { "max_error_scale",       20.0f, 600.0f },
+};
+#define PARAM_COUNT (int)(sizeof(ranges) / sizeof(ranges[0]))
+#define MAX_GUARANTEED_HITS 6
+
+typedef struct {
+    int points1, points2;
+    int hits;
+} MatchResult;
+
+typedef struct {
+    float winRate[PONG_SKILL_COUNT];
+    float rally[PONG_SKILL_COUNT];
+    float cost;
+} Score;
+
+typedef struct {
+    const PongAIParams* candidates;
+    MatchResult* results;
+    int matches;
+    int points;
+    unsigned int seed;
+} Evaluation;
+
+static float* ParamField(PongAIParams* p, int i) {
+    float* fields[PARAM_COUNT] = {
+        &p->baseDifficulty, &p->scalingFactor, &p->difficultyCap, &p->scoreThreshold,
+        &p->facilitateDifficulty, &p->reactionDelay, &p->maxErrorScale
+    };
+    return fields[i];
+}
+
+static unsigned long long rngState = 0x9E3779B97F4A7C15ULL;
+
+static float RandomUnit(void) {
+    unsigned long long x = rngState;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    rngState = x;
+    return (float)((x * 2685821657736338717ULL) >> 40) / (float)(1 << 24);
+}
+
+static void Clamp(PongAIParams* p) {
+    for (int i = 0; i < PARAM_COUNT; i++) {
+        float* v = ParamField(p, i);
+        if (*v < ranges[i].min) *v = ranges[i].min;
+        if (*v > ranges[i].max) *v = ranges[i].max;
+    }
+    if (p->guaranteedHits < 0) p->guaranteedHits = 0;
+    if (p->guaranteedHits > MAX_GUARANTEED_HITS) p->guaranteedHits = MAX_GUARANTEED_HITS;
+}
+
+static void Sample(PongAIParams* out, const PongAIParams* center, float radius) {
+    *out = *center;
+    for (int i = 0; i < PARAM_COUNT; i++) {
+        float span = ranges[i].max - ranges[i].min;
+        *ParamField(out, i) += (RandomUnit() * 2.0f - 1.0f) * radius * span;
+    }
+    if (RandomUnit() < radius) out->guaranteedHits += (RandomUnit() < 0.5f) ? -1 : 1;
+    Clamp(out);
+}
+
+// One task = one match of one candidate against one player model
+static void PlayMatch(void* ctx, int index, int worker) {
+    (void)worker;
+    Evaluation* e = (Evaluation*)ctx;
+    int match = index % e->matches;
+    int skill = (index / e->matches) % PONG_SKILL_COUNT;
+    int candidate = index / (e->matches * PONG_SKILL_COUNT);
+
+    float windowX = MONITOR_W/2.0f - INITIAL_WIDTH/2.0f;
+    float windowY = MONITOR_H/2.0f - INITIAL_HEIGHT/2.0f;
+    unsigned long long seed = (unsigned long long)e->seed * 1000003ULL + (unsigned long long)match;
+
+    PongState game;
+    Pong_Init(&game, windowX, windowY, MONITOR_W, MONITOR_H, seed);
+    game.ai = e->candidates[candidate];
+
+    PongPlayerModel player;
+    PlayerModel_Init(&player, Pong_PlayerSkill((PongSkill)skill), seed ^ 0xA5A5A5A5A5A5A5A5ULL);
+
+    MatchResult r = { 0, 0, 0 };
+    long long maxSteps = (long long)(MAX_MATCH_SECONDS * PONG_PHYSICS_HZ);
+    for (long long f = 0; f < maxSteps; f++) {
+        PongInput input = { PlayerModel_Keys(&player, &game, PONG_FIXED_DT), windowX, windowY };
+        Pong_Step(&game, &input, PONG_FIXED_DT);
+        if (game.events & (PONG_EVENT_HIT_P1 | PONG_EVENT_HIT_P2)) r.hits++;
+        if (game.score1 >= e->points || game.score2 >= e->points) break;
+    }
+    r.points1 = game.score1;
+    r.points2 = game.score2;
+    e->results[index] = r;
+}
+
+static void ScoreCandidate(const MatchResult* results, int matches, int points,
+                           float targetWinRate, float targetRally, Score* score) {
+    score->cost = 0.0f;
+    for (int skill = 0; skill < PONG_SKILL_COUNT; skill++) {
+        const MatchResult* r = &results[skill * matches];
+        float wins = 0.0f;
+        long long hits = 0, played = 0;
+        for (int m = 0; m < matches; m++) {
+            if (r[m].points1 >= points) wins += 1.0f;
+            else if (r[m].points2 < points) wins += 0.5f;   // Time cap: draw
+            hits += r[m].hits;
+            played += r[m].points1 + r[m].points2;
+        }
+        score->winRate[skill] = wins / (float)matches;
+        // A match that never scores is one endless rally
+        score->rally[skill] = (float)hits / (float)(played > 0 ? played : 1);
+
+        float dWin = score->winRate[skill] - targetWinRate;
+        // Log ratio, so a runaway rally doesn't swamp the win-rate term
+        float dRally = logf((score->rally[skill] + 1.0f) / (targetRally + 1.0f));
+        score->cost += dWin * dWin + RALLY_WEIGHT * dRally * dRally;
+    }
+}
+
+// Plays every match of every candidate on the pool and scores them
+static void Evaluate(ThreadPool* pool, const PongAIParams* candidates, int count, int matches, int points,
+                     unsigned int seed, float targetWinRate, float targetRally, Score* scores) {
+    int tasks = count * PONG_SKILL_COUNT * matches;
+    MatchResult* results = (MatchResult*)malloc(sizeof(MatchResult) * (size_t)tasks);
+    if (!results) { fprintf(stderr, "Out of memory\n"); exit(1); }
+
+    Evaluation e = { candidates, results, matches, points, seed };
+    ThreadPool_ParallelFor(pool, tasks, PlayMatch, &e);
+
+    for (int c = 0; c < count; c++) {
+        ScoreCandidate(&results[c * PONG_SKILL_COUNT * matches], matches, points,
+                       targetWinRate, targetRally, &scores[c]);
+    }
+    free(results);
+}
+
+static void PrintScore(const char* label, const Score* score) {
+    printf("%-10s cost %.4f ", label, score->cost);
+    for (int skill = 0; skill < PONG_SKILL_COUNT; skill++) {
+        printf(" | %s win %.2f rally %.1f", Pong_PlayerSkill((PongSkill)skill)->name,
+               score->winRate[skill], score->rally[skill]);
+    }
+    printf("\n");
+}
+
+static void PrintParams(const PongAIParams* p) {
+    for (int i = 0; i < PARAM_COUNT; i++) {
+        printf("  %-22s %.4f\n", ranges[i].name, *ParamField((PongAIParams*)p, i));
+    }
+    printf("  %-22s %d\n", "guaranteed_hits", p->guaranteedHits);
+}
+
+static int RunScaling(int population, int matches, int points, unsigned int seed,
+                      float targetWinRate, float targetRally, int maxThreads) {
+    PongAIParams* candidates = (PongAIParams*)malloc(sizeof(PongAIParams) * (size_t)population);
+    Score* scores = (Score*)malloc(sizeof(Score) * (size_t)population);
+    if (!candidates || !scores) { fprintf(stderr, "Out of memory\n"); return 1; }
+
+    PongAIParams defaults;
+    Pong_DefaultAIParams(&defaults);
+    for (int c = 0; c < population; c++) Sample(&candidates[c], &defaults, 0.5f);
+
+    int cpus = maxThreads > 0 ? maxThreads : ThreadPool_CpuCount();
+    double baseTime = 0.0;
+    float baseCost = 0.0f;
+    printf("scaling: %d candidates x %d skills x %d matches\n", population, PONG_SKILL_COUNT, matches);
+    printf("  %7s %10s %9s %10s\n", "threads", "time (s)", "speedup", "efficiency");
+    for (int threads = 1; ; threads *= 2) {
+        if (threads > cpus) threads = cpus;
+        ThreadPool* pool = ThreadPool_Create(threads);
+        if (!pool) { fprintf(stderr, "Could not create thread pool\n"); return 1; }
+
+        double start = Pong_ClockSeconds();
+        Evaluate(pool, candidates, population, matches, points, seed, targetWinRate, targetRally, scores);
+        double elapsed = Pong_ClockSeconds() - start;
+        ThreadPool_Destroy(pool);
+
+        if (threads == 1) { baseTime = elapsed; baseCost = scores[0].cost; }
+        double speedup = elapsed > 0.0 ? baseTime / elapsed : 0.0;
+        printf("  %7d %10.3f %8.2fx %9.0f%%%s\n", threads, elapsed, speedup, 100.0 * speedup / threads,
+               scores[0].cost == baseCost ? "" : "  RESULTS DIFFER");
+        if (threads == cpus) break;
+    }
+
+    free(candidates);
+    free(scores);
+    return 0;
+}
+
+static void Usage(void) {
+    fprintf(stderr,
+            "usage: pong_tune [--generations N] [--population N] [--matches N] [--points N]\n"
+            "                 [--target-winrate F] [--target-rally F] [--threads N]\n"
+            "                 [--seed N] [--out FILE]\n"
+            "       pong_tune --scaling [--population N] [--matches N] [--threads N]\n");
+}
+
+int main(int argc, char** argv) {
+    int generations = 10;
+    int population = 24;
+    int matches = 16;
+    int points = 5;
+    float targetWinRate = 0.5f;
+    float targetRally = 6.0f;
+    int threads = 0;
+    unsigned int seed = 1;
+    const char* outPath = "ai_params.txt";
+    bool scaling = false;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        bool hasValue = (i + 1 < argc);
+        if (strcmp(arg, "--generations") == 0 && hasValue) generations = atoi(argv[++i]);
+        else if (strcmp(arg, "--population") == 0 && hasValue) population = atoi(argv[++i]);
+        else if (strcmp(arg, "--matches") == 0 && hasValue) matches = atoi(argv[++i]);
+        else if (strcmp(arg, "--points") == 0 && hasValue) points = atoi(argv[++i]);
+        else if (strcmp(arg, "--target-winrate") == 0 && hasValue) targetWinRate = (float)atof(argv[++i]);
+        else if (strcmp(arg, "--target-rally") == 0 && hasValue) targetRally = (float)atof(argv[++i]);
+        else if (strcmp(arg, "--threads") == 0 && hasValue) threads = atoi(argv[++i]);
+        else if (strcmp(arg, "--seed") == 0 && hasValue) seed = (unsigned int)strtoul(argv[++i], NULL, 10);
+        else if (strcmp(arg, "--out") == 0 && hasValue) outPath = argv[++i];
+        else if (strcmp(arg, "--scaling") == 0) scaling = true;
+        else { Usage(); return 1; }
+    }
+    if (generations <= 0 || population <= 0 || matches <= 0 || points <= 0 || targetRally <= 0.0f) {
+        Usage();
+        return 1;
+    }
+    rngState ^= (unsigned long long)seed * 0xD1B54A32D192ED03ULL;
+
+    if (scaling) return RunScaling(population, matches, points, seed, targetWinRate, targetRally, threads);
+
+    PongAIParams* candidates = (PongAIParams*)malloc(sizeof(PongAIParams) * (size_t)population);
+    Score* scores = (Score*)malloc(sizeof(Score) * (size_t)population);
+    ThreadPool* pool = ThreadPool_Create(threads);
+    if (!candidates || !scores || !pool) { fprintf(stderr, "Out of memory\n"); return 1; }
+
+    printf("tuning: %d generations x %d candidates x %d skills x %d matches to %d, %d threads\n",
+           generations, population, PONG_SKILL_COUNT, matches, points, ThreadPool_Threads(pool));
+    printf("targets: win rate %.2f, rally %.1f hits/point\n", targetWinRate, targetRally);
+
+    PongAIParams best;
+    Pong_DefaultAIParams(&best);
+    Score bestScore;
+    Evaluate(pool, &best, 1, matches, points, seed, targetWinRate, targetRally, &bestScore);
+    PrintScore("defaults", &bestScore);
+
+    double start = Pong_ClockSeconds();
+    float radius = 0.5f;
+    for (int g = 0; g < generations; g++) {
+        for (int c = 0; c < population; c++) Sample(&candidates[c], &best, radius);
+        Evaluate(pool, candidates, population, matches, points, seed, targetWinRate, targetRally, scores);
+
+        for (int c = 0; c < population; c++) {
+            if (scores[c].cost < bestScore.cost) {
+                bestScore = scores[c];
+                best = candidates[c];
+            }
+        }
+        char label[32];
+        snprintf(label, sizeof(label), "gen %d", g);
+        PrintScore(label, &bestScore);
+        radius *= 0.7f;
+    }
+    double elapsed = Pong_ClockSeconds() - start;
+    long long played = (long long)generations * population * PONG_SKILL_COUNT * matches;
+    printf("%lld matches in %.2f s (%.0f matches/s)\n", played, elapsed, elapsed > 0 ? (double)played / elapsed : 0.0);
+
+    printf("best parameters:\n");
+    PrintParams(&best);
+
+    char comment[160];
+    snprintf(comment, sizeof(comment), "pong_tune: cost %.4f, target win rate %.2f, target rally %.1f, seed %u",
+             bestScore.cost, targetWinRate, targetRally, seed);
+    if (!Pong_SaveAIParams(outPath, &best, comment)) {
+        fprintf(stderr, "Could not write %s\n", outPath);
+        return 1;
+    }
+    printf("written to %s\n", outPath);
+
+    ThreadPool_Destroy(pool);
+    free(candidates);
+    free(scores);
+    return 0;
+}
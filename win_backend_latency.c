@@ -0,0 +1,97 @@
+#include "win_wrapper.h"
+#include "pong_clock.h"
+
+// Mock window system with a slow compositor: forwards every call to another
+// backend, but each round trip to the window system (a batch of moves being
+// applied, or a single move outside a batch) first sleeps for the configured
+// delay plus up to the configured jitter. Used to check that a slow window
+// manager can't stall the game loop.
+
+static const WinBackend* inner;
+static unsigned long long delayNs;
+static unsigned long long jitterNs;
+static unsigned long long rng = 0x2545F4914F6CDD1DULL;
+static bool batching;
+
+static void RoundTrip(void) {
+    unsigned long long wait = delayNs;
+    if (jitterNs > 0) {
+        rng ^= rng >> 12; rng ^= rng << 25; rng ^= rng >> 27;
+        wait += (rng * 2685821657736338717ULL) % jitterNs;
+    }
+    if (wait > 0) Pong_SleepNs(wait);
+}
+
+static WinHandle Latency_CreateWindow(int x, int y, int width, int height, WinHandle owner) {
+    return inner->createWindow(x, y, width, height, owner);
+}
+
+static void Latency_MakeRound(WinHandle handle, int width, int height) {
+    inner->makeRound(handle, width, height);
+}
+
+static void Latency_SetWindowPos(WinHandle handle, int x, int y, int width, int height) {
+    if (!batching) RoundTrip();
+    inner->setWindowPos(handle, x, y, width, height);
+}
+
+static void Latency_BeginMoves(int count) {
+    batching = true;
+    if (inner->beginMoves) inner->beginMoves(count);
+}
+
+static void Latency_EndMoves(void) {
+    batching = false;
+    RoundTrip();
+    if (inner->endMoves) inner->endMoves();
+}
+
+static void Latency_SetTopMost(WinHandle handle, bool enable) {
+    inner->setTopMost(handle, enable);
+}
+
+static void Latency_SetVisibleMode(WinHandle handle, bool visible) {
+    inner->setVisibleMode(handle, visible);
+}
+
+static void Latency_SetForegroundWindow(WinHandle handle) {
+    inner->setForegroundWindow(handle);
+}
+
+static void Latency_UseDarkMode(bool useDarkMode) {
+    inner->useDarkMode(useDarkMode);
+}
+
+static void Latency_ApplyEmbeddedIcon(void) {
+    inner->applyEmbeddedIcon();
+}
+
+static void Latency_ProcessMessages(void) {
+    inner->processMessages();
+}
+
+static void Latency_DestroyWindow(WinHandle handle) {
+    inner->destroyWindow(handle);
+}
+
+const WinBackend* WinBackend_Latency(const WinBackend* wrapped, unsigned long long delay, unsigned long long jitter) {
+    static const WinBackend backend = {
+        "latency",
+        Latency_CreateWindow,
+        Latency_MakeRound,
+        Latency_SetWindowPos,
+        Latency_BeginMoves,
+        Latency_EndMoves,
+        Latency_SetTopMost,
+        Latency_SetVisibleMode,
+        Latency_SetForegroundWindow,
+        Latency_UseDarkMode,
+        Latency_ApplyEmbeddedIcon,
+        Latency_ProcessMessages,
+        Latency_DestroyWindow
+    };
+    inner = wrapped;
+    delayNs = delay;
+    jitterNs = jitter;
+    return &backend;
+}
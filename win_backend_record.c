@@ -0,0 +1,91 @@
+#include <stdint.h>
+#include "win_wrapper.h"
+
+// Headless backend: creates no windows, only counts the calls it receives so
+// the number of window-system round trips can be measured on any platform.
+
+static WinRecordCounts counts;
+static uintptr_t nextHandle = 1;
+
+static WinHandle Record_CreateWindow(int x, int y, int width, int height, WinHandle owner) {
+    (void)x; (void)y; (void)width; (void)height; (void)owner;
+    counts.createWindow++;
+    return (WinHandle)(nextHandle++);
+}
+
+static void Record_MakeRound(WinHandle handle, int width, int height) {
+    (void)handle; (void)width; (void)height;
+    counts.makeRound++;
+}
+
+static void Record_SetWindowPos(WinHandle handle, int x, int y, int width, int height) {
+    (void)handle; (void)x; (void)y; (void)width; (void)height;
+    counts.setWindowPos++;
+}
+
+static void Record_BeginMoves(int count) {
+    (void)count;
+    counts.beginMoves++;
+}
+
+static void Record_EndMoves(void) {
+    counts.endMoves++;
+}
+
+static void Record_SetTopMost(WinHandle handle, bool enable) {
+    (void)handle; (void)enable;
+    counts.setTopMost++;
+}
+
+static void Record_SetVisibleMode(WinHandle handle, bool visible) {
+    (void)handle; (void)visible;
+    counts.setVisibleMode++;
+}
+
+static void Record_SetForegroundWindow(WinHandle handle) {
+    (void)handle;
+    counts.setForegroundWindow++;
+}
+
+static void Record_UseDarkMode(bool useDarkMode) {
+    (void)useDarkMode;
+}
+
+static void Record_ApplyEmbeddedIcon(void) {
+}
+
+static void Record_ProcessMessages(void) {
+    counts.processMessages++;
+}
+
+static void Record_DestroyWindow(WinHandle handle) {
+    (void)handle;
+    counts.destroyWindow++;
+}
+
+void WinRecord_GetCounts(WinRecordCounts* out) {
+    *out = counts;
+}
+
+void WinRecord_Reset(void) {
+    counts = (WinRecordCounts){ 0 };
+}
+
+const WinBackend* WinBackend_Recording(void) {
+    static const WinBackend backend = {
+        "recording",
+        Record_CreateWindow,
+        Record_MakeRound,
+        Record_SetWindowPos,
+        Record_BeginMoves,
+        Record_EndMoves,
+        Record_SetTopMost,
+        Record_SetVisibleMode,
+        Record_SetForegroundWindow,
+        Record_UseDarkMode,
+        Record_ApplyEmbeddedIcon,
+        Record_ProcessMessages,
+        Record_DestroyWindow
+    };
+    return &backend;
+}
@@ -0,0 +1,219 @@
+#ifdef _WIN32
+#define _WIN32_WINNT 0x0500 // Garante compatibilidade para Layered Windows
+#include <windows.h>
+#include <stdbool.h>
+#include <dwmapi.h>
+#include "win_wrapper.h"
+
+// Pincéis criados uma única vez (0 = preto, 1 = branco) em vez de a cada WM_PAINT
+static HBRUSH cachedBrushes[2] = { NULL, NULL };
+
+// Lote de movimentos aberto por BeginMoves (NULL fora de um lote)
+static HDWP pendingMoves = NULL;
+
+// Movimentos já adiados no lote, para refazê-los um a um se ele falhar
+#define MAX_BATCH_MOVES 16
+typedef struct {
+    HWND hwnd;
+    int x, y, width, height;
+} BatchMove;
+static BatchMove batchMoves[MAX_BATCH_MOVES];
+static int batchCount = 0;
+
+static HBRUSH GetCachedBrush(bool visible) {
+    int index = visible ? 1 : 0;
+    if (!cachedBrushes[index]) {
+        cachedBrushes[index] = CreateSolidBrush(visible ? RGB(255, 255, 255) : RGB(0, 0, 0));
+    }
+    return cachedBrushes[index];
+}
+
+LRESULT CALLBACK InternalWndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
+    switch(msg) {
+        case WM_PAINT: {
+            PAINTSTRUCT ps;
+            HDC hdc = BeginPaint(hwnd, &ps);
+            
+            // Verifica o estado salvo no UserData da janela
+            // 0 = Invisível (Pinta de preto para o ColorKey funcionar)
+            // 1 = Visível (Pinta de branco)
+            LONG_PTR isVisible = GetWindowLongPtr(hwnd, GWLP_USERDATA);
+            
+            FillRect(hdc, &ps.rcPaint, GetCachedBrush(isVisible != 0));
+            EndPaint(hwnd, &ps);
+            return 0;
+        }
+        case WM_ERASEBKGND: return 1; 
+        default: return DefWindowProc(hwnd, msg, wParam, lParam);
+    }
+}
+
+static void Win32Backend_UseDarkMode(bool useDarkMode) {
+    HWND hwnd = GetForegroundWindow();
+    BOOL useDarkModeB;
+    if(useDarkMode) useDarkModeB = TRUE; else useDarkModeB = FALSE;
+    DwmSetWindowAttribute(
+        hwnd,
+        20,
+        &useDarkModeB,
+        sizeof(useDarkModeB)
+    );
+    ShowWindow(hwnd, SW_HIDE);
+    ShowWindow(hwnd, SW_SHOW);
+}
+
+static void Win32Backend_ApplyEmbeddedIcon(void) {
+    // Carrega o ícone do EXE (IDI_APP_ICON do .rc)
+    HICON hIcon = LoadIcon(GetModuleHandle(NULL), "IDI_ICON");
+
+    // Setar ícone grande e pequeno da janela
+    HWND hwnd = GetForegroundWindow();
+
+    SendMessage(hwnd, WM_SETICON, ICON_BIG,   (LPARAM)hIcon);
+    SendMessage(hwnd, WM_SETICON, ICON_SMALL, (LPARAM)hIcon);
+}
+
+static WinHandle Win32Backend_CreateWindow(int x, int y, int width, int height, WinHandle owner) {
+    const char* CLASS_NAME = "PongElementClass";
+    static bool classRegistered = false;
+
+    if (!classRegistered) {
+        WNDCLASS wc = {0};
+        wc.lpfnWndProc = InternalWndProc;
+        wc.hInstance = GetModuleHandle(NULL);
+        wc.lpszClassName = CLASS_NAME;
+        wc.hCursor = LoadCursor(NULL, IDC_ARROW);
+        RegisterClass(&wc);
+        classRegistered = true;
+    }
+
+    // Criamos inicialmente com WS_EX_LAYERED para poder usar transparência
+    HWND hwnd = CreateWindowEx(
+        WS_EX_TOOLWINDOW | WS_EX_LAYERED, 
+        CLASS_NAME, "",
+        WS_POPUP | WS_VISIBLE,
+        x, y, width, height,
+        (HWND)owner, 
+        NULL, GetModuleHandle(NULL), NULL
+    );
+    
+    // Configura inicial: Preto transparente (Key = 0,0,0)
+    SetLayeredWindowAttributes(hwnd, RGB(0,0,0), 0, LWA_COLORKEY);
+    SetWindowLongPtr(hwnd, GWLP_USERDATA, 0); // Estado 0 = Hidden
+
+    return (WinHandle)hwnd;
+}
+
+static void Win32Backend_SetVisibleMode(WinHandle handle, bool visible) {
+    HWND hwnd = (HWND)handle;
+
+    // Atualiza o estado interno (0 ou 1)
+    SetWindowLongPtr(hwnd, GWLP_USERDATA, (LONG_PTR)(visible ? 1 : 0));
+
+    if (visible) {
+        // Remove o estilo Layered (janela normal opaca)
+        // Isso melhora performance e garante que seja branco puro
+        LONG_PTR style = GetWindowLongPtr(hwnd, GWL_EXSTYLE);
+        SetWindowLongPtr(hwnd, GWL_EXSTYLE, style & ~WS_EX_LAYERED);
+    } else {
+        // Adiciona Layered e define ColorKey preto
+        LONG_PTR style = GetWindowLongPtr(hwnd, GWL_EXSTYLE);
+        SetWindowLongPtr(hwnd, GWL_EXSTYLE, style | WS_EX_LAYERED);
+        SetLayeredWindowAttributes(hwnd, RGB(0,0,0), 0, LWA_COLORKEY);
+    }
+
+    // Força repintura imediata
+    InvalidateRect(hwnd, NULL, TRUE);
+}
+
+static void Win32Backend_MakeRound(WinHandle handle, int width, int height) {
+    HRGN hRgn = CreateEllipticRgn(0, 0, width, height);
+    SetWindowRgn((HWND)handle, hRgn, TRUE);
+}
+
+static void Win32Backend_SetTopMost(WinHandle handle, bool enable) {
+    HWND order = enable ? HWND_TOPMOST : HWND_NOTOPMOST;
+    SetWindowPos((HWND)handle, order, 0, 0, 0, 0, SWP_NOMOVE | SWP_NOSIZE | SWP_NOACTIVATE);
+}
+
+static void MoveNow(HWND hwnd, int x, int y, int width, int height) {
+    SetWindowPos(hwnd, NULL, x, y, width, height, SWP_NOACTIVATE | SWP_NOZORDER);
+}
+
+// O lote falhou e o Windows já o liberou: nenhum movimento adiado foi
+// aplicado, então todos são feitos direto (o wrapper já os conta como feitos)
+static void ReplayBatch(void) {
+    for (int i = 0; i < batchCount; i++) {
+        MoveNow(batchMoves[i].hwnd, batchMoves[i].x, batchMoves[i].y, batchMoves[i].width, batchMoves[i].height);
+    }
+    batchCount = 0;
+}
+
+static void Win32Backend_BeginMoves(int count) {
+    pendingMoves = BeginDeferWindowPos(count < MAX_BATCH_MOVES ? count : MAX_BATCH_MOVES);
+    batchCount = 0;
+}
+
+static void Win32Backend_SetWindowPos(WinHandle handle, int x, int y, int width, int height) {
+    // Lote cheio: aplica o que já foi adiado e segue movendo direto
+    if (pendingMoves && batchCount == MAX_BATCH_MOVES) {
+        if (!EndDeferWindowPos(pendingMoves)) ReplayBatch();
+        pendingMoves = NULL;
+        batchCount = 0;
+    }
+    if (pendingMoves) {
+        // DeferWindowPos pode falhar e liberar o lote inteiro
+        pendingMoves = DeferWindowPos(pendingMoves, (HWND)handle, NULL, x, y, width, height, SWP_NOACTIVATE | SWP_NOZORDER);
+        if (pendingMoves) {
+            batchMoves[batchCount++] = (BatchMove){ (HWND)handle, x, y, width, height };
+            return;
+        }
+        ReplayBatch();
+    }
+    MoveNow((HWND)handle, x, y, width, height);
+}
+
+static void Win32Backend_EndMoves(void) {
+    if (pendingMoves && !EndDeferWindowPos(pendingMoves)) ReplayBatch();
+    pendingMoves = NULL;
+    batchCount = 0;
+}
+
+static void Win32Backend_SetForegroundWindow(WinHandle handle)
+{
+    // HWND is the native Win32 window handle type.
+    SetForegroundWindow((HWND)handle);
+}
+
+static void Win32Backend_ProcessMessages(void) {
+    MSG msg;
+    while (PeekMessage(&msg, NULL, 0, 0, PM_REMOVE)) {
+        TranslateMessage(&msg);
+        DispatchMessage(&msg);
+    }
+}
+
+static void Win32Backend_DestroyWindow(WinHandle handle) {
+    DestroyWindow((HWND)handle);
+}
+
+const WinBackend* WinBackend_Win32(void) {
+    static const WinBackend backend = {
+        "win32",
+        Win32Backend_CreateWindow,
+        Win32Backend_MakeRound,
+        Win32Backend_SetWindowPos,
+        Win32Backend_BeginMoves,
+        Win32Backend_EndMoves,
+        Win32Backend_SetTopMost,
+        Win32Backend_SetVisibleMode,
+        Win32Backend_SetForegroundWindow,
+        Win32Backend_UseDarkMode,
+        Win32Backend_ApplyEmbeddedIcon,
+        Win32Backend_ProcessMessages,
+        Win32Backend_DestroyWindow
+    };
+    return &backend;
+}
+
+#endif
@@ -0,0 +1,133 @@
+#ifdef PONG_X11
+#include <stdint.h>
+#include <X11/Xlib.h>
+#include <X11/Xutil.h>
+#include <X11/extensions/shape.h>
+#include "win_wrapper.h"
+
+// X11 backend for Linux builds. The overlay windows are override-redirect so
+// the window manager neither decorates nor moves them. X has no colour key,
+// so a hidden element is simply unmapped instead of painted black.
+
+static Display* display = NULL;
+static bool batching = false;
+
+static Display* GetDisplay(void) {
+    if (!display) display = XOpenDisplay(NULL);
+    return display;
+}
+
+static Window ToWindow(WinHandle handle) {
+    return (Window)(uintptr_t)handle;
+}
+
+static WinHandle X11_CreateWindow(int x, int y, int width, int height, WinHandle owner) {
+    Display* dpy = GetDisplay();
+    if (!dpy) return NULL;
+
+    int screen = DefaultScreen(dpy);
+    XSetWindowAttributes attrs;
+    attrs.override_redirect = True;
+    attrs.background_pixel = WhitePixel(dpy, screen);
+    attrs.border_pixel = 0;
+
+    Window window = XCreateWindow(dpy, RootWindow(dpy, screen), x, y, (unsigned int)width, (unsigned int)height, 0,
+                                  CopyFromParent, InputOutput, CopyFromParent,
+                                  CWOverrideRedirect | CWBackPixel | CWBorderPixel, &attrs);
+    if (owner) XSetTransientForHint(dpy, window, ToWindow(owner));
+    XFlush(dpy);
+    return (WinHandle)(uintptr_t)window;
+}
+
+static void X11_MakeRound(WinHandle handle, int width, int height) {
+    Display* dpy = GetDisplay();
+    Window window = ToWindow(handle);
+
+    Pixmap mask = XCreatePixmap(dpy, window, (unsigned int)width, (unsigned int)height, 1);
+    GC gc = XCreateGC(dpy, mask, 0, NULL);
+    XSetForeground(dpy, gc, 0);
+    XFillRectangle(dpy, mask, gc, 0, 0, (unsigned int)width, (unsigned int)height);
+    XSetForeground(dpy, gc, 1);
+    XFillArc(dpy, mask, gc, 0, 0, (unsigned int)width, (unsigned int)height, 0, 360 * 64);
+    XShapeCombineMask(dpy, window, ShapeBounding, 0, 0, mask, ShapeSet);
+    XFreeGC(dpy, gc);
+    XFreePixmap(dpy, mask);
+}
+
+static void X11_SetWindowPos(WinHandle handle, int x, int y, int width, int height) {
+    XMoveResizeWindow(GetDisplay(), ToWindow(handle), x, y, (unsigned int)width, (unsigned int)height);
+    if (!batching) XFlush(display);
+}
+
+static void X11_BeginMoves(int count) {
+    (void)count;
+    batching = true;
+}
+
+static void X11_EndMoves(void) {
+    batching = false;
+    // Requests are buffered by Xlib, one flush sends the whole batch
+    XFlush(GetDisplay());
+}
+
+static void X11_SetTopMost(WinHandle handle, bool enable) {
+    if (enable) XRaiseWindow(GetDisplay(), ToWindow(handle));
+    else XLowerWindow(GetDisplay(), ToWindow(handle));
+    XFlush(display);
+}
+
+static void X11_SetVisibleMode(WinHandle handle, bool visible) {
+    if (visible) XMapRaised(GetDisplay(), ToWindow(handle));
+    else XUnmapWindow(GetDisplay(), ToWindow(handle));
+    XFlush(display);
+}
+
+static void X11_SetForegroundWindow(WinHandle handle) {
+    Display* dpy = GetDisplay();
+    if (!dpy || !handle) return;
+    XSetInputFocus(dpy, ToWindow(handle), RevertToParent, CurrentTime);
+    XFlush(dpy);
+}
+
+static void X11_UseDarkMode(bool useDarkMode) {
+    (void)useDarkMode;
+}
+
+static void X11_ApplyEmbeddedIcon(void) {
+}
+
+static void X11_ProcessMessages(void) {
+    Display* dpy = GetDisplay();
+    if (!dpy) return;
+    // The background pixel repaints exposed areas, events only need draining
+    while (XPending(dpy)) {
+        XEvent event;
+        XNextEvent(dpy, &event);
+    }
+}
+
+static void X11_DestroyWindow(WinHandle handle) {
+    XDestroyWindow(GetDisplay(), ToWindow(handle));
+    XFlush(display);
+}
+
+const WinBackend* WinBackend_X11(void) {
+    static const WinBackend backend = {
+        "x11",
+        X11_CreateWindow,
+        X11_MakeRound,
+        X11_SetWindowPos,
+        X11_BeginMoves,
+        X11_EndMoves,
+        X11_SetTopMost,
+        X11_SetVisibleMode,
+        X11_SetForegroundWindow,
+        X11_UseDarkMode,
+        X11_ApplyEmbeddedIcon,
+        X11_ProcessMessages,
+        X11_DestroyWindow
+    };
+    return &backend;
+}
+
+#endif
@@ -1,143 +1,174 @@
-#define _WIN32_WINNT 0x0500 // Garante compatibilidade para Layered Windows
-#include <windows.h>
-#include <stdbool.h>
-#include <dwmapi.h>
+#include <stddef.h>
 #include "win_wrapper.h"
 
-LRESULT CALLBACK InternalWndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
-    switch(msg) {
-        case WM_PAINT: {
-            PAINTSTRUCT ps;
-            HDC hdc = BeginPaint(hwnd, &ps);
-            
-            // Verifica o estado salvo no UserData da janela
-            // 0 = Invisível (Pinta de preto para o ColorKey funcionar)
-            // 1 = Visível (Pinta de branco)
-            LONG_PTR isVisible = GetWindowLongPtr(hwnd, GWLP_USERDATA);
-            
-            COLORREF color = (isVisible) ? RGB(255, 255, 255) : RGB(0, 0, 0);
-            HBRUSH brush = CreateSolidBrush(color);
-            
-            FillRect(hdc, &ps.rcPaint, brush);
-            DeleteObject(brush);
-            EndPaint(hwnd, &ps);
-            return 0;
-        }
-        case WM_ERASEBKGND: return 1; 
-        default: return DefWindowProc(hwnd, msg, wParam, lParam);
+// Backend-independent front end. Remembers the last rectangle sent for each
+// window so repeated positions never reach the backend, and queues moves
+// between Win32_BeginWindowMoves/Win32_EndWindowMoves so the backend can
+// apply them in one go.
+
+#define MAX_TRACKED_WINDOWS 16
+
+typedef struct {
+    WinHandle handle;
+    int x, y, width, height;
+    bool known;     // A position has been applied at least once
+    bool pending;   // Queued in the current batch
+    bool dirty;     // Pending move differs from the applied one
+    int px, py, pwidth, pheight;
+} TrackedWindow;
+
+static const WinBackend* activeBackend = NULL;
+static TrackedWindow tracked[MAX_TRACKED_WINDOWS];
+static int trackedCount = 0;
+static bool batching = false;
+static WinSyncStats syncStats;
+
+static const WinBackend* Backend(void) {
+    if (!activeBackend) {
+#if defined(_WIN32)
+        activeBackend = WinBackend_Win32();
+#elif defined(PONG_X11)
+        activeBackend = WinBackend_X11();
+#else
+        activeBackend = WinBackend_Recording();
+#endif
     }
+    return activeBackend;
 }
 
-void Win32_UseDarkMode(bool useDarkMode) {
-    HWND hwnd = GetForegroundWindow();
-    BOOL useDarkModeB;
-    if(useDarkMode) useDarkModeB = TRUE; else useDarkModeB = FALSE;
-    HRESULT hr = DwmSetWindowAttribute(
-        hwnd,
-        20,
-        &useDarkModeB,
-        sizeof(useDarkModeB)
-    );
-    ShowWindow(hwnd, SW_HIDE);
-    ShowWindow(hwnd, SW_SHOW);
+void Win32_SetBackend(const WinBackend* backend) {
+    activeBackend = backend;
+    trackedCount = 0;
+    batching = false;
+    syncStats = (WinSyncStats){ 0 };
 }
 
-void Win32_ApplyEmbeddedIcon(void) {
-    // Carrega o ícone do EXE (IDI_APP_ICON do .rc)
-    HICON hIcon = LoadIcon(GetModuleHandle(NULL), "IDI_ICON");
+const WinBackend* Win32_GetBackend(void) {
+    return Backend();
+}
 
-    // Setar ícone grande e pequeno da janela
-    HWND hwnd = GetForegroundWindow();
+void Win32_GetSyncStats(WinSyncStats* stats) {
+    *stats = syncStats;
+}
 
-    SendMessage(hwnd, WM_SETICON, ICON_BIG,   (LPARAM)hIcon);
-    SendMessage(hwnd, WM_SETICON, ICON_SMALL, (LPARAM)hIcon);
+static TrackedWindow* FindTracked(WinHandle handle) {
+    for (int i = 0; i < trackedCount; i++) {
+        if (tracked[i].handle == handle) return &tracked[i];
+    }
+    return NULL;
 }
 
 WinHandle Win32_CreateWindow(int x, int y, int width, int height, WinHandle owner) {
-    const char* CLASS_NAME = "PongElementClass";
-    static bool classRegistered = false;
-
-    if (!classRegistered) {
-        WNDCLASS wc = {0};
-        wc.lpfnWndProc = InternalWndProc;
-        wc.hInstance = GetModuleHandle(NULL);
-        wc.lpszClassName = CLASS_NAME;
-        wc.hCursor = LoadCursor(NULL, IDC_ARROW);
-        RegisterClass(&wc);
-        classRegistered = true;
+    WinHandle handle = Backend()->createWindow(x, y, width, height, owner);
+    if (handle && trackedCount < MAX_TRACKED_WINDOWS) {
+        tracked[trackedCount++] = (TrackedWindow){ handle, x, y, width, height, true, false, false, 0, 0, 0, 0 };
     }
+    return handle;
+}
 
-    // Criamos inicialmente com WS_EX_LAYERED para poder usar transparência
-    HWND hwnd = CreateWindowEx(
-        WS_EX_TOOLWINDOW | WS_EX_LAYERED, 
-        CLASS_NAME, "",
-        WS_POPUP | WS_VISIBLE,
-        x, y, width, height,
-        (HWND)owner, 
-        NULL, GetModuleHandle(NULL), NULL
-    );
-    
-    // Configura inicial: Preto transparente (Key = 0,0,0)
-    SetLayeredWindowAttributes(hwnd, RGB(0,0,0), 0, LWA_COLORKEY);
-    SetWindowLongPtr(hwnd, GWLP_USERDATA, 0); // Estado 0 = Hidden
-
-    return (WinHandle)hwnd;
+void Win32_MakeRound(WinHandle handle, int width, int height) {
+    if (!handle) return;
+    Backend()->makeRound(handle, width, height);
 }
 
-void Win32_SetVisibleMode(WinHandle handle, bool visible) {
+void Win32_SetWindowPos(WinHandle handle, int x, int y, int width, int height) {
     if (!handle) return;
-    HWND hwnd = (HWND)handle;
-
-    // Atualiza o estado interno (0 ou 1)
-    SetWindowLongPtr(hwnd, GWLP_USERDATA, (LONG_PTR)(visible ? 1 : 0));
-
-    if (visible) {
-        // Remove o estilo Layered (janela normal opaca)
-        // Isso melhora performance e garante que seja branco puro
-        LONG_PTR style = GetWindowLongPtr(hwnd, GWL_EXSTYLE);
-        SetWindowLongPtr(hwnd, GWL_EXSTYLE, style & ~WS_EX_LAYERED);
-    } else {
-        // Adiciona Layered e define ColorKey preto
-        LONG_PTR style = GetWindowLongPtr(hwnd, GWL_EXSTYLE);
-        SetWindowLongPtr(hwnd, GWL_EXSTYLE, style | WS_EX_LAYERED);
-        SetLayeredWindowAttributes(hwnd, RGB(0,0,0), 0, LWA_COLORKEY);
+    syncStats.moveRequests++;
+
+    TrackedWindow* w = FindTracked(handle);
+    if (!w) {
+        // Not created through us, nothing to compare against
+        syncStats.movesIssued++;
+        Backend()->setWindowPos(handle, x, y, width, height);
+        return;
+    }
+
+    if (batching) {
+        // Only the last move of a window in a batch matters
+        w->pending = true;
+        w->px = x; w->py = y; w->pwidth = width; w->pheight = height;
+        return;
     }
 
-    // Força repintura imediata
-    InvalidateRect(hwnd, NULL, TRUE);
+    if (w->known && w->x == x && w->y == y && w->width == width && w->height == height) {
+        syncStats.movesSkipped++;
+        return;
+    }
+    w->x = x; w->y = y; w->width = width; w->height = height; w->known = true;
+    syncStats.movesIssued++;
+    Backend()->setWindowPos(handle, x, y, width, height);
 }
 
-void Win32_MakeRound(WinHandle handle, int width, int height) {
-    if (!handle) return;
-    HRGN hRgn = CreateEllipticRgn(0, 0, width, height);
-    SetWindowRgn((HWND)handle, hRgn, TRUE);
+void Win32_BeginWindowMoves(int count) {
+    (void)count;
+    batching = true;
+}
+
+void Win32_EndWindowMoves(void) {
+    if (!batching) return;
+    batching = false;
+
+    int dirty = 0;
+    for (int i = 0; i < trackedCount; i++) {
+        TrackedWindow* w = &tracked[i];
+        if (!w->pending) continue;
+        w->pending = false;
+        if (w->known && w->x == w->px && w->y == w->py && w->width == w->pwidth && w->height == w->pheight) {
+            syncStats.movesSkipped++;
+            continue;
+        }
+        w->x = w->px; w->y = w->py; w->width = w->pwidth; w->height = w->pheight; w->known = true;
+        w->dirty = true;
+        dirty++;
+    }
+    if (dirty == 0) return;
+
+    const WinBackend* backend = Backend();
+    if (backend->beginMoves) backend->beginMoves(dirty);
+    for (int i = 0; i < trackedCount; i++) {
+        TrackedWindow* w = &tracked[i];
+        if (!w->dirty) continue;
+        w->dirty = false;
+        backend->setWindowPos(w->handle, w->x, w->y, w->width, w->height);
+        syncStats.movesIssued++;
+    }
+    if (backend->endMoves) backend->endMoves();
+    syncStats.batches++;
 }
 
 void Win32_SetTopMost(WinHandle handle, bool enable) {
     if (!handle) return;
-    HWND order = enable ? HWND_TOPMOST : HWND_NOTOPMOST;
-    SetWindowPos((HWND)handle, order, 0, 0, 0, 0, SWP_NOMOVE | SWP_NOSIZE | SWP_NOACTIVATE);
+    Backend()->setTopMost(handle, enable);
 }
 
-void Win32_SetWindowPos(WinHandle handle, int x, int y, int width, int height) {
+void Win32_SetVisibleMode(WinHandle handle, bool visible) {
     if (!handle) return;
-    SetWindowPos((HWND)handle, NULL, x, y, width, height, SWP_NOACTIVATE | SWP_NOZORDER);
+    Backend()->setVisibleMode(handle, visible);
 }
 
-void Win32_SetForegroundWindow(WinHandle handle)
-{
-    // HWND is the native Win32 window handle type.
-    SetForegroundWindow((HWND)handle);
+void Win32_SetForegroundWindow(WinHandle handle) {
+    Backend()->setForegroundWindow(handle);
+}
+
+void Win32_UseDarkMode(bool useDarkMode) {
+    Backend()->useDarkMode(useDarkMode);
+}
+
+void Win32_ApplyEmbeddedIcon(void) {
+    Backend()->applyEmbeddedIcon();
 }
 
 void Win32_ProcessMessages(void) {
-    MSG msg;
-    while (PeekMessage(&msg, NULL, 0, 0, PM_REMOVE)) {
-        TranslateMessage(&msg);
-        DispatchMessage(&msg);
-    }
+    Backend()->processMessages();
 }
 
 void Win32_DestroyWindow(WinHandle handle) {
-    if (handle) DestroyWindow((HWND)handle);
+    if (!handle) return;
+    for (int i = 0; i < trackedCount; i++) {
+        if (tracked[i].handle == handle) {
+            tracked[i] = tracked[--trackedCount];
+            break;
+        }
+    }
+    Backend()->destroyWindow(handle);
 }
\ No newline at end of file
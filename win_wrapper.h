@@ -4,6 +4,61 @@
 
 typedef void* WinHandle;
 
+// Window backend. Every Win32_* call below is forwarded to the active backend
+// after going through the dirty-tracking layer in win_wrapper.c.
+typedef struct {
+    const char* name;
+    WinHandle (*createWindow)(int x, int y, int width, int height, WinHandle owner);
+    void (*makeRound)(WinHandle handle, int width, int height);
+    void (*setWindowPos)(WinHandle handle, int x, int y, int width, int height);
+    void (*beginMoves)(int count);   // Optional: start of a batch of setWindowPos calls
+    void (*endMoves)(void);          // Optional: apply the batch
+    void (*setTopMost)(WinHandle handle, bool enable);
+    void (*setVisibleMode)(WinHandle handle, bool visible);
+    void (*setForegroundWindow)(WinHandle handle);
+    void (*useDarkMode)(bool useDarkMode);
+    void (*applyEmbeddedIcon)(void);
+    void (*processMessages)(void);
+    void (*destroyWindow)(WinHandle handle);
+} WinBackend;
+
+const WinBackend* WinBackend_Win32(void);     // win_backend_win32.c (Windows builds)
+const WinBackend* WinBackend_X11(void);       // win_backend_x11.c (PONG_X11 builds)
+const WinBackend* WinBackend_Recording(void); // win_backend_record.c
+// win_backend_latency.c: wraps another backend, each window-system round trip
+// sleeps delayNs plus up to jitterNs (a slow compositor, for testing)
+const WinBackend* WinBackend_Latency(const WinBackend* inner, unsigned long long delayNs, unsigned long long jitterNs);
+
+// Counters kept by the recording backend, one per backend call
+typedef struct {
+    long createWindow;
+    long makeRound;
+    long setWindowPos;
+    long beginMoves;
+    long endMoves;
+    long setTopMost;
+    long setVisibleMode;
+    long setForegroundWindow;
+    long processMessages;
+    long destroyWindow;
+} WinRecordCounts;
+
+void WinRecord_GetCounts(WinRecordCounts* counts);
+void WinRecord_Reset(void);
+
+// Counters kept by the dirty-tracking layer
+typedef struct {
+    long moveRequests;  // Win32_SetWindowPos calls made by the game
+    long movesSkipped;  // Dropped because the window was already there
+    long movesIssued;   // Forwarded to the backend
+    long batches;       // Win32_EndWindowMoves calls that issued at least one move
+} WinSyncStats;
+
+// Selects the backend (defaults to the native one for the platform)
+void Win32_SetBackend(const WinBackend* backend);
+const WinBackend* Win32_GetBackend(void);
+void Win32_GetSyncStats(WinSyncStats* stats);
+
 WinHandle Win32_CreateWindow(int x, int y, int width, int height, WinHandle owner);
 void Win32_MakeRound(WinHandle handle, int width, int height);
 void Win32_SetWindowPos(WinHandle handle, int x, int y, int width, int height);
@@ -12,6 +67,10 @@ void Win32_SetVisibleMode(WinHandle handle, bool visible);
 void Win32_SetForegroundWindow(WinHandle handle);
 void Win32_UseDarkMode(bool useDarkMode);
 
+// Moves between Begin/End are queued and applied together (DeferWindowPos)
+void Win32_BeginWindowMoves(int count);
+void Win32_EndWindowMoves(void);
+
 void Win32_ApplyEmbeddedIcon(void);
 
 void Win32_ProcessMessages(void);